@@ -0,0 +1,113 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * btree_set / btree_map 与 std::set / std::map 的比较，key 是随机排列的 64 位整数，n 取 1M 和 10M：
+ * (1)随机顺序逐个 insert，以及从有序区间构造
+ * (2)随机查找 1M 次，一半命中一半不命中
+ * (3)从头到尾按顺序遍历一遍
+ */
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "bench_common.h"
+#include "mabu_btree_map.h"
+#include "mabu_btree_set.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    typedef unsigned long long key_type;
+
+    // 偶数作为 key，查找时奇数一定不命中
+    std::vector<key_type> make_keys(size_t n) {
+        std::vector<key_type> keys(n);
+        for(size_t i = 0; i != n; ++i) keys[i] = 2 * i;
+        std::shuffle(keys.begin(), keys.end(), std::mt19937_64(20261017));
+        return keys;
+    }
+
+    std::vector<key_type> make_queries(size_t n, size_t count) {
+        std::mt19937_64 rng(1);
+        std::vector<key_type> queries(count);
+        for(size_t i = 0; i != count; ++i) queries[i] = rng() % (2 * n);
+        return queries;
+    }
+
+    template<class Set>
+    void insert_all(Set& s, const std::vector<key_type>& keys) {
+        for(size_t i = 0; i != keys.size(); ++i) s.insert(keys[i]);
+        do_not_optimize(s.size());
+    }
+
+    template<class Set>
+    void find_all(const Set& s, const std::vector<key_type>& queries) {
+        size_t hits = 0;
+        for(size_t i = 0; i != queries.size(); ++i) hits += s.find(queries[i]) != s.end();
+        do_not_optimize(hits);
+    }
+
+    template<class Set>
+    void scan(const Set& s) {
+        key_type sum = 0;
+        for(typename Set::const_iterator it = s.begin(); it != s.end(); ++it) sum += *it;
+        do_not_optimize(sum);
+    }
+
+    template<class Map>
+    void scan_map(const Map& m) {
+        key_type sum = 0;
+        for(typename Map::const_iterator it = m.begin(); it != m.end(); ++it) sum += it->second;
+        do_not_optimize(sum);
+    }
+}
+
+int main() {
+    const size_t sizes[] = {size_t(1) << 20, 10000000};
+    for(size_t s = 0; s != sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        const size_t n = sizes[s];
+        const std::vector<key_type> keys = make_keys(n);
+        const std::vector<key_type> queries = make_queries(n, size_t(1) << 20);
+        std::vector<key_type> sorted(keys);
+        std::sort(sorted.begin(), sorted.end());
+        char name[64];
+
+        std::set<key_type> ss;
+        mabustl::btree_set<key_type> ms;
+        std::snprintf(name, sizeof(name), "set insert random n=%zu", n);
+        report(name, best_ms([&] { ss.clear(); }, [&] { insert_all(ss, keys); }),
+               best_ms([&] { ms.clear(); }, [&] { insert_all(ms, keys); }));
+
+        std::snprintf(name, sizeof(name), "set build sorted n=%zu", n);
+        report(name, best_ms([&] { ss.clear(); }, [&] { ss.insert(sorted.begin(), sorted.end()); }),
+               best_ms([&] { ms.clear(); }, [&] { ms.insert(sorted.data(), sorted.data() + n); }));
+
+        std::snprintf(name, sizeof(name), "set find n=%zu", n);
+        report(name, best_ms([&] { find_all(ss, queries); }), best_ms([&] { find_all(ms, queries); }));
+
+        std::snprintf(name, sizeof(name), "set scan n=%zu", n);
+        report(name, best_ms([&] { scan(ss); }), best_ms([&] { scan(ms); }));
+        ss.clear();
+        ms.clear();
+
+        std::map<key_type, key_type> sm;
+        mabustl::btree_map<key_type, key_type> mm;
+        for(size_t i = 0; i != n; ++i) {
+            sm.insert(std::make_pair(keys[i], i));
+            mm.insert(mabustl::make_pair(keys[i], static_cast<key_type>(i)));
+        }
+        std::snprintf(name, sizeof(name), "map find n=%zu", n);
+        report(name, best_ms([&] { find_all(sm, queries); }), best_ms([&] { find_all(mm, queries); }));
+
+        std::snprintf(name, sizeof(name), "map scan n=%zu", n);
+        report(name, best_ms([&] { scan_map(sm); }), best_ms([&] { scan_map(mm); }));
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * 基准测试用的公共工具
+ * 每个 bench_*.cpp 是一个独立的可执行文件，对同一组输入分别运行 std 和 mabustl 的实现，
+ * 每项取 BENCH_REPEAT 次中最快的一次，输出毫秒数；基准测试不注册到 ctest
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace mabustl_bench {
+    enum { BENCH_REPEAT = 5 };
+
+    // 阻止编译器把结果没有被使用的计算优化掉
+    template<class T>
+    inline void do_not_optimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // 运行 f 若干次，返回最快一次的毫秒数；setup 在每次计时之前调用，不计入时间
+    template<class Setup, class Function>
+    double best_ms(Setup setup, Function f) {
+        double best = 1e300;
+        for(int i = 0; i != BENCH_REPEAT; ++i) {
+            setup();
+            const auto start = std::chrono::steady_clock::now();
+            f();
+            const auto stop = std::chrono::steady_clock::now();
+            const double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+            if(ms < best) best = ms;
+        }
+        return best;
+    }
+
+    template<class Function>
+    double best_ms(Function f) {
+        return best_ms([] {}, f);
+    }
+
+    inline void report(const char* name, double std_ms, double mabu_ms) {
+        std::printf("%-36s std %10.3f ms   mabustl %10.3f ms   ratio %5.2f\n", name, std_ms, mabu_ms,
+                    mabu_ms > 0 ? std_ms / mabu_ms : 0.0);
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * d_ary_heap 与 std::priority_queue(二叉堆)的比较，定时器负载：
+ * (1)堆中常驻 n 个(1K 和 1M) 16 字节的定时器项，反复取出最早到期的一项，再以新的到期时间放回(pop + push)
+ * (2)同样的负载用 replace_top 代替 pop + push
+ * (3)先 push n 项，再全部 pop
+ */
+
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "bench_common.h"
+#include "mabu_d_ary_heap.h"
+#include "mabu_functional.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    struct timer {
+        long long deadline;
+        long long id;
+
+        bool operator>(const timer& rhs) const { return deadline > rhs.deadline; }
+    };
+
+    typedef std::priority_queue<timer, std::vector<timer>, std::greater<timer> > std_heap;
+
+    template<size_t D>
+    struct mabu_heap {
+        typedef mabustl::d_ary_heap<timer, D, mabustl::greater<timer> > type;
+    };
+
+    std::vector<long long> make_delays(size_t n) {
+        std::mt19937_64 rng(20261017);
+        std::vector<long long> delays(n);
+        for(size_t i = 0; i != n; ++i) delays[i] = static_cast<long long>(rng() % 1000000);
+        return delays;
+    }
+
+    template<class Heap>
+    void fill(Heap& heap, const std::vector<long long>& delays, size_t n) {
+        for(size_t i = 0; i != n; ++i) {
+            timer t = {delays[i], static_cast<long long>(i)};
+            heap.push(t);
+        }
+    }
+
+    template<class Heap>
+    void reschedule(Heap& heap, const std::vector<long long>& delays) {
+        for(size_t i = 0; i != delays.size(); ++i) {
+            timer t = heap.top();
+            heap.pop();
+            t.deadline += delays[i];
+            heap.push(t);
+        }
+        do_not_optimize(heap.top());
+    }
+
+    template<class Heap>
+    void reschedule_in_place(Heap& heap, const std::vector<long long>& delays) {
+        for(size_t i = 0; i != delays.size(); ++i) {
+            timer t = heap.top();
+            t.deadline += delays[i];
+            heap.replace_top(t);
+        }
+        do_not_optimize(heap.top());
+    }
+
+    template<class Heap>
+    void push_pop_all(const std::vector<long long>& delays) {
+        Heap heap;
+        fill(heap, delays, delays.size());
+        long long sum = 0;
+        while(!heap.empty()) {
+            sum += heap.top().deadline;
+            heap.pop();
+        }
+        do_not_optimize(sum);
+    }
+
+    template<size_t D>
+    void run(size_t n, const std::vector<long long>& delays) {
+        char name[64];
+        std_heap s;
+        typename mabu_heap<D>::type m;
+        const double std_ms = best_ms([&] { s = std_heap(); fill(s, delays, n); }, [&] { reschedule(s, delays); });
+        std::snprintf(name, sizeof(name), "D=%zu pop+push n=%zu", D, n);
+        report(name, std_ms, best_ms([&] { m.clear(); fill(m, delays, n); }, [&] { reschedule(m, delays); }));
+        std::snprintf(name, sizeof(name), "D=%zu replace_top n=%zu", D, n);
+        report(name, std_ms, best_ms([&] { m.clear(); fill(m, delays, n); }, [&] { reschedule_in_place(m, delays); }));
+    }
+}
+
+int main() {
+    const std::vector<long long> delays = make_delays(size_t(1) << 20);
+    const size_t sizes[] = {size_t(1) << 10, size_t(1) << 20};
+    for(size_t i = 0; i != sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        run<2>(sizes[i], delays);
+        run<4>(sizes[i], delays);
+        run<8>(sizes[i], delays);
+    }
+    report("D=4 push then pop all 1M", best_ms([&] { push_pop_all<std_heap>(delays); }),
+           best_ms([&] { push_pop_all<mabu_heap<4>::type>(delays); }));
+    report("D=8 push then pop all 1M", best_ms([&] { push_pop_all<std_heap>(delays); }),
+           best_ms([&] { push_pop_all<mabu_heap<8>::type>(delays); }));
+    return 0;
+}
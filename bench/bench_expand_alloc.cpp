@@ -0,0 +1,80 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * allocate_at_least / try_expand 在以 push_back 为主的负载上的收益
+ * 同一个 mabustl::vector 分别使用完整的 allocator 和只有 allocate / deallocate 的 allocator(每次扩容都重新分配并搬移)，
+ * std 一栏是 std::vector + std::allocator 作为参照：
+ * (1)pool_alloc 上的大量短 vector：每个 push_back 1 到 48 个 int，大小等级的余量由 allocate_at_least 用上
+ * (2)mmap_alloc 上的一个大 vector：push_back 64M 个 int，映射可以用 mremap 原地扩大，不再搬移旧元素
+ */
+
+#include <vector>
+
+#include "bench_common.h"
+#include "mabu_allocator.h"
+#include "mabu_vector.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    // 只有 allocate / deallocate，allocator_traits 为它提供的 allocate_at_least 就是 allocate，try_expand 总是失败
+    template<class T, class Backend>
+    struct plain_allocator {
+        typedef T value_type;
+
+        plain_allocator() {}
+
+        template<class U>
+        plain_allocator(const plain_allocator<U, Backend>&) {}
+
+        T* allocate(size_t n) { return mabustl::allocator<T, Backend>::allocate(n); }
+        void deallocate(T* ptr, size_t n) { mabustl::allocator<T, Backend>::deallocate(ptr, n); }
+    };
+
+    template<class T, class U, class Backend>
+    bool operator==(const plain_allocator<T, Backend>&, const plain_allocator<U, Backend>&) { return true; }
+
+    template<class T, class U, class Backend>
+    bool operator!=(const plain_allocator<T, Backend>&, const plain_allocator<U, Backend>&) { return false; }
+
+    template<class Vector>
+    void many_short(const std::vector<int>& lengths) {
+        std::vector<Vector> vectors(lengths.size());
+        for(size_t i = 0; i != lengths.size(); ++i) {
+            for(int j = 0; j != lengths[i]; ++j) vectors[i].push_back(j);
+        }
+        do_not_optimize(vectors.back());
+    }
+
+    template<class Vector>
+    void one_long(size_t n) {
+        Vector v;
+        for(size_t i = 0; i != n; ++i) v.push_back(static_cast<int>(i));
+        do_not_optimize(v.back());
+    }
+}
+
+int main() {
+    std::vector<int> lengths(200000);
+    std::mt19937 rng(20261017);
+    for(size_t i = 0; i != lengths.size(); ++i) lengths[i] = 1 + static_cast<int>(rng() % 48);
+
+    typedef mabustl::vector<int, plain_allocator<int, mabustl::pool_alloc> > plain_pool_vector;
+    typedef mabustl::vector<int, mabustl::pool_allocator<int> > pool_vector;
+    const double std_short = best_ms([&] { many_short<std::vector<int> >(lengths); });
+    report("200K short vectors, pool plain", std_short, best_ms([&] { many_short<plain_pool_vector>(lengths); }));
+    report("200K short vectors, pool at_least", std_short, best_ms([&] { many_short<pool_vector>(lengths); }));
+
+    const size_t n = size_t(64) << 20;
+    typedef mabustl::vector<int, plain_allocator<int, mabustl::mmap_alloc> > plain_mmap_vector;
+    typedef mabustl::vector<int, mabustl::allocator<int, mabustl::mmap_alloc> > mmap_vector;
+    const double std_long = best_ms([n] { one_long<std::vector<int> >(n); });
+    report("push_back 64M ints, mmap plain", std_long, best_ms([n] { one_long<plain_mmap_vector>(n); }));
+    report("push_back 64M ints, mmap expand", std_long, best_ms([n] { one_long<mmap_vector>(n); }));
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * hash_bytes 与 std::hash<std::string> 的比较
+ * (1)吞吐量：对 8 B 到 64 KiB 的输入反复求哈希
+ * (2)雪崩质量：翻转每个输入位时，每个输出位翻转概率与 0.5 的偏差(0 为理想，1 为完全不变或完全相关)
+ * (3)整数 key：步长为 2 的幂的 key 按哈希值的低位放进 2 的幂个桶，恒等哈希与 mixed_hash 占用的桶数和最长的桶
+ */
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "bench_common.h"
+#include "mabu_functional.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    struct std_string_hash {
+        size_t operator()(const std::string& s) const { return std::hash<std::string>()(s); }
+    };
+
+    struct mabu_string_hash {
+        size_t operator()(const std::string& s) const { return mabustl::hash_bytes(s.data(), s.size()); }
+    };
+
+    template<class Hash>
+    void hash_loop(const std::string& input, size_t times) {
+        Hash h;
+        size_t sum = 0;
+        for(size_t i = 0; i != times; ++i) {
+            sum += h(input);
+            do_not_optimize(input);
+        }
+        do_not_optimize(sum);
+    }
+
+    // 通过 worst / mean 返回所有(输入位, 输出位)组合中的最大偏差和平均偏差
+    template<class Hash>
+    void avalanche(size_t len, double& worst, double& mean) {
+        const int samples = 1000;
+        std::vector<long long> flipped(len * 8 * 64);
+        std::mt19937_64 rng(20261017);
+        Hash h;
+        std::string input(len, '\0');
+        for(int s = 0; s != samples; ++s) {
+            for(size_t i = 0; i != len; ++i) input[i] = static_cast<char>(rng());
+            const size_t base = h(input);
+            for(size_t bit = 0; bit != len * 8; ++bit) {
+                input[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+                const size_t diff = base ^ h(input);
+                input[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+                for(size_t out = 0; out != 64; ++out) flipped[bit * 64 + out] += (diff >> out) & 1;
+            }
+        }
+        worst = 0;
+        mean = 0;
+        for(size_t i = 0; i != flipped.size(); ++i) {
+            const double bias = std::fabs(2.0 * static_cast<double>(flipped[i]) / samples - 1.0);
+            if(bias > worst) worst = bias;
+            mean += bias;
+        }
+        mean /= static_cast<double>(flipped.size());
+    }
+
+    template<class Hash>
+    void bucket_load(size_t bucket_bits, size_t& used, size_t& longest) {
+        std::vector<size_t> buckets(size_t(1) << bucket_bits);
+        Hash h;
+        for(unsigned long long i = 0; i != buckets.size(); ++i) ++buckets[h(i << 12) & (buckets.size() - 1)];
+        used = 0;
+        longest = 0;
+        for(size_t i = 0; i != buckets.size(); ++i) {
+            if(buckets[i] != 0) ++used;
+            if(buckets[i] > longest) longest = buckets[i];
+        }
+    }
+}
+
+int main() {
+    const size_t lengths[] = {8, 16, 64, 1024, 65536};
+    for(size_t l = 0; l != sizeof(lengths) / sizeof(lengths[0]); ++l) {
+        const std::string input(lengths[l], 'x');
+        const size_t times = (size_t(64) << 20) / lengths[l];
+        char name[64];
+        std::snprintf(name, sizeof(name), "hash %zu B x %zu", lengths[l], times);
+        report(name, best_ms([&] { hash_loop<std_string_hash>(input, times); }),
+               best_ms([&] { hash_loop<mabu_string_hash>(input, times); }));
+    }
+
+    const size_t avalanche_lengths[] = {4, 8, 16, 64};
+    for(size_t l = 0; l != sizeof(avalanche_lengths) / sizeof(avalanche_lengths[0]); ++l) {
+        double std_worst, std_mean, mabu_worst, mabu_mean;
+        avalanche<std_string_hash>(avalanche_lengths[l], std_worst, std_mean);
+        avalanche<mabu_string_hash>(avalanche_lengths[l], mabu_worst, mabu_mean);
+        std::printf("avalanche %2zu B: std worst %.3f mean %.3f   mabustl worst %.3f mean %.3f\n",
+                    avalanche_lengths[l], std_worst, std_mean, mabu_worst, mabu_mean);
+    }
+
+    size_t identity_used, identity_longest, mixed_used, mixed_longest;
+    bucket_load<mabustl::hash<unsigned long long> >(20, identity_used, identity_longest);
+    bucket_load<mabustl::mixed_hash<unsigned long long> >(20, mixed_used, mixed_longest);
+    std::printf("2^20 keys i << 12 in 2^20 buckets: identity used %zu longest %zu   mixed_hash used %zu longest %zu\n",
+                identity_used, identity_longest, mixed_used, mixed_longest);
+    return 0;
+}
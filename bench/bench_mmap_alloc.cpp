@@ -0,0 +1,77 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * mmap_alloc / huge_page_alloc 与默认后端(default_alloc，未定义宏时为 operator new)在大数组上的比较，
+ * 数组为 512 MB 的 64 位整数，输出中 std 一栏是默认后端：
+ * (1)分配并顺序写满一遍再回收，包括缺页中断的开销；预先缺页(Prefault)的版本把缺页放在 allocate 里
+ * (2)已经写满的数组上做 16M 次随机读，4K 页时几乎每次访问都会 TLB 缺失，透明大页可以减少缺失
+ * 透明大页是否生效取决于 /sys/kernel/mm/transparent_hugepage/enabled，为 never 时与 mmap_alloc 相同
+ */
+
+#include <cstdint>
+
+#include "bench_common.h"
+#include "mabu_allocator.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    typedef std::uint64_t word;
+
+    const size_t words = (size_t(512) << 20) / sizeof(word);
+    const size_t reads = size_t(16) << 20;
+
+    typedef mabustl::allocator<word> default_allocator;
+    typedef mabustl::allocator<word, mabustl::mmap_alloc> mmap_allocator;
+    typedef mabustl::huge_page_allocator<word> huge_page_allocator;
+    typedef mabustl::allocator<word, mabustl::basic_mmap_alloc<true, true> > prefault_allocator;
+
+    template<class Alloc>
+    void allocate_and_fill() {
+        word* data = Alloc::allocate(words);
+        for(size_t i = 0; i != words; ++i) data[i] = i;
+        do_not_optimize(data[words - 1]);
+        Alloc::deallocate(data, words);
+    }
+
+    // 下标由 xorshift 生成，读取之间没有依赖，主要受 TLB 和缓存缺失的限制
+    void random_reads(const word* data) {
+        std::uint64_t x = 88172645463325252ULL;
+        word sum = 0;
+        for(size_t i = 0; i != reads; ++i) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            sum += data[x % words];
+        }
+        do_not_optimize(sum);
+    }
+
+    template<class Alloc>
+    double random_reads_ms() {
+        word* data = Alloc::allocate(words);
+        for(size_t i = 0; i != words; ++i) data[i] = i;
+        const double ms = best_ms([data] { random_reads(data); });
+        Alloc::deallocate(data, words);
+        return ms;
+    }
+}
+
+int main() {
+    const double default_fill = best_ms([] { allocate_and_fill<default_allocator>(); });
+    report("allocate + fill 512 MB, mmap", default_fill, best_ms([] { allocate_and_fill<mmap_allocator>(); }));
+    report("allocate + fill 512 MB, huge page", default_fill,
+           best_ms([] { allocate_and_fill<huge_page_allocator>(); }));
+    report("allocate + fill 512 MB, prefault", default_fill,
+           best_ms([] { allocate_and_fill<prefault_allocator>(); }));
+
+    const double default_reads = random_reads_ms<default_allocator>();
+    report("16M random reads, mmap", default_reads, random_reads_ms<mmap_allocator>());
+    report("16M random reads, huge page", default_reads, random_reads_ms<huge_page_allocator>());
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * mpmc_queue 与 std::mutex + std::condition_variable + std::deque 的比较，容量都是 1024：
+ * k 个生产者和 k 个消费者用阻塞的 push / pop 一共传递 n 个 64 位整数，k 从 1 倍增到核数(至少到 4)，
+ * 输出毫秒数和每秒操作数；线程依次轮流绑定到各个核上，只有一个核时只能看出时间片轮转下的开销
+ */
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench_common.h"
+#include "mabu_mpmc_queue.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    typedef unsigned long long item;
+
+    const size_t queue_capacity = 1024;
+
+    void pin_to(unsigned cpu) {
+        const unsigned cores = std::thread::hardware_concurrency();
+        if(cores < 2) return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu % cores, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    class locked_queue {
+    public:
+        void push(item value) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_full_.wait(lock, [this] { return queue_.size() < queue_capacity; });
+            queue_.push_back(value);
+            not_empty_.notify_one();
+        }
+
+        void pop(item& value) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_empty_.wait(lock, [this] { return !queue_.empty(); });
+            value = queue_.front();
+            queue_.pop_front();
+            not_full_.notify_one();
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable not_full_;
+        std::condition_variable not_empty_;
+        std::deque<item> queue_;
+    };
+
+    // n 个元素平均分给 k 个生产者和 k 个消费者
+    template<class Queue>
+    void transfer(Queue& q, size_t k, size_t n) {
+        const size_t share = n / k;
+        std::vector<item> sums(k);
+        std::vector<std::thread> threads;
+        for(size_t t = 0; t != k; ++t) {
+            threads.emplace_back([&q, t, share] {
+                pin_to(static_cast<unsigned>(2 * t));
+                for(size_t i = 0; i != share; ++i) q.push(i);
+            });
+            threads.emplace_back([&q, &sums, t, share] {
+                pin_to(static_cast<unsigned>(2 * t + 1));
+                item sum = 0;
+                for(size_t i = 0; i != share; ++i) {
+                    item value;
+                    q.pop(value);
+                    sum += value;
+                }
+                sums[t] = sum;
+            });
+        }
+        for(size_t t = 0; t != threads.size(); ++t) threads[t].join();
+        do_not_optimize(sums[0]);
+    }
+
+    void report_ops(const char* name, size_t n, double ms) {
+        std::printf("%-36s %10.3f Mops/s\n", name, n / ms / 1000.0);
+    }
+}
+
+int main() {
+    const unsigned cores = std::thread::hardware_concurrency();
+    std::printf("cores: %u\n", cores);
+
+    const size_t n = size_t(1) << 21;
+    const size_t max_k = cores / 2 > 4 ? cores / 2 : 4;
+    for(size_t k = 1; k <= max_k; k *= 2) {
+        locked_queue lq;
+        mabustl::mpmc_queue<item> mq(queue_capacity);
+        const double std_ms = best_ms([&] { transfer(lq, k, n); });
+        const double mabu_ms = best_ms([&] { transfer(mq, k, n); });
+        char name[64];
+        std::snprintf(name, sizeof(name), "%zu producers + %zu consumers", k, k);
+        report(name, std_ms, mabu_ms);
+        report_ops("  mutex + condvar + std::deque", n, std_ms);
+        report_ops("  mpmc_queue", n, mabu_ms);
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * pool_alloc 与 operator new 的比较
+ * (1)反复分配、回收一批同样大小的小块
+ * (2)std::list<int> 反复 push_back 再 clear，节点通过 allocator 分配
+ */
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "bench_common.h"
+#include "mabu_allocator.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    struct node40 {
+        char data[40];
+    };
+
+    template<class Alloc>
+    void churn(std::vector<node40*>& blocks) {
+        Alloc alloc;
+        for(int round = 0; round != 2000; ++round) {
+            for(size_t i = 0; i != blocks.size(); ++i) blocks[i] = alloc.allocate(1);
+            for(size_t i = 0; i != blocks.size(); ++i) alloc.deallocate(blocks[i], 1);
+        }
+        do_not_optimize(blocks.front());
+    }
+
+    template<class Alloc>
+    void list_churn() {
+        std::list<int, Alloc> list;
+        for(int round = 0; round != 200; ++round) {
+            for(int i = 0; i != 10000; ++i) list.push_back(i);
+            do_not_optimize(list.back());
+            list.clear();
+        }
+    }
+}
+
+int main() {
+    std::vector<node40*> blocks(1000);
+    report("allocate/deallocate 40 bytes x2M", best_ms([&] { churn<std::allocator<node40> >(blocks); }),
+           best_ms([&] { churn<mabustl::pool_allocator<node40> >(blocks); }));
+    report("std::list push_back/clear x2M", best_ms([] { list_churn<std::allocator<int> >(); }),
+           best_ms([] { list_churn<mabustl::pool_allocator<int> >(); }));
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * radix_heap 与 std::priority_queue(二叉小根堆)的比较，模拟定时器流量：
+ * 堆中常驻 n 个定时器(64 位时间戳 + 32 位编号)，反复取出最早到期的一个，把当前时间推进到它的到期时间，
+ * 再以 当前时间 + 随机延迟 重新放回；延迟分别取 [0, 1ms) 和 [0, 10s) 的纳秒数
+ */
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "bench_common.h"
+#include "mabu_radix_heap.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    typedef std::pair<unsigned long long, unsigned> std_timer;
+    typedef std::priority_queue<std_timer, std::vector<std_timer>, std::greater<std_timer> > std_heap;
+    typedef mabustl::radix_heap<unsigned long long, unsigned> mabu_heap;
+
+    std::vector<unsigned long long> make_delays(size_t n, unsigned long long range) {
+        std::mt19937_64 rng(20261017);
+        std::vector<unsigned long long> delays(n);
+        for(size_t i = 0; i != n; ++i) delays[i] = rng() % range;
+        return delays;
+    }
+
+    void fill(std_heap& heap, const std::vector<unsigned long long>& delays, size_t n) {
+        heap = std_heap();
+        for(size_t i = 0; i != n; ++i) heap.push(std_timer(delays[i], static_cast<unsigned>(i)));
+    }
+
+    void fill(mabu_heap& heap, const std::vector<unsigned long long>& delays, size_t n) {
+        heap.clear();
+        for(size_t i = 0; i != n; ++i) heap.push(mabustl::make_pair(delays[i], static_cast<unsigned>(i)));
+    }
+
+    void run(std_heap& heap, const std::vector<unsigned long long>& delays) {
+        for(size_t i = 0; i != delays.size(); ++i) {
+            std_timer t = heap.top();
+            heap.pop();
+            t.first += delays[i];
+            heap.push(t);
+        }
+        do_not_optimize(heap.top());
+    }
+
+    void run(mabu_heap& heap, const std::vector<unsigned long long>& delays) {
+        for(size_t i = 0; i != delays.size(); ++i) {
+            mabustl::pair<unsigned long long, unsigned> t = heap.top();
+            heap.pop();
+            t.first += delays[i];
+            heap.push(t);
+        }
+        do_not_optimize(heap.top());
+    }
+}
+
+int main() {
+    const unsigned long long ranges[] = {1000000ULL, 10000000000ULL};
+    const char* range_names[] = {"1ms", "10s"};
+    const size_t sizes[] = {size_t(1) << 10, size_t(1) << 16, size_t(1) << 20};
+    for(size_t r = 0; r != 2; ++r) {
+        const std::vector<unsigned long long> delays = make_delays(size_t(1) << 21, ranges[r]);
+        for(size_t s = 0; s != sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            const size_t n = sizes[s];
+            std_heap sh;
+            mabu_heap mh;
+            char name[64];
+            std::snprintf(name, sizeof(name), "timers n=%zu delay<%s", n, range_names[r]);
+            report(name, best_ms([&] { fill(sh, delays, n); }, [&] { run(sh, delays); }),
+                   best_ms([&] { fill(mh, delays, n); }, [&] { run(mh, delays); }));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * radix_sort 与 std::sort 在 64 位整数上的比较，目标是 100M 个随机 key 的批量排序，每次计时前复制同一份输入：
+ * (1)随机的 64 位 key，100M 个需要约 800 MB 输入、800 MB 待排序数组和 800 MB 缓冲区
+ * (2)只有低 32 位非 0 的 key，高位的各趟被跳过
+ * 缓冲区由调用者用 mabustl::allocator 提前分配，不计入时间；mabustl::sort 的结果一并输出作为比较排序的参照
+ * 元素个数可以由第一个参数指定，默认 100M，内存不够时可以改小
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "bench_common.h"
+#include "mabu_allocator.h"
+#include "mabu_radix_sort.h"
+#include "mabu_sort_algorithm.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    typedef std::uint64_t key_type;
+
+    void run(const char* pattern, const std::vector<key_type>& input, key_type* buffer) {
+        std::vector<key_type> v;
+        const double std_ms = best_ms([&] { v = input; }, [&] {
+            std::sort(v.begin(), v.end());
+            do_not_optimize(v[0]);
+        });
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "%s n=%zu, radix_sort", pattern, input.size());
+        report(name, std_ms, best_ms([&] { v = input; }, [&] {
+            mabustl::radix_sort(v.data(), v.data() + v.size(), mabustl::identity<key_type>(), buffer);
+            do_not_optimize(v[0]);
+        }));
+        std::snprintf(name, sizeof(name), "%s n=%zu, sort", pattern, input.size());
+        report(name, std_ms, best_ms([&] { v = input; }, [&] {
+            mabustl::sort(v.data(), v.data() + v.size());
+            do_not_optimize(v[0]);
+        }));
+    }
+}
+
+int main(int argc, char** argv) {
+    const size_t n = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : size_t(100000000);
+    key_type* buffer = mabustl::allocator<key_type>::allocate(n);
+
+    std::vector<key_type> input(n);
+    std::mt19937_64 rng(20261017);
+    for(size_t i = 0; i != n; ++i) input[i] = rng();
+    run("random 64-bit", input, buffer);
+
+    for(size_t i = 0; i != n; ++i) input[i] = rng() >> 32;
+    run("random 32-bit", input, buffer);
+
+    mabustl::allocator<key_type>::deallocate(buffer, n);
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * small_vector 与 std::vector 在大量短序列上的比较，每个序列 push_back 1 到 16 个 int：
+ * (1)分配次数：两者使用同一个计数的 allocator，small_vector 在元素不超过 N 时不应该分配
+ * (2)耗时：N 为 8 时一部分序列会溢出到堆上，N 为 16 时全部放在内联缓冲区
+ * 序列在循环内创建和销毁，模拟函数里的临时容器
+ */
+
+#include <vector>
+
+#include "bench_common.h"
+#include "mabu_allocator.h"
+#include "mabu_small_vector.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    size_t allocations = 0;
+
+    // small_vector 要求 allocator 用 placement new 构造元素，所以从 mabustl::allocator 派生，只在分配时计数
+    template<class T>
+    class counting_allocator : public mabustl::allocator<T> {
+    public:
+        typedef mabustl::allocator<T> base_type;
+        typedef typename base_type::size_type size_type;
+
+        template<class U>
+        struct rebind {
+            typedef counting_allocator<U> other;
+        };
+
+        counting_allocator() noexcept {}
+
+        template<class U>
+        counting_allocator(const counting_allocator<U>&) noexcept {}
+
+        static T* allocate(size_type n) {
+            ++allocations;
+            return base_type::allocate(n);
+        }
+
+        static mabustl::allocation_result<T*, size_type> allocate_at_least(size_type n) {
+            ++allocations;
+            return base_type::allocate_at_least(n);
+        }
+    };
+
+    template<class Vector>
+    void short_sequences(const std::vector<int>& lengths) {
+        int sum = 0;
+        for(size_t i = 0; i != lengths.size(); ++i) {
+            Vector v;
+            for(int j = 0; j != lengths[i]; ++j) v.push_back(j);
+            sum += v.back();
+            do_not_optimize(v[0]);
+        }
+        do_not_optimize(sum);
+    }
+
+    template<class Vector>
+    size_t count_allocations(const std::vector<int>& lengths) {
+        allocations = 0;
+        short_sequences<Vector>(lengths);
+        return allocations;
+    }
+}
+
+int main() {
+    std::vector<int> lengths(1000000);
+    std::mt19937 rng(20261017);
+    for(size_t i = 0; i != lengths.size(); ++i) lengths[i] = 1 + static_cast<int>(rng() % 16);
+
+    typedef std::vector<int, counting_allocator<int> > std_vector;
+    typedef mabustl::small_vector<int, 8, counting_allocator<int> > small_vector8;
+    typedef mabustl::small_vector<int, 16, counting_allocator<int> > small_vector16;
+
+    std::printf("allocations for 1M sequences: std %zu, small_vector<8> %zu, small_vector<16> %zu\n",
+                count_allocations<std_vector>(lengths), count_allocations<small_vector8>(lengths),
+                count_allocations<small_vector16>(lengths));
+
+    const double std_ms = best_ms([&] { short_sequences<std_vector>(lengths); });
+    report("1M short sequences, N = 8", std_ms, best_ms([&] { short_sequences<small_vector8>(lengths); }));
+    report("1M short sequences, N = 16", std_ms, best_ms([&] { short_sequences<small_vector16>(lengths); }));
+    return 0;
+}
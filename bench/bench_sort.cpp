@@ -0,0 +1,92 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * mabustl::sort 与 std::sort 的比较，每次计时前把同一份输入复制到待排序的数组中：
+ * (1)1M 个 64 位整数和 double：随机、有序、逆序、少量不同值(16 种)、山峰，算术类型走无分支划分
+ * (2)200K 个随机字符串，走普通划分
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "bench_common.h"
+#include "mabu_sort_algorithm.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    enum pattern {
+        RANDOM,
+        SORTED,
+        REVERSED,
+        FEW_UNIQUE,
+        ORGAN_PIPE,
+        PATTERN_COUNT
+    };
+
+    const char* pattern_names[] = {"random", "sorted", "reversed", "few unique", "organ pipe"};
+
+    template<class T>
+    std::vector<T> make_input(pattern p, size_t n) {
+        std::mt19937_64 rng(20261017);
+        std::vector<T> v(n);
+        for(size_t i = 0; i != n; ++i) {
+            switch(p) {
+                case RANDOM: v[i] = static_cast<T>(rng() >> 1); break;
+                case SORTED: v[i] = static_cast<T>(i); break;
+                case REVERSED: v[i] = static_cast<T>(n - i); break;
+                case FEW_UNIQUE: v[i] = static_cast<T>(rng() % 16); break;
+                default: v[i] = static_cast<T>(i < n / 2 ? i : n - i); break;
+            }
+        }
+        return v;
+    }
+
+    template<class T>
+    void run(const char* type_name, size_t n) {
+        for(int p = 0; p != PATTERN_COUNT; ++p) {
+            const std::vector<T> input = make_input<T>(static_cast<pattern>(p), n);
+            std::vector<T> v;
+            char name[64];
+            std::snprintf(name, sizeof(name), "%s %s n=%zu", type_name, pattern_names[p], n);
+            report(name, best_ms([&] { v = input; }, [&] {
+                       std::sort(v.begin(), v.end());
+                       do_not_optimize(v[0]);
+                   }),
+                   best_ms([&] { v = input; }, [&] {
+                       mabustl::sort(v.data(), v.data() + v.size());
+                       do_not_optimize(v[0]);
+                   }));
+        }
+    }
+
+    void run_strings(size_t n) {
+        std::mt19937_64 rng(20261017);
+        std::vector<std::string> input(n);
+        for(size_t i = 0; i != n; ++i) input[i] = "key" + std::to_string(rng());
+        std::vector<std::string> v;
+        char name[64];
+        std::snprintf(name, sizeof(name), "string random n=%zu", n);
+        report(name, best_ms([&] { v = input; }, [&] {
+                   std::sort(v.begin(), v.end());
+                   do_not_optimize(v[0]);
+               }),
+               best_ms([&] { v = input; }, [&] {
+                   mabustl::sort(v.data(), v.data() + v.size());
+                   do_not_optimize(v[0]);
+               }));
+    }
+}
+
+int main() {
+    run<unsigned long long>("uint64", size_t(1) << 20);
+    run<double>("double", size_t(1) << 20);
+    run_strings(200000);
+    return 0;
+}
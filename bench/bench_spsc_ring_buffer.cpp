@@ -0,0 +1,189 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * spsc_ring_buffer 与 std::mutex + std::queue 的比较，一个生产者线程和一个消费者线程：
+ * (1)吞吐：传递 n 个 64 位整数，分别逐个 push / pop 和按 64 个一批 push_n / pop_n，输出毫秒数和每秒操作数
+ * (2)尾延迟：两个队列组成往返，主线程记录每次往返的时间，输出 p50 / p99 / p99.9 的纳秒数
+ * 机器至少有两个核时把两个线程分别绑定到 0 号和 1 号核上，只有一个核时没有进展就让出
+ */
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "bench_common.h"
+#include "mabu_spsc_ring_buffer.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    typedef unsigned long long item;
+
+    const size_t queue_capacity = 1024;
+    const size_t batch = 64;
+
+    bool pinned() {
+        return std::thread::hardware_concurrency() >= 2;
+    }
+
+    void pin_to(unsigned cpu) {
+        if(!pinned()) return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    void backoff() {
+        if(!pinned()) std::this_thread::yield();
+    }
+
+    // 容量与 spsc_ring_buffer 相同的加锁队列
+    class locked_queue {
+    public:
+        bool push(item value) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(queue_.size() == queue_capacity) return false;
+            queue_.push(value);
+            return true;
+        }
+
+        bool pop(item& value) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(queue_.empty()) return false;
+            value = queue_.front();
+            queue_.pop();
+            return true;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::queue<item> queue_;
+    };
+
+    typedef mabustl::spsc_ring_buffer<item> ring;
+
+    template<class Queue>
+    void transfer_single(Queue& q, size_t n) {
+        std::thread producer([&q, n] {
+            pin_to(1);
+            for(item i = 0; i != n;) {
+                if(q.push(i)) ++i;
+                else backoff();
+            }
+        });
+        item sum = 0;
+        for(size_t received = 0; received != n;) {
+            item value;
+            if(q.pop(value)) {
+                sum += value;
+                ++received;
+            } else {
+                backoff();
+            }
+        }
+        producer.join();
+        do_not_optimize(sum);
+    }
+
+    void transfer_batch(ring& q, size_t n) {
+        std::thread producer([&q, n] {
+            pin_to(1);
+            item values[batch];
+            for(size_t sent = 0; sent != n;) {
+                const size_t k = std::min(batch, n - sent);
+                for(size_t i = 0; i != k; ++i) values[i] = sent + i;
+                const size_t pushed = q.push_n(values, k);
+                if(pushed == 0) backoff();
+                sent += pushed;
+            }
+        });
+        item values[batch];
+        item sum = 0;
+        for(size_t received = 0; received != n;) {
+            const size_t popped = q.pop_n(values, batch);
+            if(popped == 0) backoff();
+            for(size_t i = 0; i != popped; ++i) sum += values[i];
+            received += popped;
+        }
+        producer.join();
+        do_not_optimize(sum);
+    }
+
+    // 主线程经 request 发出编号，回声线程经 reply 原样送回，返回每次往返的纳秒数
+    template<class Queue>
+    std::vector<double> round_trips(size_t n) {
+        Queue request;
+        Queue reply;
+        std::thread echo([&request, &reply, n] {
+            pin_to(1);
+            for(size_t i = 0; i != n; ++i) {
+                item value;
+                while(!request.pop(value)) backoff();
+                while(!reply.push(value)) backoff();
+            }
+        });
+        std::vector<double> ns(n);
+        for(size_t i = 0; i != n; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            while(!request.push(i)) backoff();
+            item value;
+            while(!reply.pop(value)) backoff();
+            const auto stop = std::chrono::steady_clock::now();
+            ns[i] = std::chrono::duration<double, std::nano>(stop - start).count();
+        }
+        echo.join();
+        std::sort(ns.begin(), ns.end());
+        return ns;
+    }
+
+    // ring 不能默认构造，包一层固定容量
+    struct fixed_ring : ring {
+        fixed_ring(): ring(queue_capacity) {}
+    };
+
+    double percentile(const std::vector<double>& sorted, double p) {
+        return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+    }
+
+    void report_latency(const char* name, const std::vector<double>& ns) {
+        std::printf("%-36s p50 %8.0f ns   p99 %8.0f ns   p99.9 %8.0f ns\n", name, percentile(ns, 0.5),
+                    percentile(ns, 0.99), percentile(ns, 0.999));
+    }
+
+    void report_ops(const char* name, size_t n, double ms) {
+        std::printf("%-36s %10.3f Mops/s\n", name, n / ms / 1000.0);
+    }
+}
+
+int main() {
+    pin_to(0);
+    std::printf("threads pinned: %s\n", pinned() ? "yes" : "no (single core)");
+
+    const size_t n = size_t(1) << 22;
+    locked_queue lq;
+    ring rq(queue_capacity);
+    const double std_ms = best_ms([&] { transfer_single(lq, n); });
+    const double single_ms = best_ms([&] { transfer_single(rq, n); });
+    const double batch_ms = best_ms([&] { transfer_batch(rq, n); });
+    report("transfer push/pop", std_ms, single_ms);
+    report("transfer push_n/pop_n batch=64", std_ms, batch_ms);
+    report_ops("  mutex + std::queue", n, std_ms);
+    report_ops("  spsc_ring_buffer push/pop", n, single_ms);
+    report_ops("  spsc_ring_buffer push_n/pop_n", n, batch_ms);
+
+    const size_t trips = size_t(1) << 16;
+    report_latency("round trip mutex + std::queue", round_trips<locked_queue>(trips));
+    report_latency("round trip spsc_ring_buffer", round_trips<fixed_ring>(trips));
+    return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * thread_cache_alloc 在多线程争用下与 std::allocator(operator new) 和 pool_alloc(一把全局锁)的比较，
+ * k 个线程从 1 倍增到核数(至少到 4)：
+ * (1)本线程分配、本线程回收：每个线程反复分配一批 16 到 256 字节的小块再全部回收
+ * (2)跨线程回收：每一轮每个线程先分配一批块，所有线程到齐后各自回收下一个线程分配的那一批
+ * 输出 std 与 thread_cache_alloc 的毫秒数，以及 pool_alloc 的毫秒数作为只加锁时的参照
+ */
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "bench_common.h"
+#include "mabu_allocator.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    const size_t batch = 256;
+    const size_t rounds = 2000;
+
+    // 16 到 256 字节，覆盖 pool_alloc 的多个大小等级
+    template<size_t N>
+    struct block {
+        char data[N];
+    };
+
+    // 所有线程到齐后一起继续，可以重复使用
+    class spin_barrier {
+    public:
+        explicit spin_barrier(size_t n): n_(n), waiting_(0), phase_(0) {}
+
+        void wait() {
+            const size_t phase = phase_.load(std::memory_order_acquire);
+            if(waiting_.fetch_add(1, std::memory_order_acq_rel) + 1 == n_) {
+                waiting_.store(0, std::memory_order_relaxed);
+                phase_.store(phase + 1, std::memory_order_release);
+                return;
+            }
+            while(phase_.load(std::memory_order_acquire) == phase) std::this_thread::yield();
+        }
+
+    private:
+        const size_t n_;
+        std::atomic<size_t> waiting_;
+        std::atomic<size_t> phase_;
+    };
+
+    // 每个块的大小由下标决定，分配和回收用同一个 Alloc 的不同 rebind
+    template<template<class> class Alloc>
+    struct mixed_sizes {
+        typedef Alloc<block<16> > alloc16;
+        typedef Alloc<block<64> > alloc64;
+        typedef Alloc<block<256> > alloc256;
+
+        static void* allocate(size_t i) {
+            switch(i % 3) {
+            case 0: return alloc16().allocate(1);
+            case 1: return alloc64().allocate(1);
+            default: return alloc256().allocate(1);
+            }
+        }
+
+        static void deallocate(void* ptr, size_t i) {
+            switch(i % 3) {
+            case 0: alloc16().deallocate(static_cast<block<16>*>(ptr), 1); break;
+            case 1: alloc64().deallocate(static_cast<block<64>*>(ptr), 1); break;
+            default: alloc256().deallocate(static_cast<block<256>*>(ptr), 1); break;
+            }
+        }
+    };
+
+    template<class T>
+    using std_allocator = std::allocator<T>;
+
+    template<class T>
+    using pool_allocator = mabustl::pool_allocator<T>;
+
+    template<class T>
+    using thread_cache_allocator = mabustl::thread_cache_allocator<T>;
+
+    template<template<class> class Alloc>
+    void local_churn(size_t k) {
+        typedef mixed_sizes<Alloc> sizes;
+        std::vector<std::thread> threads;
+        for(size_t t = 0; t != k; ++t) {
+            threads.emplace_back([] {
+                std::vector<void*> blocks(batch);
+                for(size_t round = 0; round != rounds; ++round) {
+                    for(size_t i = 0; i != batch; ++i) blocks[i] = sizes::allocate(i);
+                    do_not_optimize(blocks[round % batch]);
+                    for(size_t i = 0; i != batch; ++i) sizes::deallocate(blocks[i], i);
+                }
+            });
+        }
+        for(size_t t = 0; t != threads.size(); ++t) threads[t].join();
+    }
+
+    template<template<class> class Alloc>
+    void cross_thread_churn(size_t k) {
+        typedef mixed_sizes<Alloc> sizes;
+        std::vector<std::vector<void*> > slots(k, std::vector<void*>(batch));
+        spin_barrier barrier(k);
+        std::vector<std::thread> threads;
+        for(size_t t = 0; t != k; ++t) {
+            threads.emplace_back([&slots, &barrier, t, k] {
+                std::vector<void*>& mine = slots[t];
+                std::vector<void*>& next = slots[(t + 1) % k];
+                // 跨线程的一轮需要两次同步，轮数减少到四分之一，总分配次数仍然随 k 线性增长
+                for(size_t round = 0; round != rounds / 4; ++round) {
+                    for(size_t i = 0; i != batch; ++i) mine[i] = sizes::allocate(i);
+                    barrier.wait();
+                    for(size_t i = 0; i != batch; ++i) sizes::deallocate(next[i], i);
+                    barrier.wait();
+                }
+            });
+        }
+        for(size_t t = 0; t != threads.size(); ++t) threads[t].join();
+    }
+
+    void report_pool(double ms) {
+        std::printf("%-36s     %10.3f ms\n", "  pool_alloc (one global lock)", ms);
+    }
+}
+
+int main() {
+    const unsigned cores = std::thread::hardware_concurrency();
+    std::printf("cores: %u\n", cores);
+
+    const size_t max_k = cores > 4 ? cores : 4;
+    for(size_t k = 1; k <= max_k; k *= 2) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "%zu threads, local free", k);
+        report(name, best_ms([k] { local_churn<std_allocator>(k); }),
+               best_ms([k] { local_churn<thread_cache_allocator>(k); }));
+        report_pool(best_ms([k] { local_churn<pool_allocator>(k); }));
+
+        std::snprintf(name, sizeof(name), "%zu threads, cross-thread free", k);
+        report(name, best_ms([k] { cross_thread_churn<std_allocator>(k); }),
+               best_ms([k] { cross_thread_churn<thread_cache_allocator>(k); }));
+        report_pool(best_ms([k] { cross_thread_churn<pool_allocator>(k); }));
+    }
+    return 0;
+}
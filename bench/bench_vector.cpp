@@ -0,0 +1,95 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * vector 与 std::vector 的比较，元素为 int(memmove 搬移)和 std::string(移动构造搬移)：
+ * (1)不预先 reserve，push_back 到 1M 个元素，包括所有扩容
+ * (2)reserve 之后 push_back 同样多的元素，只剩构造本身的开销
+ * (3)在中间位置逐个 insert，每次都要把后半部分后移一位
+ * (4)emplace_back 直接构造 std::string，不产生临时对象
+ */
+
+#include <string>
+#include <vector>
+
+#include "bench_common.h"
+#include "mabu_vector.h"
+
+using mabustl_bench::best_ms;
+using mabustl_bench::do_not_optimize;
+using mabustl_bench::report;
+
+namespace {
+    template<class T>
+    T make(size_t i);
+
+    template<>
+    int make<int>(size_t i) {
+        return static_cast<int>(i);
+    }
+
+    // 超过短字符串优化的长度，移动时只交换指针
+    template<>
+    std::string make<std::string>(size_t i) {
+        return std::string(24, static_cast<char>('a' + i % 26));
+    }
+
+    template<class Vector>
+    void push_back_growth(const std::vector<typename Vector::value_type>& values) {
+        Vector v;
+        for(size_t i = 0; i != values.size(); ++i) v.push_back(values[i]);
+        do_not_optimize(v.back());
+    }
+
+    template<class Vector>
+    void push_back_reserved(const std::vector<typename Vector::value_type>& values) {
+        Vector v;
+        v.reserve(values.size());
+        for(size_t i = 0; i != values.size(); ++i) v.push_back(values[i]);
+        do_not_optimize(v.back());
+    }
+
+    template<class Vector>
+    void insert_middle(const std::vector<typename Vector::value_type>& values) {
+        Vector v;
+        for(size_t i = 0; i != values.size(); ++i) v.insert(v.begin() + v.size() / 2, values[i]);
+        do_not_optimize(v.back());
+    }
+
+    template<class Vector>
+    void emplace_strings(size_t n) {
+        Vector v;
+        for(size_t i = 0; i != n; ++i) v.emplace_back(24, static_cast<char>('a' + i % 26));
+        do_not_optimize(v.back());
+    }
+
+    template<class T>
+    void run(const char* type_name) {
+        typedef std::vector<T> std_vector;
+        typedef mabustl::vector<T> mabu_vector;
+        std::vector<T> values(1 << 20);
+        for(size_t i = 0; i != values.size(); ++i) values[i] = make<T>(i);
+        const std::vector<T> middle(values.begin(), values.begin() + (1 << 14));
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "push_back 1M %s", type_name);
+        report(name, best_ms([&] { push_back_growth<std_vector>(values); }),
+               best_ms([&] { push_back_growth<mabu_vector>(values); }));
+        std::snprintf(name, sizeof(name), "reserve + push_back 1M %s", type_name);
+        report(name, best_ms([&] { push_back_reserved<std_vector>(values); }),
+               best_ms([&] { push_back_reserved<mabu_vector>(values); }));
+        std::snprintf(name, sizeof(name), "insert middle 16K %s", type_name);
+        report(name, best_ms([&] { insert_middle<std_vector>(middle); }),
+               best_ms([&] { insert_middle<mabu_vector>(middle); }));
+    }
+}
+
+int main() {
+    run<int>("int");
+    run<std::string>("string");
+    report("emplace_back 1M string", best_ms([] { emplace_strings<std::vector<std::string> >(1 << 20); }),
+           best_ms([] { emplace_strings<mabustl::vector<std::string> >(1 << 20); }));
+    return 0;
+}
@@ -13,6 +13,7 @@
 * move move_backward
 * equal
 * fill_n fill
+* 以上 copy copy_backward move move_backward fill 对分段迭代器(如 deque 的迭代器)逐段处理
 * lexicographical_compare
 * mimatch
 */
@@ -62,6 +63,19 @@ namespace mabustl {
         mabustl::swap(*iter1, *iter2);
     }
 
+    /*
+     * *****************************************************************************************************************
+     * 分段迭代器
+     * 输入区间由分段迭代器给出时，按段取出底层的 [begin, end) 交给下面的实现；
+     * 输出位置是分段迭代器、输入可以随机访问时，每次只写到输出当前所在段的末尾。
+     * 这样每一段都是指针区间，平凡类型可以直接 memmove / memset，其余类型也省去了每一步跨段的判断
+     * *****************************************************************************************************************
+     */
+    template<class InputIter, class OutputIter>
+    struct is_segmented_output : public std::integral_constant<bool,
+            segmented_iterator_traits<OutputIter>::is_segmented::value &&
+            is_random_access_iterator<InputIter>::value> {};
+
     /*
      * *****************************************************************************************************************
      * copy 将[first,last)区间内的元素拷贝到[result,result+last-first)内
@@ -98,9 +112,11 @@ namespace mabustl {
     // std::remove_const 去除类型中的const，如const int变int
     // std::is_same 判断两个类型是否相同
     // std::is_trivially_copy_assignable 判断一个类型是否可以平凡复制赋值（该类型的对象可以通过简单的内存拷贝来实现赋值操作）如int，float
+    // std::is_trivially_copyable 要求复制 / 移动构造和析构也是平凡的，memmove 只对这样的类型有定义，否则逐个赋值
     // std::enable_if<Condition,T> 第一个模板参数Condition为true，则std::enable_if<Condition,T>::type为T，否则没有type属性，模板实例化失败
     template<class T, class U>
     typename std::enable_if<std::is_same<typename std::remove_const<T>::type, U>::value &&
+                            std::is_trivially_copyable<U>::value &&
                             std::is_trivially_copy_assignable<U>::value, U*>::type
     unchecked_copy(T* first, T* last, U* result) {
         // 要拷贝的区间的元素数量
@@ -110,9 +126,56 @@ namespace mabustl {
         return result + n;
     }
 
+    // 输出为分段迭代器的版本
+    template<class InputIter, class OutputIter>
+    OutputIter segmented_copy_to(InputIter first, InputIter last, OutputIter result, std::false_type) {
+        return mabustl::unchecked_copy(first, last, result);
+    }
+
+    template<class RandomIter, class OutputIter>
+    OutputIter segmented_copy_to(RandomIter first, RandomIter last, OutputIter result, std::true_type) {
+        typedef segmented_iterator_traits<OutputIter> traits;
+        auto n = last - first;
+        while(n > 0) {
+            auto local = traits::local(result);
+            auto room = traits::end(traits::segment(result)) - local;
+            if(room > n) room = n;
+            mabustl::unchecked_copy(first, first + room, local);
+            first += room;
+            result += room;
+            n -= room;
+        }
+
+        return result;
+    }
+
+    // 输入为分段迭代器的版本
+    template<class InputIter, class OutputIter>
+    OutputIter segmented_copy(InputIter first, InputIter last, OutputIter result, std::false_type) {
+        return mabustl::segmented_copy_to(first, last, result, is_segmented_output<InputIter, OutputIter>());
+    }
+
+    template<class InputIter, class OutputIter>
+    OutputIter segmented_copy(InputIter first, InputIter last, OutputIter result, std::true_type) {
+        typedef segmented_iterator_traits<InputIter> traits;
+        typedef is_segmented_output<typename traits::local_iterator, OutputIter> to_segmented;
+        auto sfirst = traits::segment(first);
+        auto slast = traits::segment(last);
+        if(sfirst == slast) {
+            return mabustl::segmented_copy_to(traits::local(first), traits::local(last), result, to_segmented());
+        }
+        result = mabustl::segmented_copy_to(traits::local(first), traits::end(sfirst), result, to_segmented());
+        for(++sfirst; sfirst != slast; ++sfirst) {
+            result = mabustl::segmented_copy_to(traits::begin(sfirst), traits::end(sfirst), result, to_segmented());
+        }
+
+        return mabustl::segmented_copy_to(traits::begin(slast), traits::local(last), result, to_segmented());
+    }
+
     template<class InputIter, class OutputIter>
     OutputIter copy(InputIter first, InputIter last, OutputIter result) {
-        return unchecked_copy(first, last, result);
+        return mabustl::segmented_copy(first, last, result,
+                                       typename segmented_iterator_traits<InputIter>::is_segmented());
     }
 
     /*
@@ -150,7 +213,7 @@ namespace mabustl {
 
     template<class Iter1, class Iter2>
     Iter2 unchecked_copy_backward(Iter1 first, Iter1 last, Iter2 result) {
-        return unchecked_copy_cat(first, last, result, mabustl::iterator_category(first));
+        return unchecked_copy_backward_cat(first, last, result, mabustl::iterator_category(first));
     }
 
     // 对于简单类型的特化版本
@@ -160,6 +223,7 @@ namespace mabustl {
     // std::enable_if<Condition,T> 第一个模板参数Condition为true，则std::enable_if<Condition,T>::type为T，否则没有type属性，模板实例化失败
     template<class T, class U>
     typename std::enable_if<std::is_same<typename std::remove_const<T>::type, U>::value &&
+                            std::is_trivially_copyable<U>::value &&
                             std::is_trivially_copy_assignable<U>::value, U*>::type
     unchecked_copy_backward(T* first, T* last, U* result) {
         const auto n = static_cast<size_t>(last - first);
@@ -171,9 +235,61 @@ namespace mabustl {
         return result;
     }
 
+    // 输出为分段迭代器的版本，result 位于段首时要写的是上一段的末尾，所以按 result - 1 所在的段切分
+    template<class Iter1, class Iter2>
+    Iter2 segmented_copy_backward_to(Iter1 first, Iter1 last, Iter2 result, std::false_type) {
+        return mabustl::unchecked_copy_backward(first, last, result);
+    }
+
+    template<class RandomIter, class Iter2>
+    Iter2 segmented_copy_backward_to(RandomIter first, RandomIter last, Iter2 result, std::true_type) {
+        typedef segmented_iterator_traits<Iter2> traits;
+        auto n = last - first;
+        while(n > 0) {
+            Iter2 prev = result - 1;
+            auto local_end = traits::local(prev) + 1;
+            auto room = local_end - traits::begin(traits::segment(prev));
+            if(room > n) room = n;
+            mabustl::unchecked_copy_backward(last - room, last, local_end);
+            last -= room;
+            result -= room;
+            n -= room;
+        }
+
+        return result;
+    }
+
+    // 输入为分段迭代器的版本
+    template<class Iter1, class Iter2>
+    Iter2 segmented_copy_backward(Iter1 first, Iter1 last, Iter2 result, std::false_type) {
+        return mabustl::segmented_copy_backward_to(first, last, result, is_segmented_output<Iter1, Iter2>());
+    }
+
+    template<class Iter1, class Iter2>
+    Iter2 segmented_copy_backward(Iter1 first, Iter1 last, Iter2 result, std::true_type) {
+        typedef segmented_iterator_traits<Iter1> traits;
+        typedef is_segmented_output<typename traits::local_iterator, Iter2> to_segmented;
+        auto sfirst = traits::segment(first);
+        auto slast = traits::segment(last);
+        if(sfirst == slast) {
+            return mabustl::segmented_copy_backward_to(traits::local(first), traits::local(last), result,
+                                                       to_segmented());
+        }
+        result = mabustl::segmented_copy_backward_to(traits::begin(slast), traits::local(last), result,
+                                                     to_segmented());
+        for(--slast; slast != sfirst; --slast) {
+            result = mabustl::segmented_copy_backward_to(traits::begin(slast), traits::end(slast), result,
+                                                         to_segmented());
+        }
+
+        return mabustl::segmented_copy_backward_to(traits::local(first), traits::end(sfirst), result,
+                                                   to_segmented());
+    }
+
     template<class Iter1, class Iter2>
     Iter2 copy_backward(Iter1 first, Iter1 last, Iter2 result) {
-        return unchecked_copy_backward(first, last, result);
+        return mabustl::segmented_copy_backward(first, last, result,
+                                                typename segmented_iterator_traits<Iter1>::is_segmented());
     }
 
     /*
@@ -276,6 +392,7 @@ namespace mabustl {
     // std::enable_if<Condition,T> 第一个模板参数Condition为true，则std::enable_if<Condition,T>::type为T，否则没有type属性，模板实例化失败
     template<class T, class U>
     typename std::enable_if<std::is_same<typename std::remove_const<T>::type, U>::value &&
+                            std::is_trivially_copyable<U>::value &&
                             std::is_trivially_move_assignable<U>::value, U*>::type
     unchecked_move(T* first, T* last, U* result) {
         const auto n = static_cast<size_t>(last - first);
@@ -283,9 +400,56 @@ namespace mabustl {
         return result + n;
     }
 
+    // 输出为分段迭代器的版本
+    template<class InputIter, class OutputIter>
+    OutputIter segmented_move_to(InputIter first, InputIter last, OutputIter result, std::false_type) {
+        return mabustl::unchecked_move(first, last, result);
+    }
+
+    template<class RandomIter, class OutputIter>
+    OutputIter segmented_move_to(RandomIter first, RandomIter last, OutputIter result, std::true_type) {
+        typedef segmented_iterator_traits<OutputIter> traits;
+        auto n = last - first;
+        while(n > 0) {
+            auto local = traits::local(result);
+            auto room = traits::end(traits::segment(result)) - local;
+            if(room > n) room = n;
+            mabustl::unchecked_move(first, first + room, local);
+            first += room;
+            result += room;
+            n -= room;
+        }
+
+        return result;
+    }
+
+    // 输入为分段迭代器的版本
+    template<class InputIter, class OutputIter>
+    OutputIter segmented_move(InputIter first, InputIter last, OutputIter result, std::false_type) {
+        return mabustl::segmented_move_to(first, last, result, is_segmented_output<InputIter, OutputIter>());
+    }
+
+    template<class InputIter, class OutputIter>
+    OutputIter segmented_move(InputIter first, InputIter last, OutputIter result, std::true_type) {
+        typedef segmented_iterator_traits<InputIter> traits;
+        typedef is_segmented_output<typename traits::local_iterator, OutputIter> to_segmented;
+        auto sfirst = traits::segment(first);
+        auto slast = traits::segment(last);
+        if(sfirst == slast) {
+            return mabustl::segmented_move_to(traits::local(first), traits::local(last), result, to_segmented());
+        }
+        result = mabustl::segmented_move_to(traits::local(first), traits::end(sfirst), result, to_segmented());
+        for(++sfirst; sfirst != slast; ++sfirst) {
+            result = mabustl::segmented_move_to(traits::begin(sfirst), traits::end(sfirst), result, to_segmented());
+        }
+
+        return mabustl::segmented_move_to(traits::begin(slast), traits::local(last), result, to_segmented());
+    }
+
     template<class InputIter, class OutputIter>
     OutputIter move(InputIter first, InputIter last, OutputIter result) {
-        return unchecked_move(first, last, result);
+        return mabustl::segmented_move(first, last, result,
+                                       typename segmented_iterator_traits<InputIter>::is_segmented());
     }
 
     /*
@@ -329,6 +493,7 @@ namespace mabustl {
     // 为 trivially_copy_assignable 类型提供特化版本
     template<class Tp, class Up>
     typename std::enable_if<std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+                            std::is_trivially_copyable<Up>::value &&
                             std::is_trivially_move_assignable<Up>::value, Up*>::type
     unchecked_move_backward(Tp* first, Tp* last, Up* result) {
         const auto n = static_cast<size_t>(last - first);
@@ -339,9 +504,61 @@ namespace mabustl {
         return result;
     }
 
+    // 输出为分段迭代器的版本
+    template<class Iter1, class Iter2>
+    Iter2 segmented_move_backward_to(Iter1 first, Iter1 last, Iter2 result, std::false_type) {
+        return mabustl::unchecked_move_backward(first, last, result);
+    }
+
+    template<class RandomIter, class Iter2>
+    Iter2 segmented_move_backward_to(RandomIter first, RandomIter last, Iter2 result, std::true_type) {
+        typedef segmented_iterator_traits<Iter2> traits;
+        auto n = last - first;
+        while(n > 0) {
+            Iter2 prev = result - 1;
+            auto local_end = traits::local(prev) + 1;
+            auto room = local_end - traits::begin(traits::segment(prev));
+            if(room > n) room = n;
+            mabustl::unchecked_move_backward(last - room, last, local_end);
+            last -= room;
+            result -= room;
+            n -= room;
+        }
+
+        return result;
+    }
+
+    // 输入为分段迭代器的版本
+    template<class Iter1, class Iter2>
+    Iter2 segmented_move_backward(Iter1 first, Iter1 last, Iter2 result, std::false_type) {
+        return mabustl::segmented_move_backward_to(first, last, result, is_segmented_output<Iter1, Iter2>());
+    }
+
+    template<class Iter1, class Iter2>
+    Iter2 segmented_move_backward(Iter1 first, Iter1 last, Iter2 result, std::true_type) {
+        typedef segmented_iterator_traits<Iter1> traits;
+        typedef is_segmented_output<typename traits::local_iterator, Iter2> to_segmented;
+        auto sfirst = traits::segment(first);
+        auto slast = traits::segment(last);
+        if(sfirst == slast) {
+            return mabustl::segmented_move_backward_to(traits::local(first), traits::local(last), result,
+                                                       to_segmented());
+        }
+        result = mabustl::segmented_move_backward_to(traits::begin(slast), traits::local(last), result,
+                                                     to_segmented());
+        for(--slast; slast != sfirst; --slast) {
+            result = mabustl::segmented_move_backward_to(traits::begin(slast), traits::end(slast), result,
+                                                         to_segmented());
+        }
+
+        return mabustl::segmented_move_backward_to(traits::local(first), traits::end(sfirst), result,
+                                                   to_segmented());
+    }
+
     template<class Iter1, class Iter2>
     Iter2 move_backward(Iter1 first, Iter1 last, Iter2 result) {
-        return unchecked_move_backward(first, last, result);
+        return mabustl::segmented_move_backward(first, last, result,
+                                                typename segmented_iterator_traits<Iter1>::is_segmented());
     }
 
     /*
@@ -429,10 +646,32 @@ namespace mabustl {
     }
 
     template<class Iter, class T>
-    void fill(Iter first, Iter last, const T& value) {
+    void segmented_fill(Iter first, Iter last, const T& value, std::false_type) {
         mabustl::fill_cat(first, last, value, mabustl::iterator_category(first));
     }
 
+    // 分段迭代器逐段调用 fill_n，单字节类型每段一次 memset
+    template<class Iter, class T>
+    void segmented_fill(Iter first, Iter last, const T& value, std::true_type) {
+        typedef segmented_iterator_traits<Iter> traits;
+        auto sfirst = traits::segment(first);
+        auto slast = traits::segment(last);
+        if(sfirst == slast) {
+            mabustl::fill_n(traits::local(first), traits::local(last) - traits::local(first), value);
+            return;
+        }
+        mabustl::fill_n(traits::local(first), traits::end(sfirst) - traits::local(first), value);
+        for(++sfirst; sfirst != slast; ++sfirst) {
+            mabustl::fill_n(traits::begin(sfirst), traits::end(sfirst) - traits::begin(sfirst), value);
+        }
+        mabustl::fill_n(traits::begin(slast), traits::local(last) - traits::begin(slast), value);
+    }
+
+    template<class Iter, class T>
+    void fill(Iter first, Iter last, const T& value) {
+        mabustl::segmented_fill(first, last, value, typename segmented_iterator_traits<Iter>::is_segmented());
+    }
+
     /*
     * ******************************************************************************************************************
     * lexicographical_compare
@@ -447,7 +686,7 @@ namespace mabustl {
     bool lexicographical_compare(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2) {
         while(first1 != last1 && first2 != last2) {
             if(*first1 < *first2) return true;
-            if(*first1 < *first2) return false;
+            if(*first2 < *first1) return false;
 
             ++first1;
             ++first2;
@@ -471,11 +710,13 @@ namespace mabustl {
     }
 
     // 针对const unsigned char*的特化版本
-    bool lexicographical_compare(const unsigned char* first1, const unsigned char* last1,
-                                 const unsigned char* first2, const unsigned char* last2) {
+    inline bool lexicographical_compare(const unsigned char* first1, const unsigned char* last1,
+                                        const unsigned char* first2, const unsigned char* last2) {
         const auto len1 = last1 - first1;
         const auto len2 = last2 - first2;
-        const auto result = std::memcmp(first1, first2, mabustl::min(len1, len2));
+        const auto len = mabustl::min(len1, len2);
+        // 空区间可能由空指针给出，不能传给 memcmp
+        const auto result = len == 0 ? 0 : std::memcmp(first1, first2, static_cast<size_t>(len));
 
         return result != 0 ? result < 0 : len1 < len2;
     }
@@ -0,0 +1,600 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * 内存配置器的后端，供 mabustl::allocator 选择使用
+ * 每个后端只负责按字节分配和回收原始内存，对象的构造和析构由 allocator 负责
+ * 后端可以额外提供 allocate_at_least(返回实际可用的字节数) 和 try_expand(原地扩大已分配的块)，
+ * 回收时传入的大小可以是请求的大小，也可以是 allocate_at_least / try_expand 得到的大小
+ * 实现的功能：
+ * new_alloc(直接调用 operator new / operator delete)
+ * pool_alloc(按大小分级的自由链表内存池)
+ * thread_cache_alloc(每个线程缓存最近回收的块，批量与 pool_alloc 交换)
+ * basic_mmap_alloc mmap_alloc huge_page_alloc(大块内存直接通过 mmap 向系统申请，可使用透明大页)
+ * aligned_allocate aligned_deallocate(在任意后端上按指定对齐分配)
+ * backend_allocate_at_least backend_try_expand(后端没有提供对应函数时使用默认实现)
+ * default_alloc(allocator 默认使用的后端，可通过宏切换)
+ */
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define MABUSTL_HAS_MMAP 1
+#endif
+
+namespace mabustl {
+    /*
+    * *****************************************************************************************************************
+    * new_alloc
+    * 直接调用全局的 operator new / operator delete
+    * *****************************************************************************************************************
+    */
+    class new_alloc {
+    public:
+        static void* allocate(size_t n) {
+            return ::operator new(n);
+        }
+
+        static void deallocate(void* ptr, size_t) {
+            ::operator delete(ptr);
+        }
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * pool_alloc
+    * 小于等于 MAX_BYTES 的请求按 ALIGN 对齐到对应的大小等级，从该等级的自由链表中取出
+    * 自由链表为空时从内存池中一次切割多个块来补充，内存池不足时再向 operator new 申请一大块内存
+    * 大于 MAX_BYTES 的请求直接交给 new_alloc
+    * 回收的小块只会回到自由链表，不会归还给系统
+    * *****************************************************************************************************************
+    */
+
+    // 自由链表的节点，空闲时用前几个字节存储下一个节点的地址
+    union free_list_node {
+        free_list_node* next;
+        char data[1];
+    };
+
+    class pool_alloc {
+    public:
+        enum : size_t {
+            ALIGN = 16,                           // 大小等级的间隔，同时保证返回的地址按 16 字节对齐
+            MAX_BYTES = 256,                      // 由内存池负责的最大字节数
+            FREE_LIST_COUNT = MAX_BYTES / ALIGN,  // 自由链表的个数
+            REFILL_COUNT = 32,                    // 补充自由链表时一次切割的块数
+            CHUNK_BYTES = 64 * 1024               // 向 operator new 申请的最小内存块大小
+        };
+
+    public:
+        static void* allocate(size_t n);
+
+        static void deallocate(void* ptr, size_t n);
+
+        // 小块按大小等级上调，实际可用的字节数通过 usable 返回
+        static void* allocate_at_least(size_t n, size_t& usable) {
+            usable = n > MAX_BYTES ? n : round_up(n == 0 ? 1 : n);
+            return allocate(n);
+        }
+
+        // 新的大小仍在原来的大小等级内时可以原地扩大，new_n 小于 old_n 时返回 false
+        static bool try_expand(void*, size_t old_n, size_t new_n) {
+            if(new_n < old_n) return false;
+            return new_n == old_n || (new_n <= MAX_BYTES && new_n <= round_up(old_n));
+        }
+
+        // 一次取出至多 count 个大小为 n 的块，串成以 nullptr 结尾的链表返回，count 被改为实际取出的块数
+        static free_list_node* allocate_batch(size_t n, size_t& count);
+
+        // 把 [first, last] 这段大小为 n 的块链表一次挂回自由链表
+        static void deallocate_batch(free_list_node* first, free_list_node* last, size_t n);
+
+        // 将 n 上调至 ALIGN 的倍数
+        static size_t round_up(size_t n) {
+            return (n + ALIGN - 1) & ~(static_cast<size_t>(ALIGN) - 1);
+        }
+
+        // n 字节对应的自由链表下标，n 必须在 (0, MAX_BYTES] 之间
+        static size_t free_list_index(size_t n) {
+            return (n + ALIGN - 1) / ALIGN - 1;
+        }
+
+    private:
+        struct pool_state {
+            free_list_node* free_list[FREE_LIST_COUNT];
+            char* start_free;  // 内存池中尚未切割部分的起始位置
+            char* end_free;    // 内存池的结束位置
+            std::mutex mutex;
+        };
+
+        // 函数内的静态变量在所有编译单元中只有一份，且在第一次使用时才初始化
+        static pool_state& state() {
+            static pool_state s;
+            return s;
+        }
+
+        static free_list_node* refill(pool_state& s, size_t n);
+
+        static char* chunk_alloc(pool_state& s, size_t size, size_t& nobjs);
+    };
+
+    inline void* pool_alloc::allocate(size_t n) {
+        if(n > MAX_BYTES) return new_alloc::allocate(n);
+        if(n == 0) n = 1;
+
+        pool_state& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        free_list_node*& head = s.free_list[free_list_index(n)];
+        free_list_node* result = head;
+        if(result == nullptr) return refill(s, round_up(n));
+
+        head = result->next;
+        return result;
+    }
+
+    inline void pool_alloc::deallocate(void* ptr, size_t n) {
+        if(ptr == nullptr) return;
+        if(n > MAX_BYTES) {
+            new_alloc::deallocate(ptr, n);
+            return;
+        }
+        if(n == 0) n = 1;
+
+        pool_state& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        free_list_node*& head = s.free_list[free_list_index(n)];
+        free_list_node* node = static_cast<free_list_node*>(ptr);
+        node->next = head;
+        head = node;
+    }
+
+    inline free_list_node* pool_alloc::allocate_batch(size_t n, size_t& count) {
+        if(n == 0) n = 1;
+
+        pool_state& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        free_list_node*& head = s.free_list[free_list_index(n)];
+
+        // 自由链表为空时直接从内存池切割，不经过自由链表
+        if(head == nullptr) {
+            const size_t size = round_up(n);
+            char* chunk = chunk_alloc(s, size, count);
+            for(size_t i = 0; i + 1 < count; ++i) {
+                reinterpret_cast<free_list_node*>(chunk + i * size)->next =
+                    reinterpret_cast<free_list_node*>(chunk + (i + 1) * size);
+            }
+            reinterpret_cast<free_list_node*>(chunk + (count - 1) * size)->next = nullptr;
+            return reinterpret_cast<free_list_node*>(chunk);
+        }
+
+        free_list_node* first = head;
+        free_list_node* last = head;
+        size_t got = 1;
+        while(got < count && last->next != nullptr) {
+            last = last->next;
+            ++got;
+        }
+        head = last->next;
+        last->next = nullptr;
+        count = got;
+        return first;
+    }
+
+    inline void pool_alloc::deallocate_batch(free_list_node* first, free_list_node* last, size_t n) {
+        if(first == nullptr) return;
+        if(n == 0) n = 1;
+
+        pool_state& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        free_list_node*& head = s.free_list[free_list_index(n)];
+        last->next = head;
+        head = first;
+    }
+
+    // 为大小为 n 的自由链表补充节点，返回其中一个节点给调用者，其余挂到自由链表上，n 已经上调至 ALIGN 的倍数
+    inline free_list_node* pool_alloc::refill(pool_state& s, size_t n) {
+        size_t nobjs = REFILL_COUNT;
+        char* chunk = chunk_alloc(s, n, nobjs);
+        free_list_node* result = reinterpret_cast<free_list_node*>(chunk);
+        if(nobjs == 1) return result;
+
+        // 从第二块开始串成链表
+        free_list_node*& head = s.free_list[free_list_index(n)];
+        free_list_node* curr = reinterpret_cast<free_list_node*>(chunk + n);
+        head = curr;
+        for(size_t i = 2; i < nobjs; ++i) {
+            free_list_node* next = reinterpret_cast<free_list_node*>(chunk + i * n);
+            curr->next = next;
+            curr = next;
+        }
+        curr->next = nullptr;
+
+        return result;
+    }
+
+    // 从内存池中取出 nobjs 个大小为 size 的块，内存池不足时 nobjs 会被改为实际取出的块数
+    inline char* pool_alloc::chunk_alloc(pool_state& s, size_t size, size_t& nobjs) {
+        const size_t need_bytes = size * nobjs;
+        const size_t left_bytes = static_cast<size_t>(s.end_free - s.start_free);
+
+        // 剩余空间足够
+        if(left_bytes >= need_bytes) {
+            char* result = s.start_free;
+            s.start_free += need_bytes;
+            return result;
+        }
+
+        // 剩余空间至少能切出一块
+        if(left_bytes >= size) {
+            nobjs = left_bytes / size;
+            char* result = s.start_free;
+            s.start_free += size * nobjs;
+            return result;
+        }
+
+        // 剩余空间一块都切不出来，先把零头挂到对应的自由链表上，零头一定是 ALIGN 的倍数
+        if(left_bytes > 0) {
+            free_list_node*& head = s.free_list[free_list_index(left_bytes)];
+            free_list_node* node = reinterpret_cast<free_list_node*>(s.start_free);
+            node->next = head;
+            head = node;
+        }
+        s.start_free = s.end_free = nullptr;
+
+        // 再向 operator new 申请一块新的内存，失败时抛出 std::bad_alloc
+        const size_t chunk_bytes = need_bytes > CHUNK_BYTES ? need_bytes : static_cast<size_t>(CHUNK_BYTES);
+        s.start_free = static_cast<char*>(new_alloc::allocate(chunk_bytes));
+        s.end_free = s.start_free + chunk_bytes;
+
+        char* result = s.start_free;
+        s.start_free += need_bytes;
+        return result;
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * thread_cache_alloc
+    * 每个线程为每个大小等级保留一个不加锁的缓存(magazine)，分配和回收优先在本线程的缓存中完成
+    * 缓存为空时从 pool_alloc 一次取回 BATCH_COUNT 块，缓存超过 MAX_CACHED 块时只保留 BATCH_COUNT 块，其余还回 pool_alloc
+    * 同一大小等级的块可以互换，所以在 A 线程分配、在 B 线程回收的块直接进入 B 线程的缓存
+    * 线程退出时其缓存中的块全部还给 pool_alloc
+    * 大于 pool_alloc::MAX_BYTES 的请求直接交给 new_alloc
+    * *****************************************************************************************************************
+    */
+    class thread_cache_alloc {
+    public:
+        enum : size_t {
+            BATCH_COUNT = 32,  // 与 pool_alloc 交换时一次移动的块数
+            MAX_CACHED = 64    // 每个大小等级在缓存中最多保留的块数
+        };
+
+    public:
+        static void* allocate(size_t n);
+
+        static void deallocate(void* ptr, size_t n);
+
+        // 与 pool_alloc 使用相同的大小等级
+        static void* allocate_at_least(size_t n, size_t& usable) {
+            usable = n > pool_alloc::MAX_BYTES ? n : pool_alloc::round_up(n == 0 ? 1 : n);
+            return allocate(n);
+        }
+
+        static bool try_expand(void* ptr, size_t old_n, size_t new_n) {
+            return pool_alloc::try_expand(ptr, old_n, new_n);
+        }
+
+    private:
+        struct magazine {
+            free_list_node* head;
+            size_t count;
+        };
+
+        // 线程存储期的变量会先被零初始化，所以不需要构造函数
+        struct thread_cache {
+            magazine mags[pool_alloc::FREE_LIST_COUNT];
+
+            ~thread_cache() {
+                for(size_t i = 0; i < pool_alloc::FREE_LIST_COUNT; ++i) {
+                    magazine& m = mags[i];
+                    if(m.head == nullptr) continue;
+                    free_list_node* last = m.head;
+                    while(last->next != nullptr) last = last->next;
+                    pool_alloc::deallocate_batch(m.head, last, (i + 1) * pool_alloc::ALIGN);
+                    m.head = nullptr;
+                    m.count = 0;
+                }
+            }
+        };
+
+        static thread_cache& cache() {
+            static thread_local thread_cache c;
+            return c;
+        }
+    };
+
+    inline void* thread_cache_alloc::allocate(size_t n) {
+        if(n > pool_alloc::MAX_BYTES) return new_alloc::allocate(n);
+        if(n == 0) n = 1;
+
+        magazine& m = cache().mags[pool_alloc::free_list_index(n)];
+        if(m.head == nullptr) {
+            size_t count = BATCH_COUNT;
+            m.head = pool_alloc::allocate_batch(n, count);
+            m.count = count;
+        }
+
+        free_list_node* result = m.head;
+        m.head = result->next;
+        --m.count;
+        return result;
+    }
+
+    inline void thread_cache_alloc::deallocate(void* ptr, size_t n) {
+        if(ptr == nullptr) return;
+        if(n > pool_alloc::MAX_BYTES) {
+            new_alloc::deallocate(ptr, n);
+            return;
+        }
+        if(n == 0) n = 1;
+
+        magazine& m = cache().mags[pool_alloc::free_list_index(n)];
+        free_list_node* node = static_cast<free_list_node*>(ptr);
+        node->next = m.head;
+        m.head = node;
+        ++m.count;
+
+        // 缓存过多时把最近回收的 BATCH_COUNT 块之后的部分还给 pool_alloc，保留较热的块
+        if(m.count > MAX_CACHED) {
+            free_list_node* keep_last = m.head;
+            for(size_t i = 1; i < BATCH_COUNT; ++i) keep_last = keep_last->next;
+            free_list_node* first = keep_last->next;
+            free_list_node* last = first;
+            while(last->next != nullptr) last = last->next;
+            keep_last->next = nullptr;
+            pool_alloc::deallocate_batch(first, last, n);
+            m.count = BATCH_COUNT;
+        }
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * basic_mmap_alloc
+    * 不小于 Threshold 字节的请求直接用 mmap 映射匿名内存，回收时 munmap 归还给系统，更小的请求交给 new_alloc
+    * HugePage 为 true 时映射按 2MB 对齐，并通过 madvise(MADV_HUGEPAGE) 请求透明大页，降低 TLB 压力
+    * Prefault 为 true 时在返回前把所有页面提前写入一次，避免第一次访问时的缺页中断
+    * 不支持 mmap 的平台上全部交给 new_alloc
+    * *****************************************************************************************************************
+    */
+    enum : size_t {
+        HUGE_PAGE_SIZE = 2 * 1024 * 1024,  // x86-64 / AArch64 上透明大页的大小
+        MMAP_THRESHOLD = 1024 * 1024       // mmap_alloc 默认的阈值
+    };
+
+#if defined(MABUSTL_HAS_MMAP)
+    template<bool HugePage, bool Prefault = false,
+        size_t Threshold = HugePage ? static_cast<size_t>(HUGE_PAGE_SIZE) : static_cast<size_t>(MMAP_THRESHOLD)>
+    class basic_mmap_alloc {
+    public:
+        static void* allocate(size_t n) {
+            if(n < Threshold) return new_alloc::allocate(n);
+            return map(n);
+        }
+
+        static void deallocate(void* ptr, size_t n) {
+            if(ptr == nullptr) return;
+            if(n < Threshold) {
+                new_alloc::deallocate(ptr, n);
+                return;
+            }
+            ::munmap(ptr, mapped_size(n));
+        }
+
+        // 映射按页上调，整页都可以使用
+        static void* allocate_at_least(size_t n, size_t& usable) {
+            usable = n < Threshold ? n : mapped_size(n);
+            return allocate(n);
+        }
+
+        // 已映射的页足够时直接成功，否则在 Linux 上尝试用 mremap 原地扩大映射(不允许移动)
+        static bool try_expand(void* ptr, size_t old_n, size_t new_n) {
+            if(new_n < old_n) return false;
+            if(new_n == old_n) return true;
+            if(old_n < Threshold) return false;
+            const size_t old_len = mapped_size(old_n);
+            const size_t new_len = mapped_size(new_n);
+            if(new_len <= old_len) return true;
+#if defined(__linux__)
+            if(::mremap(ptr, old_len, new_len, 0) == MAP_FAILED) return false;
+#if defined(MADV_HUGEPAGE)
+            if(HugePage) ::madvise(static_cast<char*>(ptr) + old_len, new_len - old_len, MADV_HUGEPAGE);
+#endif
+            if(Prefault) prefault(static_cast<char*>(ptr) + old_len, new_len - old_len);
+            return true;
+#else
+            return false;
+#endif
+        }
+
+    private:
+        static size_t page_size() {
+            static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            return size;
+        }
+
+        // 实际映射的字节数，按页(或大页)上调
+        static size_t mapped_size(size_t n) {
+            const size_t unit = HugePage ? static_cast<size_t>(HUGE_PAGE_SIZE) : page_size();
+            return (n + unit - 1) & ~(unit - 1);
+        }
+
+        static void* map(size_t n) {
+            const size_t len = mapped_size(n);
+            const int prot = PROT_READ | PROT_WRITE;
+            const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+            if(!HugePage) {
+                void* result = ::mmap(nullptr, len, prot, flags, -1, 0);
+                if(result == MAP_FAILED) throw std::bad_alloc();
+                if(Prefault) prefault(static_cast<char*>(result), len);
+                return result;
+            }
+
+            // 多映射一个大页，再把首尾不对齐的部分 munmap 掉，得到按大页对齐的区域
+            void* raw = ::mmap(nullptr, len + HUGE_PAGE_SIZE, prot, flags, -1, 0);
+            if(raw == MAP_FAILED) throw std::bad_alloc();
+            char* first = static_cast<char*>(raw);
+            const size_t addr = reinterpret_cast<size_t>(first);
+            char* result = reinterpret_cast<char*>((addr + HUGE_PAGE_SIZE - 1) & ~(static_cast<size_t>(HUGE_PAGE_SIZE) - 1));
+            const size_t head = static_cast<size_t>(result - first);
+            if(head > 0) ::munmap(first, head);
+            if(HUGE_PAGE_SIZE - head > 0) ::munmap(result + len, HUGE_PAGE_SIZE - head);
+
+#if defined(MADV_HUGEPAGE)
+            ::madvise(result, len, MADV_HUGEPAGE);
+#endif
+            if(Prefault) prefault(result, len);
+            return result;
+        }
+
+        static void prefault(char* first, size_t len) {
+#if defined(MADV_POPULATE_WRITE)
+            if(::madvise(first, len, MADV_POPULATE_WRITE) == 0) return;
+#endif
+            // 内核不支持 MADV_POPULATE_WRITE 时逐页写入
+            volatile char* p = first;
+            for(size_t offset = 0; offset < len; offset += page_size()) p[offset] = 0;
+        }
+    };
+#else
+    template<bool HugePage, bool Prefault = false, size_t Threshold = MMAP_THRESHOLD>
+    class basic_mmap_alloc : public new_alloc {};
+#endif
+
+    // 大块内存使用 mmap，按普通页映射
+    typedef basic_mmap_alloc<false> mmap_alloc;
+
+    // 大块内存使用 mmap，并请求透明大页
+    typedef basic_mmap_alloc<true> huge_page_alloc;
+
+    /*
+    * *****************************************************************************************************************
+    * aligned_allocate / aligned_deallocate
+    * 所有后端返回的地址都至少按 default_alignment 对齐，对齐要求不超过它时直接交给后端
+    * 否则向后端多申请 alignment 字节，返回其中按 alignment 对齐的地址，并把原始地址保存在返回地址之前
+    * alignment 必须是 2 的幂，回收时必须传入与分配时相同的 n 和 alignment
+    * *****************************************************************************************************************
+    */
+    constexpr size_t default_alignment = alignof(std::max_align_t);
+
+    template<class Alloc>
+    void* aligned_allocate(size_t n, size_t alignment) {
+        if(alignment <= default_alignment) return Alloc::allocate(n);
+
+        // raw 至少按 default_alignment 对齐，所以 aligned 与 raw 之间至少留有 sizeof(void*) 字节
+        char* raw = static_cast<char*>(Alloc::allocate(n + alignment));
+        const size_t addr = reinterpret_cast<size_t>(raw + sizeof(void*));
+        char* aligned = reinterpret_cast<char*>((addr + alignment - 1) & ~(alignment - 1));
+        reinterpret_cast<void**>(aligned)[-1] = raw;
+        return aligned;
+    }
+
+    template<class Alloc>
+    void aligned_deallocate(void* ptr, size_t n, size_t alignment) {
+        if(ptr == nullptr) return;
+        if(alignment <= default_alignment) {
+            Alloc::deallocate(ptr, n);
+            return;
+        }
+        Alloc::deallocate(static_cast<void**>(ptr)[-1], n + alignment);
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * backend_allocate_at_least / backend_try_expand
+    * 后端提供了 allocate_at_least / try_expand 时调用它，否则按请求的大小分配 / 只在大小不变时返回 true
+    * try_expand 只用于扩大，new_n 小于 old_n 时返回 false，成功后回收时应传入 new_n
+    * *****************************************************************************************************************
+    */
+    template<class Alloc>
+    struct backend_has_allocate_at_least {
+    private:
+        template<class A>
+        static auto test(int) -> decltype(A::allocate_at_least(size_t(), std::declval<size_t&>()), std::true_type());
+
+        template<class A>
+        static std::false_type test(...);
+
+    public:
+        typedef decltype(test<Alloc>(0)) type;
+    };
+
+    template<class Alloc>
+    struct backend_has_try_expand {
+    private:
+        template<class A>
+        static auto test(int) -> decltype(A::try_expand(std::declval<void*>(), size_t(), size_t()), std::true_type());
+
+        template<class A>
+        static std::false_type test(...);
+
+    public:
+        typedef decltype(test<Alloc>(0)) type;
+    };
+
+    template<class Alloc>
+    void* backend_allocate_at_least_dispatch(size_t n, size_t& usable, std::true_type) {
+        return Alloc::allocate_at_least(n, usable);
+    }
+
+    template<class Alloc>
+    void* backend_allocate_at_least_dispatch(size_t n, size_t& usable, std::false_type) {
+        usable = n;
+        return Alloc::allocate(n);
+    }
+
+    template<class Alloc>
+    void* backend_allocate_at_least(size_t n, size_t& usable) {
+        return backend_allocate_at_least_dispatch<Alloc>(n, usable, typename backend_has_allocate_at_least<Alloc>::type());
+    }
+
+    template<class Alloc>
+    bool backend_try_expand_dispatch(void* ptr, size_t old_n, size_t new_n, std::true_type) {
+        return Alloc::try_expand(ptr, old_n, new_n);
+    }
+
+    template<class Alloc>
+    bool backend_try_expand_dispatch(void*, size_t old_n, size_t new_n, std::false_type) {
+        return new_n == old_n;
+    }
+
+    template<class Alloc>
+    bool backend_try_expand(void* ptr, size_t old_n, size_t new_n) {
+        return backend_try_expand_dispatch<Alloc>(ptr, old_n, new_n, typename backend_has_try_expand<Alloc>::type());
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * default_alloc
+    * allocator 默认使用的后端
+    * 定义 MABUSTL_USE_THREAD_CACHE_ALLOC 时使用 thread_cache_alloc，定义 MABUSTL_USE_POOL_ALLOC 时使用 pool_alloc
+    * 都没有定义时使用 new_alloc
+    * *****************************************************************************************************************
+    */
+#if defined(MABUSTL_USE_THREAD_CACHE_ALLOC)
+    typedef thread_cache_alloc default_alloc;
+#elif defined(MABUSTL_USE_POOL_ALLOC)
+    typedef pool_alloc default_alloc;
+#else
+    typedef new_alloc default_alloc;
+#endif
+}
@@ -0,0 +1,308 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * 内存分配统计，实现的功能有：
+ * instrumented_allocator(记录统计信息的 allocator)
+ * for_each_type_stats for_each_thread_stats(按值类型 / 按线程遍历统计信息)
+ * total_alloc_stats(所有值类型的统计之和)
+ * dump_alloc_stats(把统计信息输出到文件)
+ *
+ * 只有定义了 MABUSTL_ALLOC_STATS 时才会记录，否则 instrumented_allocator 就是 allocator，
+ * 遍历和输出函数什么也不做，没有任何额外开销
+ * allocator 允许回收时传入请求的大小，而 instrumented_allocator 按实际得到的大小记录：
+ * allocate_at_least 得到的内存回收时必须传入 count，try_expand 成功后必须传入 new_n，否则 live_bytes 会偏离
+ */
+
+#include <cstddef>
+#include <cstdio>
+
+#include "mabu_allocator.h"
+
+#if defined(MABUSTL_ALLOC_STATS)
+#include <atomic>
+#include <typeinfo>
+#endif
+
+namespace mabustl {
+    enum : size_t {
+        ALLOC_STATS_BUCKETS = 64  // 按 log2(字节数) 划分的直方图桶数
+    };
+
+    // 统计信息的快照
+    struct alloc_stats {
+        const char* name;                              // 值类型名(typeid 的 name)或 "thread"
+        size_t id;                                     // 线程统计的编号，值类型统计为 0
+        long long live_bytes;                          // 当前未回收的字节数，跨线程回收时单个线程的值可能为负
+        long long peak_bytes;                          // live_bytes 的峰值
+        unsigned long long allocate_calls;
+        unsigned long long deallocate_calls;
+        unsigned long long allocated_bytes;            // 累计分配的字节数
+        unsigned long long histogram[ALLOC_STATS_BUCKETS];  // histogram[i] 为字节数在 [2^i, 2^(i+1)) 内的分配次数
+    };
+
+#if defined(MABUSTL_ALLOC_STATS)
+    /*
+    * *****************************************************************************************************************
+    * alloc_stats_record
+    * 统计信息的记录，值类型记录和线程记录分别串成只增不减的链表，记录一旦创建就不会释放
+    * *****************************************************************************************************************
+    */
+    struct alloc_stats_record {
+        const char* name;
+        size_t id;
+        std::atomic<long long> live_bytes;
+        std::atomic<long long> peak_bytes;
+        std::atomic<unsigned long long> allocate_calls;
+        std::atomic<unsigned long long> deallocate_calls;
+        std::atomic<unsigned long long> allocated_bytes;
+        std::atomic<unsigned long long> histogram[ALLOC_STATS_BUCKETS];
+        alloc_stats_record* next;
+
+        void on_allocate(size_t bytes) {
+            const long long live = live_bytes.fetch_add(static_cast<long long>(bytes), std::memory_order_relaxed) +
+                                   static_cast<long long>(bytes);
+            long long peak = peak_bytes.load(std::memory_order_relaxed);
+            while(live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+            allocate_calls.fetch_add(1, std::memory_order_relaxed);
+            allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            histogram[size_bucket(bytes)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void on_deallocate(size_t bytes) {
+            live_bytes.fetch_sub(static_cast<long long>(bytes), std::memory_order_relaxed);
+            deallocate_calls.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        alloc_stats snapshot() const {
+            alloc_stats result;
+            result.name = name;
+            result.id = id;
+            result.live_bytes = live_bytes.load(std::memory_order_relaxed);
+            result.peak_bytes = peak_bytes.load(std::memory_order_relaxed);
+            result.allocate_calls = allocate_calls.load(std::memory_order_relaxed);
+            result.deallocate_calls = deallocate_calls.load(std::memory_order_relaxed);
+            result.allocated_bytes = allocated_bytes.load(std::memory_order_relaxed);
+            for(size_t i = 0; i < ALLOC_STATS_BUCKETS; ++i) {
+                result.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+            }
+            return result;
+        }
+
+        // floor(log2(bytes))，bytes 为 0 时放在第 0 个桶
+        static size_t size_bucket(size_t bytes) {
+            if(bytes == 0) return 0;
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>(63 - __builtin_clzll(static_cast<unsigned long long>(bytes)));
+#else
+            size_t result = 0;
+            while(bytes >>= 1) ++result;
+            return result;
+#endif
+        }
+    };
+
+    // 值类型记录链表的表头
+    inline std::atomic<alloc_stats_record*>& type_stats_head() {
+        static std::atomic<alloc_stats_record*> head(nullptr);
+        return head;
+    }
+
+    // 线程记录链表的表头
+    inline std::atomic<alloc_stats_record*>& thread_stats_head() {
+        static std::atomic<alloc_stats_record*> head(nullptr);
+        return head;
+    }
+
+    // 创建一条记录并无锁地插入链表头部
+    inline alloc_stats_record* register_stats_record(std::atomic<alloc_stats_record*>& head,
+                                                     const char* name, size_t id) {
+        alloc_stats_record* record = new alloc_stats_record();
+        record->name = name;
+        record->id = id;
+        alloc_stats_record* old = head.load(std::memory_order_relaxed);
+        do {
+            record->next = old;
+        } while(!head.compare_exchange_weak(old, record, std::memory_order_release, std::memory_order_relaxed));
+        return record;
+    }
+
+    template<class T>
+    alloc_stats_record& type_stats_record() {
+        static alloc_stats_record* record = register_stats_record(type_stats_head(), typeid(T).name(), 0);
+        return *record;
+    }
+
+    inline alloc_stats_record& thread_stats_record() {
+        static std::atomic<size_t> next_id(1);
+        static thread_local alloc_stats_record* record = nullptr;
+        if(record == nullptr) {
+            record = register_stats_record(thread_stats_head(), "thread",
+                                           next_id.fetch_add(1, std::memory_order_relaxed));
+        }
+        return *record;
+    }
+
+    template<class T>
+    void record_allocate(size_t bytes) {
+        type_stats_record<T>().on_allocate(bytes);
+        thread_stats_record().on_allocate(bytes);
+    }
+
+    template<class T>
+    void record_deallocate(size_t bytes) {
+        type_stats_record<T>().on_deallocate(bytes);
+        thread_stats_record().on_deallocate(bytes);
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * instrumented_allocator
+    * 与 allocator<T, Alloc> 相同，并在每次分配和回收时按值类型 T 和当前线程记录统计信息
+    * *****************************************************************************************************************
+    */
+    template<class T, class Alloc = default_alloc>
+    class instrumented_allocator : public allocator<T, Alloc> {
+    public:
+        typedef allocator<T, Alloc> base_type;
+        typedef typename base_type::size_type size_type;
+
+        template<class U>
+        struct rebind {
+            typedef instrumented_allocator<U, Alloc> other;
+        };
+
+    public:
+        instrumented_allocator() noexcept {}
+
+        template<class U>
+        instrumented_allocator(const instrumented_allocator<U, Alloc>&) noexcept {}
+
+        static T* allocate() {
+            T* result = base_type::allocate();
+            record_allocate<T>(sizeof(T));
+            return result;
+        }
+
+        static T* allocate(size_type n) {
+            T* result = base_type::allocate(n);
+            if(result != nullptr) record_allocate<T>(n * sizeof(T));
+            return result;
+        }
+
+        static T* allocate(size_type n, size_t alignment) {
+            T* result = base_type::allocate(n, alignment);
+            if(result != nullptr) record_allocate<T>(n * sizeof(T));
+            return result;
+        }
+
+        // 记录实际得到的 count 个对象，回收时必须传入 count 而不是 n
+        static allocation_result<T*, size_type> allocate_at_least(size_type n) {
+            allocation_result<T*, size_type> result = base_type::allocate_at_least(n);
+            if(result.ptr != nullptr) record_allocate<T>(result.count * sizeof(T));
+            return result;
+        }
+
+        // 原地扩大成功时把增加的部分记为一次分配
+        static bool try_expand(T* ptr, size_type old_n, size_type new_n) {
+            if(!base_type::try_expand(ptr, old_n, new_n)) return false;
+            if(new_n > old_n) record_allocate<T>((new_n - old_n) * sizeof(T));
+            return true;
+        }
+
+        static void deallocate(T* ptr) {
+            if(ptr == nullptr) return;
+            record_deallocate<T>(sizeof(T));
+            base_type::deallocate(ptr);
+        }
+
+        static void deallocate(T* ptr, size_type n) {
+            if(ptr == nullptr) return;
+            record_deallocate<T>(n * sizeof(T));
+            base_type::deallocate(ptr, n);
+        }
+
+        static void deallocate(T* ptr, size_type n, size_t alignment) {
+            if(ptr == nullptr) return;
+            record_deallocate<T>(n * sizeof(T));
+            base_type::deallocate(ptr, n, alignment);
+        }
+    };
+
+    // 对每个值类型的统计快照调用 f(const alloc_stats&)
+    template<class Func>
+    void for_each_type_stats(Func f) {
+        for(alloc_stats_record* r = type_stats_head().load(std::memory_order_acquire); r != nullptr; r = r->next) {
+            f(r->snapshot());
+        }
+    }
+
+    // 对每个线程(包括已经退出的线程)的统计快照调用 f(const alloc_stats&)
+    template<class Func>
+    void for_each_thread_stats(Func f) {
+        for(alloc_stats_record* r = thread_stats_head().load(std::memory_order_acquire); r != nullptr; r = r->next) {
+            f(r->snapshot());
+        }
+    }
+
+    inline bool alloc_stats_enabled() {
+        return true;
+    }
+#else
+    template<class T, class Alloc = default_alloc>
+    using instrumented_allocator = allocator<T, Alloc>;
+
+    template<class Func>
+    void for_each_type_stats(Func) {}
+
+    template<class Func>
+    void for_each_thread_stats(Func) {}
+
+    inline bool alloc_stats_enabled() {
+        return false;
+    }
+#endif
+
+    // 所有值类型的统计之和，name 为 "total"
+    inline alloc_stats total_alloc_stats() {
+        alloc_stats result = alloc_stats();
+        result.name = "total";
+        for_each_type_stats([&result](const alloc_stats& s) {
+            result.live_bytes += s.live_bytes;
+            result.peak_bytes += s.peak_bytes;
+            result.allocate_calls += s.allocate_calls;
+            result.deallocate_calls += s.deallocate_calls;
+            result.allocated_bytes += s.allocated_bytes;
+            for(size_t i = 0; i < ALLOC_STATS_BUCKETS; ++i) result.histogram[i] += s.histogram[i];
+        });
+        return result;
+    }
+
+    // 输出一条统计，直方图只输出非零的桶
+    inline void dump_alloc_stats(std::FILE* out, const alloc_stats& s) {
+        std::fprintf(out, "%s#%zu live=%lld peak=%lld alloc=%llu dealloc=%llu bytes=%llu\n",
+                     s.name, s.id, s.live_bytes, s.peak_bytes,
+                     s.allocate_calls, s.deallocate_calls, s.allocated_bytes);
+        for(size_t i = 0; i < ALLOC_STATS_BUCKETS; ++i) {
+            if(s.histogram[i] == 0) continue;
+            std::fprintf(out, "    [2^%zu, 2^%zu): %llu\n", i, i + 1, s.histogram[i]);
+        }
+    }
+
+    // 输出全部统计，total 中的 peak 为各值类型峰值之和，只是一个上界
+    inline void dump_alloc_stats(std::FILE* out = stderr) {
+        if(!alloc_stats_enabled()) {
+            std::fprintf(out, "mabustl alloc stats disabled, define MABUSTL_ALLOC_STATS to enable\n");
+            return;
+        }
+        dump_alloc_stats(out, total_alloc_stats());
+        std::fprintf(out, "-- by type --\n");
+        for_each_type_stats([out](const alloc_stats& s) { dump_alloc_stats(out, s); });
+        std::fprintf(out, "-- by thread --\n");
+        for_each_thread_stats([out](const alloc_stats& s) { dump_alloc_stats(out, s); });
+    }
+}
@@ -1,8 +1,10 @@
 #pragma once
 #include <cstddef>
-#include <__memory/allocator_traits.h>
 
+#include "mabu_alloc.h"
+#include "mabu_allocator_traits.h"
 #include "mabu_construct.h"
+#include "mabu_stddef.h"
 
 /*
  * time: 2025-2-11
@@ -10,7 +12,9 @@
  */
 
 namespace mabustl {
-    template<class T>
+    // Alloc 为负责分配原始内存的后端，见 mabu_alloc.h
+    // 分配的内存至少按 alignof(T) 对齐，alignof(T) 超过后端的默认对齐时自动走 aligned_allocate
+    template<class T, class Alloc = default_alloc>
     class allocator {
     public:
         typedef T value_type;
@@ -20,8 +24,27 @@ namespace mabustl {
         typedef const T& const_reference;
         typedef size_t size_type;
         typedef ptrdiff_t difference_type;
+        typedef Alloc alloc_type;
+
+        // 不含状态，任意两个实例都相等
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type is_always_equal;
+
+        template<class U>
+        struct rebind {
+            typedef allocator<U, Alloc> other;
+        };
 
     public:
+        allocator() noexcept {}
+
+        template<class U>
+        allocator(const allocator<U, Alloc>&) noexcept {}
+
+        static size_type max_size() noexcept {
+            return static_cast<size_type>(-1) / sizeof(T);
+        }
+
         static T* allocate();
 
         static T* allocate(size_type n);
@@ -30,6 +53,18 @@ namespace mabustl {
 
         static void deallocate(T* ptr, size_type n);
 
+        // 按 alignment 对齐分配 n 个对象，alignment 小于 alignof(T) 时按 alignof(T) 处理
+        static T* allocate(size_type n, size_t alignment);
+
+        // 回收由 allocate(n, alignment) 分配的内存
+        static void deallocate(T* ptr, size_type n, size_t alignment);
+
+        // 分配至少 n 个对象的空间，count 为实际可用的个数，回收时可以传入 n 或 count
+        static allocation_result<T*, size_type> allocate_at_least(size_type n);
+
+        // 尝试把 ptr 处 old_n 个对象的空间原地扩大到 new_n 个，成功后回收时应传入 new_n
+        static bool try_expand(T* ptr, size_type old_n, size_type new_n);
+
         static void construct(T* ptr);
 
         static void construct(T* ptr, const T& value);
@@ -44,57 +79,188 @@ namespace mabustl {
         static void destroy(T* first, T* last);
     };
 
-    template<class T>
-    T* allocator<T>::allocate() {
-        return static_cast<T*>(operator new(sizeof(T)));
+    template<class T1, class T2, class Alloc>
+    bool operator==(const allocator<T1, Alloc>&, const allocator<T2, Alloc>&) noexcept {
+        return true;
     }
 
-    template<class T>
-    T* allocator<T>::allocate(size_type n) {
+    template<class T1, class T2, class Alloc>
+    bool operator!=(const allocator<T1, Alloc>&, const allocator<T2, Alloc>&) noexcept {
+        return false;
+    }
+
+    template<class T, class Alloc>
+    T* allocator<T, Alloc>::allocate() {
+        return static_cast<T*>(aligned_allocate<Alloc>(sizeof(T), alignof(T)));
+    }
+
+    template<class T, class Alloc>
+    T* allocator<T, Alloc>::allocate(size_type n) {
         if(n == 0) return nullptr;
-        return static_cast<T*>(operator new(n * sizeof(T)));
+        return static_cast<T*>(aligned_allocate<Alloc>(n * sizeof(T), alignof(T)));
     }
 
-    template<class T>
-    void allocator<T>::deallocate(T* ptr) {
+    template<class T, class Alloc>
+    void allocator<T, Alloc>::deallocate(T* ptr) {
         if(ptr == nullptr) return;
-        ::operator delete(ptr);
+        aligned_deallocate<Alloc>(ptr, sizeof(T), alignof(T));
     }
 
-    template<class T>
-    void allocator<T>::deallocate(T* ptr, size_type) {
+    template<class T, class Alloc>
+    void allocator<T, Alloc>::deallocate(T* ptr, size_type n) {
         if(ptr == nullptr) return;
-        ::operator delete(ptr);
+        aligned_deallocate<Alloc>(ptr, n * sizeof(T), alignof(T));
     }
 
-    template<class T>
-    void allocator<T>::construct(T* ptr) {
+    template<class T, class Alloc>
+    T* allocator<T, Alloc>::allocate(size_type n, size_t alignment) {
+        if(n == 0) return nullptr;
+        if(alignment < alignof(T)) alignment = alignof(T);
+        MABUSTL_DEBUG((alignment & (alignment - 1)) == 0);
+        return static_cast<T*>(aligned_allocate<Alloc>(n * sizeof(T), alignment));
+    }
+
+    template<class T, class Alloc>
+    void allocator<T, Alloc>::deallocate(T* ptr, size_type n, size_t alignment) {
+        if(ptr == nullptr) return;
+        if(alignment < alignof(T)) alignment = alignof(T);
+        aligned_deallocate<Alloc>(ptr, n * sizeof(T), alignment);
+    }
+
+    template<class T, class Alloc>
+    allocation_result<T*, typename allocator<T, Alloc>::size_type> allocator<T, Alloc>::allocate_at_least(size_type n) {
+        allocation_result<T*, size_type> result = {nullptr, 0};
+        if(n == 0) return result;
+
+        // over-aligned 类型走 aligned_allocate，没有额外的可用空间
+        if(alignof(T) > default_alignment) {
+            result.ptr = allocate(n);
+            result.count = n;
+            return result;
+        }
+
+        size_t usable = 0;
+        result.ptr = static_cast<T*>(backend_allocate_at_least<Alloc>(n * sizeof(T), usable));
+        result.count = usable / sizeof(T);
+        return result;
+    }
+
+    template<class T, class Alloc>
+    bool allocator<T, Alloc>::try_expand(T* ptr, size_type old_n, size_type new_n) {
+        if(ptr == nullptr || alignof(T) > default_alignment) return new_n == old_n;
+        return backend_try_expand<Alloc>(ptr, old_n * sizeof(T), new_n * sizeof(T));
+    }
+
+    template<class T, class Alloc>
+    void allocator<T, Alloc>::construct(T* ptr) {
         return mabustl::construct(ptr);
     }
 
-    template<class T>
-    void allocator<T>::construct(T* ptr, const T& value) {
+    template<class T, class Alloc>
+    void allocator<T, Alloc>::construct(T* ptr, const T& value) {
         return mabustl::construct(ptr, value);
     }
 
-    template<class T>
-    void allocator<T>::construct(T* ptr, T&& value) {
+    template<class T, class Alloc>
+    void allocator<T, Alloc>::construct(T* ptr, T&& value) {
         return mabustl::construct(ptr, mabustl::move(value));
     }
 
-    template<class T>
+    template<class T, class Alloc>
     template<class... Args>
-    void allocator<T>::construct(T* ptr, Args&&... args) {
+    void allocator<T, Alloc>::construct(T* ptr, Args&&... args) {
         return mabustl::construct(ptr, mabustl::forward<Args>(args)...);
     }
 
-    template<class T>
-    void allocator<T>::destroy(T* ptr) {
+    template<class T, class Alloc>
+    void allocator<T, Alloc>::destroy(T* ptr) {
         mabustl::destroy(ptr);
     }
 
-    template<class T>
-    void allocator<T>::destroy(T* first, T* last) {
+    template<class T, class Alloc>
+    void allocator<T, Alloc>::destroy(T* first, T* last) {
         mabustl::destroy(first, last);
     }
+
+    // 判断 Alloc 的 construct / destroy 是否就是 mabustl::construct / destroy
+    // 为 true 时 uninitialized_*_a 可以直接走 uninitialized_* 的快速路径(例如对平凡类型使用 memmove)
+    template<class Alloc, class = void>
+    struct allocator_uses_default_construct : std::false_type {};
+
+    template<class Alloc>
+    struct allocator_uses_default_construct<Alloc, typename void_type<typename Alloc::alloc_type>::type>
+        : std::is_base_of<allocator<typename Alloc::value_type, typename Alloc::alloc_type>, Alloc> {};
+
+    // 使用内存池的 allocator，可直接替换 allocator<T>
+    template<class T>
+    using pool_allocator = allocator<T, pool_alloc>;
+
+    /*
+    * *****************************************************************************************************************
+    * aligned_allocator
+    * 所有分配都按 Align 对齐，Align 必须是 2 的幂且不小于 alignof(T)
+    * 用于 SIMD 对齐加载，或让每个对象独占缓存行以避免伪共享
+    * *****************************************************************************************************************
+    */
+    template<class T, size_t Align = cache_line_size, class Alloc = default_alloc>
+    class aligned_allocator : public allocator<T, Alloc> {
+        static_assert((Align & (Align - 1)) == 0, "aligned_allocator: Align must be a power of two");
+        static_assert(Align >= alignof(T), "aligned_allocator: Align must not be less than alignof(T)");
+
+    public:
+        typedef allocator<T, Alloc> base_type;
+        typedef typename base_type::size_type size_type;
+
+        static const size_t alignment = Align;
+
+        // 重新绑定到对齐要求更高的类型时，使用该类型的对齐
+        template<class U>
+        struct rebind {
+            typedef aligned_allocator<U, (Align > alignof(U) ? Align : alignof(U)), Alloc> other;
+        };
+
+    public:
+        aligned_allocator() noexcept {}
+
+        template<class U, size_t OtherAlign>
+        aligned_allocator(const aligned_allocator<U, OtherAlign, Alloc>&) noexcept {}
+
+        static T* allocate() {
+            return static_cast<T*>(aligned_allocate<Alloc>(sizeof(T), Align));
+        }
+
+        static T* allocate(size_type n) {
+            return base_type::allocate(n, Align);
+        }
+
+        static void deallocate(T* ptr) {
+            aligned_deallocate<Alloc>(ptr, sizeof(T), Align);
+        }
+
+        static void deallocate(T* ptr, size_type n) {
+            base_type::deallocate(ptr, n, Align);
+        }
+
+        // 对齐分配没有额外的可用空间，也不能原地扩大
+        static allocation_result<T*, size_type> allocate_at_least(size_type n) {
+            allocation_result<T*, size_type> result = {allocate(n), n};
+            return result;
+        }
+
+        static bool try_expand(T*, size_type old_n, size_type new_n) {
+            return new_n == old_n;
+        }
+    };
+
+    // 按缓存行对齐的 allocator
+    template<class T>
+    using cache_aligned_allocator = aligned_allocator<T, cache_line_size>;
+
+    // 大数组使用 mmap 和透明大页的 allocator
+    template<class T>
+    using huge_page_allocator = allocator<T, huge_page_alloc>;
+
+    // 带线程缓存的 allocator，适合多线程频繁分配回收小对象的场景
+    template<class T>
+    using thread_cache_allocator = allocator<T, thread_cache_alloc>;
 }
@@ -0,0 +1,360 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * allocator_traits: 容器通过它访问 allocator，allocator 没有提供的成员使用默认值
+ * 支持有状态的 allocator(例如持有 memory_resource 指针的 polymorphic_allocator)
+ */
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "mabu_construct.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    // allocate_at_least 的返回值，ptr 指向至少能容纳 count 个对象的内存
+    template<class Pointer, class SizeType = size_t>
+    struct allocation_result {
+        Pointer ptr;
+        SizeType count;
+    };
+
+    // 把任意类型映射为 void，用于检测某个成员类型是否存在
+    template<class T>
+    struct void_type {
+        typedef void type;
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * 成员类型的萃取，Alloc 中有对应的成员类型时使用它，否则使用默认值
+    * *****************************************************************************************************************
+    */
+    template<class Alloc, class = void>
+    struct alloc_pointer {
+        typedef typename Alloc::value_type* type;
+    };
+
+    template<class Alloc>
+    struct alloc_pointer<Alloc, typename void_type<typename Alloc::pointer>::type> {
+        typedef typename Alloc::pointer type;
+    };
+
+    template<class Alloc, class = void>
+    struct alloc_const_pointer {
+        typedef const typename Alloc::value_type* type;
+    };
+
+    template<class Alloc>
+    struct alloc_const_pointer<Alloc, typename void_type<typename Alloc::const_pointer>::type> {
+        typedef typename Alloc::const_pointer type;
+    };
+
+    template<class Alloc, class = void>
+    struct alloc_size_type {
+        typedef size_t type;
+    };
+
+    template<class Alloc>
+    struct alloc_size_type<Alloc, typename void_type<typename Alloc::size_type>::type> {
+        typedef typename Alloc::size_type type;
+    };
+
+    template<class Alloc, class = void>
+    struct alloc_difference_type {
+        typedef ptrdiff_t type;
+    };
+
+    template<class Alloc>
+    struct alloc_difference_type<Alloc, typename void_type<typename Alloc::difference_type>::type> {
+        typedef typename Alloc::difference_type type;
+    };
+
+    template<class Alloc, class = void>
+    struct alloc_propagate_on_copy {
+        typedef std::false_type type;
+    };
+
+    template<class Alloc>
+    struct alloc_propagate_on_copy<Alloc,
+                typename void_type<typename Alloc::propagate_on_container_copy_assignment>::type> {
+        typedef typename Alloc::propagate_on_container_copy_assignment type;
+    };
+
+    template<class Alloc, class = void>
+    struct alloc_propagate_on_move {
+        typedef std::false_type type;
+    };
+
+    template<class Alloc>
+    struct alloc_propagate_on_move<Alloc,
+                typename void_type<typename Alloc::propagate_on_container_move_assignment>::type> {
+        typedef typename Alloc::propagate_on_container_move_assignment type;
+    };
+
+    template<class Alloc, class = void>
+    struct alloc_propagate_on_swap {
+        typedef std::false_type type;
+    };
+
+    template<class Alloc>
+    struct alloc_propagate_on_swap<Alloc, typename void_type<typename Alloc::propagate_on_container_swap>::type> {
+        typedef typename Alloc::propagate_on_container_swap type;
+    };
+
+    // 没有 is_always_equal 时，不含非静态数据成员的 allocator 视为总是相等
+    template<class Alloc, class = void>
+    struct alloc_is_always_equal {
+        typedef typename std::is_empty<Alloc>::type type;
+    };
+
+    template<class Alloc>
+    struct alloc_is_always_equal<Alloc, typename void_type<typename Alloc::is_always_equal>::type> {
+        typedef typename Alloc::is_always_equal type;
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * rebind: 得到分配 U 类型对象的 allocator
+    * 优先使用 Alloc::rebind<U>::other，否则把 Alloc<T, Args...> 替换为 Alloc<U, Args...>
+    * *****************************************************************************************************************
+    */
+    template<class Alloc, class U>
+    struct alloc_rebind_replace {};
+
+    template<template<class, class...> class AllocTemplate, class T, class... Args, class U>
+    struct alloc_rebind_replace<AllocTemplate<T, Args...>, U> {
+        typedef AllocTemplate<U, Args...> type;
+    };
+
+    template<class Alloc, class U, class = void>
+    struct alloc_rebind {
+        typedef typename alloc_rebind_replace<Alloc, U>::type type;
+    };
+
+    template<class Alloc, class U>
+    struct alloc_rebind<Alloc, U, typename void_type<typename Alloc::template rebind<U>::other>::type> {
+        typedef typename Alloc::template rebind<U>::other type;
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * 成员函数的检测，Alloc 提供了对应的成员函数时调用它，否则使用默认实现
+    * *****************************************************************************************************************
+    */
+    template<class Alloc, class T, class... Args>
+    struct alloc_has_construct {
+    private:
+        template<class A>
+        static auto test(int) -> decltype(std::declval<A&>().construct(std::declval<T*>(), std::declval<Args>()...),
+                                          std::true_type());
+
+        template<class A>
+        static std::false_type test(...);
+
+    public:
+        typedef decltype(test<Alloc>(0)) type;
+        static const bool value = type::value;
+    };
+
+    template<class Alloc, class T>
+    struct alloc_has_destroy {
+    private:
+        template<class A>
+        static auto test(int) -> decltype(std::declval<A&>().destroy(std::declval<T*>()), std::true_type());
+
+        template<class A>
+        static std::false_type test(...);
+
+    public:
+        typedef decltype(test<Alloc>(0)) type;
+        static const bool value = type::value;
+    };
+
+    template<class Alloc>
+    struct alloc_has_allocate_at_least {
+    private:
+        template<class A>
+        static auto test(int) -> decltype(std::declval<A&>().allocate_at_least(size_t()), std::true_type());
+
+        template<class A>
+        static std::false_type test(...);
+
+    public:
+        typedef decltype(test<Alloc>(0)) type;
+        static const bool value = type::value;
+    };
+
+    template<class Alloc, class Pointer>
+    struct alloc_has_try_expand {
+    private:
+        template<class A>
+        static auto test(int) -> decltype(std::declval<A&>().try_expand(std::declval<Pointer>(), size_t(), size_t()),
+                                          std::true_type());
+
+        template<class A>
+        static std::false_type test(...);
+
+    public:
+        typedef decltype(test<Alloc>(0)) type;
+        static const bool value = type::value;
+    };
+
+    template<class Alloc>
+    struct alloc_has_max_size {
+    private:
+        template<class A>
+        static auto test(int) -> decltype(std::declval<const A&>().max_size(), std::true_type());
+
+        template<class A>
+        static std::false_type test(...);
+
+    public:
+        typedef decltype(test<Alloc>(0)) type;
+        static const bool value = type::value;
+    };
+
+    template<class Alloc>
+    struct alloc_has_select_on_copy {
+    private:
+        template<class A>
+        static auto test(int) -> decltype(std::declval<const A&>().select_on_container_copy_construction(),
+                                          std::true_type());
+
+        template<class A>
+        static std::false_type test(...);
+
+    public:
+        typedef decltype(test<Alloc>(0)) type;
+        static const bool value = type::value;
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * allocator_traits
+    * *****************************************************************************************************************
+    */
+    template<class Alloc>
+    struct allocator_traits {
+        typedef Alloc allocator_type;
+        typedef typename Alloc::value_type value_type;
+        typedef typename alloc_pointer<Alloc>::type pointer;
+        typedef typename alloc_const_pointer<Alloc>::type const_pointer;
+        typedef typename alloc_size_type<Alloc>::type size_type;
+        typedef typename alloc_difference_type<Alloc>::type difference_type;
+
+        // 容器复制赋值 / 移动赋值 / 交换时是否连同 allocator 一起复制 / 移动 / 交换
+        typedef typename alloc_propagate_on_copy<Alloc>::type propagate_on_container_copy_assignment;
+        typedef typename alloc_propagate_on_move<Alloc>::type propagate_on_container_move_assignment;
+        typedef typename alloc_propagate_on_swap<Alloc>::type propagate_on_container_swap;
+
+        // 同类型的两个 allocator 是否总是相等(一个分配的内存可以由另一个回收)
+        typedef typename alloc_is_always_equal<Alloc>::type is_always_equal;
+
+        template<class U>
+        using rebind_alloc = typename alloc_rebind<Alloc, U>::type;
+
+        template<class U>
+        using rebind_traits = allocator_traits<rebind_alloc<U> >;
+
+        static pointer allocate(Alloc& alloc, size_type n) {
+            return alloc.allocate(n);
+        }
+
+        static void deallocate(Alloc& alloc, pointer ptr, size_type n) {
+            alloc.deallocate(ptr, n);
+        }
+
+        // 分配至少 n 个对象的空间，返回实际可用的个数，回收时可以传入 n 或 count
+        static allocation_result<pointer, size_type> allocate_at_least(Alloc& alloc, size_type n) {
+            return allocate_at_least_dispatch(typename alloc_has_allocate_at_least<Alloc>::type(), alloc, n);
+        }
+
+        // 尝试把 ptr 处 old_n 个对象的空间原地扩大到 new_n 个，成功后回收时应传入 new_n
+        static bool try_expand(Alloc& alloc, pointer ptr, size_type old_n, size_type new_n) {
+            return try_expand_dispatch(typename alloc_has_try_expand<Alloc, pointer>::type(), alloc, ptr, old_n, new_n);
+        }
+
+        template<class T, class... Args>
+        static void construct(Alloc& alloc, T* ptr, Args&&... args) {
+            construct_dispatch(typename alloc_has_construct<Alloc, T, Args...>::type(), alloc, ptr,
+                               mabustl::forward<Args>(args)...);
+        }
+
+        template<class T>
+        static void destroy(Alloc& alloc, T* ptr) {
+            destroy_dispatch(typename alloc_has_destroy<Alloc, T>::type(), alloc, ptr);
+        }
+
+        static size_type max_size(const Alloc& alloc) noexcept {
+            return max_size_dispatch(typename alloc_has_max_size<Alloc>::type(), alloc);
+        }
+
+        // 复制容器时新容器使用的 allocator
+        static Alloc select_on_container_copy_construction(const Alloc& alloc) {
+            return select_dispatch(typename alloc_has_select_on_copy<Alloc>::type(), alloc);
+        }
+
+    private:
+        static allocation_result<pointer, size_type> allocate_at_least_dispatch(std::true_type, Alloc& alloc,
+                                                                                 size_type n) {
+            return alloc.allocate_at_least(n);
+        }
+
+        static allocation_result<pointer, size_type> allocate_at_least_dispatch(std::false_type, Alloc& alloc,
+                                                                                 size_type n) {
+            allocation_result<pointer, size_type> result = {alloc.allocate(n), n};
+            return result;
+        }
+
+        static bool try_expand_dispatch(std::true_type, Alloc& alloc, pointer ptr, size_type old_n, size_type new_n) {
+            return alloc.try_expand(ptr, old_n, new_n);
+        }
+
+        static bool try_expand_dispatch(std::false_type, Alloc&, pointer, size_type old_n, size_type new_n) {
+            return new_n == old_n;
+        }
+
+        template<class T, class... Args>
+        static void construct_dispatch(std::true_type, Alloc& alloc, T* ptr, Args&&... args) {
+            alloc.construct(ptr, mabustl::forward<Args>(args)...);
+        }
+
+        template<class T, class... Args>
+        static void construct_dispatch(std::false_type, Alloc&, T* ptr, Args&&... args) {
+            mabustl::construct(ptr, mabustl::forward<Args>(args)...);
+        }
+
+        template<class T>
+        static void destroy_dispatch(std::true_type, Alloc& alloc, T* ptr) {
+            alloc.destroy(ptr);
+        }
+
+        template<class T>
+        static void destroy_dispatch(std::false_type, Alloc&, T* ptr) {
+            mabustl::destroy(ptr);
+        }
+
+        static size_type max_size_dispatch(std::true_type, const Alloc& alloc) noexcept {
+            return alloc.max_size();
+        }
+
+        static size_type max_size_dispatch(std::false_type, const Alloc&) noexcept {
+            return static_cast<size_type>(-1) / sizeof(value_type);
+        }
+
+        static Alloc select_dispatch(std::true_type, const Alloc& alloc) {
+            return alloc.select_on_container_copy_construction();
+        }
+
+        static Alloc select_dispatch(std::false_type, const Alloc& alloc) {
+            return alloc;
+        }
+    };
+}
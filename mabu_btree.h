@@ -0,0 +1,959 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * btree: btree_map 和 btree_set 的底层有序容器，key 不允许重复
+ * 红黑树每个节点只放一个元素，查找时每下降一层就是一次缓存缺失；B 树把多个元素连续放在一个节点里：
+ * (1)节点的目标大小为 BTREE_NODE_BYTES(4 个 cache line)，一个节点能放的元素个数由 sizeof(Value) 决定，
+ *    放 int 时每个节点 60 个元素，10M 个 key 的树只有 4 层
+ * (2)节点内查找：key 是算术类型并且用 less/greater 比较时，统计节点内比 key 小的元素个数，没有分支，可以向量化；
+ *    其余情况用二分查找
+ * (3)叶子节点和内部节点都存放元素，内部节点另外存放 count + 1 个子节点指针，叶子节点不分配这部分空间
+ * (4)插入位置在树的最右端(按递增顺序插入)时，不需要从根向下查找，节点分裂时左边几乎保持满载，
+ *    因此用有序区间构造或者 insert(first, last) 时每个元素摊还 O(1)，得到的叶子几乎全满，相当于批量装载
+ * (5)删除后节点的元素不足一半时，与相邻的兄弟节点合并，或者从兄弟节点借一部分元素
+ * 迭代器是双向迭代器，按 key 从小到大遍历，可以直接用于 set_union、set_intersection 等有序区间算法
+ * insert 和 erase 会在节点之间搬移元素，之后所有迭代器、指针和引用都可能失效
+ */
+
+#include <cstring>
+#include <utility>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_allocator.h"
+#include "mabu_allocator_traits.h"
+#include "mabu_functional.h"
+#include "mabu_iterator.h"
+#include "mabu_stddef.h"
+#include "mabu_type_traits.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    // 节点的目标大小
+    constexpr size_t BTREE_NODE_BYTES = 4 * cache_line_size;
+
+    // 叶子节点，内部节点在它后面接上子节点指针
+    template<class Value, size_t Slots>
+    struct btree_node {
+        btree_node* parent;         // 根节点为 nullptr
+        unsigned short position;    // 在父节点中是第几个子节点
+        unsigned short count;       // 元素个数
+        bool leaf;
+        typename std::aligned_storage<sizeof(Value), alignof(Value)>::type slots[Slots];
+
+        Value* value(size_t i) noexcept { return reinterpret_cast<Value*>(slots + i); }
+        const Value* value(size_t i) const noexcept { return reinterpret_cast<const Value*>(slots + i); }
+
+        btree_node* child(size_t i) const noexcept;
+
+        // 把 c 放到第 i 个子节点的位置，同时更新 c 的 parent 和 position
+        void set_child(size_t i, btree_node* c) noexcept;
+    };
+
+    template<class Value, size_t Slots>
+    struct btree_internal_node : public btree_node<Value, Slots> {
+        btree_node<Value, Slots>* children[Slots + 1];
+    };
+
+    template<class Value, size_t Slots>
+    btree_node<Value, Slots>* btree_node<Value, Slots>::child(size_t i) const noexcept {
+        return static_cast<const btree_internal_node<Value, Slots>*>(this)->children[i];
+    }
+
+    template<class Value, size_t Slots>
+    void btree_node<Value, Slots>::set_child(size_t i, btree_node* c) noexcept {
+        static_cast<btree_internal_node<Value, Slots>*>(this)->children[i] = c;
+        c->parent = this;
+        c->position = static_cast<unsigned short>(i);
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * btree_iterator
+    * 由节点和节点内的位置组成，end() 是最右叶子的 count 位置
+    * 叶子内部前进后退只改 position，走出叶子时才向上或向下找相邻的元素
+    * *****************************************************************************************************************
+    */
+    template<class Node, class Value, class Ref, class Ptr>
+    struct btree_iterator : public mabustl::iterator<bidirectional_iterator_tag, Value, ptrdiff_t, Ptr, Ref> {
+        typedef btree_iterator<Node, Value, Ref, Ptr> self;
+
+        typedef Value value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+
+        Node* node;
+        int position;
+
+        btree_iterator() noexcept: node(nullptr), position(0) {}
+
+        btree_iterator(Node* n, int pos) noexcept: node(n), position(pos) {}
+
+        // iterator 可以转换为 const_iterator
+        template<class R, class P, typename std::enable_if<std::is_convertible<P, Ptr>::value, int>::type = 0>
+        btree_iterator(const btree_iterator<Node, Value, R, P>& rhs) noexcept
+            : node(rhs.node), position(rhs.position) {}
+
+        reference operator*() const { return *node->value(position); }
+        pointer operator->() const { return node->value(position); }
+
+        self& operator++() {
+            if(node->leaf && ++position < node->count) return *this;
+            increment_slow();
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        self& operator--() {
+            if(node->leaf && --position >= 0) return *this;
+            decrement_slow();
+            return *this;
+        }
+
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        void increment_slow() noexcept;
+
+        void decrement_slow() noexcept;
+
+        friend bool operator==(const self& lhs, const self& rhs) {
+            return lhs.node == rhs.node && lhs.position == rhs.position;
+        }
+
+        friend bool operator!=(const self& lhs, const self& rhs) { return !(lhs == rhs); }
+    };
+
+    // 叶子走到末尾时向上找第一个还有元素的祖先，一直到根都没有说明已经是 end()；
+    // 内部节点的下一个元素是右侧子树最左边的叶子的第一个元素
+    template<class Node, class Value, class Ref, class Ptr>
+    void btree_iterator<Node, Value, Ref, Ptr>::increment_slow() noexcept {
+        if(node->leaf) {
+            const self save = *this;
+            while(position == node->count && node->parent) {
+                position = node->position;
+                node = node->parent;
+            }
+            if(position == node->count) *this = save;
+        } else {
+            node = node->child(position + 1);
+            while(!node->leaf) node = node->child(0);
+            position = 0;
+        }
+    }
+
+    template<class Node, class Value, class Ref, class Ptr>
+    void btree_iterator<Node, Value, Ref, Ptr>::decrement_slow() noexcept {
+        if(node->leaf) {
+            const self save = *this;
+            while(position < 0 && node->parent) {
+                position = node->position - 1;
+                node = node->parent;
+            }
+            if(position < 0) *this = save;
+        } else {
+            node = node->child(position);
+            while(!node->leaf) node = node->child(node->count);
+            position = node->count - 1;
+        }
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * btree
+    * Policy 提供 key_type、init_type(emplace 时临时元素的类型，key 可以移动)、
+    * static const key_type& key(const Value&) 和 key(const init_type&)，
+    * 以及 static void transfer(Alloc&, Value* dst, Value* src) noexcept(把 src 移动构造到 dst 并析构 src)
+    * *****************************************************************************************************************
+    */
+    template<class Value, class Policy, class Compare, class Alloc>
+    class btree {
+    public:
+        typedef typename Policy::key_type key_type;
+        typedef Value value_type;
+        typedef Compare key_compare;
+        typedef Alloc allocator_type;
+        typedef allocator_traits<Alloc> alloc_traits;
+
+        typedef typename alloc_traits::size_type size_type;
+        typedef typename alloc_traits::difference_type difference_type;
+        typedef Value& reference;
+        typedef const Value& const_reference;
+        typedef Value* pointer;
+        typedef const Value* const_pointer;
+
+        // 每个节点的元素个数，至少为 3；元素少于 MIN_SLOTS 的非根节点需要合并或借元素
+        enum : size_t {
+            NODE_SLOTS = (BTREE_NODE_BYTES - 2 * sizeof(void*)) / sizeof(Value) < 3 ? 3 :
+                         (BTREE_NODE_BYTES - 2 * sizeof(void*)) / sizeof(Value) > 255 ? 255 :
+                         (BTREE_NODE_BYTES - 2 * sizeof(void*)) / sizeof(Value),
+            MIN_SLOTS = NODE_SLOTS / 2
+        };
+
+        typedef btree_node<Value, NODE_SLOTS> node_type;
+        typedef btree_internal_node<Value, NODE_SLOTS> internal_node_type;
+
+        typedef btree_iterator<node_type, Value, Value&, Value*> iterator;
+        typedef btree_iterator<node_type, Value, const Value&, const Value*> const_iterator;
+
+    private:
+        typedef typename alloc_traits::template rebind_alloc<node_type> leaf_allocator;
+        typedef typename alloc_traits::template rebind_alloc<internal_node_type> internal_allocator;
+        typedef allocator_traits<leaf_allocator> leaf_traits;
+        typedef allocator_traits<internal_allocator> internal_traits;
+
+        // 搬移元素时能否直接 memmove
+        typedef std::integral_constant<bool, is_trivially_relocatable<Value>::value &&
+                                             allocator_uses_default_construct<Alloc>::value> relocate_by_memcpy;
+
+        // relocate 在分裂、合并节点的中途调用，不能抛异常，否则树的结构会被破坏
+        static_assert(relocate_by_memcpy::value || noexcept(Policy::transfer(std::declval<Alloc&>(),
+                                                                             std::declval<Value*>(),
+                                                                             std::declval<Value*>())),
+                      "btree: Policy::transfer must not throw");
+
+        // 节点内是否用无分支的线性查找
+        typedef std::integral_constant<bool, std::is_arithmetic<key_type>::value &&
+                                             (std::is_same<Compare, mabustl::less<key_type> >::value ||
+                                              std::is_same<Compare, mabustl::greater<key_type> >::value)>
+        linear_search;
+
+        // 继承 allocator，不含状态的 allocator 不占用空间
+        struct btree_impl : public Alloc {
+            node_type* root_;
+            node_type* leftmost_;     // 第一个叶子，begin() 所在的节点
+            node_type* rightmost_;    // 最后一个叶子，end() 所在的节点
+            size_type size_;
+
+            explicit btree_impl(const Alloc& alloc)
+                : Alloc(alloc), root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), size_(0) {}
+        };
+
+        btree_impl impl_;
+        key_compare comp_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        btree(const Compare& comp, const Alloc& alloc): impl_(alloc), comp_(comp) {}
+
+        btree(const btree& rhs)
+            : impl_(alloc_traits::select_on_container_copy_construction(rhs.get_alloc())), comp_(rhs.comp_) {
+            try {
+                copy_from(rhs);
+            } catch(...) {
+                clear();
+                throw;
+            }
+        }
+
+        btree(btree&& rhs) noexcept: impl_(mabustl::move(rhs.get_alloc())), comp_(rhs.comp_) {
+            steal(rhs);
+        }
+
+        btree& operator=(const btree& rhs);
+
+        btree& operator=(btree&& rhs);
+
+        ~btree() {
+            clear();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept { return iterator(impl_.leftmost_, 0); }
+        const_iterator begin() const noexcept { return iterator(impl_.leftmost_, 0); }
+
+        iterator end() noexcept {
+            return iterator(impl_.rightmost_, impl_.rightmost_ ? impl_.rightmost_->count : 0);
+        }
+
+        const_iterator end() const noexcept {
+            return iterator(impl_.rightmost_, impl_.rightmost_ ? impl_.rightmost_->count : 0);
+        }
+
+        // 容量相关操作
+        bool empty() const noexcept { return impl_.size_ == 0; }
+        size_type size() const noexcept { return impl_.size_; }
+        size_type max_size() const noexcept { return alloc_traits::max_size(get_alloc()); }
+
+        // 查找相关操作
+        iterator find(const key_type& key) { return internal_find(key); }
+        const_iterator find(const key_type& key) const { return internal_find(key); }
+
+        size_type count(const key_type& key) const { return internal_find(key) == end() ? 0 : 1; }
+        bool contains(const key_type& key) const { return internal_find(key) != end(); }
+
+        iterator lower_bound(const key_type& key) { return internal_lower_bound(key); }
+        const_iterator lower_bound(const key_type& key) const { return internal_lower_bound(key); }
+
+        iterator upper_bound(const key_type& key) { return internal_upper_bound(key); }
+        const_iterator upper_bound(const key_type& key) const { return internal_upper_bound(key); }
+
+        // 插入相关操作，key 已存在时返回指向已有元素的迭代器和 false
+        pair<iterator, bool> insert_unique(const value_type& value) {
+            return insert_with(Policy::key(value), [&value](Alloc& alloc, Value* p) {
+                alloc_traits::construct(alloc, p, value);
+            });
+        }
+
+        pair<iterator, bool> insert_unique(value_type&& value) {
+            return insert_with(Policy::key(value), [&value](Alloc& alloc, Value* p) {
+                alloc_traits::construct(alloc, p, mabustl::move(value));
+            });
+        }
+
+        // 必须先构造出元素才能得到 key，临时元素的 key 不是 const，插入时可以移动
+        template<class... Args>
+        pair<iterator, bool> emplace_unique(Args&&... args) {
+            typename Policy::init_type tmp(mabustl::forward<Args>(args)...);
+            return insert_with(Policy::key(tmp), [&tmp](Alloc& alloc, Value* p) {
+                alloc_traits::construct(alloc, p, mabustl::move(tmp));
+            });
+        }
+
+        // key 不存在时调用 make(alloc, p) 在 p 处构造元素，make 构造的元素的 key 必须等于 key
+        template<class Maker>
+        pair<iterator, bool> insert_with(const key_type& key, Maker make);
+
+        // 元素应当放在 hint 之前时不需要从根向下查找，否则退化为 insert_with
+        template<class Maker>
+        iterator insert_hint_with(const_iterator hint, const key_type& key, Maker make);
+
+        // 删除相关操作，返回被删除元素的下一个位置
+        iterator erase(const_iterator pos);
+
+        iterator erase(const_iterator first, const_iterator last);
+
+        size_type erase_key(const key_type& key) {
+            const iterator it = internal_find(key);
+            if(it == end()) return 0;
+            erase(it);
+            return 1;
+        }
+
+        // 析构所有元素并释放所有节点
+        void clear() noexcept;
+
+        void swap(btree& rhs) noexcept;
+
+        key_compare key_comp() const { return comp_; }
+        allocator_type get_allocator() const { return impl_; }
+
+    private:
+        Alloc& get_alloc() noexcept { return impl_; }
+        const Alloc& get_alloc() const noexcept { return impl_; }
+
+        const key_type& key_at(const node_type* n, int i) const noexcept { return Policy::key(*n->value(i)); }
+
+        // 节点内第一个不小于 key 的位置
+        int node_lower_bound(const node_type* n, const key_type& key) const {
+            return node_lower_bound(n, key, linear_search());
+        }
+
+        int node_lower_bound(const node_type* n, const key_type& key, std::true_type) const {
+            int i = 0;
+            for(int j = 0; j != n->count; ++j) i += comp_(key_at(n, j), key);
+            return i;
+        }
+
+        int node_lower_bound(const node_type* n, const key_type& key, std::false_type) const {
+            int lo = 0, hi = n->count;
+            while(lo < hi) {
+                const int mid = (lo + hi) >> 1;
+                if(comp_(key_at(n, mid), key)) lo = mid + 1;
+                else hi = mid;
+            }
+            return lo;
+        }
+
+        // 节点内第一个大于 key 的位置
+        int node_upper_bound(const node_type* n, const key_type& key) const {
+            return node_upper_bound(n, key, linear_search());
+        }
+
+        int node_upper_bound(const node_type* n, const key_type& key, std::true_type) const {
+            int i = 0;
+            for(int j = 0; j != n->count; ++j) i += !comp_(key, key_at(n, j));
+            return i;
+        }
+
+        int node_upper_bound(const node_type* n, const key_type& key, std::false_type) const {
+            int lo = 0, hi = n->count;
+            while(lo < hi) {
+                const int mid = (lo + hi) >> 1;
+                if(comp_(key, key_at(n, mid))) hi = mid;
+                else lo = mid + 1;
+            }
+            return lo;
+        }
+
+        iterator internal_end() const noexcept {
+            return iterator(impl_.rightmost_, impl_.rightmost_ ? impl_.rightmost_->count : 0);
+        }
+
+        // 叶子中的位置可能是 count，向上找到真正的下一个元素
+        iterator internal_last(iterator it) const noexcept {
+            while(it.node && it.position == it.node->count) {
+                it.position = it.node->position;
+                it.node = it.node->parent;
+            }
+            return it.node ? it : internal_end();
+        }
+
+        iterator internal_find(const key_type& key) const;
+
+        iterator internal_lower_bound(const key_type& key) const;
+
+        iterator internal_upper_bound(const key_type& key) const;
+
+        // it 指向叶子中的插入位置，节点已满时先分裂
+        template<class Maker>
+        iterator internal_emplace(iterator it, Maker& make);
+
+        // 分裂 it 所在的满节点，父节点也满时先递归分裂父节点，之后 it 指向新的插入位置
+        void split_for_insert(iterator& it);
+
+        void split_node(node_type* n, int insert_position, node_type* dest) noexcept;
+
+        // 删除后从 it 所在的叶子开始向上合并或借元素，返回删除位置的下一个元素
+        iterator rebalance_after_erase(iterator it);
+
+        bool try_merge_or_rebalance(iterator& it);
+
+        // 把 right 和父节点中的分隔元素一起并入 left，然后释放 right
+        void merge_nodes(node_type* left, node_type* right) noexcept;
+
+        // 从右兄弟借 to_move 个元素(经过父节点中转)
+        void rebalance_right_to_left(node_type* left, node_type* right, int to_move) noexcept;
+
+        void rebalance_left_to_right(node_type* left, node_type* right, int to_move) noexcept;
+
+        // 根节点没有元素时降低树高，树为空时释放根节点
+        void try_shrink() noexcept;
+
+        // 节点的分配和释放
+        node_type* new_leaf_node() {
+            leaf_allocator alloc(get_alloc());
+            node_type* n = leaf_traits::allocate(alloc, 1);
+            n->parent = nullptr;
+            n->position = 0;
+            n->count = 0;
+            n->leaf = true;
+            return n;
+        }
+
+        node_type* new_internal_node() {
+            internal_allocator alloc(get_alloc());
+            node_type* n = internal_traits::allocate(alloc, 1);
+            n->parent = nullptr;
+            n->position = 0;
+            n->count = 0;
+            n->leaf = false;
+            return n;
+        }
+
+        void delete_node(node_type* n) noexcept {
+            if(n->leaf) {
+                leaf_allocator alloc(get_alloc());
+                leaf_traits::deallocate(alloc, n, 1);
+            } else {
+                internal_allocator alloc(get_alloc());
+                internal_traits::deallocate(alloc, static_cast<internal_node_type*>(n), 1);
+            }
+        }
+
+        // 析构子树中的所有元素并释放节点
+        void clear_node(node_type* n) noexcept;
+
+        // 把 [src, src + n) 搬到 dst，两个区间可以重叠
+        void relocate(Value* dst, Value* src, size_type n) noexcept {
+            if(n != 0) relocate(dst, src, n, relocate_by_memcpy());
+        }
+
+        void relocate(Value* dst, Value* src, size_type n, std::true_type) noexcept {
+            std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(Value));
+        }
+
+        void relocate(Value* dst, Value* src, size_type n, std::false_type) noexcept {
+            if(dst < src) {
+                for(size_type i = 0; i != n; ++i) Policy::transfer(get_alloc(), dst + i, src + i);
+            } else {
+                for(size_type i = n; i != 0; --i) Policy::transfer(get_alloc(), dst + i - 1, src + i - 1);
+            }
+        }
+
+        // 把 n 中 [first, count] 的子节点整体右移 shift 个位置
+        static void shift_children_right(node_type* n, int first, int shift) noexcept {
+            for(int i = n->count; i >= first; --i) n->set_child(i + shift, n->child(i));
+        }
+
+        // 有序并且互不相同的 rhs 逐个追加到最右端
+        void copy_from(const btree& rhs);
+
+        void steal(btree& rhs) noexcept {
+            impl_.root_ = rhs.impl_.root_;
+            impl_.leftmost_ = rhs.impl_.leftmost_;
+            impl_.rightmost_ = rhs.impl_.rightmost_;
+            impl_.size_ = rhs.impl_.size_;
+            rhs.impl_.root_ = rhs.impl_.leftmost_ = rhs.impl_.rightmost_ = nullptr;
+            rhs.impl_.size_ = 0;
+        }
+
+        // 调用前已 clear()，旧节点都由原 allocator 释放
+        void copy_alloc(const btree& rhs, std::true_type) {
+            get_alloc() = rhs.get_alloc();
+        }
+
+        void copy_alloc(const btree&, std::false_type) {}
+
+        void move_alloc(btree& rhs, std::true_type) {
+            get_alloc() = mabustl::move(rhs.get_alloc());
+        }
+
+        void move_alloc(btree&, std::false_type) {}
+
+        void swap_alloc(btree& rhs, std::true_type) {
+            mabustl::swap(get_alloc(), rhs.get_alloc());
+        }
+
+        void swap_alloc(btree&, std::false_type) {}
+    };
+
+    /*****************************************************************************************************************/
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    btree<Value, Policy, Compare, Alloc>& btree<Value, Policy, Compare, Alloc>::operator=(const btree& rhs) {
+        if(this == &rhs) return *this;
+        clear();
+        copy_alloc(rhs, typename alloc_traits::propagate_on_container_copy_assignment());
+        comp_ = rhs.comp_;
+        copy_from(rhs);
+        return *this;
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    btree<Value, Policy, Compare, Alloc>& btree<Value, Policy, Compare, Alloc>::operator=(btree&& rhs) {
+        if(this == &rhs) return *this;
+        clear();
+        comp_ = rhs.comp_;
+        if(alloc_traits::propagate_on_container_move_assignment::value ||
+           alloc_traits::is_always_equal::value || get_alloc() == rhs.get_alloc()) {
+            move_alloc(rhs, typename alloc_traits::propagate_on_container_move_assignment());
+            steal(rhs);
+        } else {
+            // allocator 不相等，只能逐个移动元素
+            for(iterator it = rhs.begin(); it != rhs.end(); ++it) insert_unique(mabustl::move(*it));
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    void btree<Value, Policy, Compare, Alloc>::clear() noexcept {
+        if(impl_.root_ != nullptr) clear_node(impl_.root_);
+        impl_.root_ = impl_.leftmost_ = impl_.rightmost_ = nullptr;
+        impl_.size_ = 0;
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    void btree<Value, Policy, Compare, Alloc>::clear_node(node_type* n) noexcept {
+        if(!(std::is_trivially_destructible<Value>::value && allocator_uses_default_construct<Alloc>::value)) {
+            for(int i = 0; i != n->count; ++i) alloc_traits::destroy(get_alloc(), n->value(i));
+        }
+        if(!n->leaf) {
+            for(int i = 0; i <= n->count; ++i) clear_node(n->child(i));
+        }
+        delete_node(n);
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    void btree<Value, Policy, Compare, Alloc>::swap(btree& rhs) noexcept {
+        if(this == &rhs) return;
+        mabustl::swap(impl_.root_, rhs.impl_.root_);
+        mabustl::swap(impl_.leftmost_, rhs.impl_.leftmost_);
+        mabustl::swap(impl_.rightmost_, rhs.impl_.rightmost_);
+        mabustl::swap(impl_.size_, rhs.impl_.size_);
+        mabustl::swap(comp_, rhs.comp_);
+        swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    void btree<Value, Policy, Compare, Alloc>::copy_from(const btree& rhs) {
+        for(const_iterator it = rhs.begin(); it != rhs.end(); ++it) insert_unique(*it);
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * 查找
+    * key 互不相同，find 在内部节点遇到相等的 key 就可以停下；lower_bound 和 upper_bound 一直走到叶子，
+    * 叶子中的位置是 count 时再向上找到真正的下一个元素
+    * *****************************************************************************************************************
+    */
+    template<class Value, class Policy, class Compare, class Alloc>
+    typename btree<Value, Policy, Compare, Alloc>::iterator
+    btree<Value, Policy, Compare, Alloc>::internal_find(const key_type& key) const {
+        node_type* n = impl_.root_;
+        if(n == nullptr) return internal_end();
+        while(true) {
+            const int i = node_lower_bound(n, key);
+            if(i != n->count && !comp_(key, key_at(n, i))) return iterator(n, i);
+            if(n->leaf) return internal_end();
+            n = n->child(i);
+        }
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    typename btree<Value, Policy, Compare, Alloc>::iterator
+    btree<Value, Policy, Compare, Alloc>::internal_lower_bound(const key_type& key) const {
+        node_type* n = impl_.root_;
+        if(n == nullptr) return internal_end();
+        while(true) {
+            const int i = node_lower_bound(n, key);
+            if(n->leaf) return internal_last(iterator(n, i));
+            n = n->child(i);
+        }
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    typename btree<Value, Policy, Compare, Alloc>::iterator
+    btree<Value, Policy, Compare, Alloc>::internal_upper_bound(const key_type& key) const {
+        node_type* n = impl_.root_;
+        if(n == nullptr) return internal_end();
+        while(true) {
+            const int i = node_upper_bound(n, key);
+            if(n->leaf) return internal_last(iterator(n, i));
+            n = n->child(i);
+        }
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * 插入
+    * 新元素总是放在叶子中；新 key 比最大的 key 还大时直接追加到最右叶子的末尾
+    * *****************************************************************************************************************
+    */
+    template<class Value, class Policy, class Compare, class Alloc>
+    template<class Maker>
+    pair<typename btree<Value, Policy, Compare, Alloc>::iterator, bool>
+    btree<Value, Policy, Compare, Alloc>::insert_with(const key_type& key, Maker make) {
+        if(impl_.root_ == nullptr) {
+            node_type* n = new_leaf_node();
+            try {
+                make(get_alloc(), n->value(0));
+            } catch(...) {
+                delete_node(n);
+                throw;
+            }
+            n->count = 1;
+            impl_.root_ = impl_.leftmost_ = impl_.rightmost_ = n;
+            impl_.size_ = 1;
+            return pair<iterator, bool>(iterator(n, 0), true);
+        }
+
+        node_type* last = impl_.rightmost_;
+        if(comp_(key_at(last, last->count - 1), key)) {
+            return pair<iterator, bool>(internal_emplace(iterator(last, last->count), make), true);
+        }
+
+        node_type* n = impl_.root_;
+        while(true) {
+            const int i = node_lower_bound(n, key);
+            if(i != n->count && !comp_(key, key_at(n, i))) return pair<iterator, bool>(iterator(n, i), false);
+            if(n->leaf) return pair<iterator, bool>(internal_emplace(iterator(n, i), make), true);
+            n = n->child(i);
+        }
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    template<class Maker>
+    typename btree<Value, Policy, Compare, Alloc>::iterator
+    btree<Value, Policy, Compare, Alloc>::insert_hint_with(const_iterator hint, const key_type& key, Maker make) {
+        iterator pos(hint.node, hint.position);
+        if(!empty() && (pos == end() || comp_(key, Policy::key(*pos)))) {
+            iterator prev = pos;
+            if(pos == begin() || comp_(Policy::key(*--prev), key)) {
+                // 内部节点中的元素之前的位置就是前一个元素(一定在叶子中)之后的位置
+                if(!pos.node->leaf) {
+                    pos = prev;
+                    ++pos.position;
+                }
+                return internal_emplace(pos, make);
+            }
+        }
+        return insert_with(key, make).first;
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    template<class Maker>
+    typename btree<Value, Policy, Compare, Alloc>::iterator
+    btree<Value, Policy, Compare, Alloc>::internal_emplace(iterator it, Maker& make) {
+        if(it.node->count == NODE_SLOTS) split_for_insert(it);
+        node_type* n = it.node;
+        const int i = it.position;
+        relocate(n->value(i + 1), n->value(i), n->count - i);
+        try {
+            make(get_alloc(), n->value(i));
+        } catch(...) {
+            relocate(n->value(i), n->value(i + 1), n->count - i);
+            throw;
+        }
+        ++n->count;
+        ++impl_.size_;
+        return it;
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    void btree<Value, Policy, Compare, Alloc>::split_for_insert(iterator& it) {
+        node_type*& n = it.node;
+        int& insert_position = it.position;
+        node_type* dest = n->leaf ? new_leaf_node() : new_internal_node();
+        node_type* parent = n->parent;
+        try {
+            if(parent == nullptr) {
+                parent = new_internal_node();
+                parent->set_child(0, n);
+                impl_.root_ = parent;
+            } else if(parent->count == NODE_SLOTS) {
+                iterator parent_it(parent, n->position);
+                split_for_insert(parent_it);
+            }
+        } catch(...) {
+            delete_node(dest);
+            throw;
+        }
+        split_node(n, insert_position, dest);
+        if(impl_.rightmost_ == n) impl_.rightmost_ = dest;
+        if(insert_position > n->count) {
+            insert_position -= n->count + 1;
+            n = dest;
+        }
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * split_node
+    * 把满节点 n 后面的一部分元素移到 dest，n 的最后一个元素上移到父节点作为 n 和 dest 的分隔元素
+    * 插入位置在末尾(递增插入)时 dest 只分到一个元素，n 保持几乎满载；否则平分
+    * 两边都至少留一个元素，插入时 make 抛出异常也不会留下空节点
+    * *****************************************************************************************************************
+    */
+    template<class Value, class Policy, class Compare, class Alloc>
+    void btree<Value, Policy, Compare, Alloc>::split_node(node_type* n, int insert_position,
+                                                          node_type* dest) noexcept {
+        const int to_move = insert_position == static_cast<int>(NODE_SLOTS) ? 1 : n->count / 2;
+        n->count = static_cast<unsigned short>(n->count - to_move);
+        relocate(dest->value(0), n->value(n->count), to_move);
+        dest->count = static_cast<unsigned short>(to_move);
+
+        --n->count;
+        node_type* parent = n->parent;
+        const int pos = n->position;
+        relocate(parent->value(pos + 1), parent->value(pos), parent->count - pos);
+        relocate(parent->value(pos), n->value(n->count), 1);
+        shift_children_right(parent, pos + 1, 1);
+        parent->set_child(pos + 1, dest);
+        ++parent->count;
+
+        if(!n->leaf) {
+            for(int i = 0; i <= to_move; ++i) dest->set_child(i, n->child(n->count + 1 + i));
+        }
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * 删除
+    * 内部节点中的元素用它的前一个元素(左子树最右叶子的最后一个元素)顶替，实际总是从叶子中删除
+    * 之后从叶子开始向上处理元素不足的节点
+    * *****************************************************************************************************************
+    */
+    template<class Value, class Policy, class Compare, class Alloc>
+    typename btree<Value, Policy, Compare, Alloc>::iterator
+    btree<Value, Policy, Compare, Alloc>::erase(const_iterator pos) {
+        iterator it(pos.node, pos.position);
+        bool internal_delete = false;
+        alloc_traits::destroy(get_alloc(), it.node->value(it.position));
+        if(!it.node->leaf) {
+            iterator internal_it = it;
+            --it;
+            relocate(internal_it.node->value(internal_it.position), it.node->value(it.position), 1);
+            internal_delete = true;
+        }
+        node_type* n = it.node;
+        relocate(n->value(it.position), n->value(it.position + 1), n->count - it.position - 1);
+        --n->count;
+        --impl_.size_;
+
+        // 从内部节点删除时，下一个元素是顶替上去的前一个元素之后的那个
+        iterator res = rebalance_after_erase(it);
+        if(internal_delete) ++res;
+        return res;
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    typename btree<Value, Policy, Compare, Alloc>::iterator
+    btree<Value, Policy, Compare, Alloc>::erase(const_iterator first, const_iterator last) {
+        if(first == begin() && last == end()) {
+            clear();
+            return end();
+        }
+        difference_type n = mabustl::distance(first, last);
+        iterator it(first.node, first.position);
+        while(n-- > 0) it = erase(it);
+        return it;
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    typename btree<Value, Policy, Compare, Alloc>::iterator
+    btree<Value, Policy, Compare, Alloc>::rebalance_after_erase(iterator it) {
+        iterator res(it);
+        bool first_iteration = true;
+        while(true) {
+            if(it.node == impl_.root_) {
+                try_shrink();
+                if(empty()) return end();
+                break;
+            }
+            if(it.node->count >= MIN_SLOTS) break;
+            const bool merged = try_merge_or_rebalance(it);
+            // 合并或借元素后叶子中的元素位置可能变了
+            if(first_iteration) {
+                res = it;
+                first_iteration = false;
+            }
+            if(!merged) break;
+            it.position = it.node->position;
+            it.node = it.node->parent;
+        }
+        if(res.position == res.node->count) {
+            res.position = res.node->count - 1;
+            ++res;
+        }
+        return res;
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * try_merge_or_rebalance
+    * 依次尝试：与左兄弟合并、与右兄弟合并、从右兄弟借、从左兄弟借，合并后父节点少一个元素，需要继续向上处理
+    * 删除的是节点的第一个(最后一个)元素时不从右(左)兄弟借，连续从前(后)删除时不会每次都搬移元素
+    * *****************************************************************************************************************
+    */
+    template<class Value, class Policy, class Compare, class Alloc>
+    bool btree<Value, Policy, Compare, Alloc>::try_merge_or_rebalance(iterator& it) {
+        node_type* parent = it.node->parent;
+        if(it.node->position > 0) {
+            node_type* left = parent->child(it.node->position - 1);
+            if(1u + left->count + it.node->count <= NODE_SLOTS) {
+                it.position += 1 + left->count;
+                merge_nodes(left, it.node);
+                it.node = left;
+                return true;
+            }
+        }
+        if(it.node->position < parent->count) {
+            node_type* right = parent->child(it.node->position + 1);
+            if(1u + it.node->count + right->count <= NODE_SLOTS) {
+                merge_nodes(it.node, right);
+                return true;
+            }
+            if(right->count > MIN_SLOTS && (it.node->count == 0 || it.position > 0)) {
+                const int to_move = mabustl::min((right->count - it.node->count) / 2, right->count - 1);
+                rebalance_right_to_left(it.node, right, to_move);
+                return false;
+            }
+        }
+        if(it.node->position > 0) {
+            node_type* left = parent->child(it.node->position - 1);
+            if(left->count > MIN_SLOTS && (it.node->count == 0 || it.position < it.node->count)) {
+                const int to_move = mabustl::min((left->count - it.node->count) / 2, left->count - 1);
+                rebalance_left_to_right(left, it.node, to_move);
+                it.position += to_move;
+                return false;
+            }
+        }
+        return false;
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    void btree<Value, Policy, Compare, Alloc>::merge_nodes(node_type* left, node_type* right) noexcept {
+        node_type* parent = left->parent;
+        const int pos = left->position;
+        relocate(left->value(left->count), parent->value(pos), 1);
+        relocate(left->value(left->count + 1), right->value(0), right->count);
+        if(!left->leaf) {
+            for(int i = 0; i <= right->count; ++i) left->set_child(left->count + 1 + i, right->child(i));
+        }
+        left->count = static_cast<unsigned short>(left->count + 1 + right->count);
+
+        // 父节点中去掉分隔元素和 right
+        relocate(parent->value(pos), parent->value(pos + 1), parent->count - pos - 1);
+        for(int i = pos + 2; i <= parent->count; ++i) parent->set_child(i - 1, parent->child(i));
+        --parent->count;
+
+        if(impl_.rightmost_ == right) impl_.rightmost_ = left;
+        delete_node(right);
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    void btree<Value, Policy, Compare, Alloc>::rebalance_right_to_left(node_type* left, node_type* right,
+                                                                       int to_move) noexcept {
+        node_type* parent = left->parent;
+        const int pos = left->position;
+        // 分隔元素下移到 left 末尾，right 的前 to_move - 1 个元素跟在后面，right 的第 to_move 个元素上移
+        relocate(left->value(left->count), parent->value(pos), 1);
+        relocate(left->value(left->count + 1), right->value(0), to_move - 1);
+        relocate(parent->value(pos), right->value(to_move - 1), 1);
+        relocate(right->value(0), right->value(to_move), right->count - to_move);
+        if(!left->leaf) {
+            for(int i = 0; i < to_move; ++i) left->set_child(left->count + 1 + i, right->child(i));
+            for(int i = 0; i <= right->count - to_move; ++i) right->set_child(i, right->child(i + to_move));
+        }
+        left->count = static_cast<unsigned short>(left->count + to_move);
+        right->count = static_cast<unsigned short>(right->count - to_move);
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    void btree<Value, Policy, Compare, Alloc>::rebalance_left_to_right(node_type* left, node_type* right,
+                                                                       int to_move) noexcept {
+        node_type* parent = left->parent;
+        const int pos = left->position;
+        // 与 rebalance_right_to_left 对称，先给 right 的开头腾出 to_move 个位置
+        relocate(right->value(to_move), right->value(0), right->count);
+        relocate(right->value(to_move - 1), parent->value(pos), 1);
+        relocate(right->value(0), left->value(left->count - to_move + 1), to_move - 1);
+        relocate(parent->value(pos), left->value(left->count - to_move), 1);
+        if(!left->leaf) {
+            shift_children_right(right, 0, to_move);
+            for(int i = 0; i < to_move; ++i) right->set_child(i, left->child(left->count - to_move + 1 + i));
+        }
+        left->count = static_cast<unsigned short>(left->count - to_move);
+        right->count = static_cast<unsigned short>(right->count + to_move);
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    void btree<Value, Policy, Compare, Alloc>::try_shrink() noexcept {
+        node_type* root = impl_.root_;
+        if(root->count > 0) return;
+        if(root->leaf) {
+            impl_.root_ = impl_.leftmost_ = impl_.rightmost_ = nullptr;
+        } else {
+            node_type* child = root->child(0);
+            child->parent = nullptr;
+            child->position = 0;
+            impl_.root_ = child;
+        }
+        delete_node(root);
+    }
+}
@@ -0,0 +1,309 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * btree_map: 以 btree 为底层的有序映射，key 不允许重复
+ * 元素按 key 从小到大排列，多个元素连续存放在一个节点里，insert 和 erase 后迭代器、指针和引用都可能失效
+ * 用有序区间构造或 insert(first, last) 时元素逐个追加到最右端，不需要查找
+ */
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_allocator.h"
+#include "mabu_btree.h"
+#include "mabu_functional.h"
+#include "mabu_iterator.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    template<class Key, class T>
+    struct btree_map_policy {
+        typedef Key key_type;
+        typedef pair<const Key, T> value_type;
+        typedef pair<Key, T> init_type;
+
+        static const Key& key(const value_type& value) noexcept {
+            return value.first;
+        }
+
+        static const Key& key(const init_type& value) noexcept {
+            return value.first;
+        }
+
+        // 原元素随后就会析构，通过 map_slot 从可修改的 key 移动构造
+        template<class Alloc>
+        static void transfer(Alloc& alloc, value_type* dst, value_type* src)
+            noexcept(std::is_nothrow_move_constructible<Key>::value && std::is_nothrow_move_constructible<T>::value) {
+            allocator_traits<Alloc>::construct(alloc, dst, mabustl::move(mabustl::map_slot_mutable(src)));
+            allocator_traits<Alloc>::destroy(alloc, src);
+        }
+    };
+
+    template<class Key, class T, class Compare = mabustl::less<Key>,
+             class Alloc = mabustl::allocator<pair<const Key, T> > >
+    class btree_map {
+    private:
+        typedef btree<pair<const Key, T>, btree_map_policy<Key, T>, Compare, Alloc> base_type;
+
+        base_type tree_;
+
+    public:
+        typedef Key key_type;
+        typedef T mapped_type;
+        typedef typename base_type::value_type value_type;
+        typedef typename base_type::key_compare key_compare;
+        typedef typename base_type::allocator_type allocator_type;
+
+        typedef typename base_type::size_type size_type;
+        typedef typename base_type::difference_type difference_type;
+        typedef typename base_type::pointer pointer;
+        typedef typename base_type::const_pointer const_pointer;
+        typedef typename base_type::reference reference;
+        typedef typename base_type::const_reference const_reference;
+
+        typedef typename base_type::iterator iterator;
+        typedef typename base_type::const_iterator const_iterator;
+        typedef mabustl::reverse_iterator<iterator> reverse_iterator;
+        typedef mabustl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        // 按 key 比较两个元素
+        class value_compare : public binary_function<value_type, value_type, bool> {
+            friend class btree_map;
+
+        private:
+            Compare comp_;
+
+            explicit value_compare(const Compare& comp): comp_(comp) {}
+
+        public:
+            bool operator()(const value_type& lhs, const value_type& rhs) const {
+                return comp_(lhs.first, rhs.first);
+            }
+        };
+
+    public:
+        // 构造、复制、移动函数
+        btree_map(): tree_(Compare(), Alloc()) {}
+
+        explicit btree_map(const Compare& comp, const Alloc& alloc = Alloc()): tree_(comp, alloc) {}
+
+        explicit btree_map(const Alloc& alloc): tree_(Compare(), alloc) {}
+
+        template<class InputIter, typename std::enable_if<mabustl::is_input_iterator<InputIter>::value, int>::type = 0>
+        btree_map(InputIter first, InputIter last, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : tree_(comp, alloc) {
+            insert(first, last);
+        }
+
+        btree_map(std::initializer_list<value_type> ilist, const Compare& comp = Compare(),
+                  const Alloc& alloc = Alloc())
+            : tree_(comp, alloc) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        btree_map(const btree_map& rhs): tree_(rhs.tree_) {}
+
+        btree_map(btree_map&& rhs) noexcept: tree_(mabustl::move(rhs.tree_)) {}
+
+        btree_map& operator=(const btree_map& rhs) {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+
+        btree_map& operator=(btree_map&& rhs) {
+            tree_ = mabustl::move(rhs.tree_);
+            return *this;
+        }
+
+        btree_map& operator=(std::initializer_list<value_type> ilist) {
+            tree_.clear();
+            insert(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        ~btree_map() = default;
+
+        // 迭代器相关操作
+        iterator begin() noexcept { return tree_.begin(); }
+        const_iterator begin() const noexcept { return tree_.begin(); }
+        iterator end() noexcept { return tree_.end(); }
+        const_iterator end() const noexcept { return tree_.end(); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return tree_.begin(); }
+        const_iterator cend() const noexcept { return tree_.end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return tree_.empty(); }
+        size_type size() const noexcept { return tree_.size(); }
+        size_type max_size() const noexcept { return tree_.max_size(); }
+
+        // 插入删除相关操作
+        template<class... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            return tree_.emplace_unique(mabustl::forward<Args>(args)...);
+        }
+
+        template<class... Args>
+        iterator emplace_hint(const_iterator hint, Args&&... args) {
+            pair<Key, T> tmp(mabustl::forward<Args>(args)...);
+            return tree_.insert_hint_with(hint, tmp.first, [&tmp](Alloc& alloc, value_type* p) {
+                allocator_traits<Alloc>::construct(alloc, p, mabustl::move(tmp));
+            });
+        }
+
+        // key 不存在时才构造 mapped_type
+        template<class... Args>
+        pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+            return tree_.insert_with(key, [&](Alloc& alloc, value_type* p) {
+                allocator_traits<Alloc>::construct(alloc, p, key, mapped_type(mabustl::forward<Args>(args)...));
+            });
+        }
+
+        template<class... Args>
+        pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+            return tree_.insert_with(key, [&](Alloc& alloc, value_type* p) {
+                allocator_traits<Alloc>::construct(alloc, p, mabustl::move(key),
+                                                   mapped_type(mabustl::forward<Args>(args)...));
+            });
+        }
+
+        pair<iterator, bool> insert(const value_type& value) {
+            return tree_.insert_unique(value);
+        }
+
+        pair<iterator, bool> insert(value_type&& value) {
+            return tree_.insert_unique(mabustl::move(value));
+        }
+
+        iterator insert(const_iterator hint, const value_type& value) {
+            return tree_.insert_hint_with(hint, value.first, [&value](Alloc& alloc, value_type* p) {
+                allocator_traits<Alloc>::construct(alloc, p, value);
+            });
+        }
+
+        iterator insert(const_iterator hint, value_type&& value) {
+            return tree_.insert_hint_with(hint, value.first, [&value](Alloc& alloc, value_type* p) {
+                allocator_traits<Alloc>::construct(alloc, p, mabustl::move(value));
+            });
+        }
+
+        // 有序输入每次都追加到最右端
+        template<class InputIter>
+        void insert(InputIter first, InputIter last) {
+            for(; first != last; ++first) tree_.insert_unique(*first);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        template<class M>
+        pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+            pair<iterator, bool> result = try_emplace(key, mabustl::forward<M>(obj));
+            if(!result.second) result.first->second = mabustl::forward<M>(obj);
+            return result;
+        }
+
+        iterator erase(const_iterator pos) { return tree_.erase(pos); }
+        iterator erase(const_iterator first, const_iterator last) { return tree_.erase(first, last); }
+        size_type erase(const key_type& key) { return tree_.erase_key(key); }
+
+        void clear() noexcept { tree_.clear(); }
+
+        void swap(btree_map& rhs) noexcept { tree_.swap(rhs.tree_); }
+
+        // 查找相关操作
+        mapped_type& at(const key_type& key) {
+            iterator it = tree_.find(key);
+            THROW_OUT_OF_LENGTH_IF(it == tree_.end(), "btree_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        const mapped_type& at(const key_type& key) const {
+            const_iterator it = tree_.find(key);
+            THROW_OUT_OF_LENGTH_IF(it == tree_.end(), "btree_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        mapped_type& operator[](const key_type& key) {
+            return try_emplace(key).first->second;
+        }
+
+        mapped_type& operator[](key_type&& key) {
+            return try_emplace(mabustl::move(key)).first->second;
+        }
+
+        size_type count(const key_type& key) const { return tree_.count(key); }
+
+        bool contains(const key_type& key) const { return tree_.contains(key); }
+
+        iterator find(const key_type& key) { return tree_.find(key); }
+        const_iterator find(const key_type& key) const { return tree_.find(key); }
+
+        iterator lower_bound(const key_type& key) { return tree_.lower_bound(key); }
+        const_iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+        iterator upper_bound(const key_type& key) { return tree_.upper_bound(key); }
+        const_iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator> equal_range(const key_type& key) {
+            iterator it = tree_.lower_bound(key);
+            iterator last = it;
+            if(it != tree_.end() && !key_comp()(key, it->first)) ++last;
+            return pair<iterator, iterator>(it, last);
+        }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+            const_iterator it = tree_.lower_bound(key);
+            const_iterator last = it;
+            if(it != tree_.end() && !key_comp()(key, it->first)) ++last;
+            return pair<const_iterator, const_iterator>(it, last);
+        }
+
+        key_compare key_comp() const { return tree_.key_comp(); }
+        value_compare value_comp() const { return value_compare(tree_.key_comp()); }
+        allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+    public:
+        friend bool operator==(const btree_map& lhs, const btree_map& rhs) {
+            return lhs.size() == rhs.size() && mabustl::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator!=(const btree_map& lhs, const btree_map& rhs) {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator<(const btree_map& lhs, const btree_map& rhs) {
+            return mabustl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+        friend bool operator>(const btree_map& lhs, const btree_map& rhs) {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const btree_map& lhs, const btree_map& rhs) {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const btree_map& lhs, const btree_map& rhs) {
+            return !(lhs < rhs);
+        }
+    };
+
+    // 重载 mabustl 的 swap
+    template<class Key, class T, class Compare, class Alloc>
+    void swap(btree_map<Key, T, Compare, Alloc>& lhs, btree_map<Key, T, Compare, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * btree_set: 以 btree 为底层的有序集合，元素不允许重复
+ * 元素从小到大排列，多个元素连续存放在一个节点里，insert 和 erase 后迭代器、指针和引用都可能失效
+ * 迭代器可以直接作为 set_union、set_intersection 等算法的输入；用有序区间构造时元素逐个追加到最右端
+ */
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_allocator.h"
+#include "mabu_btree.h"
+#include "mabu_functional.h"
+#include "mabu_iterator.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    template<class Key>
+    struct btree_set_policy {
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Key init_type;
+
+        static const Key& key(const value_type& value) noexcept {
+            return value;
+        }
+
+        template<class Alloc>
+        static void transfer(Alloc& alloc, value_type* dst, value_type* src)
+            noexcept(std::is_nothrow_move_constructible<Key>::value) {
+            allocator_traits<Alloc>::construct(alloc, dst, mabustl::move(*src));
+            allocator_traits<Alloc>::destroy(alloc, src);
+        }
+    };
+
+    template<class Key, class Compare = mabustl::less<Key>, class Alloc = mabustl::allocator<Key> >
+    class btree_set {
+    private:
+        typedef btree<Key, btree_set_policy<Key>, Compare, Alloc> base_type;
+
+        base_type tree_;
+
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Key init_type;
+        typedef typename base_type::key_compare key_compare;
+        typedef typename base_type::key_compare value_compare;
+        typedef typename base_type::allocator_type allocator_type;
+
+        typedef typename base_type::size_type size_type;
+        typedef typename base_type::difference_type difference_type;
+        typedef typename base_type::const_pointer pointer;
+        typedef typename base_type::const_pointer const_pointer;
+        typedef typename base_type::const_reference reference;
+        typedef typename base_type::const_reference const_reference;
+
+        // 修改元素会破坏顺序，所以 iterator 也是 const 的
+        typedef typename base_type::const_iterator iterator;
+        typedef typename base_type::const_iterator const_iterator;
+        typedef mabustl::reverse_iterator<iterator> reverse_iterator;
+        typedef mabustl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    public:
+        // 构造、复制、移动函数
+        btree_set(): tree_(Compare(), Alloc()) {}
+
+        explicit btree_set(const Compare& comp, const Alloc& alloc = Alloc()): tree_(comp, alloc) {}
+
+        explicit btree_set(const Alloc& alloc): tree_(Compare(), alloc) {}
+
+        template<class InputIter, typename std::enable_if<mabustl::is_input_iterator<InputIter>::value, int>::type = 0>
+        btree_set(InputIter first, InputIter last, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : tree_(comp, alloc) {
+            insert(first, last);
+        }
+
+        btree_set(std::initializer_list<value_type> ilist, const Compare& comp = Compare(),
+                  const Alloc& alloc = Alloc())
+            : tree_(comp, alloc) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        btree_set(const btree_set& rhs): tree_(rhs.tree_) {}
+
+        btree_set(btree_set&& rhs) noexcept: tree_(mabustl::move(rhs.tree_)) {}
+
+        btree_set& operator=(const btree_set& rhs) {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+
+        btree_set& operator=(btree_set&& rhs) {
+            tree_ = mabustl::move(rhs.tree_);
+            return *this;
+        }
+
+        btree_set& operator=(std::initializer_list<value_type> ilist) {
+            tree_.clear();
+            insert(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        ~btree_set() = default;
+
+        // 迭代器相关操作
+        iterator begin() const noexcept { return tree_.begin(); }
+        iterator end() const noexcept { return tree_.end(); }
+        reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+        reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+        const_iterator cbegin() const noexcept { return tree_.begin(); }
+        const_iterator cend() const noexcept { return tree_.end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return tree_.empty(); }
+        size_type size() const noexcept { return tree_.size(); }
+        size_type max_size() const noexcept { return tree_.max_size(); }
+
+        // 插入删除相关操作
+        template<class... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            return tree_.emplace_unique(mabustl::forward<Args>(args)...);
+        }
+
+        template<class... Args>
+        iterator emplace_hint(const_iterator hint, Args&&... args) {
+            value_type tmp(mabustl::forward<Args>(args)...);
+            return insert(hint, mabustl::move(tmp));
+        }
+
+        pair<iterator, bool> insert(const value_type& value) {
+            return tree_.insert_unique(value);
+        }
+
+        pair<iterator, bool> insert(value_type&& value) {
+            return tree_.insert_unique(mabustl::move(value));
+        }
+
+        iterator insert(const_iterator hint, const value_type& value) {
+            return tree_.insert_hint_with(hint, value, [&value](Alloc& alloc, value_type* p) {
+                allocator_traits<Alloc>::construct(alloc, p, value);
+            });
+        }
+
+        iterator insert(const_iterator hint, value_type&& value) {
+            return tree_.insert_hint_with(hint, value, [&value](Alloc& alloc, value_type* p) {
+                allocator_traits<Alloc>::construct(alloc, p, mabustl::move(value));
+            });
+        }
+
+        // 有序输入每次都追加到最右端
+        template<class InputIter>
+        void insert(InputIter first, InputIter last) {
+            for(; first != last; ++first) tree_.insert_unique(*first);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        iterator erase(const_iterator pos) { return tree_.erase(pos); }
+        iterator erase(const_iterator first, const_iterator last) { return tree_.erase(first, last); }
+        size_type erase(const key_type& key) { return tree_.erase_key(key); }
+
+        void clear() noexcept { tree_.clear(); }
+
+        void swap(btree_set& rhs) noexcept { tree_.swap(rhs.tree_); }
+
+        // 查找相关操作
+        size_type count(const key_type& key) const { return tree_.count(key); }
+
+        bool contains(const key_type& key) const { return tree_.contains(key); }
+
+        iterator find(const key_type& key) const { return tree_.find(key); }
+
+        iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+        iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator> equal_range(const key_type& key) const {
+            iterator it = tree_.lower_bound(key);
+            iterator last = it;
+            if(it != tree_.end() && !key_comp()(key, *it)) ++last;
+            return pair<iterator, iterator>(it, last);
+        }
+
+        key_compare key_comp() const { return tree_.key_comp(); }
+        value_compare value_comp() const { return tree_.key_comp(); }
+        allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+    public:
+        friend bool operator==(const btree_set& lhs, const btree_set& rhs) {
+            return lhs.size() == rhs.size() && mabustl::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator!=(const btree_set& lhs, const btree_set& rhs) {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator<(const btree_set& lhs, const btree_set& rhs) {
+            return mabustl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+        friend bool operator>(const btree_set& lhs, const btree_set& rhs) {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const btree_set& lhs, const btree_set& rhs) {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const btree_set& lhs, const btree_set& rhs) {
+            return !(lhs < rhs);
+        }
+    };
+
+    // 重载 mabustl 的 swap
+    template<class Key, class Compare, class Alloc>
+    void swap(btree_set<Key, Compare, Alloc>& lhs, btree_set<Key, Compare, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
@@ -7,6 +7,7 @@
 
 #include <new>
 #include "mabu_iterator.h"
+#include "mabu_stddef.h"
 #include "mabu_type_traits.h"
 #include "mabu_utility.h"
 
@@ -18,19 +19,23 @@
 
 namespace mabustl {
     // construct 创建对象
+    // placement new 不会修正地址，ptr 必须已经按 alignof(T) 对齐，over-aligned 类型的内存应由 allocator 分配
 
     template<class T>
     void construct(T* ptr) {
+        MABUSTL_DEBUG(reinterpret_cast<size_t>(ptr) % alignof(T) == 0);
         ::new((void*) ptr) T();
     }
 
     template<class T1, class T2>
     void construct(T1* ptr, const T2& value) {
+        MABUSTL_DEBUG(reinterpret_cast<size_t>(ptr) % alignof(T1) == 0);
         ::new((void*) ptr) T1(value);
     }
 
     template<class T, class... Args>
     void construct(T* ptr, Args&&... args) {
+        MABUSTL_DEBUG(reinterpret_cast<size_t>(ptr) % alignof(T) == 0);
         ::new((void*) ptr) T(mabustl::forward<Args>(args)...);
     }
 
@@ -45,7 +50,7 @@ namespace mabustl {
     }
 
     template<class ForwardIter>
-    void destroy_cat(ForwardIter iter1, ForwardIter iter2, std::true_type) {}
+    void destroy_cat(ForwardIter, ForwardIter, std::true_type) {}
 
     template<class ForwardIter>
     void destroy_cat(ForwardIter first, ForwardIter last, std::false_type) {
@@ -58,14 +63,15 @@ namespace mabustl {
         }
     }
 
+    // 平凡析构的类型不需要调用析构函数
     template<class T>
     void destroy(T* ptr) {
-        destroy_one(ptr, std::is_trivially_copy_assignable<T>{});
+        destroy_one(ptr, std::is_trivially_destructible<T>{});
     }
 
     template<class Iterator>
     void destroy(Iterator first, Iterator last) {
-        destroy_cat(first, last, std::is_trivially_constructible<typename iterator_traits<Iterator>::value_type>{});
+        destroy_cat(first, last, std::is_trivially_destructible<typename iterator_traits<Iterator>::value_type>{});
     }
 }
 
@@ -0,0 +1,436 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * d_ary_heap: 每个节点有 D 个子节点的堆，默认为大根堆
+ * 节点 i 的子节点是 D * i + 1 ... D * i + D，在数组中连续存放，下沉时一层只访问一组子节点，
+ * 树高只有二叉堆的 1 / log2(D)，元素很多时每层一次的缓存缺失随之减少
+ *
+ * 子节点组按缓存行对齐：
+ * 数组开头空出 D - 1 个位置(不构造对象)，根节点放在第 D - 1 个位置，于是节点 i 的子节点组从第 D * (i + 1)
+ * 个位置开始，每组的起始地址都是 D * sizeof(T) 的整数倍。默认的 cache_aligned_allocator 按缓存行对齐分配，
+ * D * sizeof(T) 能整除或是缓存行大小的整数倍时(如 D = 4 / 8 的 int、指针、double、16 字节的定时器项)，
+ * 每组子节点都不会跨缓存行。换成 mabustl::allocator<T> 可以去掉对齐，只保留连续的布局
+ *
+ * 元素直接用 construct / destroy 构造和析构，所以 Alloc 必须使用默认的 construct
+ */
+
+#include <initializer_list>
+
+#include "mabu_allocator.h"
+#include "mabu_allocator_traits.h"
+#include "mabu_construct.h"
+#include "mabu_functional.h"
+#include "mabu_heap_algorithm.h"
+#include "mabu_iterator.h"
+#include "mabu_stddef.h"
+#include "mabu_type_traits.h"
+#include "mabu_uninitialized.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    template<class T, size_t D = 4, class Compare = mabustl::less<T>, class Alloc = mabustl::cache_aligned_allocator<T> >
+    class d_ary_heap {
+        static_assert(D >= 2, "d_ary_heap: D must be at least 2");
+        static_assert(std::is_same<T, typename Alloc::value_type>::value, "d_ary_heap: Alloc::value_type must be T");
+        static_assert(allocator_uses_default_construct<Alloc>::value,
+                      "d_ary_heap: Alloc must construct elements with placement new");
+
+    public:
+        typedef T value_type;
+        typedef Compare value_compare;
+        typedef Alloc allocator_type;
+        typedef allocator_traits<Alloc> alloc_traits;
+        typedef typename alloc_traits::size_type size_type;
+        typedef typename alloc_traits::difference_type difference_type;
+
+        typedef T& reference;
+        typedef const T& const_reference;
+
+        static const size_t arity = D;
+
+    private:
+        // 根节点之前空出的位置数
+        static const size_type PAD = D - 1;
+
+        // 继承 allocator，不含状态的 allocator 不占用空间
+        struct d_ary_heap_impl : public Alloc {
+            T* buf_;          // 分配得到的空间，包括开头的 PAD 个空位
+            size_type size_;
+            size_type cap_;   // 可以存放的元素个数，不包括空位
+
+            d_ary_heap_impl(): Alloc(), buf_(nullptr), size_(0), cap_(0) {}
+
+            explicit d_ary_heap_impl(const Alloc& alloc): Alloc(alloc), buf_(nullptr), size_(0), cap_(0) {}
+        };
+
+        d_ary_heap_impl impl_;
+        Compare comp_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        d_ary_heap(): impl_(), comp_() {}
+
+        explicit d_ary_heap(const Compare& comp, const Alloc& alloc = Alloc()): impl_(alloc), comp_(comp) {}
+
+        template<class InputIter, typename std::enable_if<mabustl::is_input_iterator<InputIter>::value, int>::type = 0>
+        d_ary_heap(InputIter first, InputIter last, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : impl_(alloc), comp_(comp) {
+            push_range(first, last);
+        }
+
+        d_ary_heap(std::initializer_list<T> ilist, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : impl_(alloc), comp_(comp) {
+            push_range(ilist.begin(), ilist.end());
+        }
+
+        d_ary_heap(const d_ary_heap& rhs)
+            : impl_(alloc_traits::select_on_container_copy_construction(rhs.get_alloc())), comp_(rhs.comp_) {
+            copy_from(rhs);
+        }
+
+        d_ary_heap(d_ary_heap&& rhs) noexcept: impl_(mabustl::move(rhs.get_alloc())), comp_(rhs.comp_) {
+            steal(rhs);
+        }
+
+        d_ary_heap& operator=(const d_ary_heap& rhs);
+        d_ary_heap& operator=(d_ary_heap&& rhs);
+
+        ~d_ary_heap() {
+            destroy_and_deallocate();
+        }
+
+        // 访问元素相关操作
+        const_reference top() const {
+            MABUSTL_DEBUG(!empty());
+            return data()[0];
+        }
+
+        // 容量相关操作
+        bool empty() const noexcept { return impl_.size_ == 0; }
+        size_type size() const noexcept { return impl_.size_; }
+        size_type capacity() const noexcept { return impl_.cap_; }
+        size_type max_size() const noexcept { return alloc_traits::max_size(get_alloc()) - PAD; }
+
+        void reserve(size_type n);
+
+        // 修改容器相关操作
+        void push(const T& value) {
+            emplace(value);
+        }
+
+        void push(T&& value) {
+            emplace(mabustl::move(value));
+        }
+
+        template<class... Args>
+        void emplace(Args&&... args);
+
+        // 追加[first, last)后按需要整体重建堆，见 push_range 的定义
+        template<class InputIter>
+        void push_range(InputIter first, InputIter last);
+
+        void pop();
+
+        // 相当于 pop 之后再 push(value)，但只做一次下沉，定时器重新调度时常用
+        void replace_top(T value);
+
+        void clear() noexcept {
+            mabustl::destroy(data(), data() + impl_.size_);
+            impl_.size_ = 0;
+        }
+
+        void swap(d_ary_heap& rhs) noexcept;
+
+        allocator_type get_allocator() const { return get_alloc(); }
+        value_compare value_comp() const { return comp_; }
+
+    private:
+        Alloc& get_alloc() noexcept { return impl_; }
+        const Alloc& get_alloc() const noexcept { return impl_; }
+
+        // 根节点的位置，没有分配空间时 buf_ 为空，返回的指针也只用于空区间
+        T* data() noexcept { return impl_.buf_ + (impl_.buf_ ? PAD : 0); }
+        const T* data() const noexcept { return impl_.buf_ + (impl_.buf_ ? PAD : 0); }
+
+        void reallocate(size_type new_cap);
+        void grow_if_full();
+
+        // 节点 child ... child + D - 1 的子节点是连续的 D * D 个元素，下沉前先预取下一层，
+        // 这样在比较本层时下一层的缓存缺失已经在处理中
+        void prefetch_grandchildren(size_type child, size_type n) const noexcept {
+            const size_type first = D * child + 1;
+            if(first >= n) return;
+            const size_type last = first + D * D < n ? first + D * D : n;
+            const char* p = reinterpret_cast<const char*>(data() + first);
+            const char* end = reinterpret_cast<const char*>(data() + last);
+            for(; p < end; p += cache_line_size) mabustl::prefetch(p);
+        }
+
+        void sift_up(size_type hole, size_type top, T&& value);
+        void sift_down(size_type hole, T&& value);
+        void make_heap();
+
+        void copy_from(const d_ary_heap& rhs);
+
+        void steal(d_ary_heap& rhs) noexcept {
+            impl_.buf_ = rhs.impl_.buf_;
+            impl_.size_ = rhs.impl_.size_;
+            impl_.cap_ = rhs.impl_.cap_;
+            rhs.impl_.buf_ = nullptr;
+            rhs.impl_.size_ = rhs.impl_.cap_ = 0;
+        }
+
+        void destroy_and_deallocate() noexcept {
+            if(impl_.buf_ == nullptr) return;
+            clear();
+            alloc_traits::deallocate(get_alloc(), impl_.buf_, impl_.cap_ + PAD);
+            impl_.buf_ = nullptr;
+            impl_.cap_ = 0;
+        }
+
+        // 传播前先用当前 allocator 释放旧空间
+        void copy_alloc(const d_ary_heap& rhs, std::true_type) {
+            if(get_alloc() != rhs.get_alloc()) destroy_and_deallocate();
+            get_alloc() = rhs.get_alloc();
+        }
+
+        void copy_alloc(const d_ary_heap&, std::false_type) {}
+
+        void move_alloc(d_ary_heap& rhs, std::true_type) {
+            get_alloc() = mabustl::move(rhs.get_alloc());
+        }
+
+        void move_alloc(d_ary_heap&, std::false_type) {}
+
+        void swap_alloc(d_ary_heap& rhs, std::true_type) {
+            mabustl::swap(get_alloc(), rhs.get_alloc());
+        }
+
+        void swap_alloc(d_ary_heap&, std::false_type) {}
+    };
+
+    /*****************************************************************************************************************/
+
+    template<class T, size_t D, class Compare, class Alloc>
+    d_ary_heap<T, D, Compare, Alloc>& d_ary_heap<T, D, Compare, Alloc>::operator=(const d_ary_heap& rhs) {
+        if(this == &rhs) return *this;
+        copy_alloc(rhs, typename alloc_traits::propagate_on_container_copy_assignment());
+        clear();
+        comp_ = rhs.comp_;
+        copy_from(rhs);
+        return *this;
+    }
+
+    // 移动赋值：能接管 rhs 的内存时直接接管，否则逐个移动元素
+    template<class T, size_t D, class Compare, class Alloc>
+    d_ary_heap<T, D, Compare, Alloc>& d_ary_heap<T, D, Compare, Alloc>::operator=(d_ary_heap&& rhs) {
+        if(this == &rhs) return *this;
+        comp_ = rhs.comp_;
+        if(alloc_traits::propagate_on_container_move_assignment::value ||
+           alloc_traits::is_always_equal::value || get_alloc() == rhs.get_alloc()) {
+            destroy_and_deallocate();
+            move_alloc(rhs, typename alloc_traits::propagate_on_container_move_assignment());
+            steal(rhs);
+        } else {
+            clear();
+            reserve(rhs.size());
+            mabustl::uninitialized_move(rhs.data(), rhs.data() + rhs.size(), data());
+            impl_.size_ = rhs.size();
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    // 复制 rhs 的元素，调用前 *this 必须为空，rhs 已经是堆，按原顺序复制即可
+    template<class T, size_t D, class Compare, class Alloc>
+    void d_ary_heap<T, D, Compare, Alloc>::copy_from(const d_ary_heap& rhs) {
+        reserve(rhs.size());
+        mabustl::uninitialized_copy(rhs.data(), rhs.data() + rhs.size(), data());
+        impl_.size_ = rhs.size();
+    }
+
+    template<class T, size_t D, class Compare, class Alloc>
+    void d_ary_heap<T, D, Compare, Alloc>::reserve(size_type n) {
+        if(n <= capacity()) return;
+        THROW_LENGTH_ERROR_IF(n > max_size(), "d_ary_heap<T> reserve() n too big");
+        reallocate(n);
+    }
+
+    // 分配新空间并把元素搬过去，可平凡重定位的类型直接 memcpy
+    template<class T, size_t D, class Compare, class Alloc>
+    void d_ary_heap<T, D, Compare, Alloc>::reallocate(size_type new_cap) {
+        T* new_buf = alloc_traits::allocate(get_alloc(), new_cap + PAD);
+        try {
+            mabustl::uninitialized_relocate(data(), data() + impl_.size_, new_buf + PAD);
+        } catch(...) {
+            alloc_traits::deallocate(get_alloc(), new_buf, new_cap + PAD);
+            throw;
+        }
+        if(impl_.buf_) alloc_traits::deallocate(get_alloc(), impl_.buf_, impl_.cap_ + PAD);
+        impl_.buf_ = new_buf;
+        impl_.cap_ = new_cap;
+    }
+
+    template<class T, size_t D, class Compare, class Alloc>
+    void d_ary_heap<T, D, Compare, Alloc>::grow_if_full() {
+        if(impl_.size_ < impl_.cap_) return;
+        THROW_LENGTH_ERROR_IF(impl_.size_ == max_size(), "d_ary_heap<T> size too big");
+        // 分配的总数(包括空位)保持为 D 的倍数，容量翻倍
+        size_type new_cap = impl_.cap_ == 0 ? D * 4 - PAD : impl_.cap_ * 2 + PAD;
+        if(new_cap > max_size() || new_cap < impl_.cap_) new_cap = max_size();
+        reallocate(new_cap);
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * sift_up / sift_down
+    * 与 mabu_heap_algorithm.h 中的 push_heap_aux / adjust_heap 相同，都是移动"空洞"而不是交换元素
+    * sift_down 先让空洞沿最大的子节点下沉到叶子(每层比较 D - 1 次)，再把 value 从那里上溯
+    * *****************************************************************************************************************
+    */
+    template<class T, size_t D, class Compare, class Alloc>
+    void d_ary_heap<T, D, Compare, Alloc>::sift_up(size_type hole, size_type top, T&& value) {
+        T* base = data();
+        while(hole > top) {
+            const size_type parent = (hole - 1) / D;
+            if(!comp_(base[parent], value)) break;
+            base[hole] = mabustl::move(base[parent]);
+            hole = parent;
+        }
+        base[hole] = mabustl::move(value);
+    }
+
+    template<class T, size_t D, class Compare, class Alloc>
+    void d_ary_heap<T, D, Compare, Alloc>::sift_down(size_type hole, T&& value) {
+        T* base = data();
+        const size_type n = impl_.size_;
+        const size_type top = hole;
+        size_type child = D * hole + 1;
+        // 完整的子节点组，D 是常量，内层循环会被展开
+        while(child + D <= n) {
+            prefetch_grandchildren(child, n);
+            size_type best = child;
+            for(size_type k = 1; k < D; ++k) {
+                if(comp_(base[best], base[child + k])) best = child + k;
+            }
+            base[hole] = mabustl::move(base[best]);
+            hole = best;
+            child = D * hole + 1;
+        }
+        // 最后一组子节点不满
+        if(child < n) {
+            size_type best = child;
+            for(size_type k = child + 1; k < n; ++k) {
+                if(comp_(base[best], base[k])) best = k;
+            }
+            base[hole] = mabustl::move(base[best]);
+            hole = best;
+        }
+        sift_up(hole, top, mabustl::move(value));
+    }
+
+    // Floyd 建堆：从最后一个非叶子节点开始向前逐个下沉
+    template<class T, size_t D, class Compare, class Alloc>
+    void d_ary_heap<T, D, Compare, Alloc>::make_heap() {
+        const size_type n = impl_.size_;
+        if(n < 2) return;
+        T* base = data();
+        size_type hole = (n - 2) / D;
+        while(true) {
+            T value = mabustl::move(base[hole]);
+            sift_down(hole, mabustl::move(value));
+            if(hole == 0) return;
+            --hole;
+        }
+    }
+
+    template<class T, size_t D, class Compare, class Alloc>
+    template<class... Args>
+    void d_ary_heap<T, D, Compare, Alloc>::emplace(Args&&... args) {
+        grow_if_full();
+        T* slot = data() + impl_.size_;
+        mabustl::construct(slot, mabustl::forward<Args>(args)...);
+        ++impl_.size_;
+        if(impl_.size_ > 1) {
+            T value = mabustl::move(*slot);
+            sift_up(impl_.size_ - 1, 0, mabustl::move(value));
+        }
+    }
+
+    template<class T, size_t D, class Compare, class Alloc>
+    void d_ary_heap<T, D, Compare, Alloc>::pop() {
+        MABUSTL_DEBUG(!empty());
+        T* base = data();
+        const size_type last = --impl_.size_;
+        if(last != 0) {
+            T value = mabustl::move(base[last]);
+            mabustl::destroy(base + last);
+            sift_down(0, mabustl::move(value));
+        } else {
+            mabustl::destroy(base);
+        }
+    }
+
+    template<class T, size_t D, class Compare, class Alloc>
+    void d_ary_heap<T, D, Compare, Alloc>::replace_top(T value) {
+        MABUSTL_DEBUG(!empty());
+        sift_down(0, mabustl::move(value));
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * push_range
+    * 逐个上溯或者 Floyd 重建，与 priority_queue::push_range 一样由 prefer_make_heap 按 D 叉堆的代价选择
+    * *****************************************************************************************************************
+    */
+    template<class T, size_t D, class Compare, class Alloc>
+    template<class InputIter>
+    void d_ary_heap<T, D, Compare, Alloc>::push_range(InputIter first, InputIter last) {
+        const size_type old_size = impl_.size_;
+        try {
+            for(; first != last; ++first) {
+                grow_if_full();
+                mabustl::construct(data() + impl_.size_, *first);
+                ++impl_.size_;
+            }
+        } catch(...) {
+            // 已经追加的元素保留下来，重新成堆后再抛出
+            make_heap();
+            throw;
+        }
+        const size_type new_size = impl_.size_;
+        const size_type count = new_size - old_size;
+        if(count == 0) return;
+
+        if(mabustl::prefer_make_heap(old_size, new_size, static_cast<size_type>(D))) {
+            make_heap();
+        } else {
+            T* base = data();
+            for(size_type i = old_size; i < new_size; ++i) {
+                T value = mabustl::move(base[i]);
+                sift_up(i, 0, mabustl::move(value));
+            }
+        }
+    }
+
+    template<class T, size_t D, class Compare, class Alloc>
+    void d_ary_heap<T, D, Compare, Alloc>::swap(d_ary_heap& rhs) noexcept {
+        if(this == &rhs) return;
+        swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+        mabustl::swap(impl_.buf_, rhs.impl_.buf_);
+        mabustl::swap(impl_.size_, rhs.impl_.size_);
+        mabustl::swap(impl_.cap_, rhs.impl_.cap_);
+        mabustl::swap(comp_, rhs.comp_);
+    }
+
+    // 重载 mabustl 的 swap
+    template<class T, size_t D, class Compare, class Alloc>
+    void swap(d_ary_heap<T, D, Compare, Alloc>& lhs, d_ary_heap<T, D, Compare, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,1283 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * deque: 双端队列，两端插入、删除都是 O(1)，并且不移动已有元素
+ * 元素存放在若干大小相同的缓冲区中，由一个中控器 map 按顺序保存各缓冲区的地址
+ * 缓冲区大小：sizeof(T) 小于 256 时为 4096 / sizeof(T) 个元素，否则为 16 个
+ * (1)默认构造和移动后的 deque 不分配任何内存，第一次插入时才建立 map
+ * (2)尾部总留有一个可用的位置(end_.cur < end_.last)，缓冲区用完时才分配下一个
+ * (3)pop 使某个缓冲区变空时立即释放它，两端都预留的 map 空间不够时，
+ *    先尝试在原 map 中居中，map 使用不足一半时才重新分配更大的 map
+ * deque 的迭代器是分段迭代器，copy move fill 等算法会逐个缓冲区处理(见 mabu_algorithm_base.h)
+ */
+
+#include <initializer_list>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_allocator.h"
+#include "mabu_allocator_traits.h"
+#include "mabu_iterator.h"
+#include "mabu_stddef.h"
+#include "mabu_type_traits.h"
+#include "mabu_uninitialized.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    // 每个缓冲区容纳的元素个数
+    template<class T>
+    struct deque_buf_size {
+        static constexpr size_t value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * deque_iterator
+    * cur 指向当前元素，[first, last) 为当前缓冲区，node 指向 map 中保存当前缓冲区地址的位置
+    * *****************************************************************************************************************
+    */
+    template<class T, class Ref, class Ptr>
+    struct deque_iterator : public iterator<random_access_iterator_tag, T> {
+        typedef deque_iterator<T, T&, T*> iterator;
+        typedef deque_iterator<T, const T&, const T*> const_iterator;
+        typedef deque_iterator self;
+
+        typedef T value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef T* value_pointer;
+        typedef T** map_pointer;
+
+        static constexpr size_type buffer_size = deque_buf_size<T>::value;
+
+        value_pointer cur;
+        value_pointer first;
+        value_pointer last;
+        map_pointer node;
+
+        // 构造、复制函数
+        deque_iterator() noexcept: cur(nullptr), first(nullptr), last(nullptr), node(nullptr) {}
+
+        deque_iterator(value_pointer v, map_pointer n) noexcept: cur(v), first(*n), last(*n + buffer_size), node(n) {}
+
+        // iterator 可以转换为 const_iterator
+        template<class R, class P, typename std::enable_if<std::is_convertible<P, Ptr>::value, int>::type = 0>
+        deque_iterator(const deque_iterator<T, R, P>& rhs) noexcept
+            : cur(rhs.cur), first(rhs.first), last(rhs.last), node(rhs.node) {}
+
+        // 跳到 new_node 所指的缓冲区，cur 由调用者设置
+        void set_node(map_pointer new_node) noexcept {
+            node = new_node;
+            first = *new_node;
+            last = first + buffer_size;
+        }
+
+        // 重载运算符
+        reference operator*() const { return *cur; }
+        pointer operator->() const { return cur; }
+
+        self& operator++() {
+            ++cur;
+            if(cur == last) {
+                set_node(node + 1);
+                cur = first;
+            }
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        self& operator--() {
+            if(cur == first) {
+                set_node(node - 1);
+                cur = last;
+            }
+            --cur;
+            return *this;
+        }
+
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        self& operator+=(difference_type n) {
+            const difference_type offset = n + (cur - first);
+            const difference_type bs = static_cast<difference_type>(buffer_size);
+            if(offset >= 0 && offset < bs) {
+                cur += n;
+            } else {
+                const difference_type node_offset = offset > 0 ? offset / bs : -((-offset - 1) / bs) - 1;
+                set_node(node + node_offset);
+                cur = first + (offset - node_offset * bs);
+            }
+            return *this;
+        }
+
+        self operator+(difference_type n) const {
+            self tmp = *this;
+            return tmp += n;
+        }
+
+        self& operator-=(difference_type n) {
+            return *this += -n;
+        }
+
+        self operator-(difference_type n) const {
+            self tmp = *this;
+            return tmp -= n;
+        }
+
+        reference operator[](difference_type n) const { return *(*this + n); }
+    };
+
+    template<class T, class Ref, class Ptr>
+    constexpr typename deque_iterator<T, Ref, Ptr>::size_type deque_iterator<T, Ref, Ptr>::buffer_size;
+
+    // 两个迭代器之间的距离，按 cur - first 计算，默认构造的迭代器之间距离为 0
+    template<class T, class R1, class P1, class R2, class P2>
+    ptrdiff_t operator-(const deque_iterator<T, R1, P1>& lhs, const deque_iterator<T, R2, P2>& rhs) {
+        return static_cast<ptrdiff_t>(deque_buf_size<T>::value) * (lhs.node - rhs.node) +
+               (lhs.cur - lhs.first) - (rhs.cur - rhs.first);
+    }
+
+    template<class T, class Ref, class Ptr>
+    deque_iterator<T, Ref, Ptr> operator+(ptrdiff_t n, const deque_iterator<T, Ref, Ptr>& it) {
+        return it + n;
+    }
+
+    template<class T, class R1, class P1, class R2, class P2>
+    bool operator==(const deque_iterator<T, R1, P1>& lhs, const deque_iterator<T, R2, P2>& rhs) {
+        return lhs.cur == rhs.cur;
+    }
+
+    template<class T, class R1, class P1, class R2, class P2>
+    bool operator!=(const deque_iterator<T, R1, P1>& lhs, const deque_iterator<T, R2, P2>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T, class R1, class P1, class R2, class P2>
+    bool operator<(const deque_iterator<T, R1, P1>& lhs, const deque_iterator<T, R2, P2>& rhs) {
+        return lhs.node == rhs.node ? lhs.cur < rhs.cur : lhs.node < rhs.node;
+    }
+
+    template<class T, class R1, class P1, class R2, class P2>
+    bool operator>(const deque_iterator<T, R1, P1>& lhs, const deque_iterator<T, R2, P2>& rhs) {
+        return rhs < lhs;
+    }
+
+    template<class T, class R1, class P1, class R2, class P2>
+    bool operator<=(const deque_iterator<T, R1, P1>& lhs, const deque_iterator<T, R2, P2>& rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class T, class R1, class P1, class R2, class P2>
+    bool operator>=(const deque_iterator<T, R1, P1>& lhs, const deque_iterator<T, R2, P2>& rhs) {
+        return !(lhs < rhs);
+    }
+
+    // deque 的迭代器按缓冲区分段，每一段是一个完整的缓冲区
+    template<class T, class Ref, class Ptr>
+    struct segmented_iterator_traits<deque_iterator<T, Ref, Ptr> > {
+        typedef std::true_type is_segmented;
+        typedef deque_iterator<T, Ref, Ptr> iterator;
+        typedef T** segment_iterator;
+        typedef Ptr local_iterator;
+
+        static segment_iterator segment(const iterator& it) noexcept { return it.node; }
+        static local_iterator local(const iterator& it) noexcept { return it.cur; }
+        static local_iterator begin(segment_iterator seg) noexcept { return *seg; }
+        static local_iterator end(segment_iterator seg) noexcept { return *seg + iterator::buffer_size; }
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * deque
+    * *****************************************************************************************************************
+    */
+    template<class T, class Alloc = mabustl::allocator<T> >
+    class deque {
+        static_assert(std::is_same<T, typename Alloc::value_type>::value, "deque: Alloc::value_type must be T");
+
+    public:
+        typedef T value_type;
+        typedef Alloc allocator_type;
+        typedef allocator_traits<Alloc> alloc_traits;
+        typedef typename alloc_traits::size_type size_type;
+        typedef typename alloc_traits::difference_type difference_type;
+
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+
+        typedef deque_iterator<T, T&, T*> iterator;
+        typedef deque_iterator<T, const T&, const T*> const_iterator;
+        typedef mabustl::reverse_iterator<iterator> reverse_iterator;
+        typedef mabustl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    private:
+        typedef T** map_pointer;
+        typedef typename alloc_traits::template rebind_alloc<T*> map_allocator;
+        typedef allocator_traits<map_allocator> map_traits;
+
+        static constexpr size_type buffer_size = deque_buf_size<T>::value;
+
+        enum : size_type { INIT_MAP_SIZE = 8 };
+
+        // 继承 allocator，不含状态的 allocator 不占用空间
+        struct deque_impl : public Alloc {
+            map_pointer map_;
+            size_type map_size_;
+            iterator begin_;
+            iterator end_;
+
+            deque_impl(): Alloc(), map_(nullptr), map_size_(0), begin_(), end_() {}
+
+            explicit deque_impl(const Alloc& alloc): Alloc(alloc), map_(nullptr), map_size_(0), begin_(), end_() {}
+
+            explicit deque_impl(Alloc&& alloc)
+                : Alloc(mabustl::move(alloc)), map_(nullptr), map_size_(0), begin_(), end_() {}
+        };
+
+        deque_impl impl_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        deque() noexcept(std::is_nothrow_default_constructible<Alloc>::value): impl_() {}
+
+        explicit deque(const Alloc& alloc) noexcept: impl_(alloc) {}
+
+        explicit deque(size_type n, const Alloc& alloc = Alloc()): impl_(alloc) {
+            init_guard([&] { default_append(n); });
+        }
+
+        deque(size_type n, const T& value, const Alloc& alloc = Alloc()): impl_(alloc) {
+            init_guard([&] { fill_insert(end(), n, value); });
+        }
+
+        template<class Iter, typename std::enable_if<mabustl::is_input_iterator<Iter>::value, int>::type = 0>
+        deque(Iter first, Iter last, const Alloc& alloc = Alloc()): impl_(alloc) {
+            init_guard([&] { range_insert(end(), first, last, mabustl::iterator_category(first)); });
+        }
+
+        deque(std::initializer_list<T> ilist, const Alloc& alloc = Alloc()): impl_(alloc) {
+            init_guard([&] {
+                range_insert(end(), ilist.begin(), ilist.end(), mabustl::random_access_iterator_tag());
+            });
+        }
+
+        deque(const deque& rhs): impl_(alloc_traits::select_on_container_copy_construction(rhs.get_alloc())) {
+            init_guard([&] { range_insert(end(), rhs.begin(), rhs.end(), mabustl::random_access_iterator_tag()); });
+        }
+
+        deque(const deque& rhs, const Alloc& alloc): impl_(alloc) {
+            init_guard([&] { range_insert(end(), rhs.begin(), rhs.end(), mabustl::random_access_iterator_tag()); });
+        }
+
+        deque(deque&& rhs) noexcept: impl_(mabustl::move(rhs.get_alloc())) {
+            steal(rhs);
+        }
+
+        // allocator 不相等时不能接管 rhs 的缓冲区，只能逐个移动元素
+        deque(deque&& rhs, const Alloc& alloc): impl_(alloc) {
+            if(get_alloc() == rhs.get_alloc()) {
+                steal(rhs);
+            } else {
+                init_guard([&] { move_append(rhs); });
+            }
+        }
+
+        deque& operator=(const deque& rhs);
+
+        deque& operator=(deque&& rhs) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                               alloc_traits::is_always_equal::value);
+
+        deque& operator=(std::initializer_list<T> ilist) {
+            range_assign(ilist.begin(), ilist.end(), mabustl::random_access_iterator_tag());
+            return *this;
+        }
+
+        ~deque() {
+            destroy_and_deallocate();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept { return impl_.begin_; }
+        const_iterator begin() const noexcept { return impl_.begin_; }
+        iterator end() noexcept { return impl_.end_; }
+        const_iterator end() const noexcept { return impl_.end_; }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return impl_.begin_ == impl_.end_; }
+        size_type size() const noexcept { return static_cast<size_type>(impl_.end_ - impl_.begin_); }
+        size_type max_size() const noexcept { return alloc_traits::max_size(get_alloc()); }
+
+        // 变空的缓冲区在 pop 和 erase 时已经释放，这里只把 map 缩小到刚好容纳现有的缓冲区
+        void shrink_to_fit();
+
+        // 访问元素相关操作
+        reference operator[](size_type n) {
+            MABUSTL_DEBUG(n < size());
+            return impl_.begin_[static_cast<difference_type>(n)];
+        }
+
+        const_reference operator[](size_type n) const {
+            MABUSTL_DEBUG(n < size());
+            return impl_.begin_[static_cast<difference_type>(n)];
+        }
+
+        reference at(size_type n) {
+            THROW_OUT_OF_LENGTH_IF(!(n < size()), "deque<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        const_reference at(size_type n) const {
+            THROW_OUT_OF_LENGTH_IF(!(n < size()), "deque<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        reference front() {
+            MABUSTL_DEBUG(!empty());
+            return *impl_.begin_.cur;
+        }
+
+        const_reference front() const {
+            MABUSTL_DEBUG(!empty());
+            return *impl_.begin_.cur;
+        }
+
+        reference back() {
+            MABUSTL_DEBUG(!empty());
+            return *(impl_.end_ - 1);
+        }
+
+        const_reference back() const {
+            MABUSTL_DEBUG(!empty());
+            return *(impl_.end_ - 1);
+        }
+
+        allocator_type get_allocator() const { return get_alloc(); }
+
+    public:
+        // 修改容器相关操作
+
+        void assign(size_type n, const T& value);
+
+        template<class Iter, typename std::enable_if<mabustl::is_input_iterator<Iter>::value, int>::type = 0>
+        void assign(Iter first, Iter last) {
+            range_assign(first, last, mabustl::iterator_category(first));
+        }
+
+        void assign(std::initializer_list<T> ilist) {
+            range_assign(ilist.begin(), ilist.end(), mabustl::random_access_iterator_tag());
+        }
+
+        // 当前缓冲区还有位置时直接构造，否则才进入 emplace_front_aux / emplace_back_aux
+        template<class... Args>
+        reference emplace_front(Args&&... args) {
+            if(impl_.begin_.cur != impl_.begin_.first) {
+                alloc_traits::construct(get_alloc(), impl_.begin_.cur - 1, mabustl::forward<Args>(args)...);
+                --impl_.begin_.cur;
+            } else {
+                emplace_front_aux(mabustl::forward<Args>(args)...);
+            }
+            return front();
+        }
+
+        template<class... Args>
+        reference emplace_back(Args&&... args) {
+            if(impl_.end_.last - impl_.end_.cur > 1) {
+                alloc_traits::construct(get_alloc(), impl_.end_.cur, mabustl::forward<Args>(args)...);
+                ++impl_.end_.cur;
+            } else {
+                emplace_back_aux(mabustl::forward<Args>(args)...);
+            }
+            return back();
+        }
+
+        void push_front(const T& value) {
+            emplace_front(value);
+        }
+
+        void push_front(T&& value) {
+            emplace_front(mabustl::move(value));
+        }
+
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value) {
+            emplace_back(mabustl::move(value));
+        }
+
+        void pop_front();
+
+        void pop_back();
+
+        template<class... Args>
+        iterator emplace(const_iterator pos, Args&&... args);
+
+        iterator insert(const_iterator pos, const T& value) {
+            return emplace(pos, value);
+        }
+
+        iterator insert(const_iterator pos, T&& value) {
+            return emplace(pos, mabustl::move(value));
+        }
+
+        iterator insert(const_iterator pos, size_type n, const T& value) {
+            return fill_insert(pos, n, value);
+        }
+
+        template<class Iter, typename std::enable_if<mabustl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert(const_iterator pos, Iter first, Iter last) {
+            return range_insert(pos, first, last, mabustl::iterator_category(first));
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+            return range_insert(pos, ilist.begin(), ilist.end(), mabustl::random_access_iterator_tag());
+        }
+
+        iterator erase(const_iterator pos);
+
+        iterator erase(const_iterator first, const_iterator last);
+
+        // 只保留 begin_ 所在的缓冲区
+        void clear() noexcept;
+
+        void resize(size_type n);
+
+        void resize(size_type n, const T& value);
+
+        void swap(deque& rhs) noexcept;
+
+    private:
+        Alloc& get_alloc() noexcept { return impl_; }
+        const Alloc& get_alloc() const noexcept { return impl_; }
+
+        // 构造函数中抛出异常时析构函数不会执行，这里负责释放已经构造的元素和分配的内存
+        template<class F>
+        void init_guard(F f) {
+            try {
+                f();
+            } catch(...) {
+                destroy_and_deallocate();
+                throw;
+            }
+        }
+
+        iterator to_iterator(const_iterator pos) noexcept {
+            return impl_.begin_ + (pos - impl_.begin_);
+        }
+
+        T* allocate_node() {
+            return alloc_traits::allocate(get_alloc(), buffer_size);
+        }
+
+        void deallocate_node(T* p) noexcept {
+            alloc_traits::deallocate(get_alloc(), p, buffer_size);
+        }
+
+        map_pointer allocate_map(size_type n) {
+            map_allocator alloc(get_alloc());
+            map_pointer m = map_traits::allocate(alloc, n);
+            for(size_type i = 0; i < n; ++i) m[i] = nullptr;
+            return m;
+        }
+
+        void deallocate_map(map_pointer m, size_type n) noexcept {
+            map_allocator alloc(get_alloc());
+            map_traits::deallocate(alloc, m, n);
+        }
+
+        // 分配[first, last)上的缓冲区，失败时释放已经分配的部分
+        void create_nodes(map_pointer first, map_pointer last);
+
+        // 释放[first, last)上的缓冲区
+        void destroy_nodes(map_pointer first, map_pointer last) noexcept {
+            for(; first < last; ++first) deallocate_node(*first);
+        }
+
+        // 建立只有一个缓冲区的 map，begin_ 和 end_ 都指向该缓冲区的开头
+        void map_init();
+
+        // map 中 end_ 之后至少还能放下 nodes_to_add 个缓冲区
+        void reserve_map_at_back(size_type nodes_to_add = 1) {
+            if(nodes_to_add + 1 > impl_.map_size_ - static_cast<size_type>(impl_.end_.node - impl_.map_)) {
+                reallocate_map(nodes_to_add, false);
+            }
+        }
+
+        // map 中 begin_ 之前至少还能放下 nodes_to_add 个缓冲区
+        void reserve_map_at_front(size_type nodes_to_add = 1) {
+            if(nodes_to_add > static_cast<size_type>(impl_.begin_.node - impl_.map_)) {
+                reallocate_map(nodes_to_add, true);
+            }
+        }
+
+        void reallocate_map(size_type nodes_to_add, bool add_at_front);
+
+        // 保证 end_ 之后(begin_ 之前)还有 n 个可以构造元素的位置，返回新的 end_(begin_)，并不修改 end_(begin_)
+        iterator reserve_elements_at_back(size_type n);
+
+        iterator reserve_elements_at_front(size_type n);
+
+        template<class... Args>
+        void emplace_front_aux(Args&&... args);
+
+        template<class... Args>
+        void emplace_back_aux(Args&&... args);
+
+        // 在尾部追加 n 个值初始化的元素
+        void default_append(size_type n);
+
+        // 逐个移动 rhs 的元素到尾部
+        void move_append(deque& rhs);
+
+        iterator fill_insert(const_iterator pos, size_type n, const T& value);
+
+        // 在 pos 处插入 n 个 value，pos 不在两端
+        void fill_insert_aux(iterator pos, size_type n, const T& value);
+
+        template<class Iter>
+        iterator range_insert(const_iterator pos, Iter first, Iter last, mabustl::input_iterator_tag);
+
+        template<class Iter>
+        iterator range_insert(const_iterator pos, Iter first, Iter last, mabustl::forward_iterator_tag);
+
+        // 在 pos 处插入[first, last)共 n 个元素，pos 不在两端
+        template<class Iter>
+        void range_insert_aux(iterator pos, Iter first, Iter last, size_type n);
+
+        template<class Iter>
+        void range_assign(Iter first, Iter last, mabustl::input_iterator_tag);
+
+        template<class Iter>
+        void range_assign(Iter first, Iter last, mabustl::forward_iterator_tag);
+
+        // 删除[new_end, end_)，释放变空的缓冲区
+        void erase_at_end(iterator new_end) noexcept;
+
+        // 删除[begin_, new_begin)，释放变空的缓冲区
+        void erase_at_begin(iterator new_begin) noexcept;
+
+        void steal(deque& rhs) noexcept {
+            impl_.map_ = rhs.impl_.map_;
+            impl_.map_size_ = rhs.impl_.map_size_;
+            impl_.begin_ = rhs.impl_.begin_;
+            impl_.end_ = rhs.impl_.end_;
+            rhs.impl_.map_ = nullptr;
+            rhs.impl_.map_size_ = 0;
+            rhs.impl_.begin_ = rhs.impl_.end_ = iterator();
+        }
+
+        void destroy_and_deallocate() noexcept {
+            if(impl_.map_ == nullptr) return;
+            clear();
+            deallocate_node(impl_.begin_.first);
+            deallocate_map(impl_.map_, impl_.map_size_);
+            impl_.map_ = nullptr;
+            impl_.map_size_ = 0;
+            impl_.begin_ = impl_.end_ = iterator();
+        }
+
+        // 传播前先用当前 allocator 释放旧空间
+        void copy_alloc(const deque& rhs, std::true_type) {
+            if(get_alloc() != rhs.get_alloc()) destroy_and_deallocate();
+            get_alloc() = rhs.get_alloc();
+        }
+
+        void copy_alloc(const deque&, std::false_type) {}
+
+        void move_alloc(deque& rhs, std::true_type) {
+            get_alloc() = mabustl::move(rhs.get_alloc());
+        }
+
+        void move_alloc(deque&, std::false_type) {}
+
+        void swap_alloc(deque& rhs, std::true_type) {
+            mabustl::swap(get_alloc(), rhs.get_alloc());
+        }
+
+        void swap_alloc(deque&, std::false_type) {}
+    };
+
+    template<class T, class Alloc>
+    constexpr typename deque<T, Alloc>::size_type deque<T, Alloc>::buffer_size;
+
+    /*****************************************************************************************************************/
+
+    // 复制赋值：allocator 需要传播且与当前的不相等时，先用当前 allocator 释放旧空间
+    template<class T, class Alloc>
+    deque<T, Alloc>& deque<T, Alloc>::operator=(const deque& rhs) {
+        if(this == &rhs) return *this;
+        copy_alloc(rhs, typename alloc_traits::propagate_on_container_copy_assignment());
+        range_assign(rhs.begin(), rhs.end(), mabustl::random_access_iterator_tag());
+        return *this;
+    }
+
+    // 移动赋值：能接管 rhs 的缓冲区时直接接管，否则逐个移动元素
+    template<class T, class Alloc>
+    deque<T, Alloc>& deque<T, Alloc>::operator=(deque&& rhs)
+    noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+             alloc_traits::is_always_equal::value) {
+        if(this == &rhs) return *this;
+        if(alloc_traits::propagate_on_container_move_assignment::value ||
+           alloc_traits::is_always_equal::value || get_alloc() == rhs.get_alloc()) {
+            destroy_and_deallocate();
+            move_alloc(rhs, typename alloc_traits::propagate_on_container_move_assignment());
+            steal(rhs);
+        } else {
+            clear();
+            move_append(rhs);
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::shrink_to_fit() {
+        if(impl_.map_ == nullptr) return;
+        if(empty()) {
+            destroy_and_deallocate();
+            return;
+        }
+        const size_type num_nodes = static_cast<size_type>(impl_.end_.node - impl_.begin_.node) + 1;
+        if(num_nodes + 2 >= impl_.map_size_) return;
+        const size_type new_map_size = num_nodes + 2;
+        map_pointer new_map = allocate_map(new_map_size);
+        mabustl::copy(impl_.begin_.node, impl_.end_.node + 1, new_map + 1);
+        deallocate_map(impl_.map_, impl_.map_size_);
+        impl_.map_ = new_map;
+        impl_.map_size_ = new_map_size;
+        impl_.begin_.set_node(new_map + 1);
+        impl_.end_.set_node(new_map + num_nodes);
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::pop_front() {
+        MABUSTL_DEBUG(!empty());
+        alloc_traits::destroy(get_alloc(), impl_.begin_.cur);
+        if(impl_.begin_.cur != impl_.begin_.last - 1) {
+            ++impl_.begin_.cur;
+        } else {
+            deallocate_node(impl_.begin_.first);
+            impl_.begin_.set_node(impl_.begin_.node + 1);
+            impl_.begin_.cur = impl_.begin_.first;
+        }
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::pop_back() {
+        MABUSTL_DEBUG(!empty());
+        if(impl_.end_.cur != impl_.end_.first) {
+            --impl_.end_.cur;
+        } else {
+            deallocate_node(impl_.end_.first);
+            impl_.end_.set_node(impl_.end_.node - 1);
+            impl_.end_.cur = impl_.end_.last - 1;
+        }
+        alloc_traits::destroy(get_alloc(), impl_.end_.cur);
+    }
+
+    // 在 pos 处构造元素：靠近头部时把前半段向前移一位，否则把后半段向后移一位
+    template<class T, class Alloc>
+    template<class... Args>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::emplace(const_iterator pos, Args&&... args) {
+        if(pos.cur == impl_.begin_.cur) {
+            emplace_front(mabustl::forward<Args>(args)...);
+            return impl_.begin_;
+        }
+        if(pos.cur == impl_.end_.cur) {
+            emplace_back(mabustl::forward<Args>(args)...);
+            return impl_.end_ - 1;
+        }
+
+        const difference_type index = pos - impl_.begin_;
+        // 先构造出新元素，args 可能引用容器中的元素
+        T tmp(mabustl::forward<Args>(args)...);
+        if(static_cast<size_type>(index) < size() / 2) {
+            emplace_front(mabustl::move(front()));
+            iterator front1 = impl_.begin_ + 1;
+            iterator front2 = front1 + 1;
+            iterator p = impl_.begin_ + index;
+            mabustl::move(front2, p + 1, front1);
+            *p = mabustl::move(tmp);
+            return p;
+        } else {
+            emplace_back(mabustl::move(back()));
+            iterator back1 = impl_.end_ - 1;
+            iterator back2 = back1 - 1;
+            iterator p = impl_.begin_ + index;
+            mabustl::move_backward(p, back2, back1);
+            *p = mabustl::move(tmp);
+            return p;
+        }
+    }
+
+    // 删除 pos 处的元素：移动元素较少的一侧
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::erase(const_iterator pos) {
+        MABUSTL_DEBUG(pos != cend());
+        iterator p = to_iterator(pos);
+        iterator next = p + 1;
+        const difference_type index = p - impl_.begin_;
+        if(static_cast<size_type>(index) < size() / 2) {
+            mabustl::move_backward(impl_.begin_, p, next);
+            pop_front();
+        } else {
+            mabustl::move(next, impl_.end_, p);
+            pop_back();
+        }
+        return impl_.begin_ + index;
+    }
+
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::erase(const_iterator first, const_iterator last) {
+        if(first == last) return to_iterator(first);
+        if(first == cbegin() && last == cend()) {
+            clear();
+            return impl_.end_;
+        }
+        const difference_type n = last - first;
+        const difference_type elems_before = first - impl_.begin_;
+        if(static_cast<size_type>(elems_before) < (size() - static_cast<size_type>(n)) / 2) {
+            mabustl::move_backward(impl_.begin_, to_iterator(first), to_iterator(last));
+            erase_at_begin(impl_.begin_ + n);
+        } else {
+            mabustl::move(to_iterator(last), impl_.end_, to_iterator(first));
+            erase_at_end(impl_.end_ - n);
+        }
+        return impl_.begin_ + elems_before;
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::clear() noexcept {
+        if(impl_.map_ == nullptr) return;
+        erase_at_end(impl_.begin_);
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::resize(size_type n) {
+        const size_type len = size();
+        if(n < len) {
+            erase_at_end(impl_.begin_ + static_cast<difference_type>(n));
+        } else {
+            default_append(n - len);
+        }
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::resize(size_type n, const T& value) {
+        const size_type len = size();
+        if(n < len) {
+            erase_at_end(impl_.begin_ + static_cast<difference_type>(n));
+        } else {
+            fill_insert(cend(), n - len, value);
+        }
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::swap(deque& rhs) noexcept {
+        if(this == &rhs) return;
+        swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+        mabustl::swap(impl_.map_, rhs.impl_.map_);
+        mabustl::swap(impl_.map_size_, rhs.impl_.map_size_);
+        mabustl::swap(impl_.begin_, rhs.impl_.begin_);
+        mabustl::swap(impl_.end_, rhs.impl_.end_);
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::assign(size_type n, const T& value) {
+        const size_type len = size();
+        if(n > len) {
+            mabustl::fill(impl_.begin_, impl_.end_, value);
+            fill_insert(cend(), n - len, value);
+        } else {
+            erase_at_end(impl_.begin_ + static_cast<difference_type>(n));
+            mabustl::fill(impl_.begin_, impl_.end_, value);
+        }
+    }
+
+    /*****************************************************************************************************************/
+    // 内存管理
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::create_nodes(map_pointer first, map_pointer last) {
+        map_pointer curr = first;
+        try {
+            for(; curr < last; ++curr) *curr = allocate_node();
+        } catch(...) {
+            destroy_nodes(first, curr);
+            throw;
+        }
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::map_init() {
+        impl_.map_ = allocate_map(INIT_MAP_SIZE);
+        impl_.map_size_ = INIT_MAP_SIZE;
+        map_pointer start = impl_.map_ + INIT_MAP_SIZE / 2;
+        try {
+            *start = allocate_node();
+        } catch(...) {
+            deallocate_map(impl_.map_, impl_.map_size_);
+            impl_.map_ = nullptr;
+            impl_.map_size_ = 0;
+            throw;
+        }
+        impl_.begin_.set_node(start);
+        impl_.end_.set_node(start);
+        impl_.begin_.cur = impl_.begin_.first;
+        impl_.end_.cur = impl_.end_.first;
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * reallocate_map
+    * map 的容量超过所需缓冲区数的两倍时，只在原 map 中把[begin_.node, end_.node]移到中间，
+    * 否则分配一个更大的 map；两种情况下都在需要增长的一侧留出 nodes_to_add 个位置
+    * *****************************************************************************************************************
+    */
+    template<class T, class Alloc>
+    void deque<T, Alloc>::reallocate_map(size_type nodes_to_add, bool add_at_front) {
+        const size_type old_num_nodes = static_cast<size_type>(impl_.end_.node - impl_.begin_.node) + 1;
+        const size_type new_num_nodes = old_num_nodes + nodes_to_add;
+        map_pointer new_start;
+        if(impl_.map_size_ > 2 * new_num_nodes) {
+            new_start = impl_.map_ + (impl_.map_size_ - new_num_nodes) / 2 + (add_at_front ? nodes_to_add : 0);
+            if(new_start < impl_.begin_.node) {
+                mabustl::copy(impl_.begin_.node, impl_.end_.node + 1, new_start);
+            } else {
+                mabustl::copy_backward(impl_.begin_.node, impl_.end_.node + 1, new_start + old_num_nodes);
+            }
+        } else {
+            const size_type new_map_size =
+                impl_.map_size_ + (impl_.map_size_ > nodes_to_add ? impl_.map_size_ : nodes_to_add) + 2;
+            map_pointer new_map = allocate_map(new_map_size);
+            new_start = new_map + (new_map_size - new_num_nodes) / 2 + (add_at_front ? nodes_to_add : 0);
+            mabustl::copy(impl_.begin_.node, impl_.end_.node + 1, new_start);
+            deallocate_map(impl_.map_, impl_.map_size_);
+            impl_.map_ = new_map;
+            impl_.map_size_ = new_map_size;
+        }
+        impl_.begin_.set_node(new_start);
+        impl_.end_.set_node(new_start + old_num_nodes - 1);
+    }
+
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::reserve_elements_at_back(size_type n) {
+        if(impl_.map_ == nullptr) map_init();
+        const size_type vacancies = static_cast<size_type>(impl_.end_.last - impl_.end_.cur) - 1;
+        if(n > vacancies) {
+            THROW_LENGTH_ERROR_IF(n > max_size() - size(), "deque<T> size too big");
+            const size_type new_nodes = (n - vacancies + buffer_size - 1) / buffer_size;
+            reserve_map_at_back(new_nodes);
+            create_nodes(impl_.end_.node + 1, impl_.end_.node + 1 + new_nodes);
+        }
+        return impl_.end_ + static_cast<difference_type>(n);
+    }
+
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::reserve_elements_at_front(size_type n) {
+        if(impl_.map_ == nullptr) map_init();
+        const size_type vacancies = static_cast<size_type>(impl_.begin_.cur - impl_.begin_.first);
+        if(n > vacancies) {
+            THROW_LENGTH_ERROR_IF(n > max_size() - size(), "deque<T> size too big");
+            const size_type new_nodes = (n - vacancies + buffer_size - 1) / buffer_size;
+            reserve_map_at_front(new_nodes);
+            create_nodes(impl_.begin_.node - new_nodes, impl_.begin_.node);
+        }
+        return impl_.begin_ - static_cast<difference_type>(n);
+    }
+
+    // 头部缓冲区已满：在前一个缓冲区的末尾构造
+    template<class T, class Alloc>
+    template<class... Args>
+    void deque<T, Alloc>::emplace_front_aux(Args&&... args) {
+        if(impl_.map_ == nullptr) map_init();
+        reserve_map_at_front();
+        *(impl_.begin_.node - 1) = allocate_node();
+        try {
+            alloc_traits::construct(get_alloc(), *(impl_.begin_.node - 1) + (buffer_size - 1),
+                                    mabustl::forward<Args>(args)...);
+        } catch(...) {
+            deallocate_node(*(impl_.begin_.node - 1));
+            throw;
+        }
+        impl_.begin_.set_node(impl_.begin_.node - 1);
+        impl_.begin_.cur = impl_.begin_.last - 1;
+    }
+
+    // 尾部缓冲区只剩最后一个位置：在这里构造，再让 end_ 指向新分配的缓冲区
+    template<class T, class Alloc>
+    template<class... Args>
+    void deque<T, Alloc>::emplace_back_aux(Args&&... args) {
+        if(impl_.map_ == nullptr) {
+            map_init();
+            alloc_traits::construct(get_alloc(), impl_.end_.cur, mabustl::forward<Args>(args)...);
+            ++impl_.end_.cur;
+            return;
+        }
+        reserve_map_at_back();
+        *(impl_.end_.node + 1) = allocate_node();
+        try {
+            alloc_traits::construct(get_alloc(), impl_.end_.cur, mabustl::forward<Args>(args)...);
+        } catch(...) {
+            deallocate_node(*(impl_.end_.node + 1));
+            throw;
+        }
+        impl_.end_.set_node(impl_.end_.node + 1);
+        impl_.end_.cur = impl_.end_.first;
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::erase_at_end(iterator new_end) noexcept {
+        mabustl::destroy_a(new_end, impl_.end_, get_alloc());
+        destroy_nodes(new_end.node + 1, impl_.end_.node + 1);
+        impl_.end_ = new_end;
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::erase_at_begin(iterator new_begin) noexcept {
+        mabustl::destroy_a(impl_.begin_, new_begin, get_alloc());
+        destroy_nodes(impl_.begin_.node, new_begin.node);
+        impl_.begin_ = new_begin;
+    }
+
+    /*****************************************************************************************************************/
+    // 插入
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::default_append(size_type n) {
+        if(n == 0) return;
+        iterator new_end = reserve_elements_at_back(n);
+        iterator curr = impl_.end_;
+        try {
+            for(; curr != new_end; ++curr) alloc_traits::construct(get_alloc(), curr.cur);
+        } catch(...) {
+            mabustl::destroy_a(impl_.end_, curr, get_alloc());
+            destroy_nodes(impl_.end_.node + 1, new_end.node + 1);
+            throw;
+        }
+        impl_.end_ = new_end;
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::move_append(deque& rhs) {
+        const size_type n = rhs.size();
+        if(n == 0) return;
+        iterator new_end = reserve_elements_at_back(n);
+        try {
+            mabustl::uninitialized_move_a(rhs.begin(), rhs.end(), impl_.end_, get_alloc());
+        } catch(...) {
+            destroy_nodes(impl_.end_.node + 1, new_end.node + 1);
+            throw;
+        }
+        impl_.end_ = new_end;
+    }
+
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::iterator deque<T, Alloc>::fill_insert(const_iterator pos, size_type n, const T& value) {
+        const difference_type index = pos - impl_.begin_;
+        if(n == 0) return impl_.begin_ + index;
+        if(pos.cur == impl_.begin_.cur) {
+            iterator new_begin = reserve_elements_at_front(n);
+            try {
+                mabustl::uninitialized_fill_n_a(new_begin, n, value, get_alloc());
+            } catch(...) {
+                destroy_nodes(new_begin.node, impl_.begin_.node);
+                throw;
+            }
+            impl_.begin_ = new_begin;
+            return impl_.begin_;
+        }
+        if(pos.cur == impl_.end_.cur) {
+            iterator new_end = reserve_elements_at_back(n);
+            try {
+                mabustl::uninitialized_fill_n_a(impl_.end_, n, value, get_alloc());
+            } catch(...) {
+                destroy_nodes(impl_.end_.node + 1, new_end.node + 1);
+                throw;
+            }
+            impl_.end_ = new_end;
+            return impl_.begin_ + index;
+        }
+        fill_insert_aux(impl_.begin_ + index, n, value);
+        return impl_.begin_ + index;
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * fill_insert_aux
+    * 靠近头部时：在头部预留 n 个位置，把[begin_, pos)整体前移 n 位，前移到未初始化区域的部分用移动构造，其余用移动赋值；
+    * 靠近尾部时对称地把[pos, end_)后移 n 位
+    * *****************************************************************************************************************
+    */
+    template<class T, class Alloc>
+    void deque<T, Alloc>::fill_insert_aux(iterator pos, size_type n, const T& value) {
+        const T value_copy = value;
+        const size_type elems_before = static_cast<size_type>(pos - impl_.begin_);
+        const size_type len = size();
+        const difference_type dn = static_cast<difference_type>(n);
+        if(elems_before < len / 2) {
+            iterator new_begin = reserve_elements_at_front(n);
+            iterator old_begin = impl_.begin_;
+            pos = impl_.begin_ + static_cast<difference_type>(elems_before);
+            try {
+                if(elems_before >= n) {
+                    iterator begin_n = impl_.begin_ + dn;
+                    mabustl::uninitialized_move_a(impl_.begin_, begin_n, new_begin, get_alloc());
+                    impl_.begin_ = new_begin;
+                    mabustl::move(begin_n, pos, old_begin);
+                    mabustl::fill(pos - dn, pos, value_copy);
+                } else {
+                    iterator mid = mabustl::uninitialized_move_a(impl_.begin_, pos, new_begin, get_alloc());
+                    try {
+                        mabustl::uninitialized_fill_n_a(mid, n - elems_before, value_copy, get_alloc());
+                    } catch(...) {
+                        mabustl::destroy_a(new_begin, mid, get_alloc());
+                        throw;
+                    }
+                    impl_.begin_ = new_begin;
+                    mabustl::fill(old_begin, pos, value_copy);
+                }
+            } catch(...) {
+                destroy_nodes(new_begin.node, impl_.begin_.node);
+                throw;
+            }
+        } else {
+            iterator new_end = reserve_elements_at_back(n);
+            iterator old_end = impl_.end_;
+            const size_type elems_after = len - elems_before;
+            pos = impl_.end_ - static_cast<difference_type>(elems_after);
+            try {
+                if(elems_after > n) {
+                    iterator end_n = impl_.end_ - dn;
+                    mabustl::uninitialized_move_a(end_n, impl_.end_, impl_.end_, get_alloc());
+                    impl_.end_ = new_end;
+                    mabustl::move_backward(pos, end_n, old_end);
+                    mabustl::fill(pos, pos + dn, value_copy);
+                } else {
+                    iterator mid = mabustl::uninitialized_fill_n_a(impl_.end_, n - elems_after, value_copy,
+                                                                   get_alloc());
+                    try {
+                        mabustl::uninitialized_move_a(pos, impl_.end_, mid, get_alloc());
+                    } catch(...) {
+                        mabustl::destroy_a(impl_.end_, mid, get_alloc());
+                        throw;
+                    }
+                    impl_.end_ = new_end;
+                    mabustl::fill(pos, old_end, value_copy);
+                }
+            } catch(...) {
+                destroy_nodes(impl_.end_.node + 1, new_end.node + 1);
+                throw;
+            }
+        }
+    }
+
+    // input iterator 只能逐个插入
+    template<class T, class Alloc>
+    template<class Iter>
+    typename deque<T, Alloc>::iterator
+    deque<T, Alloc>::range_insert(const_iterator pos, Iter first, Iter last, mabustl::input_iterator_tag) {
+        const difference_type index = pos - impl_.begin_;
+        if(pos.cur == impl_.end_.cur) {
+            for(; first != last; ++first) emplace_back(*first);
+        } else {
+            for(difference_type i = index; first != last; ++first, ++i) emplace(impl_.begin_ + i, *first);
+        }
+        return impl_.begin_ + index;
+    }
+
+    template<class T, class Alloc>
+    template<class Iter>
+    typename deque<T, Alloc>::iterator
+    deque<T, Alloc>::range_insert(const_iterator pos, Iter first, Iter last, mabustl::forward_iterator_tag) {
+        const difference_type index = pos - impl_.begin_;
+        const size_type n = static_cast<size_type>(mabustl::distance(first, last));
+        if(n == 0) return impl_.begin_ + index;
+        if(pos.cur == impl_.begin_.cur) {
+            iterator new_begin = reserve_elements_at_front(n);
+            try {
+                mabustl::uninitialized_copy_a(first, last, new_begin, get_alloc());
+            } catch(...) {
+                destroy_nodes(new_begin.node, impl_.begin_.node);
+                throw;
+            }
+            impl_.begin_ = new_begin;
+            return impl_.begin_;
+        }
+        if(pos.cur == impl_.end_.cur) {
+            iterator new_end = reserve_elements_at_back(n);
+            try {
+                mabustl::uninitialized_copy_a(first, last, impl_.end_, get_alloc());
+            } catch(...) {
+                destroy_nodes(impl_.end_.node + 1, new_end.node + 1);
+                throw;
+            }
+            impl_.end_ = new_end;
+            return impl_.begin_ + index;
+        }
+        range_insert_aux(impl_.begin_ + index, first, last, n);
+        return impl_.begin_ + index;
+    }
+
+    // 与 fill_insert_aux 相同，只是新元素来自[first, last)
+    template<class T, class Alloc>
+    template<class Iter>
+    void deque<T, Alloc>::range_insert_aux(iterator pos, Iter first, Iter last, size_type n) {
+        const size_type elems_before = static_cast<size_type>(pos - impl_.begin_);
+        const size_type len = size();
+        const difference_type dn = static_cast<difference_type>(n);
+        if(elems_before < len / 2) {
+            iterator new_begin = reserve_elements_at_front(n);
+            iterator old_begin = impl_.begin_;
+            pos = impl_.begin_ + static_cast<difference_type>(elems_before);
+            try {
+                if(elems_before >= n) {
+                    iterator begin_n = impl_.begin_ + dn;
+                    mabustl::uninitialized_move_a(impl_.begin_, begin_n, new_begin, get_alloc());
+                    impl_.begin_ = new_begin;
+                    mabustl::move(begin_n, pos, old_begin);
+                    mabustl::copy(first, last, pos - dn);
+                } else {
+                    Iter mid_src = first;
+                    mabustl::advance(mid_src, n - elems_before);
+                    iterator mid = mabustl::uninitialized_move_a(impl_.begin_, pos, new_begin, get_alloc());
+                    try {
+                        mabustl::uninitialized_copy_a(first, mid_src, mid, get_alloc());
+                    } catch(...) {
+                        mabustl::destroy_a(new_begin, mid, get_alloc());
+                        throw;
+                    }
+                    impl_.begin_ = new_begin;
+                    mabustl::copy(mid_src, last, old_begin);
+                }
+            } catch(...) {
+                destroy_nodes(new_begin.node, impl_.begin_.node);
+                throw;
+            }
+        } else {
+            iterator new_end = reserve_elements_at_back(n);
+            iterator old_end = impl_.end_;
+            const size_type elems_after = len - elems_before;
+            pos = impl_.end_ - static_cast<difference_type>(elems_after);
+            try {
+                if(elems_after > n) {
+                    iterator end_n = impl_.end_ - dn;
+                    mabustl::uninitialized_move_a(end_n, impl_.end_, impl_.end_, get_alloc());
+                    impl_.end_ = new_end;
+                    mabustl::move_backward(pos, end_n, old_end);
+                    mabustl::copy(first, last, pos);
+                } else {
+                    Iter mid_src = first;
+                    mabustl::advance(mid_src, elems_after);
+                    iterator mid = mabustl::uninitialized_copy_a(mid_src, last, impl_.end_, get_alloc());
+                    try {
+                        mabustl::uninitialized_move_a(pos, impl_.end_, mid, get_alloc());
+                    } catch(...) {
+                        mabustl::destroy_a(impl_.end_, mid, get_alloc());
+                        throw;
+                    }
+                    impl_.end_ = new_end;
+                    mabustl::copy(first, mid_src, pos);
+                }
+            } catch(...) {
+                destroy_nodes(impl_.end_.node + 1, new_end.node + 1);
+                throw;
+            }
+        }
+    }
+
+    template<class T, class Alloc>
+    template<class Iter>
+    void deque<T, Alloc>::range_assign(Iter first, Iter last, mabustl::input_iterator_tag) {
+        iterator curr = impl_.begin_;
+        for(; first != last && curr != impl_.end_; ++first, ++curr) *curr = *first;
+        if(first == last) {
+            erase_at_end(curr);
+        } else {
+            range_insert(cend(), first, last, mabustl::input_iterator_tag());
+        }
+    }
+
+    template<class T, class Alloc>
+    template<class Iter>
+    void deque<T, Alloc>::range_assign(Iter first, Iter last, mabustl::forward_iterator_tag) {
+        const size_type len = size();
+        const size_type n = static_cast<size_type>(mabustl::distance(first, last));
+        if(n > len) {
+            Iter mid = first;
+            mabustl::advance(mid, len);
+            mabustl::copy(first, mid, impl_.begin_);
+            range_insert(cend(), mid, last, mabustl::forward_iterator_tag());
+        } else {
+            erase_at_end(mabustl::copy(first, last, impl_.begin_));
+        }
+    }
+
+    /*****************************************************************************************************************/
+    // 重载比较运算符
+
+    template<class T, class Alloc>
+    bool operator==(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
+        return lhs.size() == rhs.size() && mabustl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template<class T, class Alloc>
+    bool operator!=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T, class Alloc>
+    bool operator<(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
+        return mabustl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template<class T, class Alloc>
+    bool operator>(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
+        return rhs < lhs;
+    }
+
+    template<class T, class Alloc>
+    bool operator<=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class T, class Alloc>
+    bool operator>=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
+        return !(lhs < rhs);
+    }
+
+    // 重载 mabustl 的 swap
+    template<class T, class Alloc>
+    void swap(deque<T, Alloc>& lhs, deque<T, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,631 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * dynamic_bitset: 长度可变的位集合，可以用来表示稠密的整数集合
+ * 有序区间上的 set_union / set_intersection 等算法逐个元素比较和归并，每个元素一次分支；
+ * 元素落在一个不大的范围 [0, n) 内并且比较稠密时，用位集合表示，一条指令处理 64 个元素：
+ * (1)| & ^ - 分别对应 set_union、set_intersection、set_symmetric_difference、set_difference，按字(64 位)并行计算
+ * (2)union_count 等只统计结果的元素个数，不生成结果
+ * (3)统计 1 的个数：有 AVX2 时每次处理 256 位(用 pshufb 查 4 位的表再用 sad 求和)；
+ *    有 popcnt 指令时逐字使用；否则用 Harley-Seal 进位保存加法器把 16 个字压缩后再用 SWAR 统计
+ * (4)find_first / find_next 跳过全 0 的字，用 ctz 找到字内最低的 1；for_each_set 逐字清除最低位的 1
+ * (5)可以从有序(或无序)的元素区间构造，to_elements 按从小到大的顺序输出所有元素
+ * 位数不同的两个集合运算时，较短一方缺少的位视为 0：| 和 ^ 的结果长度取较大者，& 和 - 的结果长度与左侧相同
+ * 最后一个字中超出 size() 的位总是 0
+ */
+
+#include <cstdint>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_allocator.h"
+#include "mabu_iterator.h"
+#include "mabu_stddef.h"
+#include "mabu_utility.h"
+#include "mabu_vector.h"
+
+#if !defined(MABUSTL_NO_AVX2) && defined(__AVX2__)
+#define MABUSTL_BITSET_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace mabustl {
+    // 最低位 1 的位置，x 不能为 0
+    inline size_t bitset_ctz(uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzll(x));
+#else
+        size_t result = 0;
+        while((x & 1) == 0) {
+            x >>= 1;
+            ++result;
+        }
+        return result;
+#endif
+    }
+
+    // 一个字中 1 的个数，没有 popcnt 指令时用 SWAR：先两位一组求和，再四位、八位，最后用乘法把各字节加到最高字节
+    inline size_t bitset_popcount(uint64_t x) noexcept {
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__POPCNT__)
+        return static_cast<size_t>(__builtin_popcountll(x));
+#else
+        x = x - ((x >> 1) & 0x5555555555555555ull);
+        x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+        return static_cast<size_t>((x * 0x0101010101010101ull) >> 56);
+#endif
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * 按字运算的函数对象，统计 op(a[i], b[i]) 中 1 的个数时使用
+    * *****************************************************************************************************************
+    */
+    struct bitset_first_op {
+        uint64_t operator()(uint64_t a, uint64_t) const noexcept { return a; }
+#if defined(MABUSTL_BITSET_AVX2)
+        __m256i operator()(__m256i a, __m256i) const noexcept { return a; }
+#endif
+    };
+
+    struct bitset_and_op {
+        uint64_t operator()(uint64_t a, uint64_t b) const noexcept { return a & b; }
+#if defined(MABUSTL_BITSET_AVX2)
+        __m256i operator()(__m256i a, __m256i b) const noexcept { return _mm256_and_si256(a, b); }
+#endif
+    };
+
+    struct bitset_or_op {
+        uint64_t operator()(uint64_t a, uint64_t b) const noexcept { return a | b; }
+#if defined(MABUSTL_BITSET_AVX2)
+        __m256i operator()(__m256i a, __m256i b) const noexcept { return _mm256_or_si256(a, b); }
+#endif
+    };
+
+    struct bitset_xor_op {
+        uint64_t operator()(uint64_t a, uint64_t b) const noexcept { return a ^ b; }
+#if defined(MABUSTL_BITSET_AVX2)
+        __m256i operator()(__m256i a, __m256i b) const noexcept { return _mm256_xor_si256(a, b); }
+#endif
+    };
+
+    struct bitset_andnot_op {
+        uint64_t operator()(uint64_t a, uint64_t b) const noexcept { return a & ~b; }
+#if defined(MABUSTL_BITSET_AVX2)
+        __m256i operator()(__m256i a, __m256i b) const noexcept { return _mm256_andnot_si256(b, a); }
+#endif
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * bitset_count_words
+    * 统计 op(a[i], b[i]) (0 <= i < n) 中 1 的总数
+    * *****************************************************************************************************************
+    */
+#if defined(MABUSTL_BITSET_AVX2)
+    // 每个字节拆成高低两个 4 位，用 pshufb 查表得到各自 1 的个数，sad 把 32 个字节的计数加到 4 个 64 位整数中
+    template<class Op>
+    size_t bitset_count_words(const uint64_t* a, const uint64_t* b, size_t n, Op op) noexcept {
+        const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low_mask = _mm256_set1_epi8(0x0F);
+        __m256i acc = _mm256_setzero_si256();
+        size_t i = 0;
+        for(; i + 4 <= n; i += 4) {
+            const __m256i v = op(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                 _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+            const __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+        }
+        size_t total = static_cast<size_t>(_mm256_extract_epi64(acc, 0)) +
+                       static_cast<size_t>(_mm256_extract_epi64(acc, 1)) +
+                       static_cast<size_t>(_mm256_extract_epi64(acc, 2)) +
+                       static_cast<size_t>(_mm256_extract_epi64(acc, 3));
+        for(; i != n; ++i) total += bitset_popcount(op(a[i], b[i]));
+        return total;
+    }
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__POPCNT__)
+    // popcnt 的吞吐量是每周期一个，四个累加器打断依赖链
+    template<class Op>
+    size_t bitset_count_words(const uint64_t* a, const uint64_t* b, size_t n, Op op) noexcept {
+        size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+        size_t i = 0;
+        for(; i + 4 <= n; i += 4) {
+            c0 += bitset_popcount(op(a[i], b[i]));
+            c1 += bitset_popcount(op(a[i + 1], b[i + 1]));
+            c2 += bitset_popcount(op(a[i + 2], b[i + 2]));
+            c3 += bitset_popcount(op(a[i + 3], b[i + 3]));
+        }
+        for(; i != n; ++i) c0 += bitset_popcount(op(a[i], b[i]));
+        return c0 + c1 + c2 + c3;
+    }
+#else
+    // 进位保存加法器：把 a b c 三个字按位相加，low 为和的本位，high 为进位
+    inline void bitset_csa(uint64_t& high, uint64_t& low, uint64_t a, uint64_t b, uint64_t c) noexcept {
+        const uint64_t u = a ^ b;
+        high = (a & b) | (u & c);
+        low = u ^ c;
+    }
+
+    // Harley-Seal：每 16 个字经过 15 次 CSA 只留下一个权重为 16 的字需要 popcount
+    template<class Op>
+    size_t bitset_count_words(const uint64_t* a, const uint64_t* b, size_t n, Op op) noexcept {
+        uint64_t ones = 0, twos = 0, fours = 0, eights = 0, sixteens = 0;
+        uint64_t twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+        size_t total = 0;
+        size_t i = 0;
+        for(; i + 16 <= n; i += 16) {
+            bitset_csa(twos_a, ones, ones, op(a[i], b[i]), op(a[i + 1], b[i + 1]));
+            bitset_csa(twos_b, ones, ones, op(a[i + 2], b[i + 2]), op(a[i + 3], b[i + 3]));
+            bitset_csa(fours_a, twos, twos, twos_a, twos_b);
+            bitset_csa(twos_a, ones, ones, op(a[i + 4], b[i + 4]), op(a[i + 5], b[i + 5]));
+            bitset_csa(twos_b, ones, ones, op(a[i + 6], b[i + 6]), op(a[i + 7], b[i + 7]));
+            bitset_csa(fours_b, twos, twos, twos_a, twos_b);
+            bitset_csa(eights_a, fours, fours, fours_a, fours_b);
+            bitset_csa(twos_a, ones, ones, op(a[i + 8], b[i + 8]), op(a[i + 9], b[i + 9]));
+            bitset_csa(twos_b, ones, ones, op(a[i + 10], b[i + 10]), op(a[i + 11], b[i + 11]));
+            bitset_csa(fours_a, twos, twos, twos_a, twos_b);
+            bitset_csa(twos_a, ones, ones, op(a[i + 12], b[i + 12]), op(a[i + 13], b[i + 13]));
+            bitset_csa(twos_b, ones, ones, op(a[i + 14], b[i + 14]), op(a[i + 15], b[i + 15]));
+            bitset_csa(fours_b, twos, twos, twos_a, twos_b);
+            bitset_csa(eights_b, fours, fours, fours_a, fours_b);
+            bitset_csa(sixteens, eights, eights, eights_a, eights_b);
+            total += bitset_popcount(sixteens);
+        }
+        total = 16 * total + 8 * bitset_popcount(eights) + 4 * bitset_popcount(fours) +
+                2 * bitset_popcount(twos) + bitset_popcount(ones);
+        for(; i != n; ++i) total += bitset_popcount(op(a[i], b[i]));
+        return total;
+    }
+#endif
+
+    // 元素是否为负数，无符号类型不做比较
+    template<class T>
+    bool bitset_is_negative(const T& x, std::true_type) noexcept { return x < T(0); }
+
+    template<class T>
+    bool bitset_is_negative(const T&, std::false_type) noexcept { return false; }
+
+    /*
+    * *****************************************************************************************************************
+    * dynamic_bitset
+    * *****************************************************************************************************************
+    */
+    template<class Alloc = mabustl::allocator<uint64_t> >
+    class dynamic_bitset {
+    public:
+        typedef uint64_t block_type;
+        typedef Alloc allocator_type;
+        typedef mabustl::vector<block_type, Alloc> container_type;
+        typedef typename container_type::size_type size_type;
+
+        static constexpr size_type bits_per_block = 64;
+        static constexpr size_type npos = static_cast<size_type>(-1);
+
+    private:
+        container_type blocks_;
+        size_type size_;
+
+    public:
+        // 构造、复制、移动函数
+        dynamic_bitset() noexcept: blocks_(), size_(0) {}
+
+        explicit dynamic_bitset(const Alloc& alloc) noexcept: blocks_(alloc), size_(0) {}
+
+        // n 位，全部为 value
+        explicit dynamic_bitset(size_type n, bool value = false, const Alloc& alloc = Alloc())
+            : blocks_(block_count(n), value ? ~block_type(0) : block_type(0), alloc), size_(n) {
+            clear_unused_bits();
+        }
+
+        // 由元素区间构造，位数为 max(n, 最大元素 + 1)
+        template<class InputIter, typename std::enable_if<mabustl::is_input_iterator<InputIter>::value, int>::type = 0>
+        dynamic_bitset(InputIter first, InputIter last, size_type n = 0, const Alloc& alloc = Alloc())
+            : blocks_(block_count(n), block_type(0), alloc), size_(n) {
+            insert_elements(first, last);
+        }
+
+        dynamic_bitset(const dynamic_bitset& rhs) = default;
+
+        dynamic_bitset(dynamic_bitset&& rhs) noexcept: blocks_(mabustl::move(rhs.blocks_)), size_(rhs.size_) {
+            rhs.size_ = 0;
+        }
+
+        dynamic_bitset& operator=(const dynamic_bitset& rhs) = default;
+
+        dynamic_bitset& operator=(dynamic_bitset&& rhs) noexcept {
+            if(this != &rhs) {
+                blocks_ = mabustl::move(rhs.blocks_);
+                size_ = rhs.size_;
+                rhs.size_ = 0;
+            }
+            return *this;
+        }
+
+        ~dynamic_bitset() = default;
+
+        // 容量相关操作
+        size_type size() const noexcept { return size_; }
+        size_type num_blocks() const noexcept { return blocks_.size(); }
+        bool empty() const noexcept { return size_ == 0; }
+
+        // 位数的上限：block_count 不会溢出，块数也不超过 vector 的上限
+        size_type max_size() const noexcept {
+            const size_type blocks = blocks_.max_size();
+            return blocks > npos / bits_per_block ? npos / bits_per_block * bits_per_block : blocks * bits_per_block;
+        }
+
+        void reserve(size_type n) {
+            THROW_LENGTH_ERROR_IF(n > max_size(), "dynamic_bitset<>::reserve() n too big");
+            blocks_.reserve(block_count(n));
+        }
+
+        // 新增的位为 value
+        void resize(size_type n, bool value = false);
+
+        void push_back(bool value) {
+            if(size_ % bits_per_block == 0) blocks_.push_back(0);
+            ++size_;
+            set(size_ - 1, value);
+        }
+
+        void clear() noexcept {
+            blocks_.clear();
+            size_ = 0;
+        }
+
+        // 访问底层的字，最后一个字中超出 size() 的位必须保持为 0
+        block_type* data() noexcept { return blocks_.data(); }
+        const block_type* data() const noexcept { return blocks_.data(); }
+
+        allocator_type get_allocator() const { return blocks_.get_allocator(); }
+
+        // 单个位的操作
+        bool test(size_type pos) const {
+            THROW_OUT_OF_LENGTH_IF(pos >= size_, "dynamic_bitset<>::test() subscript out of range");
+            return (*this)[pos];
+        }
+
+        bool operator[](size_type pos) const noexcept {
+            MABUSTL_DEBUG(pos < size_);
+            return (blocks_[block_index(pos)] >> bit_index(pos)) & 1;
+        }
+
+        dynamic_bitset& set(size_type pos, bool value = true) noexcept {
+            MABUSTL_DEBUG(pos < size_);
+            const block_type mask = block_type(1) << bit_index(pos);
+            if(value) blocks_[block_index(pos)] |= mask;
+            else blocks_[block_index(pos)] &= ~mask;
+            return *this;
+        }
+
+        dynamic_bitset& reset(size_type pos) noexcept {
+            return set(pos, false);
+        }
+
+        dynamic_bitset& flip(size_type pos) noexcept {
+            MABUSTL_DEBUG(pos < size_);
+            blocks_[block_index(pos)] ^= block_type(1) << bit_index(pos);
+            return *this;
+        }
+
+        // 所有位的操作
+        dynamic_bitset& set() noexcept {
+            mabustl::fill(blocks_.begin(), blocks_.end(), ~block_type(0));
+            clear_unused_bits();
+            return *this;
+        }
+
+        dynamic_bitset& reset() noexcept {
+            mabustl::fill(blocks_.begin(), blocks_.end(), block_type(0));
+            return *this;
+        }
+
+        dynamic_bitset& flip() noexcept {
+            for(size_type i = 0; i != blocks_.size(); ++i) blocks_[i] = ~blocks_[i];
+            clear_unused_bits();
+            return *this;
+        }
+
+        // 统计相关操作
+        size_type count() const noexcept {
+            return bitset_count_words(blocks_.data(), blocks_.data(), blocks_.size(), bitset_first_op());
+        }
+
+        bool any() const noexcept;
+
+        bool none() const noexcept { return !any(); }
+
+        bool all() const noexcept { return count() == size_; }
+
+        // 与 set_union、set_intersection、set_difference、set_symmetric_difference 对应的元素个数，不生成结果
+        size_type union_count(const dynamic_bitset& rhs) const noexcept {
+            return count_with(rhs, bitset_or_op(), true, true);
+        }
+
+        size_type intersection_count(const dynamic_bitset& rhs) const noexcept {
+            return count_with(rhs, bitset_and_op(), false, false);
+        }
+
+        size_type difference_count(const dynamic_bitset& rhs) const noexcept {
+            return count_with(rhs, bitset_andnot_op(), true, false);
+        }
+
+        size_type symmetric_difference_count(const dynamic_bitset& rhs) const noexcept {
+            return count_with(rhs, bitset_xor_op(), true, true);
+        }
+
+        // 是否是 rhs 的子集，是否与 rhs 有公共元素
+        bool is_subset_of(const dynamic_bitset& rhs) const noexcept;
+
+        bool intersects(const dynamic_bitset& rhs) const noexcept;
+
+        // 查找相关操作，找不到时返回 npos
+        size_type find_first() const noexcept {
+            return find_from(0);
+        }
+
+        // pos 之后(不含 pos)第一个为 1 的位
+        size_type find_next(size_type pos) const noexcept {
+            return pos + 1 >= size_ ? npos : find_from(pos + 1);
+        }
+
+        // 按从小到大的顺序对每个为 1 的位置调用 f(pos)
+        template<class Function>
+        void for_each_set(Function f) const;
+
+        // 与元素区间的转换，元素不能是负数，也不能大于等于 max_size()
+        template<class InputIter>
+        void insert_elements(InputIter first, InputIter last);
+
+        template<class OutputIter>
+        OutputIter to_elements(OutputIter result) const;
+
+        // 按字并行的集合运算
+        dynamic_bitset& operator&=(const dynamic_bitset& rhs) noexcept;
+
+        dynamic_bitset& operator|=(const dynamic_bitset& rhs);
+
+        dynamic_bitset& operator^=(const dynamic_bitset& rhs);
+
+        dynamic_bitset& operator-=(const dynamic_bitset& rhs) noexcept;
+
+        dynamic_bitset operator~() const {
+            dynamic_bitset tmp(*this);
+            tmp.flip();
+            return tmp;
+        }
+
+        void swap(dynamic_bitset& rhs) noexcept {
+            blocks_.swap(rhs.blocks_);
+            mabustl::swap(size_, rhs.size_);
+        }
+
+    public:
+        friend bool operator==(const dynamic_bitset& lhs, const dynamic_bitset& rhs) {
+            return lhs.size_ == rhs.size_ &&
+                   mabustl::equal(lhs.blocks_.begin(), lhs.blocks_.end(), rhs.blocks_.begin());
+        }
+
+        friend bool operator!=(const dynamic_bitset& lhs, const dynamic_bitset& rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        static size_type block_count(size_type bits) noexcept { return (bits + bits_per_block - 1) / bits_per_block; }
+        static size_type block_index(size_type pos) noexcept { return pos / bits_per_block; }
+        static size_type bit_index(size_type pos) noexcept { return pos % bits_per_block; }
+
+        // 把最后一个字中超出 size_ 的位清零
+        void clear_unused_bits() noexcept {
+            const size_type extra = bit_index(size_);
+            if(extra != 0) blocks_.back() &= (block_type(1) << extra) - 1;
+        }
+
+        size_type find_from(size_type pos) const noexcept;
+
+        // 公共部分用 op 统计，较长一方多出的字在 lhs_tail / rhs_tail 为真时计入
+        template<class Op>
+        size_type count_with(const dynamic_bitset& rhs, Op op, bool lhs_tail, bool rhs_tail) const noexcept;
+    };
+
+    /*****************************************************************************************************************/
+
+    template<class Alloc>
+    constexpr typename dynamic_bitset<Alloc>::size_type dynamic_bitset<Alloc>::bits_per_block;
+
+    template<class Alloc>
+    constexpr typename dynamic_bitset<Alloc>::size_type dynamic_bitset<Alloc>::npos;
+
+    template<class Alloc>
+    void dynamic_bitset<Alloc>::resize(size_type n, bool value) {
+        THROW_LENGTH_ERROR_IF(n > max_size(), "dynamic_bitset<>::resize() n too big");
+        const size_type old_size = size_;
+        blocks_.resize(block_count(n), value ? ~block_type(0) : block_type(0));
+        // 原来最后一个字中超出 old_size 的位是 0，需要时补成 1
+        if(value && n > old_size && bit_index(old_size) != 0) {
+            blocks_[block_index(old_size)] |= ~block_type(0) << bit_index(old_size);
+        }
+        size_ = n;
+        clear_unused_bits();
+    }
+
+    template<class Alloc>
+    bool dynamic_bitset<Alloc>::any() const noexcept {
+        for(size_type i = 0; i != blocks_.size(); ++i) {
+            if(blocks_[i] != 0) return true;
+        }
+        return false;
+    }
+
+    template<class Alloc>
+    bool dynamic_bitset<Alloc>::is_subset_of(const dynamic_bitset& rhs) const noexcept {
+        const size_type common = mabustl::min(blocks_.size(), rhs.blocks_.size());
+        for(size_type i = 0; i != common; ++i) {
+            if(blocks_[i] & ~rhs.blocks_[i]) return false;
+        }
+        for(size_type i = common; i < blocks_.size(); ++i) {
+            if(blocks_[i] != 0) return false;
+        }
+        return true;
+    }
+
+    template<class Alloc>
+    bool dynamic_bitset<Alloc>::intersects(const dynamic_bitset& rhs) const noexcept {
+        const size_type common = mabustl::min(blocks_.size(), rhs.blocks_.size());
+        for(size_type i = 0; i != common; ++i) {
+            if(blocks_[i] & rhs.blocks_[i]) return true;
+        }
+        return false;
+    }
+
+    template<class Alloc>
+    typename dynamic_bitset<Alloc>::size_type dynamic_bitset<Alloc>::find_from(size_type pos) const noexcept {
+        if(pos >= size_) return npos;
+        size_type i = block_index(pos);
+        block_type word = blocks_[i] & (~block_type(0) << bit_index(pos));
+        while(word == 0) {
+            if(++i == blocks_.size()) return npos;
+            word = blocks_[i];
+        }
+        return i * bits_per_block + bitset_ctz(word);
+    }
+
+    template<class Alloc>
+    template<class Function>
+    void dynamic_bitset<Alloc>::for_each_set(Function f) const {
+        for(size_type i = 0; i != blocks_.size(); ++i) {
+            for(block_type word = blocks_[i]; word != 0; word &= word - 1) {
+                f(i * bits_per_block + bitset_ctz(word));
+            }
+        }
+    }
+
+    // 元素超出当前位数时扩大，有序输入时位数每次扩大到最后一个元素，由 vector 保证摊还 O(1)
+    template<class Alloc>
+    template<class InputIter>
+    void dynamic_bitset<Alloc>::insert_elements(InputIter first, InputIter last) {
+        typedef typename iterator_traits<InputIter>::value_type element_type;
+        for(; first != last; ++first) {
+            THROW_OUT_OF_LENGTH_IF(bitset_is_negative(*first, std::is_signed<element_type>()),
+                                   "dynamic_bitset<>::insert_elements() negative element");
+            const size_type pos = static_cast<size_type>(*first);
+            // 检查在 pos + 1 之前，元素为 npos 时 pos + 1 会回绕成 0
+            THROW_LENGTH_ERROR_IF(pos >= max_size(), "dynamic_bitset<>::insert_elements() element too big");
+            if(pos >= size_) resize(pos + 1);
+            blocks_[block_index(pos)] |= block_type(1) << bit_index(pos);
+        }
+    }
+
+    template<class Alloc>
+    template<class OutputIter>
+    OutputIter dynamic_bitset<Alloc>::to_elements(OutputIter result) const {
+        for(size_type i = 0; i != blocks_.size(); ++i) {
+            for(block_type word = blocks_[i]; word != 0; word &= word - 1) {
+                *result = i * bits_per_block + bitset_ctz(word);
+                ++result;
+            }
+        }
+        return result;
+    }
+
+    template<class Alloc>
+    template<class Op>
+    typename dynamic_bitset<Alloc>::size_type
+    dynamic_bitset<Alloc>::count_with(const dynamic_bitset& rhs, Op op, bool lhs_tail,
+                                      bool rhs_tail) const noexcept {
+        const size_type common = mabustl::min(blocks_.size(), rhs.blocks_.size());
+        size_type total = bitset_count_words(blocks_.data(), rhs.blocks_.data(), common, op);
+        if(lhs_tail && blocks_.size() > common) {
+            total += bitset_count_words(blocks_.data() + common, blocks_.data() + common,
+                                        blocks_.size() - common, bitset_first_op());
+        }
+        if(rhs_tail && rhs.blocks_.size() > common) {
+            total += bitset_count_words(rhs.blocks_.data() + common, rhs.blocks_.data() + common,
+                                        rhs.blocks_.size() - common, bitset_first_op());
+        }
+        return total;
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * 集合运算
+    * 逐字计算的简单循环，编译器可以向量化
+    * *****************************************************************************************************************
+    */
+    template<class Alloc>
+    dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::operator&=(const dynamic_bitset& rhs) noexcept {
+        const size_type common = mabustl::min(blocks_.size(), rhs.blocks_.size());
+        block_type* a = blocks_.data();
+        const block_type* b = rhs.blocks_.data();
+        for(size_type i = 0; i != common; ++i) a[i] &= b[i];
+        for(size_type i = common; i < blocks_.size(); ++i) a[i] = 0;
+        return *this;
+    }
+
+    template<class Alloc>
+    dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::operator|=(const dynamic_bitset& rhs) {
+        if(rhs.size_ > size_) resize(rhs.size_);
+        block_type* a = blocks_.data();
+        const block_type* b = rhs.blocks_.data();
+        for(size_type i = 0; i != rhs.blocks_.size(); ++i) a[i] |= b[i];
+        return *this;
+    }
+
+    template<class Alloc>
+    dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::operator^=(const dynamic_bitset& rhs) {
+        if(rhs.size_ > size_) resize(rhs.size_);
+        block_type* a = blocks_.data();
+        const block_type* b = rhs.blocks_.data();
+        for(size_type i = 0; i != rhs.blocks_.size(); ++i) a[i] ^= b[i];
+        return *this;
+    }
+
+    template<class Alloc>
+    dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::operator-=(const dynamic_bitset& rhs) noexcept {
+        const size_type common = mabustl::min(blocks_.size(), rhs.blocks_.size());
+        block_type* a = blocks_.data();
+        const block_type* b = rhs.blocks_.data();
+        for(size_type i = 0; i != common; ++i) a[i] &= ~b[i];
+        return *this;
+    }
+
+    template<class Alloc>
+    dynamic_bitset<Alloc> operator&(const dynamic_bitset<Alloc>& lhs, const dynamic_bitset<Alloc>& rhs) {
+        dynamic_bitset<Alloc> tmp(lhs);
+        tmp &= rhs;
+        return tmp;
+    }
+
+    template<class Alloc>
+    dynamic_bitset<Alloc> operator|(const dynamic_bitset<Alloc>& lhs, const dynamic_bitset<Alloc>& rhs) {
+        dynamic_bitset<Alloc> tmp(lhs);
+        tmp |= rhs;
+        return tmp;
+    }
+
+    template<class Alloc>
+    dynamic_bitset<Alloc> operator^(const dynamic_bitset<Alloc>& lhs, const dynamic_bitset<Alloc>& rhs) {
+        dynamic_bitset<Alloc> tmp(lhs);
+        tmp ^= rhs;
+        return tmp;
+    }
+
+    template<class Alloc>
+    dynamic_bitset<Alloc> operator-(const dynamic_bitset<Alloc>& lhs, const dynamic_bitset<Alloc>& rhs) {
+        dynamic_bitset<Alloc> tmp(lhs);
+        tmp -= rhs;
+        return tmp;
+    }
+
+    // 重载 mabustl 的 swap
+    template<class Alloc>
+    void swap(dynamic_bitset<Alloc>& lhs, dynamic_bitset<Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,259 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * flat_hash_map: 以 flat_hash_table 为底层的哈希映射，key 不允许重复
+ * 元素直接存放在表的数组中，rehash、insert 和 erase 后迭代器、指针和引用都可能失效
+ */
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "mabu_allocator.h"
+#include "mabu_flat_hash_table.h"
+#include "mabu_functional.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    template<class Key, class T>
+    struct flat_hash_map_policy {
+        typedef Key key_type;
+        typedef pair<const Key, T> value_type;
+        typedef pair<Key, T> init_type;
+
+        static const Key& key(const value_type& value) noexcept {
+            return value.first;
+        }
+
+        static const Key& key(const init_type& value) noexcept {
+            return value.first;
+        }
+
+        // 原元素随后就会析构，通过 map_slot 从可修改的 key 移动构造
+        template<class Alloc>
+        static void transfer(Alloc& alloc, value_type* dst, value_type* src)
+            noexcept(std::is_nothrow_move_constructible<Key>::value && std::is_nothrow_move_constructible<T>::value) {
+            allocator_traits<Alloc>::construct(alloc, dst, mabustl::move(mabustl::map_slot_mutable(src)));
+            allocator_traits<Alloc>::destroy(alloc, src);
+        }
+    };
+
+    template<class Key, class T, class Hash = mabustl::hash<Key>, class KeyEqual = mabustl::equal_to<Key>,
+             class Alloc = mabustl::allocator<pair<const Key, T> > >
+    class flat_hash_map {
+    private:
+        typedef flat_hash_table<pair<const Key, T>, flat_hash_map_policy<Key, T>, Hash, KeyEqual, Alloc> base_type;
+
+        base_type ht_;
+
+    public:
+        typedef Key key_type;
+        typedef T mapped_type;
+        typedef typename base_type::value_type value_type;
+        typedef typename base_type::hasher hasher;
+        typedef typename base_type::key_equal key_equal;
+        typedef typename base_type::allocator_type allocator_type;
+
+        typedef typename base_type::size_type size_type;
+        typedef typename base_type::difference_type difference_type;
+        typedef typename base_type::pointer pointer;
+        typedef typename base_type::const_pointer const_pointer;
+        typedef typename base_type::reference reference;
+        typedef typename base_type::const_reference const_reference;
+
+        typedef typename base_type::iterator iterator;
+        typedef typename base_type::const_iterator const_iterator;
+
+    public:
+        // 构造、复制、移动函数
+        flat_hash_map(): ht_(0, Hash(), KeyEqual(), Alloc()) {}
+
+        explicit flat_hash_map(size_type bucket_count, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                               const Alloc& alloc = Alloc())
+            : ht_(bucket_count, hash, equal, alloc) {}
+
+        explicit flat_hash_map(const Alloc& alloc): ht_(0, Hash(), KeyEqual(), alloc) {}
+
+        template<class InputIter, typename std::enable_if<mabustl::is_input_iterator<InputIter>::value, int>::type = 0>
+        flat_hash_map(InputIter first, InputIter last, size_type bucket_count = 0, const Hash& hash = Hash(),
+                      const KeyEqual& equal = KeyEqual(), const Alloc& alloc = Alloc())
+            : ht_(bucket_count, hash, equal, alloc) {
+            insert(first, last);
+        }
+
+        flat_hash_map(std::initializer_list<value_type> ilist, size_type bucket_count = 0, const Hash& hash = Hash(),
+                      const KeyEqual& equal = KeyEqual(), const Alloc& alloc = Alloc())
+            : ht_(bucket_count, hash, equal, alloc) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        flat_hash_map(const flat_hash_map& rhs): ht_(rhs.ht_) {}
+
+        flat_hash_map(flat_hash_map&& rhs) noexcept: ht_(mabustl::move(rhs.ht_)) {}
+
+        flat_hash_map& operator=(const flat_hash_map& rhs) {
+            ht_ = rhs.ht_;
+            return *this;
+        }
+
+        flat_hash_map& operator=(flat_hash_map&& rhs) {
+            ht_ = mabustl::move(rhs.ht_);
+            return *this;
+        }
+
+        flat_hash_map& operator=(std::initializer_list<value_type> ilist) {
+            ht_.clear();
+            insert(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        ~flat_hash_map() = default;
+
+        // 迭代器相关操作
+        iterator begin() noexcept { return ht_.begin(); }
+        const_iterator begin() const noexcept { return ht_.begin(); }
+        iterator end() noexcept { return ht_.end(); }
+        const_iterator end() const noexcept { return ht_.end(); }
+        const_iterator cbegin() const noexcept { return ht_.begin(); }
+        const_iterator cend() const noexcept { return ht_.end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return ht_.empty(); }
+        size_type size() const noexcept { return ht_.size(); }
+        size_type max_size() const noexcept { return ht_.max_size(); }
+
+        // 插入删除相关操作
+        template<class... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            return ht_.emplace_unique(mabustl::forward<Args>(args)...);
+        }
+
+        // key 不存在时才构造 mapped_type
+        template<class... Args>
+        pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+            return ht_.insert_with(key, [&](Alloc& alloc, value_type* p) {
+                allocator_traits<Alloc>::construct(alloc, p, key, mapped_type(mabustl::forward<Args>(args)...));
+            });
+        }
+
+        template<class... Args>
+        pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+            return ht_.insert_with(key, [&](Alloc& alloc, value_type* p) {
+                allocator_traits<Alloc>::construct(alloc, p, mabustl::move(key),
+                                                   mapped_type(mabustl::forward<Args>(args)...));
+            });
+        }
+
+        pair<iterator, bool> insert(const value_type& value) {
+            return ht_.insert_unique(value);
+        }
+
+        pair<iterator, bool> insert(value_type&& value) {
+            return ht_.insert_unique(mabustl::move(value));
+        }
+
+        template<class InputIter>
+        void insert(InputIter first, InputIter last) {
+            for(; first != last; ++first) ht_.insert_unique(*first);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        template<class M>
+        pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+            pair<iterator, bool> result = try_emplace(key, mabustl::forward<M>(obj));
+            if(!result.second) result.first->second = mabustl::forward<M>(obj);
+            return result;
+        }
+
+        iterator erase(const_iterator pos) { return ht_.erase(pos); }
+        iterator erase(const_iterator first, const_iterator last) { return ht_.erase(first, last); }
+        size_type erase(const key_type& key) { return ht_.erase_key(key); }
+
+        void clear() noexcept { ht_.clear(); }
+
+        void swap(flat_hash_map& rhs) noexcept { ht_.swap(rhs.ht_); }
+
+        // 查找相关操作
+        mapped_type& at(const key_type& key) {
+            iterator it = ht_.find(key);
+            THROW_OUT_OF_LENGTH_IF(it == ht_.end(), "flat_hash_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        const mapped_type& at(const key_type& key) const {
+            const_iterator it = ht_.find(key);
+            THROW_OUT_OF_LENGTH_IF(it == ht_.end(), "flat_hash_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        mapped_type& operator[](const key_type& key) {
+            return try_emplace(key).first->second;
+        }
+
+        mapped_type& operator[](key_type&& key) {
+            return try_emplace(mabustl::move(key)).first->second;
+        }
+
+        size_type count(const key_type& key) const { return ht_.count(key); }
+
+        bool contains(const key_type& key) const { return ht_.contains(key); }
+
+        iterator find(const key_type& key) { return ht_.find(key); }
+        const_iterator find(const key_type& key) const { return ht_.find(key); }
+
+        pair<iterator, iterator> equal_range(const key_type& key) {
+            iterator it = ht_.find(key);
+            iterator last = it;
+            if(it != ht_.end()) ++last;
+            return pair<iterator, iterator>(it, last);
+        }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+            const_iterator it = ht_.find(key);
+            const_iterator last = it;
+            if(it != ht_.end()) ++last;
+            return pair<const_iterator, const_iterator>(it, last);
+        }
+
+        // bucket 与 hash policy
+        size_type bucket_count() const noexcept { return ht_.bucket_count(); }
+        size_type capacity() const noexcept { return ht_.capacity(); }
+        float load_factor() const noexcept { return ht_.load_factor(); }
+        float max_load_factor() const noexcept { return ht_.max_load_factor(); }
+
+        void rehash(size_type count) { ht_.rehash(count); }
+        void reserve(size_type count) { ht_.reserve(count); }
+
+        hasher hash_function() const { return ht_.hash_function(); }
+        key_equal key_eq() const { return ht_.key_eq(); }
+        allocator_type get_allocator() const { return ht_.get_allocator(); }
+
+    public:
+        friend bool operator==(const flat_hash_map& lhs, const flat_hash_map& rhs) {
+            if(lhs.size() != rhs.size()) return false;
+            for(const_iterator it = lhs.begin(); it != lhs.end(); ++it) {
+                const_iterator other = rhs.find(it->first);
+                if(other == rhs.end() || !(other->second == it->second)) return false;
+            }
+            return true;
+        }
+
+        friend bool operator!=(const flat_hash_map& lhs, const flat_hash_map& rhs) {
+            return !(lhs == rhs);
+        }
+    };
+
+    // 重载 mabustl 的 swap
+    template<class Key, class T, class Hash, class KeyEqual, class Alloc>
+    void swap(flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+              flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
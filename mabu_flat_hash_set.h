@@ -0,0 +1,199 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * flat_hash_set: 以 flat_hash_table 为底层的哈希集合，元素不允许重复
+ * 元素直接存放在表的数组中，rehash、insert 和 erase 后迭代器、指针和引用都可能失效
+ */
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "mabu_allocator.h"
+#include "mabu_flat_hash_table.h"
+#include "mabu_functional.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    template<class Key>
+    struct flat_hash_set_policy {
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Key init_type;
+
+        static const Key& key(const value_type& value) noexcept {
+            return value;
+        }
+
+        template<class Alloc>
+        static void transfer(Alloc& alloc, value_type* dst, value_type* src)
+            noexcept(std::is_nothrow_move_constructible<Key>::value) {
+            allocator_traits<Alloc>::construct(alloc, dst, mabustl::move(*src));
+            allocator_traits<Alloc>::destroy(alloc, src);
+        }
+    };
+
+    template<class Key, class Hash = mabustl::hash<Key>, class KeyEqual = mabustl::equal_to<Key>,
+             class Alloc = mabustl::allocator<Key> >
+    class flat_hash_set {
+    private:
+        typedef flat_hash_table<Key, flat_hash_set_policy<Key>, Hash, KeyEqual, Alloc> base_type;
+
+        base_type ht_;
+
+    public:
+        typedef Key key_type;
+        typedef typename base_type::value_type value_type;
+        typedef typename base_type::hasher hasher;
+        typedef typename base_type::key_equal key_equal;
+        typedef typename base_type::allocator_type allocator_type;
+
+        typedef typename base_type::size_type size_type;
+        typedef typename base_type::difference_type difference_type;
+        typedef typename base_type::const_pointer pointer;
+        typedef typename base_type::const_pointer const_pointer;
+        typedef typename base_type::const_reference reference;
+        typedef typename base_type::const_reference const_reference;
+
+        // 修改元素会破坏哈希表，所以 iterator 也是 const 的
+        typedef typename base_type::const_iterator iterator;
+        typedef typename base_type::const_iterator const_iterator;
+
+    public:
+        // 构造、复制、移动函数
+        flat_hash_set(): ht_(0, Hash(), KeyEqual(), Alloc()) {}
+
+        explicit flat_hash_set(size_type bucket_count, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                               const Alloc& alloc = Alloc())
+            : ht_(bucket_count, hash, equal, alloc) {}
+
+        explicit flat_hash_set(const Alloc& alloc): ht_(0, Hash(), KeyEqual(), alloc) {}
+
+        template<class InputIter, typename std::enable_if<mabustl::is_input_iterator<InputIter>::value, int>::type = 0>
+        flat_hash_set(InputIter first, InputIter last, size_type bucket_count = 0, const Hash& hash = Hash(),
+                      const KeyEqual& equal = KeyEqual(), const Alloc& alloc = Alloc())
+            : ht_(bucket_count, hash, equal, alloc) {
+            insert(first, last);
+        }
+
+        flat_hash_set(std::initializer_list<value_type> ilist, size_type bucket_count = 0, const Hash& hash = Hash(),
+                      const KeyEqual& equal = KeyEqual(), const Alloc& alloc = Alloc())
+            : ht_(bucket_count, hash, equal, alloc) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        flat_hash_set(const flat_hash_set& rhs): ht_(rhs.ht_) {}
+
+        flat_hash_set(flat_hash_set&& rhs) noexcept: ht_(mabustl::move(rhs.ht_)) {}
+
+        flat_hash_set& operator=(const flat_hash_set& rhs) {
+            ht_ = rhs.ht_;
+            return *this;
+        }
+
+        flat_hash_set& operator=(flat_hash_set&& rhs) {
+            ht_ = mabustl::move(rhs.ht_);
+            return *this;
+        }
+
+        flat_hash_set& operator=(std::initializer_list<value_type> ilist) {
+            ht_.clear();
+            insert(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        ~flat_hash_set() = default;
+
+        // 迭代器相关操作
+        iterator begin() const noexcept { return ht_.begin(); }
+        iterator end() const noexcept { return ht_.end(); }
+        const_iterator cbegin() const noexcept { return ht_.begin(); }
+        const_iterator cend() const noexcept { return ht_.end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return ht_.empty(); }
+        size_type size() const noexcept { return ht_.size(); }
+        size_type max_size() const noexcept { return ht_.max_size(); }
+
+        // 插入删除相关操作
+        template<class... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            return ht_.emplace_unique(mabustl::forward<Args>(args)...);
+        }
+
+        pair<iterator, bool> insert(const value_type& value) {
+            return ht_.insert_unique(value);
+        }
+
+        pair<iterator, bool> insert(value_type&& value) {
+            return ht_.insert_unique(mabustl::move(value));
+        }
+
+        template<class InputIter>
+        void insert(InputIter first, InputIter last) {
+            for(; first != last; ++first) ht_.insert_unique(*first);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        iterator erase(const_iterator pos) { return ht_.erase(pos); }
+        iterator erase(const_iterator first, const_iterator last) { return ht_.erase(first, last); }
+        size_type erase(const key_type& key) { return ht_.erase_key(key); }
+
+        void clear() noexcept { ht_.clear(); }
+
+        void swap(flat_hash_set& rhs) noexcept { ht_.swap(rhs.ht_); }
+
+        // 查找相关操作
+        size_type count(const key_type& key) const { return ht_.count(key); }
+
+        bool contains(const key_type& key) const { return ht_.contains(key); }
+
+        iterator find(const key_type& key) const { return ht_.find(key); }
+
+        pair<iterator, iterator> equal_range(const key_type& key) const {
+            iterator it = ht_.find(key);
+            iterator last = it;
+            if(it != ht_.end()) ++last;
+            return pair<iterator, iterator>(it, last);
+        }
+
+        // bucket 与 hash policy
+        size_type bucket_count() const noexcept { return ht_.bucket_count(); }
+        size_type capacity() const noexcept { return ht_.capacity(); }
+        float load_factor() const noexcept { return ht_.load_factor(); }
+        float max_load_factor() const noexcept { return ht_.max_load_factor(); }
+
+        void rehash(size_type count) { ht_.rehash(count); }
+        void reserve(size_type count) { ht_.reserve(count); }
+
+        hasher hash_function() const { return ht_.hash_function(); }
+        key_equal key_eq() const { return ht_.key_eq(); }
+        allocator_type get_allocator() const { return ht_.get_allocator(); }
+
+    public:
+        friend bool operator==(const flat_hash_set& lhs, const flat_hash_set& rhs) {
+            if(lhs.size() != rhs.size()) return false;
+            for(const_iterator it = lhs.begin(); it != lhs.end(); ++it) {
+                if(!rhs.contains(*it)) return false;
+            }
+            return true;
+        }
+
+        friend bool operator!=(const flat_hash_set& lhs, const flat_hash_set& rhs) {
+            return !(lhs == rhs);
+        }
+    };
+
+    // 重载 mabustl 的 swap
+    template<class Key, class Hash, class KeyEqual, class Alloc>
+    void swap(flat_hash_set<Key, Hash, KeyEqual, Alloc>& lhs, flat_hash_set<Key, Hash, KeyEqual, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
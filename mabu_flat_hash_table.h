@@ -0,0 +1,806 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * flat_hash_table: 开放寻址的哈希表，flat_hash_map 和 flat_hash_set 的底层实现
+ * 结构与 Swiss table 相同：
+ * (1)元素直接存放在一个数组(slots)中，另有一个等长的控制字节数组(ctrl)，每个位置一个字节
+ * (2)控制字节为 空 / 已删除 / 哨兵，或者元素哈希值的低 7 位(h2)
+ * (3)查找时按组(SSE2 下 16 个，否则 8 个)比较控制字节，一条指令得到组内 h2 相同的位置，只有这些位置需要比较 key
+ * (4)容量总是 2^k - 1，最大负载为 7/8，按组做二次探测
+ * 删除时如果该位置所在的探测窗口中存在空位，直接标记为空而不留下墓碑
+ * mabustl::hash 对整数是恒等映射，表内会先把哈希值做一次乘法混合，再拆分出 h1(探测起点) 和 h2
+ * 注意：rehash 时逐个移动元素，元素的移动构造和 hash 不应抛出异常
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "mabu_allocator.h"
+#include "mabu_allocator_traits.h"
+#include "mabu_construct.h"
+#include "mabu_iterator.h"
+#include "mabu_stddef.h"
+#include "mabu_type_traits.h"
+#include "mabu_utility.h"
+
+#if !defined(MABUSTL_NO_SSE2) && (defined(__SSE2__) || defined(_M_X64) || \
+                                  (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MABUSTL_FLAT_HASH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace mabustl {
+    // 控制字节：非负值表示该位置有元素，值为 h2
+    typedef signed char hash_ctrl_t;
+
+    enum : hash_ctrl_t {
+        CTRL_EMPTY = -128,    // 0b10000000
+        CTRL_DELETED = -2,    // 0b11111110
+        CTRL_SENTINEL = -1    // 0b11111111，位于 ctrl[capacity]，迭代到这里结束
+    };
+
+    // 把哈希值混合到所有位上，使恒等哈希的相邻整数分散到不同的组
+    inline size_t flat_hash_mix(size_t h) noexcept {
+#if defined(__SIZEOF_INT128__) && __SIZEOF_POINTER__ == 8
+        const unsigned __int128 product = static_cast<unsigned __int128>(h) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(product >> 64) ^ static_cast<size_t>(product);
+#elif (_MSC_VER && _WIN64) || ((__GNUC__ || __clang__) && __SIZEOF_POINTER__ == 8)
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        return h;
+#else
+        h ^= h >> 16;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        return h;
+#endif
+    }
+
+    // 最低位 1 的位置，x 不能为 0
+    inline size_t hash_ctz(uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzll(x));
+#else
+        size_t result = 0;
+        while((x & 1) == 0) {
+            x >>= 1;
+            ++result;
+        }
+        return result;
+#endif
+    }
+
+    // 最高位 1 之前 0 的个数，x 不能为 0
+    inline size_t hash_clz(uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_clzll(x));
+#else
+        size_t result = 0;
+        while((x & (1ull << 63)) == 0) {
+            x <<= 1;
+            ++result;
+        }
+        return result;
+#endif
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * hash_bitmask
+    * 组内匹配结果，每个位置占 2^Shift 位，可以依次取出为 1 的位置
+    * *****************************************************************************************************************
+    */
+    template<size_t Width, size_t Shift>
+    class hash_bitmask {
+    private:
+        uint64_t mask_;
+
+    public:
+        explicit hash_bitmask(uint64_t mask) noexcept: mask_(mask) {}
+
+        explicit operator bool() const noexcept { return mask_ != 0; }
+
+        // 第一个匹配的位置
+        size_t lowest() const noexcept { return hash_ctz(mask_) >> Shift; }
+
+        void clear_lowest() noexcept { mask_ &= mask_ - 1; }
+
+        // 第一个匹配位置之前不匹配的个数
+        size_t trailing_zeros() const noexcept { return mask_ == 0 ? Width : lowest(); }
+
+        // 最后一个匹配位置之后不匹配的个数
+        size_t leading_zeros() const noexcept {
+            if(mask_ == 0) return Width;
+            return (hash_clz(mask_) - (64 - (Width << Shift))) >> Shift;
+        }
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * hash_group
+    * 一次读入 WIDTH 个控制字节，批量比较
+    * *****************************************************************************************************************
+    */
+#if defined(MABUSTL_FLAT_HASH_SSE2)
+    struct hash_group {
+        enum : size_t { WIDTH = 16 };
+        typedef hash_bitmask<16, 0> bitmask;
+
+        __m128i ctrl;
+
+        explicit hash_group(const hash_ctrl_t* pos) noexcept
+            : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+        // 控制字节等于 h2 的位置
+        bitmask match(hash_ctrl_t h2) const noexcept {
+            return bitmask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))));
+        }
+
+        bitmask match_empty() const noexcept {
+            return match(CTRL_EMPTY);
+        }
+
+        bitmask match_empty_or_deleted() const noexcept {
+            return bitmask(empty_or_deleted_mask());
+        }
+
+        // 从头开始连续的空或已删除位置的个数
+        size_t count_leading_empty_or_deleted() const noexcept {
+            return bitmask(~empty_or_deleted_mask() & 0xFFFFu).trailing_zeros();
+        }
+
+    private:
+        // 空和已删除都小于哨兵
+        uint32_t empty_or_deleted_mask() const noexcept {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(CTRL_SENTINEL), ctrl)));
+        }
+    };
+#else
+    // 没有 SSE2 时用 64 位整数一次处理 8 个控制字节，假定为小端序
+    struct hash_group {
+        enum : size_t { WIDTH = 8 };
+        typedef hash_bitmask<8, 3> bitmask;
+
+        uint64_t ctrl;
+
+        explicit hash_group(const hash_ctrl_t* pos) noexcept {
+            std::memcpy(&ctrl, pos, sizeof(ctrl));
+        }
+
+        // 可能有假阳性(只会出现在有元素的位置)，调用者总会再比较 key
+        bitmask match(hash_ctrl_t h2) const noexcept {
+            const uint64_t lsbs = 0x0101010101010101ull;
+            const uint64_t msbs = 0x8080808080808080ull;
+            const uint64_t x = ctrl ^ (lsbs * static_cast<unsigned char>(h2));
+            return bitmask((x - lsbs) & ~x & msbs);
+        }
+
+        // 空: 最高位为 1 且第 1 位为 0
+        bitmask match_empty() const noexcept {
+            return bitmask((ctrl & (~ctrl << 6)) & 0x8080808080808080ull);
+        }
+
+        bitmask match_empty_or_deleted() const noexcept {
+            return bitmask(empty_or_deleted_mask());
+        }
+
+        size_t count_leading_empty_or_deleted() const noexcept {
+            return bitmask(~empty_or_deleted_mask() & 0x8080808080808080ull).trailing_zeros();
+        }
+
+    private:
+        // 空或已删除: 最高位为 1 且第 0 位为 0
+        uint64_t empty_or_deleted_mask() const noexcept {
+            return (ctrl & (~ctrl << 7)) & 0x8080808080808080ull;
+        }
+    };
+#endif
+
+    // 空表共用的控制字节，只有一个哨兵，从不写入
+    inline hash_ctrl_t* flat_hash_empty_group() noexcept {
+        alignas(16) static const hash_ctrl_t group[16] = {
+            CTRL_SENTINEL, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY,
+            CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY
+        };
+        return const_cast<hash_ctrl_t*>(group);
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * flat_hash_iterator
+    * 前向迭代器，跳过空和已删除的位置，遇到哨兵时结束
+    * *****************************************************************************************************************
+    */
+    template<class Value, class Ref, class Ptr>
+    struct flat_hash_iterator : public mabustl::iterator<mabustl::forward_iterator_tag, Value, ptrdiff_t, Ptr, Ref> {
+        typedef flat_hash_iterator<Value, Ref, Ptr> self;
+
+        const hash_ctrl_t* ctrl;
+        Value* slot;
+
+        flat_hash_iterator() noexcept: ctrl(nullptr), slot(nullptr) {}
+
+        flat_hash_iterator(const hash_ctrl_t* c, Value* s) noexcept: ctrl(c), slot(s) {}
+
+        // iterator 到 const_iterator 的转换
+        template<class R, class P, typename std::enable_if<std::is_convertible<P, Ptr>::value, int>::type = 0>
+        flat_hash_iterator(const flat_hash_iterator<Value, R, P>& rhs) noexcept: ctrl(rhs.ctrl), slot(rhs.slot) {}
+
+        Ref operator*() const { return *slot; }
+
+        Ptr operator->() const { return slot; }
+
+        self& operator++() {
+            ++ctrl;
+            ++slot;
+            skip_empty_or_deleted();
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        void skip_empty_or_deleted() {
+            while(*ctrl < CTRL_SENTINEL) {
+                const size_t shift = hash_group(ctrl).count_leading_empty_or_deleted();
+                ctrl += shift;
+                slot += shift;
+            }
+        }
+
+        friend bool operator==(const self& lhs, const self& rhs) { return lhs.ctrl == rhs.ctrl; }
+
+        friend bool operator!=(const self& lhs, const self& rhs) { return lhs.ctrl != rhs.ctrl; }
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * flat_hash_table
+    * Policy 提供 key_type、init_type(emplace 时临时元素的类型，key 可以移动)、
+    * static const key_type& key(const Value&) 和 key(const init_type&)，
+    * 以及 static void transfer(Alloc&, Value* dst, Value* src) noexcept(把 src 移动构造到 dst 并析构 src)
+    * *****************************************************************************************************************
+    */
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    class flat_hash_table {
+    public:
+        typedef typename Policy::key_type key_type;
+        typedef Value value_type;
+        typedef Hash hasher;
+        typedef KeyEqual key_equal;
+        typedef Alloc allocator_type;
+        typedef allocator_traits<Alloc> alloc_traits;
+
+        typedef typename alloc_traits::size_type size_type;
+        typedef typename alloc_traits::difference_type difference_type;
+        typedef Value& reference;
+        typedef const Value& const_reference;
+        typedef Value* pointer;
+        typedef const Value* const_pointer;
+
+        typedef flat_hash_iterator<Value, Value&, Value*> iterator;
+        typedef flat_hash_iterator<Value, const Value&, const Value*> const_iterator;
+
+    private:
+        typedef typename alloc_traits::template rebind_alloc<hash_ctrl_t> ctrl_allocator;
+        typedef allocator_traits<ctrl_allocator> ctrl_traits;
+
+        enum : size_t {
+            WIDTH = hash_group::WIDTH,
+            CLONED = WIDTH - 1    // ctrl 末尾复制了开头的 WIDTH - 1 个字节，这样从任意位置都能读入完整的一组
+        };
+
+        // 搬移元素时能否直接 memcpy
+        typedef std::integral_constant<bool, is_trivially_relocatable<Value>::value &&
+                                             allocator_uses_default_construct<Alloc>::value> relocate_by_memcpy;
+
+        // transfer 在 rehash 的中途调用，旧数组已经部分搬空，抛出异常时无法恢复
+        static_assert(relocate_by_memcpy::value || noexcept(Policy::transfer(std::declval<Alloc&>(),
+                                                                             std::declval<Value*>(),
+                                                                             std::declval<Value*>())),
+                      "flat_hash_table: Policy::transfer must not throw");
+
+        hash_ctrl_t* ctrl_;
+        Value* slots_;
+        size_type size_;
+        size_type capacity_;
+        size_type growth_left_;    // 不需要 rehash 还能放入的元素个数，已删除的位置不计入
+        hasher hash_;
+        key_equal equal_;
+        allocator_type alloc_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        flat_hash_table(size_type bucket_count, const Hash& hash, const KeyEqual& equal, const Alloc& alloc)
+            : ctrl_(flat_hash_empty_group()), slots_(nullptr), size_(0), capacity_(0), growth_left_(0),
+              hash_(hash), equal_(equal), alloc_(alloc) {
+            if(bucket_count != 0) resize(normalize_capacity(bucket_count));
+        }
+
+        flat_hash_table(const flat_hash_table& rhs)
+            : ctrl_(flat_hash_empty_group()), slots_(nullptr), size_(0), capacity_(0), growth_left_(0),
+              hash_(rhs.hash_), equal_(rhs.equal_),
+              alloc_(alloc_traits::select_on_container_copy_construction(rhs.alloc_)) {
+            try {
+                copy_from(rhs);
+            } catch(...) {
+                destroy_and_deallocate();
+                throw;
+            }
+        }
+
+        flat_hash_table(flat_hash_table&& rhs) noexcept
+            : ctrl_(rhs.ctrl_), slots_(rhs.slots_), size_(rhs.size_), capacity_(rhs.capacity_),
+              growth_left_(rhs.growth_left_), hash_(rhs.hash_), equal_(rhs.equal_), alloc_(mabustl::move(rhs.alloc_)) {
+            rhs.reset_empty();
+        }
+
+        flat_hash_table& operator=(const flat_hash_table& rhs);
+
+        flat_hash_table& operator=(flat_hash_table&& rhs);
+
+        ~flat_hash_table() {
+            destroy_and_deallocate();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept {
+            iterator it(ctrl_, slots_);
+            it.skip_empty_or_deleted();
+            return it;
+        }
+
+        const_iterator begin() const noexcept {
+            iterator it(ctrl_, slots_);
+            it.skip_empty_or_deleted();
+            return it;
+        }
+
+        iterator end() noexcept { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+        const_iterator end() const noexcept { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return size_ == 0; }
+        size_type size() const noexcept { return size_; }
+        size_type capacity() const noexcept { return capacity_; }
+        size_type max_size() const noexcept { return alloc_traits::max_size(alloc_); }
+
+        size_type bucket_count() const noexcept { return capacity_; }
+
+        float load_factor() const noexcept {
+            return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_);
+        }
+
+        // 最大负载固定为 7/8
+        float max_load_factor() const noexcept { return 0.875f; }
+
+        // 保证放入 n 个元素前不需要 rehash
+        void reserve(size_type n) {
+            if(n > size_ + growth_left_) resize(normalize_capacity(growth_to_lower_bound_capacity(n)));
+        }
+
+        // 把容量调整为能放下 max(n, size()) 个元素的最小容量，同时清除所有墓碑；n 和 size() 都为 0 时释放空间
+        void rehash(size_type n);
+
+        // 查找相关操作
+        iterator find(const key_type& key) {
+            const size_type i = find_index(key, hash_of(key));
+            return i == capacity_ ? end() : iterator(ctrl_ + i, slots_ + i);
+        }
+
+        const_iterator find(const key_type& key) const {
+            const size_type i = find_index(key, hash_of(key));
+            return i == capacity_ ? end() : iterator(ctrl_ + i, slots_ + i);
+        }
+
+        size_type count(const key_type& key) const {
+            return find_index(key, hash_of(key)) == capacity_ ? 0 : 1;
+        }
+
+        bool contains(const key_type& key) const {
+            return find_index(key, hash_of(key)) != capacity_;
+        }
+
+        // 插入相关操作，key 已存在时返回指向已有元素的迭代器和 false
+        pair<iterator, bool> insert_unique(const value_type& value) {
+            return insert_with(Policy::key(value), [&value](Alloc& alloc, Value* p) {
+                alloc_traits::construct(alloc, p, value);
+            });
+        }
+
+        pair<iterator, bool> insert_unique(value_type&& value) {
+            return insert_with(Policy::key(value), [&value](Alloc& alloc, Value* p) {
+                alloc_traits::construct(alloc, p, mabustl::move(value));
+            });
+        }
+
+        // 必须先构造出元素才能得到 key，临时元素的 key 不是 const，插入时可以移动
+        template<class... Args>
+        pair<iterator, bool> emplace_unique(Args&&... args) {
+            typename Policy::init_type tmp(mabustl::forward<Args>(args)...);
+            return insert_with(Policy::key(tmp), [&tmp](Alloc& alloc, Value* p) {
+                alloc_traits::construct(alloc, p, mabustl::move(tmp));
+            });
+        }
+
+        // key 不存在时调用 make(alloc, p) 在 p 处构造元素，make 构造的元素的 key 必须等于 key
+        template<class Maker>
+        pair<iterator, bool> insert_with(const key_type& key, Maker make);
+
+        // 删除相关操作
+        iterator erase(const_iterator pos) {
+            iterator next(pos.ctrl, pos.slot);
+            ++next;
+            erase_at(static_cast<size_type>(pos.ctrl - ctrl_));
+            return next;
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            while(first != last) first = erase(first);
+            return iterator(last.ctrl, last.slot);
+        }
+
+        size_type erase_key(const key_type& key) {
+            const size_type i = find_index(key, hash_of(key));
+            if(i == capacity_) return 0;
+            erase_at(i);
+            return 1;
+        }
+
+        // 析构所有元素，保留容量
+        void clear() noexcept;
+
+        void swap(flat_hash_table& rhs) noexcept;
+
+        hasher hash_function() const { return hash_; }
+        key_equal key_eq() const { return equal_; }
+        allocator_type get_allocator() const { return alloc_; }
+
+    private:
+        static size_type h1(size_t hash) noexcept { return hash >> 7; }
+        static hash_ctrl_t h2(size_t hash) noexcept { return static_cast<hash_ctrl_t>(hash & 0x7F); }
+        static bool is_full(hash_ctrl_t c) noexcept { return c >= 0; }
+
+        size_t hash_of(const key_type& key) const { return flat_hash_mix(hash_(key)); }
+
+        // 容量为 cap 时最多能放的元素个数
+        static size_type capacity_to_growth(size_type cap) noexcept {
+            return cap == 7 ? 6 : cap - cap / 8;
+        }
+
+        // 放下 growth 个元素需要的最小容量(未取整)
+        static size_type growth_to_lower_bound_capacity(size_type growth) noexcept {
+            if(growth == 0) return 0;
+            return growth == 7 ? 8 : growth + (growth - 1) / 7;
+        }
+
+        // 不小于 n 的 2^k - 1，并且至少为 WIDTH - 1
+        static size_type normalize_capacity(size_type n) noexcept {
+            size_type cap = WIDTH - 1;
+            while(cap < n) cap = cap * 2 + 1;
+            return cap;
+        }
+
+        // 设置控制字节，同时更新末尾复制的那一份
+        void set_ctrl(size_type i, hash_ctrl_t c) noexcept {
+            ctrl_[i] = c;
+            ctrl_[((i - CLONED) & capacity_) + (CLONED & capacity_)] = c;
+        }
+
+        // 查找 key，找不到时返回 capacity_
+        size_type find_index(const key_type& key, size_t hash) const;
+
+        // hash 的探测序列上第一个空或已删除的位置
+        size_type find_first_non_full(size_t hash) const noexcept;
+
+        // 为 hash 找到插入位置并设置控制字节，必要时先扩容，返回的位置上还没有构造元素
+        size_type prepare_insert(size_t hash);
+
+        // 析构 i 处的元素并更新控制字节
+        void erase_at(size_type i) {
+            alloc_traits::destroy(alloc_, slots_ + i);
+            erase_meta(i);
+        }
+
+        void erase_meta(size_type i) noexcept;
+
+        void rehash_and_grow_if_necessary();
+
+        // 分配容量为 new_cap 的新空间，把所有元素搬过去
+        void resize(size_type new_cap);
+
+        void transfer_slot(Value* dst, Value* src, std::true_type) {
+            std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(Value));
+        }
+
+        void transfer_slot(Value* dst, Value* src, std::false_type) {
+            Policy::transfer(alloc_, dst, src);
+        }
+
+        // 逐个复制 rhs 中的元素，rhs 中的 key 互不相同，不需要查找
+        void copy_from(const flat_hash_table& rhs);
+
+        void destroy_slots() noexcept {
+            if(std::is_trivially_destructible<Value>::value && allocator_uses_default_construct<Alloc>::value) return;
+            for(size_type i = 0; i != capacity_; ++i) {
+                if(is_full(ctrl_[i])) alloc_traits::destroy(alloc_, slots_ + i);
+            }
+        }
+
+        void deallocate_storage() noexcept {
+            if(capacity_ == 0) return;
+            ctrl_allocator ctrl_alloc(alloc_);
+            ctrl_traits::deallocate(ctrl_alloc, ctrl_, capacity_ + WIDTH);
+            alloc_traits::deallocate(alloc_, slots_, capacity_);
+        }
+
+        void destroy_and_deallocate() noexcept {
+            destroy_slots();
+            deallocate_storage();
+            reset_empty();
+        }
+
+        void reset_empty() noexcept {
+            ctrl_ = flat_hash_empty_group();
+            slots_ = nullptr;
+            size_ = capacity_ = growth_left_ = 0;
+        }
+
+        void steal(flat_hash_table& rhs) noexcept {
+            ctrl_ = rhs.ctrl_;
+            slots_ = rhs.slots_;
+            size_ = rhs.size_;
+            capacity_ = rhs.capacity_;
+            growth_left_ = rhs.growth_left_;
+            rhs.reset_empty();
+        }
+
+        void move_alloc(flat_hash_table& rhs, std::true_type) {
+            alloc_ = mabustl::move(rhs.alloc_);
+        }
+
+        void move_alloc(flat_hash_table&, std::false_type) {}
+
+        void swap_alloc(flat_hash_table& rhs, std::true_type) {
+            mabustl::swap(alloc_, rhs.alloc_);
+        }
+
+        void swap_alloc(flat_hash_table&, std::false_type) {}
+    };
+
+    /*****************************************************************************************************************/
+
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>&
+    flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::operator=(const flat_hash_table& rhs) {
+        if(this == &rhs) return *this;
+        clear();
+        if(alloc_traits::propagate_on_container_copy_assignment::value && !(alloc_ == rhs.alloc_)) {
+            deallocate_storage();
+            reset_empty();
+            alloc_ = rhs.alloc_;
+        }
+        hash_ = rhs.hash_;
+        equal_ = rhs.equal_;
+        copy_from(rhs);
+        return *this;
+    }
+
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>&
+    flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::operator=(flat_hash_table&& rhs) {
+        if(this == &rhs) return *this;
+        hash_ = mabustl::move(rhs.hash_);
+        equal_ = mabustl::move(rhs.equal_);
+        if(alloc_traits::propagate_on_container_move_assignment::value ||
+           alloc_traits::is_always_equal::value || alloc_ == rhs.alloc_) {
+            destroy_and_deallocate();
+            move_alloc(rhs, typename alloc_traits::propagate_on_container_move_assignment());
+            steal(rhs);
+        } else {
+            // allocator 不相等，只能逐个移动元素
+            clear();
+            reserve(rhs.size_);
+            for(size_type i = 0; i != rhs.capacity_; ++i) {
+                if(!is_full(rhs.ctrl_[i])) continue;
+                const size_t hash = hash_of(Policy::key(rhs.slots_[i]));
+                const size_type target = prepare_insert(hash);
+                try {
+                    alloc_traits::construct(alloc_, slots_ + target, mabustl::move(rhs.slots_[i]));
+                } catch(...) {
+                    erase_meta(target);
+                    throw;
+                }
+            }
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    void flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::rehash(size_type n) {
+        if(n == 0 && size_ == 0) {
+            destroy_and_deallocate();
+            return;
+        }
+        const size_type lower = growth_to_lower_bound_capacity(size_);
+        const size_type needed = normalize_capacity(n > lower ? n : lower);
+        if(n == 0 || needed > capacity_) resize(needed);
+    }
+
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    template<class Maker>
+    pair<typename flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::iterator, bool>
+    flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::insert_with(const key_type& key, Maker make) {
+        const size_t hash = hash_of(key);
+        size_type i = find_index(key, hash);
+        if(i != capacity_) return pair<iterator, bool>(iterator(ctrl_ + i, slots_ + i), false);
+
+        i = prepare_insert(hash);
+        try {
+            make(alloc_, slots_ + i);
+        } catch(...) {
+            erase_meta(i);
+            throw;
+        }
+        return pair<iterator, bool>(iterator(ctrl_ + i, slots_ + i), true);
+    }
+
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    void flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::clear() noexcept {
+        if(capacity_ == 0) return;
+        destroy_slots();
+        std::memset(ctrl_, static_cast<unsigned char>(CTRL_EMPTY), capacity_ + WIDTH);
+        ctrl_[capacity_] = CTRL_SENTINEL;
+        size_ = 0;
+        growth_left_ = capacity_to_growth(capacity_);
+    }
+
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    void flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::swap(flat_hash_table& rhs) noexcept {
+        if(this == &rhs) return;
+        mabustl::swap(ctrl_, rhs.ctrl_);
+        mabustl::swap(slots_, rhs.slots_);
+        mabustl::swap(size_, rhs.size_);
+        mabustl::swap(capacity_, rhs.capacity_);
+        mabustl::swap(growth_left_, rhs.growth_left_);
+        mabustl::swap(hash_, rhs.hash_);
+        mabustl::swap(equal_, rhs.equal_);
+        swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+    }
+
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    typename flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::size_type
+    flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::find_index(const key_type& key, size_t hash) const {
+        size_type offset = h1(hash) & capacity_;
+        size_type step = 0;
+        while(true) {
+            const hash_group group(ctrl_ + offset);
+            for(typename hash_group::bitmask m = group.match(h2(hash)); m; m.clear_lowest()) {
+                const size_type i = (offset + m.lowest()) & capacity_;
+                if(equal_(Policy::key(slots_[i]), key)) return i;
+            }
+            // 组内有空位说明 key 不可能在探测序列更靠后的位置
+            if(group.match_empty()) return capacity_;
+            step += WIDTH;
+            offset = (offset + step) & capacity_;
+        }
+    }
+
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    typename flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::size_type
+    flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::find_first_non_full(size_t hash) const noexcept {
+        size_type offset = h1(hash) & capacity_;
+        size_type step = 0;
+        while(true) {
+            const typename hash_group::bitmask m = hash_group(ctrl_ + offset).match_empty_or_deleted();
+            if(m) return (offset + m.lowest()) & capacity_;
+            step += WIDTH;
+            offset = (offset + step) & capacity_;
+        }
+    }
+
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    typename flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::size_type
+    flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::prepare_insert(size_t hash) {
+        size_type target = find_first_non_full(hash);
+        // 已删除的位置可以直接复用，不消耗 growth_left_
+        if(growth_left_ == 0 && ctrl_[target] != CTRL_DELETED) {
+            rehash_and_grow_if_necessary();
+            target = find_first_non_full(hash);
+        }
+        ++size_;
+        if(ctrl_[target] == CTRL_EMPTY) --growth_left_;
+        set_ctrl(target, h2(hash));
+        return target;
+    }
+
+    // 如果 i 前后连续的非空位置不足一组，那么任何探测都不会越过 i 继续向后，可以直接标记为空
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    void flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::erase_meta(size_type i) noexcept {
+        --size_;
+        const size_type before = (i - WIDTH) & capacity_;
+        const typename hash_group::bitmask empty_after = hash_group(ctrl_ + i).match_empty();
+        const typename hash_group::bitmask empty_before = hash_group(ctrl_ + before).match_empty();
+        const bool was_never_full = empty_before && empty_after &&
+                                    empty_after.trailing_zeros() + empty_before.leading_zeros() < WIDTH;
+        set_ctrl(i, was_never_full ? CTRL_EMPTY : CTRL_DELETED);
+        if(was_never_full) ++growth_left_;
+    }
+
+    // 墓碑较多时按原容量重建，否则容量翻倍
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    void flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::rehash_and_grow_if_necessary() {
+        if(capacity_ == 0) {
+            resize(WIDTH - 1);
+        } else if(size_ <= capacity_to_growth(capacity_) / 2) {
+            resize(capacity_);
+        } else {
+            resize(capacity_ * 2 + 1);
+        }
+    }
+
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    void flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::resize(size_type new_cap) {
+        THROW_LENGTH_ERROR_IF(new_cap > max_size() - WIDTH, "flat_hash_table size too big");
+        ctrl_allocator ctrl_alloc(alloc_);
+        hash_ctrl_t* new_ctrl = ctrl_traits::allocate(ctrl_alloc, new_cap + WIDTH);
+        Value* new_slots;
+        try {
+            new_slots = alloc_traits::allocate(alloc_, new_cap);
+        } catch(...) {
+            ctrl_traits::deallocate(ctrl_alloc, new_ctrl, new_cap + WIDTH);
+            throw;
+        }
+        std::memset(new_ctrl, static_cast<unsigned char>(CTRL_EMPTY), new_cap + WIDTH);
+        new_ctrl[new_cap] = CTRL_SENTINEL;
+
+        hash_ctrl_t* old_ctrl = ctrl_;
+        Value* old_slots = slots_;
+        const size_type old_cap = capacity_;
+        ctrl_ = new_ctrl;
+        slots_ = new_slots;
+        capacity_ = new_cap;
+        growth_left_ = capacity_to_growth(new_cap) - size_;
+
+        for(size_type i = 0; i != old_cap; ++i) {
+            if(!is_full(old_ctrl[i])) continue;
+            const size_t hash = hash_of(Policy::key(old_slots[i]));
+            const size_type target = find_first_non_full(hash);
+            set_ctrl(target, h2(hash));
+            transfer_slot(slots_ + target, old_slots + i, relocate_by_memcpy());
+        }
+
+        if(old_cap != 0) {
+            ctrl_traits::deallocate(ctrl_alloc, old_ctrl, old_cap + WIDTH);
+            alloc_traits::deallocate(alloc_, old_slots, old_cap);
+        }
+    }
+
+    template<class Value, class Policy, class Hash, class KeyEqual, class Alloc>
+    void flat_hash_table<Value, Policy, Hash, KeyEqual, Alloc>::copy_from(const flat_hash_table& rhs) {
+        reserve(rhs.size_);
+        for(size_type i = 0; i != rhs.capacity_; ++i) {
+            if(!is_full(rhs.ctrl_[i])) continue;
+            const size_t hash = hash_of(Policy::key(rhs.slots_[i]));
+            const size_type target = prepare_insert(hash);
+            try {
+                alloc_traits::construct(alloc_, slots_ + target, rhs.slots_[i]);
+            } catch(...) {
+                erase_meta(target);
+                throw;
+            }
+        }
+    }
+}
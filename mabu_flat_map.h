@@ -0,0 +1,273 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * flat_map: 以 flat_tree 为底层的有序映射，key 不允许重复
+ * 元素按 key 有序地连续存放，元素类型是 pair<Key, T>，不要通过迭代器修改 key
+ * 单个 insert 立即生效；insert(first, last) 先把整个区间排序去重，返回前一次合并，代价是 O(n + k log k)
+ * insert、erase 之后迭代器、指针和引用都可能失效
+ */
+
+#include <initializer_list>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_allocator.h"
+#include "mabu_flat_tree.h"
+#include "mabu_functional.h"
+#include "mabu_iterator.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    template<class Key, class T>
+    struct flat_map_policy {
+        typedef Key key_type;
+        typedef pair<Key, T> value_type;
+
+        static const Key& key(const value_type& value) noexcept {
+            return value.first;
+        }
+    };
+
+    template<class Key, class T, class Compare = mabustl::less<Key>, class Alloc = mabustl::allocator<pair<Key, T> > >
+    class flat_map {
+    private:
+        typedef flat_tree<pair<Key, T>, flat_map_policy<Key, T>, Compare, Alloc> base_type;
+
+        base_type tree_;
+
+    public:
+        typedef Key key_type;
+        typedef T mapped_type;
+        typedef typename base_type::value_type value_type;
+        typedef typename base_type::key_compare key_compare;
+        typedef typename base_type::value_compare value_compare;
+        typedef typename base_type::allocator_type allocator_type;
+
+        typedef typename base_type::size_type size_type;
+        typedef typename base_type::difference_type difference_type;
+        typedef typename base_type::pointer pointer;
+        typedef typename base_type::const_pointer const_pointer;
+        typedef typename base_type::reference reference;
+        typedef typename base_type::const_reference const_reference;
+
+        typedef typename base_type::iterator iterator;
+        typedef typename base_type::const_iterator const_iterator;
+        typedef mabustl::reverse_iterator<iterator> reverse_iterator;
+        typedef mabustl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    public:
+        // 构造、复制、移动函数
+        flat_map(): tree_(Compare(), Alloc()) {}
+
+        explicit flat_map(const Compare& comp, const Alloc& alloc = Alloc()): tree_(comp, alloc) {}
+
+        explicit flat_map(const Alloc& alloc): tree_(Compare(), alloc) {}
+
+        template<class InputIter, typename std::enable_if<mabustl::is_input_iterator<InputIter>::value, int>::type = 0>
+        flat_map(InputIter first, InputIter last, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : tree_(comp, alloc) {
+            tree_.insert_range(first, last);
+        }
+
+        flat_map(std::initializer_list<value_type> ilist, const Compare& comp = Compare(),
+                 const Alloc& alloc = Alloc())
+            : tree_(comp, alloc) {
+            tree_.insert_range(ilist.begin(), ilist.end());
+        }
+
+        flat_map(const flat_map& rhs): tree_(rhs.tree_) {}
+
+        flat_map(flat_map&& rhs) noexcept: tree_(mabustl::move(rhs.tree_)) {}
+
+        flat_map& operator=(const flat_map& rhs) {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+
+        flat_map& operator=(flat_map&& rhs) {
+            tree_ = mabustl::move(rhs.tree_);
+            return *this;
+        }
+
+        flat_map& operator=(std::initializer_list<value_type> ilist) {
+            tree_.clear();
+            tree_.insert_range(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        ~flat_map() = default;
+
+        // 迭代器相关操作
+        iterator begin() { return tree_.begin(); }
+        const_iterator begin() const { return tree_.begin(); }
+        iterator end() { return tree_.end(); }
+        const_iterator end() const { return tree_.end(); }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const { return tree_.begin(); }
+        const_iterator cend() const { return tree_.end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return tree_.empty(); }
+        size_type size() const { return tree_.size(); }
+        size_type max_size() const noexcept { return tree_.max_size(); }
+        size_type capacity() const noexcept { return tree_.capacity(); }
+
+        void reserve(size_type n) { tree_.reserve(n); }
+        void shrink_to_fit() { tree_.shrink_to_fit(); }
+
+        // 插入删除相关操作
+        template<class... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            return tree_.emplace_unique(mabustl::forward<Args>(args)...);
+        }
+
+        template<class... Args>
+        iterator emplace_hint(const_iterator hint, Args&&... args) {
+            return tree_.insert_hint(hint, value_type(mabustl::forward<Args>(args)...));
+        }
+
+        // key 不存在时才构造 mapped_type
+        template<class... Args>
+        pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+            return tree_.emplace_key(key, key, mapped_type(mabustl::forward<Args>(args)...));
+        }
+
+        template<class... Args>
+        pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+            return tree_.emplace_key(key, mabustl::move(key), mapped_type(mabustl::forward<Args>(args)...));
+        }
+
+        pair<iterator, bool> insert(const value_type& value) {
+            return tree_.insert_unique(value);
+        }
+
+        pair<iterator, bool> insert(value_type&& value) {
+            return tree_.insert_unique(mabustl::move(value));
+        }
+
+        iterator insert(const_iterator hint, const value_type& value) {
+            return tree_.insert_hint(hint, value);
+        }
+
+        iterator insert(const_iterator hint, value_type&& value) {
+            return tree_.insert_hint(hint, mabustl::move(value));
+        }
+
+        // 整个区间排序去重后一次合并，已有的 key 保留原来的元素，区间内重复的 key 保留先出现的
+        template<class InputIter>
+        void insert(InputIter first, InputIter last) {
+            tree_.insert_range(first, last);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            tree_.insert_range(ilist.begin(), ilist.end());
+        }
+
+        template<class M>
+        pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+            pair<iterator, bool> result = try_emplace(key, mabustl::forward<M>(obj));
+            if(!result.second) result.first->second = mabustl::forward<M>(obj);
+            return result;
+        }
+
+        iterator erase(const_iterator pos) { return tree_.erase(pos); }
+        iterator erase(const_iterator first, const_iterator last) { return tree_.erase(first, last); }
+        size_type erase(const key_type& key) { return tree_.erase_key(key); }
+
+        void clear() noexcept { tree_.clear(); }
+
+        void swap(flat_map& rhs) noexcept { tree_.swap(rhs.tree_); }
+
+        // 查找相关操作
+        mapped_type& at(const key_type& key) {
+            iterator it = tree_.find(key);
+            THROW_OUT_OF_LENGTH_IF(it == tree_.end(), "flat_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        const mapped_type& at(const key_type& key) const {
+            const_iterator it = tree_.find(key);
+            THROW_OUT_OF_LENGTH_IF(it == tree_.end(), "flat_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        mapped_type& operator[](const key_type& key) {
+            return try_emplace(key).first->second;
+        }
+
+        mapped_type& operator[](key_type&& key) {
+            return try_emplace(mabustl::move(key)).first->second;
+        }
+
+        size_type count(const key_type& key) const { return tree_.count(key); }
+
+        bool contains(const key_type& key) const { return tree_.contains(key); }
+
+        iterator find(const key_type& key) { return tree_.find(key); }
+        const_iterator find(const key_type& key) const { return tree_.find(key); }
+
+        iterator lower_bound(const key_type& key) { return tree_.lower_bound(key); }
+        const_iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+        iterator upper_bound(const key_type& key) { return tree_.upper_bound(key); }
+        const_iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator> equal_range(const key_type& key) {
+            iterator it = tree_.lower_bound(key);
+            iterator last = it;
+            if(it != tree_.end() && !key_comp()(key, it->first)) ++last;
+            return pair<iterator, iterator>(it, last);
+        }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+            const_iterator it = tree_.lower_bound(key);
+            const_iterator last = it;
+            if(it != tree_.end() && !key_comp()(key, it->first)) ++last;
+            return pair<const_iterator, const_iterator>(it, last);
+        }
+
+        key_compare key_comp() const { return tree_.key_comp(); }
+        value_compare value_comp() const { return tree_.value_comp(); }
+        allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+    public:
+        friend bool operator==(const flat_map& lhs, const flat_map& rhs) {
+            return lhs.size() == rhs.size() && mabustl::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator!=(const flat_map& lhs, const flat_map& rhs) {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator<(const flat_map& lhs, const flat_map& rhs) {
+            return mabustl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+        friend bool operator>(const flat_map& lhs, const flat_map& rhs) {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const flat_map& lhs, const flat_map& rhs) {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const flat_map& lhs, const flat_map& rhs) {
+            return !(lhs < rhs);
+        }
+    };
+
+    // 重载 mabustl 的 swap
+    template<class Key, class T, class Compare, class Alloc>
+    void swap(flat_map<Key, T, Compare, Alloc>& lhs, flat_map<Key, T, Compare, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * flat_set: 以 flat_tree 为底层的有序集合，元素不允许重复
+ * 元素有序地连续存放，可以直接用于 set_union、set_intersection 等有序区间算法
+ * 单个 insert 立即生效；insert(first, last) 先把整个区间排序去重，返回前一次合并，代价是 O(n + k log k)
+ * insert、erase 之后迭代器、指针和引用都可能失效
+ */
+
+#include <initializer_list>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_allocator.h"
+#include "mabu_flat_tree.h"
+#include "mabu_functional.h"
+#include "mabu_iterator.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    template<class Key>
+    struct flat_set_policy {
+        typedef Key key_type;
+        typedef Key value_type;
+
+        static const Key& key(const value_type& value) noexcept {
+            return value;
+        }
+    };
+
+    template<class Key, class Compare = mabustl::less<Key>, class Alloc = mabustl::allocator<Key> >
+    class flat_set {
+    private:
+        typedef flat_tree<Key, flat_set_policy<Key>, Compare, Alloc> base_type;
+
+        base_type tree_;
+
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef typename base_type::key_compare key_compare;
+        typedef typename base_type::key_compare value_compare;
+        typedef typename base_type::allocator_type allocator_type;
+
+        typedef typename base_type::size_type size_type;
+        typedef typename base_type::difference_type difference_type;
+        typedef typename base_type::const_pointer pointer;
+        typedef typename base_type::const_pointer const_pointer;
+        typedef typename base_type::const_reference reference;
+        typedef typename base_type::const_reference const_reference;
+
+        // 修改元素会破坏顺序，所以 iterator 也是 const 的
+        typedef typename base_type::const_iterator iterator;
+        typedef typename base_type::const_iterator const_iterator;
+        typedef mabustl::reverse_iterator<iterator> reverse_iterator;
+        typedef mabustl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    public:
+        // 构造、复制、移动函数
+        flat_set(): tree_(Compare(), Alloc()) {}
+
+        explicit flat_set(const Compare& comp, const Alloc& alloc = Alloc()): tree_(comp, alloc) {}
+
+        explicit flat_set(const Alloc& alloc): tree_(Compare(), alloc) {}
+
+        template<class InputIter, typename std::enable_if<mabustl::is_input_iterator<InputIter>::value, int>::type = 0>
+        flat_set(InputIter first, InputIter last, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : tree_(comp, alloc) {
+            tree_.insert_range(first, last);
+        }
+
+        flat_set(std::initializer_list<value_type> ilist, const Compare& comp = Compare(),
+                 const Alloc& alloc = Alloc())
+            : tree_(comp, alloc) {
+            tree_.insert_range(ilist.begin(), ilist.end());
+        }
+
+        flat_set(const flat_set& rhs): tree_(rhs.tree_) {}
+
+        flat_set(flat_set&& rhs) noexcept: tree_(mabustl::move(rhs.tree_)) {}
+
+        flat_set& operator=(const flat_set& rhs) {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+
+        flat_set& operator=(flat_set&& rhs) {
+            tree_ = mabustl::move(rhs.tree_);
+            return *this;
+        }
+
+        flat_set& operator=(std::initializer_list<value_type> ilist) {
+            tree_.clear();
+            tree_.insert_range(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        ~flat_set() = default;
+
+        // 迭代器相关操作
+        iterator begin() { return tree_.begin(); }
+        iterator begin() const { return tree_.begin(); }
+        iterator end() { return tree_.end(); }
+        iterator end() const { return tree_.end(); }
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rbegin() const { return reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+        reverse_iterator rend() const { return reverse_iterator(begin()); }
+        const_iterator cbegin() const { return tree_.begin(); }
+        const_iterator cend() const { return tree_.end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return tree_.empty(); }
+        size_type size() const { return tree_.size(); }
+        size_type max_size() const noexcept { return tree_.max_size(); }
+        size_type capacity() const noexcept { return tree_.capacity(); }
+
+        void reserve(size_type n) { tree_.reserve(n); }
+        void shrink_to_fit() { tree_.shrink_to_fit(); }
+
+        // 插入删除相关操作
+        template<class... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            return tree_.emplace_unique(mabustl::forward<Args>(args)...);
+        }
+
+        template<class... Args>
+        iterator emplace_hint(const_iterator hint, Args&&... args) {
+            return tree_.insert_hint(hint, value_type(mabustl::forward<Args>(args)...));
+        }
+
+        pair<iterator, bool> insert(const value_type& value) {
+            return tree_.insert_unique(value);
+        }
+
+        pair<iterator, bool> insert(value_type&& value) {
+            return tree_.insert_unique(mabustl::move(value));
+        }
+
+        iterator insert(const_iterator hint, const value_type& value) {
+            return tree_.insert_hint(hint, value);
+        }
+
+        iterator insert(const_iterator hint, value_type&& value) {
+            return tree_.insert_hint(hint, mabustl::move(value));
+        }
+
+        // 整个区间排序去重后一次合并，已有的 key 保留原来的元素，区间内重复的 key 保留先出现的
+        template<class InputIter>
+        void insert(InputIter first, InputIter last) {
+            tree_.insert_range(first, last);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            tree_.insert_range(ilist.begin(), ilist.end());
+        }
+
+        iterator erase(const_iterator pos) { return tree_.erase(pos); }
+        iterator erase(const_iterator first, const_iterator last) { return tree_.erase(first, last); }
+        size_type erase(const key_type& key) { return tree_.erase_key(key); }
+
+        void clear() noexcept { tree_.clear(); }
+
+        void swap(flat_set& rhs) noexcept { tree_.swap(rhs.tree_); }
+
+        // 查找相关操作
+        size_type count(const key_type& key) const { return tree_.count(key); }
+
+        bool contains(const key_type& key) const { return tree_.contains(key); }
+
+        iterator find(const key_type& key) { return tree_.find(key); }
+        iterator find(const key_type& key) const { return tree_.find(key); }
+
+        iterator lower_bound(const key_type& key) { return tree_.lower_bound(key); }
+        iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+        iterator upper_bound(const key_type& key) { return tree_.upper_bound(key); }
+        iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+        pair<iterator, iterator> equal_range(const key_type& key) {
+            iterator it = tree_.lower_bound(key);
+            iterator last = it;
+            if(it != tree_.end() && !key_comp()(key, *it)) ++last;
+            return pair<iterator, iterator>(it, last);
+        }
+
+        pair<iterator, iterator> equal_range(const key_type& key) const {
+            iterator it = tree_.lower_bound(key);
+            iterator last = it;
+            if(it != tree_.end() && !key_comp()(key, *it)) ++last;
+            return pair<iterator, iterator>(it, last);
+        }
+
+        key_compare key_comp() const { return tree_.key_comp(); }
+        value_compare value_comp() const { return tree_.key_comp(); }
+        allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+    public:
+        friend bool operator==(const flat_set& lhs, const flat_set& rhs) {
+            return lhs.size() == rhs.size() && mabustl::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator!=(const flat_set& lhs, const flat_set& rhs) {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator<(const flat_set& lhs, const flat_set& rhs) {
+            return mabustl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+        friend bool operator>(const flat_set& lhs, const flat_set& rhs) {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const flat_set& lhs, const flat_set& rhs) {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const flat_set& lhs, const flat_set& rhs) {
+            return !(lhs < rhs);
+        }
+    };
+
+    // 重载 mabustl 的 swap
+    template<class Key, class Compare, class Alloc>
+    void swap(flat_set<Key, Compare, Alloc>& lhs, flat_set<Key, Compare, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
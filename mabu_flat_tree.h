@@ -0,0 +1,317 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * flat_tree: flat_map 和 flat_set 的底层有序容器，key 不允许重复
+ * 元素按 key 有序、连续地存放在一个 vector 中，适合读多写少的字典：
+ * (1)查找用无分支的二分查找，每一步用比较结果选择下一段的起点，编译为条件传送，
+ *    循环次数只取决于元素个数，不会因为分支预测失败清空流水线，同时预取下一步的两个候选位置
+ * (2)逐个 insert 需要移动插入位置之后的所有元素，k 次插入要 O(nk) 次移动；
+ *    批量插入 insert(first, last) 先把这一批元素复制出来稳定排序(O(k log k))，
+ *    再用 set_union 把两段有序区间合并成新的数组(O(n + k))，返回时已经全部合并
+ * (3)key 已存在时保留原有元素，同一批中 key 重复时保留区间中靠前的元素
+ * 容器中不存在没有合并的元素，const 成员函数之间没有写操作，多个线程可以同时读
+ * insert 和 erase 之后迭代器、指针和引用都可能失效
+ */
+
+#include "mabu_algorithm_base.h"
+#include "mabu_allocator.h"
+#include "mabu_functional.h"
+#include "mabu_iterator.h"
+#include "mabu_set_algorithm.h"
+#include "mabu_sort_algorithm.h"
+#include "mabu_stddef.h"
+#include "mabu_utility.h"
+#include "mabu_vector.h"
+
+namespace mabustl {
+    /*
+    * *****************************************************************************************************************
+    * flat_tree
+    * Policy 提供 key_type 和 static const key_type& key(const Value&)
+    * Value 需要可以移动赋值，flat_map 的元素因此是 pair<Key, T> 而不是 pair<const Key, T>
+    * *****************************************************************************************************************
+    */
+    template<class Value, class Policy, class Compare, class Alloc>
+    class flat_tree {
+    public:
+        typedef typename Policy::key_type key_type;
+        typedef Value value_type;
+        typedef Compare key_compare;
+        typedef Alloc allocator_type;
+        typedef mabustl::vector<Value, Alloc> container_type;
+
+        typedef typename container_type::size_type size_type;
+        typedef typename container_type::difference_type difference_type;
+        typedef Value& reference;
+        typedef const Value& const_reference;
+        typedef Value* pointer;
+        typedef const Value* const_pointer;
+
+        typedef typename container_type::iterator iterator;
+        typedef typename container_type::const_iterator const_iterator;
+
+        // 按 key 比较两个元素
+        class value_compare : public binary_function<value_type, value_type, bool> {
+        private:
+            Compare comp_;
+
+        public:
+            explicit value_compare(const Compare& comp): comp_(comp) {}
+
+            bool operator()(const value_type& lhs, const value_type& rhs) const {
+                return comp_(Policy::key(lhs), Policy::key(rhs));
+            }
+        };
+
+    private:
+        // 一批元素排序时先对每段 SORT_RUN 个元素做插入排序，再两两归并
+        enum : size_type { SORT_RUN = 16 };
+
+        container_type data_;       // 有序并且 key 互不相同
+        key_compare comp_;
+
+    public:
+        // 构造、复制、移动函数由 vector 完成
+        flat_tree(const Compare& comp, const Alloc& alloc): data_(alloc), comp_(comp) {}
+
+        // 迭代器相关操作
+        iterator begin() noexcept { return data_.begin(); }
+        const_iterator begin() const noexcept { return data_.begin(); }
+        iterator end() noexcept { return data_.end(); }
+        const_iterator end() const noexcept { return data_.end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return data_.empty(); }
+        size_type size() const noexcept { return data_.size(); }
+        size_type max_size() const noexcept { return data_.max_size(); }
+        size_type capacity() const noexcept { return data_.capacity(); }
+
+        void reserve(size_type n) { data_.reserve(n); }
+        void shrink_to_fit() { data_.shrink_to_fit(); }
+
+        // 查找相关操作
+        iterator find(const key_type& key) {
+            const iterator it = data_.begin() + branchless_lower_bound(key);
+            return it != data_.end() && !comp_(key, Policy::key(*it)) ? it : data_.end();
+        }
+
+        const_iterator find(const key_type& key) const {
+            const const_iterator it = data_.begin() + branchless_lower_bound(key);
+            return it != data_.end() && !comp_(key, Policy::key(*it)) ? it : data_.end();
+        }
+
+        size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+        bool contains(const key_type& key) const { return find(key) != data_.end(); }
+
+        iterator lower_bound(const key_type& key) { return data_.begin() + branchless_lower_bound(key); }
+        const_iterator lower_bound(const key_type& key) const { return data_.begin() + branchless_lower_bound(key); }
+
+        iterator upper_bound(const key_type& key) { return data_.begin() + branchless_upper_bound(key); }
+        const_iterator upper_bound(const key_type& key) const { return data_.begin() + branchless_upper_bound(key); }
+
+        // 立即插入，key 已存在时返回指向已有元素的迭代器和 false；args 用来在 key 不存在时构造元素
+        template<class... Args>
+        pair<iterator, bool> emplace_key(const key_type& key, Args&&... args);
+
+        pair<iterator, bool> insert_unique(const value_type& value) {
+            return emplace_key(Policy::key(value), value);
+        }
+
+        pair<iterator, bool> insert_unique(value_type&& value) {
+            return emplace_key(Policy::key(value), mabustl::move(value));
+        }
+
+        // 必须先构造出元素才能得到 key
+        template<class... Args>
+        pair<iterator, bool> emplace_unique(Args&&... args) {
+            value_type tmp(mabustl::forward<Args>(args)...);
+            return insert_unique(mabustl::move(tmp));
+        }
+
+        // 元素应当放在 hint 之前时不需要查找，否则退化为 insert_unique
+        template<class V>
+        iterator insert_hint(const_iterator hint, V&& value);
+
+        // 批量插入，整个区间排序后一次合并，返回时已经全部合并
+        template<class InputIter>
+        void insert_range(InputIter first, InputIter last) {
+            container_type batch(data_.get_allocator());
+            for(; first != last; ++first) batch.emplace_back(*first);
+            if(!batch.empty()) merge_batch(batch);
+        }
+
+        // 删除相关操作
+        iterator erase(const_iterator pos) { return data_.erase(pos); }
+        iterator erase(const_iterator first, const_iterator last) { return data_.erase(first, last); }
+
+        size_type erase_key(const key_type& key) {
+            const_iterator it = find(key);
+            if(it == data_.end()) return 0;
+            data_.erase(it);
+            return 1;
+        }
+
+        void clear() noexcept { data_.clear(); }
+
+        void swap(flat_tree& rhs) noexcept {
+            data_.swap(rhs.data_);
+            mabustl::swap(comp_, rhs.comp_);
+        }
+
+        key_compare key_comp() const { return comp_; }
+        value_compare value_comp() const { return value_compare(comp_); }
+        allocator_type get_allocator() const { return data_.get_allocator(); }
+
+    private:
+        // 第一个 key 不小于 key 的元素的下标
+        // 比较之前先预取下一步可能用到的两个中点，数组比缓存大时把两次访存重叠起来
+        size_type branchless_lower_bound(const key_type& key) const {
+            const Value* base = data_.begin();
+            size_type len = data_.size();
+            if(len == 0) return 0;
+            while(len > 1) {
+                const size_type half = len >> 1;
+                mabustl::prefetch(base + (len - half) / 2);
+                mabustl::prefetch(base + half + (len - half) / 2);
+                base = comp_(Policy::key(base[half - 1]), key) ? base + half : base;
+                len -= half;
+            }
+            return static_cast<size_type>(base - data_.begin()) + comp_(Policy::key(*base), key);
+        }
+
+        // 第一个 key 大于 key 的元素的下标
+        size_type branchless_upper_bound(const key_type& key) const {
+            const Value* base = data_.begin();
+            size_type len = data_.size();
+            if(len == 0) return 0;
+            while(len > 1) {
+                const size_type half = len >> 1;
+                mabustl::prefetch(base + (len - half) / 2);
+                mabustl::prefetch(base + half + (len - half) / 2);
+                base = !comp_(key, Policy::key(base[half - 1])) ? base + half : base;
+                len -= half;
+            }
+            return static_cast<size_type>(base - data_.begin()) + !comp_(key, Policy::key(*base));
+        }
+
+        // batch 稳定排序、去掉 key 重复的元素后与有序数组合并
+        void merge_batch(container_type& batch);
+
+        // batch 按 key 稳定排序，相同 key 的元素保持原来的先后顺序
+        void sort_batch(container_type& batch) const;
+
+        // 把 [first1, last1) 和 [first2, last2) 稳定地归并后移动到 out 的末尾
+        void merge_move(Value* first1, Value* last1, Value* first2, Value* last2, container_type& out) const;
+    };
+
+    /*****************************************************************************************************************/
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    template<class... Args>
+    pair<typename flat_tree<Value, Policy, Compare, Alloc>::iterator, bool>
+    flat_tree<Value, Policy, Compare, Alloc>::emplace_key(const key_type& key, Args&&... args) {
+        const iterator it = lower_bound(key);
+        if(it != data_.end() && !comp_(key, Policy::key(*it))) return pair<iterator, bool>(it, false);
+        return pair<iterator, bool>(data_.emplace(it, mabustl::forward<Args>(args)...), true);
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    template<class V>
+    typename flat_tree<Value, Policy, Compare, Alloc>::iterator
+    flat_tree<Value, Policy, Compare, Alloc>::insert_hint(const_iterator hint, V&& value) {
+        const key_type& key = Policy::key(value);
+        if((hint == data_.end() || comp_(key, Policy::key(*hint))) &&
+           (hint == data_.begin() || comp_(Policy::key(*(hint - 1)), key))) {
+            return data_.emplace(hint, mabustl::forward<V>(value));
+        }
+        return insert_unique(mabustl::forward<V>(value)).first;
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * merge_batch
+    * 一批元素稳定排序后去掉 key 重复的元素(保留区间中靠前的)，然后：
+    * 这一批都比已有元素大时直接移动到末尾；否则用 set_union 把两段有序区间移动到新的数组，
+    * key 相同时 set_union 输出第一段(已有)的元素
+    * *****************************************************************************************************************
+    */
+    template<class Value, class Policy, class Compare, class Alloc>
+    void flat_tree<Value, Policy, Compare, Alloc>::merge_batch(container_type& batch) {
+        sort_batch(batch);
+
+        Value* result = batch.begin();
+        for(Value* it = result + 1; it != batch.end(); ++it) {
+            if(comp_(Policy::key(*result), Policy::key(*it)) && ++result != it) *result = mabustl::move(*it);
+        }
+        batch.erase(result + 1, batch.end());
+
+        if(data_.empty() || comp_(Policy::key(data_.back()), Policy::key(batch.front()))) {
+            data_.insert(data_.end(), mabustl::make_move_iterator(batch.begin()),
+                         mabustl::make_move_iterator(batch.end()));
+        } else {
+            container_type merged(data_.get_allocator());
+            merged.reserve(data_.size() + batch.size());
+            mabustl::set_union(mabustl::make_move_iterator(data_.begin()), mabustl::make_move_iterator(data_.end()),
+                               mabustl::make_move_iterator(batch.begin()),
+                               mabustl::make_move_iterator(batch.end()),
+                               mabustl::back_inserter(merged), value_compare(comp_));
+            data_.swap(merged);
+        }
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    void flat_tree<Value, Policy, Compare, Alloc>::sort_batch(container_type& batch) const {
+        const value_compare comp(comp_);
+        Value* const first = batch.begin();
+        const size_type n = batch.size();
+
+        // 每 SORT_RUN 个元素一段做插入排序，只在严格小于时前移，保持稳定
+        for(size_type lo = 0; lo < n; lo += SORT_RUN) {
+            Value* const run_first = first + lo;
+            Value* const run_last = first + (n - lo < SORT_RUN ? n : lo + SORT_RUN);
+            for(Value* i = run_first + 1; i < run_last; ++i) {
+                if(!comp(*i, *(i - 1))) continue;
+                Value tmp(mabustl::move(*i));
+                Value* j = i;
+                do {
+                    *j = mabustl::move(*(j - 1));
+                    --j;
+                } while(j != run_first && comp(tmp, *(j - 1)));
+                *j = mabustl::move(tmp);
+            }
+        }
+        if(n <= SORT_RUN) return;
+
+        // 两两归并，batch 和 buffer 轮流作为归并的目标
+        container_type buffer(batch.get_allocator());
+        buffer.reserve(n);
+        for(size_type width = SORT_RUN; width < n; width <<= 1) {
+            buffer.clear();
+            Value* const src = batch.begin();
+            for(size_type lo = 0; lo < n; lo += width << 1) {
+                const size_type mid = n - lo < width ? n : lo + width;
+                const size_type hi = n - mid < width ? n : mid + width;
+                merge_move(src + lo, src + mid, src + mid, src + hi, buffer);
+            }
+            batch.swap(buffer);
+        }
+    }
+
+    template<class Value, class Policy, class Compare, class Alloc>
+    void flat_tree<Value, Policy, Compare, Alloc>::merge_move(Value* first1, Value* last1, Value* first2,
+                                                              Value* last2, container_type& out) const {
+        const value_compare comp(comp_);
+        while(first1 != last1 && first2 != last2) {
+            if(comp(*first2, *first1)) out.push_back(mabustl::move(*first2++));
+            else out.push_back(mabustl::move(*first1++));
+        }
+        for(; first1 != last1; ++first1) out.push_back(mabustl::move(*first1));
+        for(; first2 != last2; ++first2) out.push_back(mabustl::move(*first2));
+    }
+}
@@ -5,7 +5,15 @@
  * author: mabu
  */
 
+#include <cfloat>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "mabu_utility.h"
 
 namespace mabustl {
     // 一元函数的参数类型和返回值
@@ -199,6 +207,119 @@ namespace mabustl {
     /*******************************************************************************************/
     // 哈希函数
 
+    /*
+     * 字节序列的哈希，算法与 wyhash 相同：
+     * 每次读入 8 字节，两个 64 位数相乘得到 128 位结果，再把高低两半异或(mum)，每步都能让所有输入位影响所有输出位
+     * 长度不超过 16 字节时只做一次 mum，超过 48 字节时三路并行处理
+     * 32 位平台上取 64 位结果的低 32 位
+     */
+    namespace hash_detail {
+        // 用来打散输入的常数，来自 wyhash
+        constexpr uint64_t secret0 = 0x2d358dccaa6c78a5ull;
+        constexpr uint64_t secret1 = 0x8bb84b93962eacc9ull;
+        constexpr uint64_t secret2 = 0x4b33a62ed433d4a3ull;
+        constexpr uint64_t secret3 = 0x4d5a2da51de1aa47ull;
+
+        // a * b 的 128 位结果，低 64 位放在 a，高 64 位放在 b
+        inline void mum(uint64_t& a, uint64_t& b) noexcept {
+#if defined(__SIZEOF_INT128__)
+            const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+            a = static_cast<uint64_t>(r);
+            b = static_cast<uint64_t>(r >> 64);
+#else
+            const uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+            const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+            const uint64_t t = rl + (rm0 << 32);
+            uint64_t c = t < rl;
+            const uint64_t lo = t + (rm1 << 32);
+            c += lo < t;
+            a = lo;
+            b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+        }
+
+        inline uint64_t mix(uint64_t a, uint64_t b) noexcept {
+            mum(a, b);
+            return a ^ b;
+        }
+
+        inline uint64_t read8(const unsigned char* p) noexcept {
+            uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline uint64_t read4(const unsigned char* p) noexcept {
+            uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        // 1 到 3 个字节
+        inline uint64_t read3(const unsigned char* p, size_t k) noexcept {
+            return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+        }
+    }
+
+    inline uint64_t hash_bytes64(const void* key, size_t len, uint64_t seed = 0) noexcept {
+        using namespace hash_detail;
+        const unsigned char* p = static_cast<const unsigned char*>(key);
+        seed ^= mix(seed ^ secret0, secret1);
+        uint64_t a, b;
+        if(len <= 16) {
+            if(len >= 4) {
+                a = (read4(p) << 32) | read4(p + ((len >> 3) << 2));
+                b = (read4(p + len - 4) << 32) | read4(p + len - 4 - ((len >> 3) << 2));
+            } else if(len > 0) {
+                a = read3(p, len);
+                b = 0;
+            } else {
+                a = b = 0;
+            }
+        } else {
+            size_t i = len;
+            if(i > 48) {
+                uint64_t see1 = seed, see2 = seed;
+                do {
+                    seed = mix(read8(p) ^ secret1, read8(p + 8) ^ seed);
+                    see1 = mix(read8(p + 16) ^ secret2, read8(p + 24) ^ see1);
+                    see2 = mix(read8(p + 32) ^ secret3, read8(p + 40) ^ see2);
+                    p += 48;
+                    i -= 48;
+                } while(i > 48);
+                seed ^= see1 ^ see2;
+            }
+            while(i > 16) {
+                seed = mix(read8(p) ^ secret1, read8(p + 8) ^ seed);
+                i -= 16;
+                p += 16;
+            }
+            a = read8(p + i - 16);
+            b = read8(p + i - 8);
+        }
+        a ^= secret1;
+        b ^= seed;
+        mum(a, b);
+        return mix(a ^ secret0 ^ len, b ^ secret1);
+    }
+
+    inline size_t hash_bytes(const void* key, size_t len, size_t seed = 0) noexcept {
+        return static_cast<size_t>(hash_bytes64(key, len, seed));
+    }
+
+    // 原来是逐字节的 FNV-1a，现在转到 hash_bytes
+    inline size_t bitwise_hash(const unsigned char* first, const size_t count) {
+        return hash_bytes(first, count);
+    }
+
+    // 整数的混合哈希：两次 128 位乘法，第二次的两个乘数都依赖输入，输入的每一位都会影响所有输出位
+    inline size_t hash_mix(uint64_t x) noexcept {
+        uint64_t a = x ^ hash_detail::secret0;
+        uint64_t b = x ^ hash_detail::secret1;
+        hash_detail::mum(a, b);
+        return static_cast<size_t>(hash_detail::mix(a ^ hash_detail::secret0, b ^ hash_detail::secret1));
+    }
+
     template<class Key>
     struct hash {};
 
@@ -212,11 +333,23 @@ namespace mabustl {
         }
     };
 
+    /*
+     * 整数默认为恒等哈希，定义 MABUSTL_MIXED_INTEGER_HASH 后改为 hash_mix
+     * 恒等哈希在模 2^k 的表中，步长为 2 的幂的 key 会集中到少数位置；flat_hash_table 会自己混合，不受影响
+     */
+#if defined(MABUSTL_MIXED_INTEGER_HASH)
+#define MABUSTL_TRIVIAL_HASH_FUNCTION(Type)\
+template <> struct hash<Type>{\
+    size_t operator()(Type val) const noexcept\
+    {return hash_mix(static_cast<uint64_t>(val));}\
+};
+#else
 #define MABUSTL_TRIVIAL_HASH_FUNCTION(Type)\
 template <> struct hash<Type>{\
     size_t operator()(Type val) const noexcept\
     {return static_cast<size_t>(val);}\
 };
+#endif
 
     MABUSTL_TRIVIAL_HASH_FUNCTION(bool)
 
@@ -250,28 +383,18 @@ template <> struct hash<Type>{\
 
 #undef MABUSTL_TRIVIAL_HASH_FUNCTION
 
-    // 浮点数(float, double, long double)，逐位哈希
-    // 这里用的是Folwer-Noll-Vo算法
-    inline size_t bitwise_hash(const unsigned char* first, const size_t count) {
-        // 64 位
-#if (_MSC_VER&&_WIN64)||((__GNUC__||__clang__)&&__SIZEOF_POINTER__==8)
-        const size_t fnv_offset = 14695981039346656037ull;
-        const size_t fnv_prime = 1099511628211ull;
-
-        // 32 位
-#else
-        const size_t fnv_offset = 2166136261u;
-        const size_t fnv_prime = 16777619u;
+    // 不管是否定义 MABUSTL_MIXED_INTEGER_HASH 都使用 hash_mix 的整数哈希，可作为容器的 Hash 参数
+    template<class Key>
+    struct mixed_hash {
+        static_assert(std::is_integral<Key>::value || std::is_enum<Key>::value,
+                      "mixed_hash: Key must be an integral or enum type");
 
-#endif
-        size_t result = fnv_offset;
-        for(size_t i = 0; i < count; ++i) {
-            result ^= (size_t) first[i];
-            result *= fnv_prime;
+        size_t operator()(Key val) const noexcept {
+            return hash_mix(static_cast<uint64_t>(val));
         }
-        return result;
-    }
+    };
 
+    // 浮点数(float, double, long double)，逐位哈希，+0.0 和 -0.0 的哈希值相同
     template<>
     struct hash<float> {
         size_t operator()(const float& val) const {
@@ -286,10 +409,79 @@ template <> struct hash<Type>{\
         }
     };
 
+    // x87 的 long double 只有前 10 个字节有效，后面的填充字节内容不确定，不能参与哈希
     template<>
     struct hash<long double> {
         size_t operator()(const long double& val) const {
-            return val == 0.0f ? 0 : bitwise_hash((const unsigned char*) &val, sizeof(long double));
+#if LDBL_MANT_DIG == 64
+            const size_t bytes = 10;
+#else
+            const size_t bytes = sizeof(long double);
+#endif
+            return val == 0.0f ? 0 : bitwise_hash((const unsigned char*) &val, bytes);
+        }
+    };
+
+    /*
+     * hash_combine: 把 value 的哈希值合并进 seed，用于由多个成员组成的 key
+     * 合并后经过一次 mum，成员的顺序会影响结果
+     */
+    inline void hash_combine_value(size_t& seed, size_t value) noexcept {
+        seed = static_cast<size_t>(hash_detail::mix(static_cast<uint64_t>(seed) ^ hash_detail::secret0,
+                                                    static_cast<uint64_t>(value) ^ hash_detail::secret1));
+    }
+
+    template<class T>
+    void hash_combine(size_t& seed, const T& value) {
+        hash_combine_value(seed, mabustl::hash<T>()(value));
+    }
+
+    // 依次合并多个值的哈希
+    inline size_t hash_values() noexcept {
+        return 0;
+    }
+
+    template<class T, class... Rest>
+    size_t hash_values(const T& first, const Rest&... rest) {
+        size_t seed = hash_values(rest...);
+        hash_combine(seed, first);
+        return seed;
+    }
+
+    template<class T1, class T2>
+    struct hash<pair<T1, T2> > {
+        size_t operator()(const pair<T1, T2>& p) const {
+            return hash_values(p.first, p.second);
+        }
+    };
+
+    template<class T1, class T2>
+    struct hash<std::pair<T1, T2> > {
+        size_t operator()(const std::pair<T1, T2>& p) const {
+            return hash_values(p.first, p.second);
+        }
+    };
+
+    // std::tuple 按元素从后往前合并
+    template<class Tuple, size_t I = std::tuple_size<Tuple>::value>
+    struct tuple_hash_impl {
+        static void apply(size_t& seed, const Tuple& t) {
+            hash_combine(seed, std::get<I - 1>(t));
+            tuple_hash_impl<Tuple, I - 1>::apply(seed, t);
+        }
+    };
+
+    template<class Tuple>
+    struct tuple_hash_impl<Tuple, 0> {
+        static void apply(size_t&, const Tuple&) {}
+    };
+
+    template<class... Types>
+    struct hash<std::tuple<Types...> > {
+        size_t operator()(const std::tuple<Types...>& t) const {
+            size_t seed = 0;
+            tuple_hash_impl<std::tuple<Types...> >::apply(seed, t);
+            return seed;
         }
     };
 }
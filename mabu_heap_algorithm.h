@@ -5,21 +5,250 @@
  * author: mabu
  */
 
-// TODO: 未完成堆相关算法
+/*
+ * 堆相关算法：push_heap pop_heap make_heap sort_heap is_heap_until is_heap prefer_make_heap
+ * 默认为大根堆，每个函数都有一个接受比较函数 comp 的重载版本
+ * 元素在堆中移动时都使用移动赋值，不产生多余的复制
+ */
 
 #include "mabu_iterator.h"
+#include "mabu_utility.h"
 
 namespace mabustl {
+    /*
+    * *****************************************************************************************************************
+    * push_heap
+    * 新元素已经放在容器末尾(last - 1)，把它上溯到合适的位置，[first, last - 1)必须已经是堆
+    * *****************************************************************************************************************
+    */
+    // 从 holeIndex 开始上溯，直到 topIndex 或者父节点不小于 value
     template<class RandomIter, class Distance, class T>
-    void push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex, T value) {
-        auto parent = (holeIndex - 1) / 2;
+    void push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex, T&& value) {
+        Distance parent = (holeIndex - 1) / 2;
         while(holeIndex > topIndex && *(first + parent) < value) {
-            *(first + holeIndex) = *(first + parent);
+            *(first + holeIndex) = mabustl::move(*(first + parent));
+            holeIndex = parent;
+            parent = (holeIndex - 1) / 2;
+        }
+        *(first + holeIndex) = mabustl::forward<T>(value);
+    }
+
+    template<class RandomIter>
+    void push_heap(RandomIter first, RandomIter last) {
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        if(last - first < 2) return;
+        T value = mabustl::move(*(last - 1));
+        mabustl::push_heap_aux(first, static_cast<Distance>((last - first) - 1), static_cast<Distance>(0),
+                               mabustl::move(value));
+    }
+
+    // 重载版本使用函数对象 comp 代替比较操作
+    template<class RandomIter, class Distance, class T, class Compare>
+    void push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex, T&& value, Compare comp) {
+        Distance parent = (holeIndex - 1) / 2;
+        while(holeIndex > topIndex && comp(*(first + parent), value)) {
+            *(first + holeIndex) = mabustl::move(*(first + parent));
             holeIndex = parent;
             parent = (holeIndex - 1) / 2;
         }
-        *(first + holeIndex) = value;
+        *(first + holeIndex) = mabustl::forward<T>(value);
+    }
+
+    template<class RandomIter, class Compare>
+    void push_heap(RandomIter first, RandomIter last, Compare comp) {
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        if(last - first < 2) return;
+        T value = mabustl::move(*(last - 1));
+        mabustl::push_heap_aux(first, static_cast<Distance>((last - first) - 1), static_cast<Distance>(0),
+                               mabustl::move(value), comp);
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * adjust_heap
+    * 在[first, first + len)中从 holeIndex 处放入 value 并恢复堆的性质
+    * 先让空洞沿较大的子节点一路下沉到叶子(每层只比较一次)，再把 value 从叶子上溯，
+    * value 通常来自堆底，最终位置往往接近叶子，这样比逐层比较 value 和两个子节点要少一半比较
+    * *****************************************************************************************************************
+    */
+    template<class RandomIter, class Distance, class T>
+    void adjust_heap(RandomIter first, Distance holeIndex, Distance len, T&& value) {
+        const Distance topIndex = holeIndex;
+        Distance child = 2 * holeIndex + 2;
+        while(child < len) {
+            if(*(first + child) < *(first + (child - 1))) --child;
+            *(first + holeIndex) = mabustl::move(*(first + child));
+            holeIndex = child;
+            child = 2 * child + 2;
+        }
+        // 只有左子节点
+        if(child == len) {
+            *(first + holeIndex) = mabustl::move(*(first + (child - 1)));
+            holeIndex = child - 1;
+        }
+        mabustl::push_heap_aux(first, holeIndex, topIndex, mabustl::forward<T>(value));
+    }
+
+    template<class RandomIter, class Distance, class T, class Compare>
+    void adjust_heap(RandomIter first, Distance holeIndex, Distance len, T&& value, Compare comp) {
+        const Distance topIndex = holeIndex;
+        Distance child = 2 * holeIndex + 2;
+        while(child < len) {
+            if(comp(*(first + child), *(first + (child - 1)))) --child;
+            *(first + holeIndex) = mabustl::move(*(first + child));
+            holeIndex = child;
+            child = 2 * child + 2;
+        }
+        if(child == len) {
+            *(first + holeIndex) = mabustl::move(*(first + (child - 1)));
+            holeIndex = child - 1;
+        }
+        mabustl::push_heap_aux(first, holeIndex, topIndex, mabustl::forward<T>(value), comp);
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * pop_heap
+    * 把堆顶移到 last - 1，[first, last - 1)重新成为堆
+    * *****************************************************************************************************************
+    */
+    template<class RandomIter>
+    void pop_heap(RandomIter first, RandomIter last) {
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        if(last - first < 2) return;
+        --last;
+        T value = mabustl::move(*last);
+        *last = mabustl::move(*first);
+        mabustl::adjust_heap(first, static_cast<Distance>(0), static_cast<Distance>(last - first),
+                             mabustl::move(value));
+    }
+
+    template<class RandomIter, class Compare>
+    void pop_heap(RandomIter first, RandomIter last, Compare comp) {
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        if(last - first < 2) return;
+        --last;
+        T value = mabustl::move(*last);
+        *last = mabustl::move(*first);
+        mabustl::adjust_heap(first, static_cast<Distance>(0), static_cast<Distance>(last - first),
+                             mabustl::move(value), comp);
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * make_heap
+    * Floyd 建堆：从最后一个非叶子节点开始向前逐个下沉，总共 O(n) 次比较
+    * *****************************************************************************************************************
+    */
+    template<class RandomIter>
+    void make_heap(RandomIter first, RandomIter last) {
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        const Distance len = last - first;
+        if(len < 2) return;
+        Distance holeIndex = (len - 2) / 2;
+        while(true) {
+            T value = mabustl::move(*(first + holeIndex));
+            mabustl::adjust_heap(first, holeIndex, len, mabustl::move(value));
+            if(holeIndex == 0) return;
+            --holeIndex;
+        }
+    }
+
+    template<class RandomIter, class Compare>
+    void make_heap(RandomIter first, RandomIter last, Compare comp) {
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        const Distance len = last - first;
+        if(len < 2) return;
+        Distance holeIndex = (len - 2) / 2;
+        while(true) {
+            T value = mabustl::move(*(first + holeIndex));
+            mabustl::adjust_heap(first, holeIndex, len, mabustl::move(value), comp);
+            if(holeIndex == 0) return;
+            --holeIndex;
+        }
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * sort_heap
+    * 不断执行 pop_heap，得到升序序列，之后不再是堆
+    * *****************************************************************************************************************
+    */
+    template<class RandomIter>
+    void sort_heap(RandomIter first, RandomIter last) {
+        while(last - first > 1) {
+            mabustl::pop_heap(first, last);
+            --last;
+        }
     }
 
+    template<class RandomIter, class Compare>
+    void sort_heap(RandomIter first, RandomIter last, Compare comp) {
+        while(last - first > 1) {
+            mabustl::pop_heap(first, last, comp);
+            --last;
+        }
+    }
 
+    /*
+    * *****************************************************************************************************************
+    * is_heap_until
+    * 返回最长的堆前缀的末尾，即第一个比父节点大的元素的位置
+    * *****************************************************************************************************************
+    */
+    template<class RandomIter>
+    RandomIter is_heap_until(RandomIter first, RandomIter last) {
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        const Distance len = last - first;
+        Distance parent = 0;
+        for(Distance child = 1; child < len; ++child) {
+            if(*(first + parent) < *(first + child)) return first + child;
+            if((child & 1) == 0) ++parent;
+        }
+        return last;
+    }
+
+    template<class RandomIter, class Compare>
+    RandomIter is_heap_until(RandomIter first, RandomIter last, Compare comp) {
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        const Distance len = last - first;
+        Distance parent = 0;
+        for(Distance child = 1; child < len; ++child) {
+            if(comp(*(first + parent), *(first + child))) return first + child;
+            if((child & 1) == 0) ++parent;
+        }
+        return last;
+    }
+
+    template<class RandomIter>
+    bool is_heap(RandomIter first, RandomIter last) {
+        return mabustl::is_heap_until(first, last) == last;
+    }
+
+    template<class RandomIter, class Compare>
+    bool is_heap(RandomIter first, RandomIter last, Compare comp) {
+        return mabustl::is_heap_until(first, last, comp) == last;
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * prefer_make_heap
+    * 前 old_size 个元素已经是 arity 叉堆，之后又追加到 new_size 个时，整体重建是否比逐个上溯更便宜：
+    * 逐个上溯的代价约为 k * log_arity(new_size)，Floyd 重建约为 2 * new_size，k 为追加的个数
+    * 按最终的大小估计，原来为空时 log(old_size) 为 0，会误选逐个上溯
+    * priority_queue 和 d_ary_heap 的 push_range 都用它来选择
+    * *****************************************************************************************************************
+    */
+    template<class Size>
+    bool prefer_make_heap(Size old_size, Size new_size, Size arity = 2) {
+        Size log_size = 0;
+        for(Size n = new_size; n > 1; n /= arity) ++log_size;
+        return (new_size - old_size) * log_size > 2 * new_size;
+    }
 }
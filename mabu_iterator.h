@@ -27,7 +27,7 @@ namespace mabustl {
         typedef T value_type;
         typedef Pointer pointer;
         typedef Reference reference;
-        typedef Distance different_type;
+        typedef Distance difference_type;
     };
 
     // 以下函数和类用来辅助萃取迭代器中的属性
@@ -64,7 +64,7 @@ namespace mabustl {
         typedef typename Iterator::value_type value_type;
         typedef typename Iterator::pointer pointer;
         typedef typename Iterator::reference reference;
-        typedef typename Iterator::different_type different_type;
+        typedef typename Iterator::difference_type difference_type;
     };
 
     template<class Iterator, bool>
@@ -80,11 +80,20 @@ namespace mabustl {
 
     template<class T>
     struct iterator_traits<T*> {
+        typedef random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef T* pointer;
+        typedef T& reference;
+        // typedef long int ptrdiff_t
+        typedef ptrdiff_t difference_type;
+    };
+
+    template<class T>
+    struct iterator_traits<const T*> {
         typedef random_access_iterator_tag iterator_category;
         typedef T value_type;
         typedef const T* pointer;
         typedef const T& reference;
-        // typedef long int ptrdiff_t
         typedef ptrdiff_t difference_type;
     };
 
@@ -121,6 +130,20 @@ namespace mabustl {
     struct is_iterator : public m_bool_constant<is_input_iterator<Iterator>::value ||
                                                 is_output_iterator<Iterator>::value> {};
 
+    /* 分段迭代器萃取
+     * 像 deque 这样由若干段连续内存拼成的容器，它的迭代器可以特化这个模板，
+     * 让 copy move fill 等算法按段取出底层的指针区间，逐段处理
+     * 特化版本需要提供：
+     * is_segmented      std::true_type
+     * segment_iterator  遍历各段的迭代器，local_iterator 段内的迭代器(指针)
+     * segment(it) local(it)  it 所在的段以及在段内的位置
+     * begin(seg) end(seg)    一段的起止位置
+     */
+    template<class Iterator>
+    struct segmented_iterator_traits {
+        typedef std::false_type is_segmented;
+    };
+
     /* 萃取迭代器的category
      * 继承关系：iterator_traits->iterator_traits_helper->iterator_traits_impl
      */
@@ -308,12 +331,12 @@ namespace mabustl {
 
     template<class Iterator>
     bool operator>(const reverse_iterator<Iterator>& lhs, const reverse_iterator<Iterator>& rhs) {
-        return rhs - lhs;
+        return rhs < lhs;
     }
 
     template<class Iterator>
     bool operator!=(const reverse_iterator<Iterator>& lhs, const reverse_iterator<Iterator>& rhs) {
-        return !(rhs == lhs.base);
+        return !(lhs == rhs);
     }
 
     template<class Iterator>
@@ -327,4 +350,144 @@ namespace mabustl {
                     const reverse_iterator<Iterator>& rhs) {
         return !(lhs < rhs);
     }
+
+    /*******************************************************************************************************/
+    // 移动迭代器，解引用得到右值，让 copy、set_union 等算法移动而不是复制元素
+
+    template<class Iterator>
+    class move_iterator {
+    private:
+        Iterator current;
+
+    public:
+        typedef typename iterator_traits<Iterator>::iterator_category iterator_category;
+        typedef typename iterator_traits<Iterator>::value_type value_type;
+        typedef Iterator pointer;
+        typedef value_type&& reference;
+        typedef typename iterator_traits<Iterator>::difference_type difference_type;
+
+        typedef Iterator iterator_type;
+        typedef move_iterator<Iterator> self;
+
+    public:
+        move_iterator(): current() {}
+
+        explicit move_iterator(iterator_type i): current(i) {}
+
+        iterator_type base() const {
+            return current;
+        }
+
+        reference operator*() const {
+            return static_cast<reference>(*current);
+        }
+
+        pointer operator->() const {
+            return current;
+        }
+
+        self& operator++() {
+            ++current;
+            return *this;
+        }
+
+        self operator++(int) {
+            self tmp = *this;
+            ++current;
+            return tmp;
+        }
+
+        self& operator--() {
+            --current;
+            return *this;
+        }
+
+        self operator--(int) {
+            self tmp = *this;
+            --current;
+            return tmp;
+        }
+
+        self& operator+=(difference_type n) {
+            current += n;
+            return *this;
+        }
+
+        self operator+(difference_type n) const {
+            return self(current + n);
+        }
+
+        self& operator-=(difference_type n) {
+            current -= n;
+            return *this;
+        }
+
+        self operator-(difference_type n) const {
+            return self(current - n);
+        }
+
+        reference operator[](difference_type n) const {
+            return static_cast<reference>(current[n]);
+        }
+    };
+
+    template<class Iterator>
+    typename move_iterator<Iterator>::difference_type
+    operator-(const move_iterator<Iterator>& lhs, const move_iterator<Iterator>& rhs) {
+        return lhs.base() - rhs.base();
+    }
+
+    template<class Iterator>
+    bool operator==(const move_iterator<Iterator>& lhs, const move_iterator<Iterator>& rhs) {
+        return lhs.base() == rhs.base();
+    }
+
+    template<class Iterator>
+    bool operator!=(const move_iterator<Iterator>& lhs, const move_iterator<Iterator>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class Iterator>
+    bool operator<(const move_iterator<Iterator>& lhs, const move_iterator<Iterator>& rhs) {
+        return lhs.base() < rhs.base();
+    }
+
+    template<class Iterator>
+    move_iterator<Iterator> make_move_iterator(Iterator i) {
+        return move_iterator<Iterator>(i);
+    }
+
+    /*******************************************************************************************************/
+    // 尾部插入迭代器，赋值时调用容器的 push_back
+
+    template<class Container>
+    class back_insert_iterator : public iterator<output_iterator_tag, void, void, void, void> {
+    private:
+        Container* container;
+
+    public:
+        typedef Container container_type;
+        typedef back_insert_iterator<Container> self;
+
+        explicit back_insert_iterator(Container& c): container(&c) {}
+
+        self& operator=(const typename Container::value_type& value) {
+            container->push_back(value);
+            return *this;
+        }
+
+        self& operator=(typename Container::value_type&& value) {
+            container->push_back(static_cast<typename Container::value_type&&>(value));
+            return *this;
+        }
+
+        self& operator*() { return *this; }
+        self& operator++() { return *this; }
+        self& operator++(int) { return *this; }
+    };
+
+    template<class Container>
+    back_insert_iterator<Container> back_inserter(Container& c) {
+        return back_insert_iterator<Container>(c);
+    }
 }
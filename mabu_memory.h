@@ -5,6 +5,525 @@
  * author: mabu
  */
 
+/*
+ * 内存资源相关，实现的功能有：
+ * memory_resource(内存资源的抽象接口)
+ * new_delete_resource null_memory_resource get_default_resource set_default_resource
+ * monotonic_buffer_resource(单调增长的内存区，只在 release 或析构时统一释放)
+ * unsynchronized_pool_resource(不加锁的分级内存池)
+ * polymorphic_allocator(通过 memory_resource 分配内存的 allocator)
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "mabu_alloc.h"
+#include "mabu_allocator.h"
+#include "mabu_construct.h"
+#include "mabu_utility.h"
+
 namespace mabustl {
+    /*
+    * *****************************************************************************************************************
+    * memory_resource
+    * 所有内存资源的基类，派生类实现 do_allocate do_deallocate do_is_equal
+    * *****************************************************************************************************************
+    */
+    class memory_resource {
+    public:
+        static const size_t max_align = alignof(std::max_align_t);
+
+    public:
+        virtual ~memory_resource() {}
+
+        void* allocate(size_t bytes, size_t alignment = max_align) {
+            return do_allocate(bytes, alignment);
+        }
+
+        void deallocate(void* ptr, size_t bytes, size_t alignment = max_align) {
+            do_deallocate(ptr, bytes, alignment);
+        }
+
+        bool is_equal(const memory_resource& other) const noexcept {
+            return do_is_equal(other);
+        }
+
+    private:
+        virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+
+        virtual void do_deallocate(void* ptr, size_t bytes, size_t alignment) = 0;
+
+        virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+    };
+
+    inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept {
+        return &lhs == &rhs || lhs.is_equal(rhs);
+    }
+
+    inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * new_delete_resource
+    * 使用 operator new / operator delete 分配内存
+    * 对齐要求超过 max_align 时通过 aligned_allocate 处理
+    * *****************************************************************************************************************
+    */
+    class new_delete_memory_resource : public memory_resource {
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            return aligned_allocate<new_alloc>(bytes, alignment);
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+            aligned_deallocate<new_alloc>(ptr, bytes, alignment);
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    // 任何分配请求都抛出 std::bad_alloc，用来检测不应该发生的上游分配
+    class null_memory_resource_impl : public memory_resource {
+    private:
+        void* do_allocate(size_t, size_t) override {
+            throw std::bad_alloc();
+        }
+
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    inline memory_resource* new_delete_resource() noexcept {
+        static new_delete_memory_resource resource;
+        return &resource;
+    }
+
+    inline memory_resource* null_memory_resource() noexcept {
+        static null_memory_resource_impl resource;
+        return &resource;
+    }
+
+    // 默认内存资源，初始为 new_delete_resource()
+    inline std::atomic<memory_resource*>& default_resource_holder() noexcept {
+        static std::atomic<memory_resource*> holder(new_delete_resource());
+        return holder;
+    }
+
+    inline memory_resource* get_default_resource() noexcept {
+        return default_resource_holder().load(std::memory_order_acquire);
+    }
+
+    // 设置新的默认内存资源，传入 nullptr 时恢复为 new_delete_resource()，返回之前的默认内存资源
+    inline memory_resource* set_default_resource(memory_resource* r) noexcept {
+        if(r == nullptr) r = new_delete_resource();
+        return default_resource_holder().exchange(r, std::memory_order_acq_rel);
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * monotonic_buffer_resource
+    * 从当前内存块中按顺序切割，用完后向上游申请一块更大的内存块
+    * deallocate 不做任何事，所有内存在 release 或析构时一次性归还给上游
+    * *****************************************************************************************************************
+    */
+    class monotonic_buffer_resource : public memory_resource {
+    public:
+        enum : size_t {
+            INITIAL_SIZE = 1024,  // 第一次向上游申请的默认大小
+            GROWTH_FACTOR = 2     // 每次向上游申请时大小的增长倍数
+        };
+
+    public:
+        explicit monotonic_buffer_resource(memory_resource* upstream = get_default_resource())
+            : monotonic_buffer_resource(nullptr, 0, INITIAL_SIZE, upstream) {}
+
+        monotonic_buffer_resource(size_t initial_size, memory_resource* upstream = get_default_resource())
+            : monotonic_buffer_resource(nullptr, 0, initial_size, upstream) {}
+
+        // 先使用调用者提供的 buffer，用完后再向上游申请
+        monotonic_buffer_resource(void* buffer, size_t buffer_size,
+                                  memory_resource* upstream = get_default_resource())
+            : monotonic_buffer_resource(buffer, buffer_size, buffer_size, upstream) {}
+
+        monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+
+        monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+        ~monotonic_buffer_resource() override {
+            release();
+        }
+
+        // 把所有向上游申请的内存块归还，之后重新从初始 buffer 开始分配
+        void release() {
+            while(chunks_ != nullptr) {
+                chunk_header* next = chunks_->next;
+                upstream_->deallocate(chunks_, chunks_->bytes, max_align);
+                chunks_ = next;
+            }
+            current_ = initial_buffer_;
+            space_ = initial_size_;
+            next_size_ = first_size_;
+        }
+
+        memory_resource* upstream_resource() const noexcept {
+            return upstream_;
+        }
+
+    private:
+        // 向上游申请的内存块的头部，记录链表和大小，头部之后才是可用空间
+        struct chunk_header {
+            chunk_header* next;
+            size_t bytes;
+        };
+
+        static const size_t header_size = (sizeof(chunk_header) + max_align - 1) & ~(max_align - 1);
+
+        monotonic_buffer_resource(void* buffer, size_t buffer_size, size_t next_size, memory_resource* upstream)
+            : upstream_(upstream),
+              chunks_(nullptr),
+              initial_buffer_(buffer),
+              initial_size_(buffer_size),
+              current_(buffer),
+              space_(buffer_size),
+              first_size_(next_size > 0 ? next_size : static_cast<size_t>(INITIAL_SIZE)),
+              next_size_(first_size_) {}
+
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            void* result = std::align(alignment, bytes, current_, space_);
+            if(result == nullptr) {
+                new_chunk(bytes, alignment);
+                result = std::align(alignment, bytes, current_, space_);
+            }
+            current_ = static_cast<char*>(current_) + bytes;
+            space_ -= bytes;
+            return result;
+        }
+
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        // 申请一块至少能放下 bytes 字节(按 alignment 对齐)的新内存块
+        void new_chunk(size_t bytes, size_t alignment) {
+            size_t need = bytes + alignment;
+            size_t size = next_size_;
+            while(size < need) size *= GROWTH_FACTOR;
+
+            void* raw = upstream_->allocate(size + header_size, max_align);
+            chunk_header* header = static_cast<chunk_header*>(raw);
+            header->next = chunks_;
+            header->bytes = size + header_size;
+            chunks_ = header;
+
+            current_ = static_cast<char*>(raw) + header_size;
+            space_ = size;
+            next_size_ = size * GROWTH_FACTOR;
+        }
+
+    private:
+        memory_resource* upstream_;
+        chunk_header* chunks_;   // 向上游申请的内存块链表
+        void* initial_buffer_;   // 调用者提供的初始 buffer
+        size_t initial_size_;
+        void* current_;          // 当前内存块中尚未使用部分的起始位置
+        size_t space_;           // 当前内存块中剩余的字节数
+        size_t first_size_;      // 第一次向上游申请的大小
+        size_t next_size_;       // 下一次向上游申请的大小
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * unsynchronized_pool_resource
+    * 按 2 的幂划分大小等级(MIN_BLOCK ~ MAX_BLOCK)，每个等级维护一条自由链表
+    * 自由链表为空时向上游申请一块内存切割成多个块，每次申请的块数翻倍，直到 MAX_BLOCKS_PER_CHUNK
+    * 超过 MAX_BLOCK 或对齐要求超过 max_align 的请求直接交给上游，并记录下来以便 release 时归还
+    * 不加锁，只能在单个线程中使用
+    * *****************************************************************************************************************
+    */
+    class unsynchronized_pool_resource : public memory_resource {
+    public:
+        enum : size_t {
+            MIN_BLOCK = 8,
+            MAX_BLOCK = 4096,
+            POOL_COUNT = 10,  // 8 16 32 ... 4096
+            MIN_BLOCKS_PER_CHUNK = 16,
+            MAX_BLOCKS_PER_CHUNK = 1024
+        };
+
+    public:
+        explicit unsynchronized_pool_resource(memory_resource* upstream = get_default_resource())
+            : upstream_(upstream), large_(nullptr) {
+            for(size_t i = 0; i < POOL_COUNT; ++i) {
+                pools_[i].free_list = nullptr;
+                pools_[i].chunks = nullptr;
+                pools_[i].next_blocks = MIN_BLOCKS_PER_CHUNK;
+            }
+        }
+
+        unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+
+        unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+        ~unsynchronized_pool_resource() override {
+            release();
+        }
+
+        // 把所有向上游申请的内存归还，包括尚未 deallocate 的块
+        void release() {
+            for(size_t i = 0; i < POOL_COUNT; ++i) {
+                pool& p = pools_[i];
+                while(p.chunks != nullptr) {
+                    chunk_header* next = p.chunks->next;
+                    upstream_->deallocate(p.chunks, p.chunks->bytes, max_align);
+                    p.chunks = next;
+                }
+                p.free_list = nullptr;
+                p.next_blocks = MIN_BLOCKS_PER_CHUNK;
+            }
+            while(large_ != nullptr) {
+                large_header* next = large_->next;
+                upstream_->deallocate(large_raw(large_), large_->bytes, large_->alignment);
+                large_ = next;
+            }
+        }
+
+        memory_resource* upstream_resource() const noexcept {
+            return upstream_;
+        }
+
+    private:
+        struct chunk_header {
+            chunk_header* next;
+            size_t bytes;
+        };
+
+        // 直接向上游申请的大块内存的头部，放在返回地址之前
+        struct large_header {
+            large_header* prev;
+            large_header* next;
+            size_t bytes;      // 向上游申请的总字节数
+            size_t alignment;  // 向上游申请时的对齐
+        };
+
+        struct pool {
+            free_list_node* free_list;
+            chunk_header* chunks;
+            size_t next_blocks;  // 下一次补充时切割的块数
+        };
+
+        static const size_t header_size = (sizeof(chunk_header) + max_align - 1) & ~(max_align - 1);
+
+        // 大小为 bytes、对齐为 alignment 的请求所在的等级，超出范围时返回 POOL_COUNT
+        static size_t pool_index(size_t bytes, size_t alignment) {
+            if(alignment > max_align) return POOL_COUNT;
+            size_t need = bytes > alignment ? bytes : alignment;
+            size_t block = MIN_BLOCK;
+            size_t index = 0;
+            while(block < need) {
+                block <<= 1;
+                ++index;
+            }
+            return index;
+        }
+
+        static size_t large_offset(size_t alignment) {
+            return (sizeof(large_header) + alignment - 1) & ~(alignment - 1);
+        }
+
+        static void* large_raw(large_header* header) {
+            return reinterpret_cast<char*>(header + 1) - large_offset(header->alignment);
+        }
+
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            const size_t index = pool_index(bytes, alignment);
+            if(index >= POOL_COUNT) return allocate_large(bytes, alignment);
+
+            pool& p = pools_[index];
+            if(p.free_list == nullptr) refill(p, static_cast<size_t>(MIN_BLOCK) << index);
+            free_list_node* result = p.free_list;
+            p.free_list = result->next;
+            return result;
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+            const size_t index = pool_index(bytes, alignment);
+            if(index >= POOL_COUNT) {
+                deallocate_large(ptr);
+                return;
+            }
+
+            pool& p = pools_[index];
+            free_list_node* node = static_cast<free_list_node*>(ptr);
+            node->next = p.free_list;
+            p.free_list = node;
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        void refill(pool& p, size_t block) {
+            const size_t nblocks = p.next_blocks;
+            const size_t bytes = header_size + nblocks * block;
+            char* raw = static_cast<char*>(upstream_->allocate(bytes, max_align));
+            chunk_header* header = reinterpret_cast<chunk_header*>(raw);
+            header->next = p.chunks;
+            header->bytes = bytes;
+            p.chunks = header;
+
+            // 从后往前串成链表，这样分配时按地址递增的顺序取出
+            char* first = raw + header_size;
+            for(size_t i = nblocks; i > 0; --i) {
+                free_list_node* node = reinterpret_cast<free_list_node*>(first + (i - 1) * block);
+                node->next = p.free_list;
+                p.free_list = node;
+            }
+
+            if(p.next_blocks < MAX_BLOCKS_PER_CHUNK) p.next_blocks *= 2;
+        }
+
+        void* allocate_large(size_t bytes, size_t alignment) {
+            if(alignment < alignof(large_header)) alignment = alignof(large_header);
+            const size_t offset = large_offset(alignment);
+            char* raw = static_cast<char*>(upstream_->allocate(offset + bytes, alignment));
+            large_header* header = reinterpret_cast<large_header*>(raw + offset) - 1;
+            header->prev = nullptr;
+            header->next = large_;
+            header->bytes = offset + bytes;
+            header->alignment = alignment;
+            if(large_ != nullptr) large_->prev = header;
+            large_ = header;
+            return raw + offset;
+        }
+
+        void deallocate_large(void* ptr) {
+            large_header* header = static_cast<large_header*>(ptr) - 1;
+            if(header->prev != nullptr) header->prev->next = header->next;
+            else large_ = header->next;
+            if(header->next != nullptr) header->next->prev = header->prev;
+            upstream_->deallocate(large_raw(header), header->bytes, header->alignment);
+        }
+
+    private:
+        memory_resource* upstream_;
+        pool pools_[POOL_COUNT];
+        large_header* large_;  // 直接向上游申请的大块内存链表
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * polymorphic_allocator
+    * 持有一个 memory_resource 指针，所有分配都转交给它
+    * 接口与 allocator 保持一致，可以替换 allocator 作为模板参数
+    * *****************************************************************************************************************
+    */
+    template<class T>
+    class polymorphic_allocator {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        // 有状态：容器赋值和交换时不传播 allocator，不同实例可能不相等
+        typedef std::false_type propagate_on_container_copy_assignment;
+        typedef std::false_type propagate_on_container_move_assignment;
+        typedef std::false_type propagate_on_container_swap;
+        typedef std::false_type is_always_equal;
+
+        template<class U>
+        struct rebind {
+            typedef polymorphic_allocator<U> other;
+        };
+
+    public:
+        polymorphic_allocator() noexcept: resource_(get_default_resource()) {}
+
+        polymorphic_allocator(memory_resource* resource) noexcept: resource_(resource) {}
+
+        polymorphic_allocator(const polymorphic_allocator& other) = default;
+
+        template<class U>
+        polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept: resource_(other.resource()) {}
+
+        polymorphic_allocator& operator=(const polymorphic_allocator&) = delete;
+
+    public:
+        T* allocate() {
+            return static_cast<T*>(resource_->allocate(sizeof(T), alignof(T)));
+        }
+
+        T* allocate(size_type n) {
+            if(n == 0) return nullptr;
+            return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* ptr) {
+            if(ptr == nullptr) return;
+            resource_->deallocate(ptr, sizeof(T), alignof(T));
+        }
+
+        void deallocate(T* ptr, size_type n) {
+            if(ptr == nullptr) return;
+            resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+        }
+
+        template<class U, class... Args>
+        void construct(U* ptr, Args&&... args) {
+            mabustl::construct(ptr, mabustl::forward<Args>(args)...);
+        }
+
+        template<class U>
+        void destroy(U* ptr) {
+            mabustl::destroy(ptr);
+        }
+
+        void destroy(T* first, T* last) {
+            mabustl::destroy(first, last);
+        }
+
+        // 容器被复制时，新容器使用默认内存资源，而不是沿用原容器的内存资源
+        polymorphic_allocator select_on_container_copy_construction() const {
+            return polymorphic_allocator();
+        }
+
+        memory_resource* resource() const noexcept {
+            return resource_;
+        }
+
+        size_type max_size() const noexcept {
+            return static_cast<size_type>(-1) / sizeof(T);
+        }
+
+    private:
+        memory_resource* resource_;
+    };
+
+    template<class T1, class T2>
+    bool operator==(const polymorphic_allocator<T1>& lhs, const polymorphic_allocator<T2>& rhs) noexcept {
+        return *lhs.resource() == *rhs.resource();
+    }
+
+    template<class T1, class T2>
+    bool operator!=(const polymorphic_allocator<T1>& lhs, const polymorphic_allocator<T2>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
 
+    // construct / destroy 与 mabustl::construct / destroy 相同
+    template<class T>
+    struct allocator_uses_default_construct<polymorphic_allocator<T> > : std::true_type {};
 }
@@ -0,0 +1,305 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * mpmc_queue: 有界的多生产者多消费者无锁队列(Vyukov 的按槽序号算法)
+ * 每个槽带一个序号 seq，容量为 2 的幂 N，第 pos 次入队/出队使用 pos & (N - 1) 号槽：
+ * (1)seq == pos       槽为空，轮到第 pos 次入队，生产者用 CAS 抢到 enqueue_pos 后构造元素，再把 seq 设为 pos + 1
+ * (2)seq == pos + 1   槽中有元素，轮到第 pos 次出队，消费者用 CAS 抢到 dequeue_pos 后取出元素，再把 seq 设为 pos + N
+ * (3)seq 比期望的小   队列满(入队)或空(出队)，try_push / try_pop 直接返回 false
+ * 生产者之间只竞争 enqueue_pos，消费者之间只竞争 dequeue_pos，两者各占一个 cache line；
+ * 每个槽也按 cache line 对齐，相邻的槽被不同线程同时读写时不会伪共享
+ *
+ * push / pop 是阻塞版本：先自旋重试(pause 的次数指数增长)，再 yield 几次，仍然失败就在条件变量上休眠，
+ * 另一侧操作成功后只在有线程休眠时才加锁唤醒，所以不休眠时阻塞版本只比 try 版本多一次内存屏障
+ * try 版本不负责唤醒，休眠的线程每隔 1ms 也会醒来重试一次，阻塞版本和 try 版本混用时不会永远等下去
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "mabu_allocator.h"
+#include "mabu_allocator_traits.h"
+#include "mabu_construct.h"
+#include "mabu_stddef.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    template<class T>
+    struct alignas(cache_line_size) mpmc_queue_cell {
+        std::atomic<size_t> seq;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        T* value_ptr() noexcept { return reinterpret_cast<T*>(&storage); }
+    };
+
+    template<class T, class Alloc = mabustl::allocator<T> >
+    class mpmc_queue {
+        static_assert(std::is_same<T, typename Alloc::value_type>::value, "mpmc_queue: Alloc::value_type must be T");
+        // 抢到槽之后不能再失败，否则后面的消费者会一直等待这个槽
+        static_assert(std::is_nothrow_move_constructible<T>::value,
+                      "mpmc_queue: T must be nothrow move constructible");
+        static_assert(std::is_nothrow_destructible<T>::value, "mpmc_queue: T must be nothrow destructible");
+
+    public:
+        typedef T value_type;
+        typedef Alloc allocator_type;
+        typedef size_t size_type;
+
+        typedef T& reference;
+        typedef const T& const_reference;
+
+    private:
+        typedef mpmc_queue_cell<T> cell;
+        typedef typename allocator_traits<Alloc>::template rebind_alloc<cell> cell_allocator;
+        typedef allocator_traits<cell_allocator> cell_traits;
+
+        // 自旋和 yield 的次数上限
+        enum : size_type {
+            SPIN_LIMIT = 10,
+            YIELD_LIMIT = 4
+        };
+
+        // 继承 allocator，不含状态的 allocator 不占用空间，cells 和 mask 构造后只读
+        struct mpmc_impl : public cell_allocator {
+            cell* cells_;
+            size_type mask_;
+
+            explicit mpmc_impl(const cell_allocator& alloc): cell_allocator(alloc), cells_(nullptr), mask_(0) {}
+        };
+
+        mpmc_impl impl_;
+
+        alignas(cache_line_size) std::atomic<size_type> enqueue_pos_;
+        alignas(cache_line_size) std::atomic<size_type> dequeue_pos_;
+
+        // 阻塞版本休眠用，不休眠时不会访问
+        alignas(cache_line_size) std::atomic<size_type> push_waiters_;
+        std::atomic<size_type> pop_waiters_;
+        std::mutex park_mutex_;
+        std::condition_variable not_full_;
+        std::condition_variable not_empty_;
+
+    public:
+        // 构造、析构函数，容量向上取整到 2 的幂，至少为 2
+        explicit mpmc_queue(size_type capacity, const Alloc& alloc = Alloc());
+
+        mpmc_queue(const mpmc_queue&) = delete;
+        mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+        ~mpmc_queue();
+
+        // 容量相关操作，size 在有线程同时操作时只是一个近似值
+        size_type capacity() const noexcept { return impl_.mask_ + 1; }
+
+        size_type size() const noexcept {
+            const size_type head = dequeue_pos_.load(std::memory_order_acquire);
+            const size_type tail = enqueue_pos_.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+
+        bool empty() const noexcept { return size() == 0; }
+
+        allocator_type get_allocator() const { return allocator_type(impl_); }
+
+        // 非阻塞操作，队列满(空)时返回 false
+        template<class... Args>
+        bool try_emplace(Args&&... args) {
+            return try_emplace_dispatch(std::is_nothrow_constructible<T, Args&&...>(),
+                                        mabustl::forward<Args>(args)...);
+        }
+
+        bool try_push(const T& value) {
+            return try_emplace(value);
+        }
+
+        bool try_push(T&& value) {
+            return try_emplace(mabustl::move(value));
+        }
+
+        bool try_pop(T& value);
+
+        // 阻塞操作，队列满(空)时等待
+        template<class... Args>
+        void emplace(Args&&... args);
+
+        void push(const T& value) {
+            emplace(value);
+        }
+
+        void push(T&& value) {
+            emplace(mabustl::move(value));
+        }
+
+        void pop(T& value);
+
+    private:
+        cell_allocator& get_alloc() noexcept { return impl_; }
+
+        // 抢到一个可以写入的槽，返回其序号 pos，队列满时返回 false
+        bool claim_push(cell*& c, size_type& pos) noexcept;
+
+        // 抢到一个可以读取的槽
+        bool claim_pop(cell*& c, size_type& pos) noexcept;
+
+        // 构造不抛异常时直接在槽中构造
+        template<class... Args>
+        bool try_emplace_dispatch(std::true_type, Args&&... args) {
+            cell* c;
+            size_type pos;
+            if(!claim_push(c, pos)) return false;
+            mabustl::construct(c->value_ptr(), mabustl::forward<Args>(args)...);
+            c->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 构造可能抛异常时先在槽外构造好，抢到槽后再移动进去
+        template<class... Args>
+        bool try_emplace_dispatch(std::false_type, Args&&... args) {
+            T tmp(mabustl::forward<Args>(args)...);
+            return try_emplace_dispatch(std::true_type(), mabustl::move(tmp));
+        }
+
+        // 成功一次操作后唤醒另一侧休眠的线程，屏障保证与 park 中的检查不会同时错过对方
+        void wake(std::atomic<size_type>& waiters, std::condition_variable& cv) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(waiters.load(std::memory_order_relaxed) == 0) return;
+            std::lock_guard<std::mutex> lock(park_mutex_);
+            cv.notify_all();
+        }
+
+        // 先自旋、再 yield，最后在 cv 上休眠，直到 attempt() 成功
+        template<class F>
+        void backoff(F attempt, std::atomic<size_type>& waiters, std::condition_variable& cv);
+    };
+
+    /*****************************************************************************************************************/
+
+    template<class T, class Alloc>
+    mpmc_queue<T, Alloc>::mpmc_queue(size_type capacity, const Alloc& alloc)
+        : impl_(cell_allocator(alloc)), enqueue_pos_(0), dequeue_pos_(0), push_waiters_(0), pop_waiters_(0) {
+        THROW_LENGTH_ERROR_IF(capacity > (cell_traits::max_size(get_alloc()) >> 1) + 1,
+                              "mpmc_queue<T> capacity too big");
+        size_type cap = 2;
+        while(cap < capacity) cap <<= 1;
+        impl_.cells_ = cell_traits::allocate(get_alloc(), cap);
+        for(size_type i = 0; i < cap; ++i) {
+            new(static_cast<void*>(&impl_.cells_[i].seq)) std::atomic<size_type>(i);
+        }
+        impl_.mask_ = cap - 1;
+    }
+
+    template<class T, class Alloc>
+    mpmc_queue<T, Alloc>::~mpmc_queue() {
+        const size_type tail = enqueue_pos_.load(std::memory_order_relaxed);
+        for(size_type pos = dequeue_pos_.load(std::memory_order_relaxed); pos != tail; ++pos) {
+            cell& c = impl_.cells_[pos & impl_.mask_];
+            if(c.seq.load(std::memory_order_relaxed) == pos + 1) mabustl::destroy(c.value_ptr());
+        }
+        cell_traits::deallocate(get_alloc(), impl_.cells_, capacity());
+    }
+
+    template<class T, class Alloc>
+    bool mpmc_queue<T, Alloc>::claim_push(cell*& c, size_type& pos) noexcept {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while(true) {
+            c = impl_.cells_ + (pos & impl_.mask_);
+            const size_type seq = c->seq.load(std::memory_order_acquire);
+            const ptrdiff_t diff = static_cast<ptrdiff_t>(seq - pos);
+            if(diff == 0) {
+                // 失败时 pos 被更新为当前的 enqueue_pos
+                if(enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) return true;
+            } else if(diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template<class T, class Alloc>
+    bool mpmc_queue<T, Alloc>::claim_pop(cell*& c, size_type& pos) noexcept {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while(true) {
+            c = impl_.cells_ + (pos & impl_.mask_);
+            const size_type seq = c->seq.load(std::memory_order_acquire);
+            const ptrdiff_t diff = static_cast<ptrdiff_t>(seq - (pos + 1));
+            if(diff == 0) {
+                if(dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) return true;
+            } else if(diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 移动赋值抛出异常时仍然析构元素并释放槽，元素丢失，队列保持可用
+    template<class T, class Alloc>
+    bool mpmc_queue<T, Alloc>::try_pop(T& value) {
+        cell* c;
+        size_type pos;
+        if(!claim_pop(c, pos)) return false;
+        T* const p = c->value_ptr();
+        try {
+            value = mabustl::move(*p);
+        } catch(...) {
+            mabustl::destroy(p);
+            c->seq.store(pos + impl_.mask_ + 1, std::memory_order_release);
+            throw;
+        }
+        mabustl::destroy(p);
+        c->seq.store(pos + impl_.mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * backoff
+    * 自旋阶段第 i 次失败后执行 2^i 次 pause，之后 yield 若干次，都失败就休眠：
+    * 先登记 waiters 再检查一次，另一侧成功后先看 waiters 再决定是否唤醒，两边都有 seq_cst 屏障，
+    * 所以"检查失败"和"没有看到 waiters"不会同时发生，不会丢失唤醒
+    * *****************************************************************************************************************
+    */
+    template<class T, class Alloc>
+    template<class F>
+    void mpmc_queue<T, Alloc>::backoff(F attempt, std::atomic<size_type>& waiters, std::condition_variable& cv) {
+        for(size_type i = 0; i < SPIN_LIMIT; ++i) {
+            if(attempt()) return;
+            for(size_type n = size_type(1) << i; n > 0; --n) cpu_relax();
+        }
+        for(size_type i = 0; i < YIELD_LIMIT; ++i) {
+            if(attempt()) return;
+            std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock(park_mutex_);
+        waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while(!attempt()) cv.wait_for(lock, std::chrono::milliseconds(1));
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    template<class T, class Alloc>
+    template<class... Args>
+    void mpmc_queue<T, Alloc>::emplace(Args&&... args) {
+        // 先构造好再反复尝试，避免每次重试都重新构造
+        T tmp(mabustl::forward<Args>(args)...);
+        backoff([&] { return try_emplace_dispatch(std::true_type(), mabustl::move(tmp)); }, push_waiters_, not_full_);
+        wake(pop_waiters_, not_empty_);
+    }
+
+    template<class T, class Alloc>
+    void mpmc_queue<T, Alloc>::pop(T& value) {
+        backoff([&] { return try_pop(value); }, pop_waiters_, not_empty_);
+        wake(push_waiters_, not_full_);
+    }
+}
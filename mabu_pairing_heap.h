@@ -0,0 +1,520 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * pairing_heap: 可寻址的优先队列(配对堆)，默认为大根堆
+ * push 返回一个 handle，handle 直接指向元素所在的节点，在元素被 pop / erase 之前一直有效，
+ * 通过 handle 可以 O(1) 访问元素，并支持 decrease_key、increase_key、erase(handle) 和 merge
+ *
+ * 复杂度(均摊)：push、top、merge、decrease_key O(1)，pop、erase、increase_key O(log n)
+ * 这里的 decrease_key 指把元素改成更靠近堆顶的值(按 Compare 更"大")，与 Dijkstra 中使用 greater 时的减小距离一致
+ *
+ * 节点通过 Alloc 重新绑定到节点类型后分配，默认使用 pool_allocator，节点来自内存池的自由链表，
+ * 不会每个节点都调用一次 operator new
+ * 元素直接用 construct / destroy 构造和析构，所以 Alloc 必须使用默认的 construct
+ */
+
+#include <initializer_list>
+
+#include "mabu_allocator.h"
+#include "mabu_allocator_traits.h"
+#include "mabu_construct.h"
+#include "mabu_functional.h"
+#include "mabu_iterator.h"
+#include "mabu_stddef.h"
+#include "mabu_utility.h"
+#include "mabu_vector.h"
+
+namespace mabustl {
+    // 配对堆的节点：child 指向第一个子节点，next 指向下一个兄弟，
+    // prev 对第一个子节点指向父节点，对其余节点指向前一个兄弟，根节点的 prev 和 next 都为空
+    template<class T>
+    struct pairing_heap_node {
+        pairing_heap_node* child;
+        pairing_heap_node* next;
+        pairing_heap_node* prev;
+        T value;
+    };
+
+    // 指向堆中元素的句柄，只能读取元素，修改元素要通过堆的 decrease_key / increase_key / update
+    template<class T>
+    class pairing_heap_handle {
+        template<class, class, class> friend class pairing_heap;
+
+    public:
+        typedef T value_type;
+
+    private:
+        pairing_heap_node<T>* node_;
+
+        explicit pairing_heap_handle(pairing_heap_node<T>* node) noexcept: node_(node) {}
+
+    public:
+        pairing_heap_handle() noexcept: node_(nullptr) {}
+
+        const T& operator*() const noexcept { return node_->value; }
+        const T* operator->() const noexcept { return &node_->value; }
+
+        explicit operator bool() const noexcept { return node_ != nullptr; }
+
+        friend bool operator==(const pairing_heap_handle& lhs, const pairing_heap_handle& rhs) noexcept {
+            return lhs.node_ == rhs.node_;
+        }
+
+        friend bool operator!=(const pairing_heap_handle& lhs, const pairing_heap_handle& rhs) noexcept {
+            return lhs.node_ != rhs.node_;
+        }
+    };
+
+    template<class T, class Compare = mabustl::less<T>, class Alloc = mabustl::pool_allocator<T> >
+    class pairing_heap {
+        static_assert(std::is_same<T, typename Alloc::value_type>::value, "pairing_heap: Alloc::value_type must be T");
+
+    public:
+        typedef T value_type;
+        typedef Compare value_compare;
+        typedef Alloc allocator_type;
+        typedef size_t size_type;
+
+        typedef T& reference;
+        typedef const T& const_reference;
+
+        typedef pairing_heap_handle<T> handle;
+
+    private:
+        typedef pairing_heap_node<T> node;
+        typedef typename allocator_traits<Alloc>::template rebind_alloc<node> node_allocator;
+        typedef allocator_traits<node_allocator> node_traits;
+
+        static_assert(allocator_uses_default_construct<node_allocator>::value,
+                      "pairing_heap: Alloc must construct elements with placement new");
+
+        // 继承 allocator，不含状态的 allocator 不占用空间
+        struct pairing_heap_impl : public node_allocator {
+            node* root_;
+            size_type size_;
+
+            pairing_heap_impl(): node_allocator(), root_(nullptr), size_(0) {}
+
+            explicit pairing_heap_impl(const node_allocator& alloc): node_allocator(alloc), root_(nullptr), size_(0) {}
+        };
+
+        pairing_heap_impl impl_;
+        Compare comp_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        pairing_heap(): impl_(), comp_() {}
+
+        explicit pairing_heap(const Compare& comp, const Alloc& alloc = Alloc())
+            : impl_(node_allocator(alloc)), comp_(comp) {}
+
+        template<class InputIter, typename std::enable_if<mabustl::is_input_iterator<InputIter>::value, int>::type = 0>
+        pairing_heap(InputIter first, InputIter last, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : impl_(node_allocator(alloc)), comp_(comp) {
+            for(; first != last; ++first) push(*first);
+        }
+
+        pairing_heap(std::initializer_list<T> ilist, const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+            : impl_(node_allocator(alloc)), comp_(comp) {
+            for(const T& value : ilist) push(value);
+        }
+
+        // 复制得到的是新的节点，rhs 的 handle 不能用于副本
+        pairing_heap(const pairing_heap& rhs)
+            : impl_(node_traits::select_on_container_copy_construction(rhs.get_alloc())), comp_(rhs.comp_) {
+            append_from(rhs, std::false_type());
+        }
+
+        pairing_heap(pairing_heap&& rhs) noexcept: impl_(mabustl::move(rhs.get_alloc())), comp_(rhs.comp_) {
+            steal(rhs);
+        }
+
+        // 新节点从赋值之后 *this 使用的 allocator 分配，复制完成后再释放旧节点，复制时抛出异常 *this 不变
+        pairing_heap& operator=(const pairing_heap& rhs) {
+            if(this != &rhs) {
+                typedef typename node_traits::propagate_on_container_copy_assignment pocca;
+                pairing_heap tmp(rhs.comp_, allocator_type(copy_source_alloc(rhs, pocca())));
+                tmp.append_from(rhs, std::false_type());
+                clear();
+                copy_alloc(rhs, pocca());
+                comp_ = tmp.comp_;
+                steal(tmp);
+            }
+            return *this;
+        }
+
+        // 能接管 rhs 的节点(allocator 随移动传播或两者相等)时直接接管，否则逐个移动元素到新节点中
+        pairing_heap& operator=(pairing_heap&& rhs)
+        noexcept(node_traits::propagate_on_container_move_assignment::value || node_traits::is_always_equal::value) {
+            if(this != &rhs) {
+                move_assign(rhs, std::integral_constant<bool,
+                                     node_traits::propagate_on_container_move_assignment::value ||
+                                     node_traits::is_always_equal::value>());
+            }
+            return *this;
+        }
+
+        ~pairing_heap() {
+            clear();
+        }
+
+        // 访问元素相关操作
+        const_reference top() const {
+            MABUSTL_DEBUG(!empty());
+            return impl_.root_->value;
+        }
+
+        handle top_handle() const noexcept {
+            return handle(impl_.root_);
+        }
+
+        // 容量相关操作
+        bool empty() const noexcept { return impl_.size_ == 0; }
+        size_type size() const noexcept { return impl_.size_; }
+
+        // 修改容器相关操作
+        handle push(const T& value) {
+            return emplace(value);
+        }
+
+        handle push(T&& value) {
+            return emplace(mabustl::move(value));
+        }
+
+        template<class... Args>
+        handle emplace(Args&&... args) {
+            node* p = create_node(mabustl::forward<Args>(args)...);
+            impl_.root_ = meld(impl_.root_, p);
+            ++impl_.size_;
+            return handle(p);
+        }
+
+        void pop() {
+            MABUSTL_DEBUG(!empty());
+            node* old = impl_.root_;
+            impl_.root_ = merge_pairs(old->child);
+            destroy_node(old);
+            --impl_.size_;
+        }
+
+        // 把 h 指向的元素改成 value，value 不能比原来的值更远离堆顶
+        void decrease_key(handle h, const T& value) {
+            MABUSTL_DEBUG(!comp_(value, h.node_->value));
+            h.node_->value = value;
+            raise(h.node_);
+        }
+
+        void decrease_key(handle h, T&& value) {
+            MABUSTL_DEBUG(!comp_(value, h.node_->value));
+            h.node_->value = mabustl::move(value);
+            raise(h.node_);
+        }
+
+        // 把 h 指向的元素改成 value，value 不能比原来的值更靠近堆顶
+        void increase_key(handle h, const T& value) {
+            MABUSTL_DEBUG(!comp_(h.node_->value, value));
+            h.node_->value = value;
+            sink(h.node_);
+        }
+
+        void increase_key(handle h, T&& value) {
+            MABUSTL_DEBUG(!comp_(h.node_->value, value));
+            h.node_->value = mabustl::move(value);
+            sink(h.node_);
+        }
+
+        // 方向不确定时使用
+        void update(handle h, const T& value) {
+            if(comp_(h.node_->value, value)) {
+                h.node_->value = value;
+                raise(h.node_);
+            } else {
+                h.node_->value = value;
+                sink(h.node_);
+            }
+        }
+
+        void erase(handle h);
+
+        // 把 rhs 中的元素全部并入 *this，rhs 变为空，rhs 的 handle 此后属于 *this，两者的 allocator 必须相等
+        void merge(pairing_heap& rhs) {
+            MABUSTL_DEBUG(get_alloc() == rhs.get_alloc());
+            if(this == &rhs) return;
+            impl_.root_ = meld(impl_.root_, rhs.impl_.root_);
+            impl_.size_ += rhs.impl_.size_;
+            rhs.impl_.root_ = nullptr;
+            rhs.impl_.size_ = 0;
+        }
+
+        void merge(pairing_heap&& rhs) {
+            merge(rhs);
+        }
+
+        void clear() noexcept;
+
+        // allocator 不随交换传播时两者必须相等
+        void swap(pairing_heap& rhs) noexcept {
+            if(this == &rhs) return;
+            MABUSTL_DEBUG(node_traits::propagate_on_container_swap::value || get_alloc() == rhs.get_alloc());
+            swap_alloc(rhs, typename node_traits::propagate_on_container_swap());
+            mabustl::swap(impl_.root_, rhs.impl_.root_);
+            mabustl::swap(impl_.size_, rhs.impl_.size_);
+            mabustl::swap(comp_, rhs.comp_);
+        }
+
+        allocator_type get_allocator() const { return allocator_type(get_alloc()); }
+        value_compare value_comp() const { return comp_; }
+
+    private:
+        node_allocator& get_alloc() noexcept { return impl_; }
+        const node_allocator& get_alloc() const noexcept { return impl_; }
+
+        template<class... Args>
+        node* create_node(Args&&... args) {
+            node* p = node_traits::allocate(get_alloc(), 1);
+            try {
+                mabustl::construct(&p->value, mabustl::forward<Args>(args)...);
+            } catch(...) {
+                node_traits::deallocate(get_alloc(), p, 1);
+                throw;
+            }
+            p->child = p->next = p->prev = nullptr;
+            return p;
+        }
+
+        void destroy_node(node* p) noexcept {
+            mabustl::destroy(&p->value);
+            node_traits::deallocate(get_alloc(), p, 1);
+        }
+
+        node* meld(node* a, node* b);
+        node* merge_pairs(node* first);
+        void cut(node* p) noexcept;
+        void raise(node* p);
+        void sink(node* p);
+        void append_from(const pairing_heap& rhs, std::false_type);
+        void append_from(pairing_heap& rhs, std::true_type);
+
+        void steal(pairing_heap& rhs) noexcept {
+            impl_.root_ = rhs.impl_.root_;
+            impl_.size_ = rhs.impl_.size_;
+            rhs.impl_.root_ = nullptr;
+            rhs.impl_.size_ = 0;
+        }
+
+        void move_assign(pairing_heap& rhs, std::true_type) noexcept {
+            clear();
+            move_alloc(rhs, typename node_traits::propagate_on_container_move_assignment());
+            comp_ = rhs.comp_;
+            steal(rhs);
+        }
+
+        void move_assign(pairing_heap& rhs, std::false_type) {
+            if(get_alloc() == rhs.get_alloc()) {
+                move_assign(rhs, std::true_type());
+                return;
+            }
+            pairing_heap tmp(rhs.comp_, allocator_type(get_alloc()));
+            tmp.append_from(rhs, std::true_type());
+            clear();
+            comp_ = tmp.comp_;
+            steal(tmp);
+            rhs.clear();
+        }
+
+        // 复制赋值时新节点使用的 allocator
+        const node_allocator& copy_source_alloc(const pairing_heap& rhs, std::true_type) const noexcept {
+            return rhs.get_alloc();
+        }
+
+        const node_allocator& copy_source_alloc(const pairing_heap&, std::false_type) const noexcept {
+            return get_alloc();
+        }
+
+        void copy_alloc(const pairing_heap& rhs, std::true_type) {
+            get_alloc() = rhs.get_alloc();
+        }
+
+        void copy_alloc(const pairing_heap&, std::false_type) {}
+
+        void move_alloc(pairing_heap& rhs, std::true_type) {
+            get_alloc() = mabustl::move(rhs.get_alloc());
+        }
+
+        void move_alloc(pairing_heap&, std::false_type) {}
+
+        void swap_alloc(pairing_heap& rhs, std::true_type) {
+            mabustl::swap(get_alloc(), rhs.get_alloc());
+        }
+
+        void swap_alloc(pairing_heap&, std::false_type) {}
+    };
+
+    /*****************************************************************************************************************/
+
+    // 合并两棵树(a、b 都是根或为空)，较小的根成为较大的根的第一个子节点
+    template<class T, class Compare, class Alloc>
+    typename pairing_heap<T, Compare, Alloc>::node* pairing_heap<T, Compare, Alloc>::meld(node* a, node* b) {
+        if(a == nullptr) return b;
+        if(b == nullptr) return a;
+        if(comp_(a->value, b->value)) mabustl::swap(a, b);
+        b->next = a->child;
+        if(a->child) a->child->prev = b;
+        b->prev = a;
+        a->child = b;
+        return a;
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * merge_pairs
+    * 两趟合并一串兄弟节点，返回新的根：
+    * 第一趟从左到右两两合并，结果按相反的顺序串成链表；第二趟从最后一对开始依次合并到一起
+    * 不使用递归，兄弟链再长也不会爆栈
+    * *****************************************************************************************************************
+    */
+    template<class T, class Compare, class Alloc>
+    typename pairing_heap<T, Compare, Alloc>::node* pairing_heap<T, Compare, Alloc>::merge_pairs(node* first) {
+        if(first == nullptr) return nullptr;
+
+        node* pairs = nullptr;
+        while(first) {
+            node* a = first;
+            node* b = a->next;
+            if(b == nullptr) {
+                a->prev = nullptr;
+                a->next = pairs;
+                pairs = a;
+                break;
+            }
+            first = b->next;
+            a->prev = a->next = nullptr;
+            b->prev = b->next = nullptr;
+            node* m = meld(a, b);
+            m->next = pairs;
+            pairs = m;
+        }
+
+        node* root = pairs;
+        pairs = pairs->next;
+        root->next = nullptr;
+        while(pairs) {
+            node* rest = pairs->next;
+            pairs->next = nullptr;
+            root = meld(root, pairs);
+            pairs = rest;
+        }
+        return root;
+    }
+
+    // 把以 p 为根的子树从它所在的兄弟链中摘下，p 不能是整个堆的根
+    template<class T, class Compare, class Alloc>
+    void pairing_heap<T, Compare, Alloc>::cut(node* p) noexcept {
+        if(p->prev->child == p) p->prev->child = p->next;
+        else p->prev->next = p->next;
+        if(p->next) p->next->prev = p->prev;
+        p->prev = p->next = nullptr;
+    }
+
+    // p 的值变得更靠近堆顶：连同子树一起摘下再与根合并
+    template<class T, class Compare, class Alloc>
+    void pairing_heap<T, Compare, Alloc>::raise(node* p) {
+        if(p == impl_.root_) return;
+        cut(p);
+        impl_.root_ = meld(impl_.root_, p);
+    }
+
+    // p 的值变得更远离堆顶：子节点可能比它大，把子节点合并成一棵树后与 p 分别重新并入堆
+    template<class T, class Compare, class Alloc>
+    void pairing_heap<T, Compare, Alloc>::sink(node* p) {
+        node* children = p->child;
+        p->child = nullptr;
+        if(p == impl_.root_) {
+            impl_.root_ = meld(p, merge_pairs(children));
+            return;
+        }
+        cut(p);
+        impl_.root_ = meld(meld(impl_.root_, p), merge_pairs(children));
+    }
+
+    template<class T, class Compare, class Alloc>
+    void pairing_heap<T, Compare, Alloc>::erase(handle h) {
+        node* p = h.node_;
+        if(p == impl_.root_) {
+            pop();
+            return;
+        }
+        cut(p);
+        impl_.root_ = meld(impl_.root_, merge_pairs(p->child));
+        destroy_node(p);
+        --impl_.size_;
+    }
+
+    // 销毁所有节点：把每个节点的子节点链接到它的兄弟链后面，整棵树就变成一条链，不需要递归或额外的栈
+    template<class T, class Compare, class Alloc>
+    void pairing_heap<T, Compare, Alloc>::clear() noexcept {
+        node* cur = impl_.root_;
+        while(cur) {
+            if(cur->child) {
+                node* last = cur->child;
+                while(last->next) last = last->next;
+                last->next = cur->next;
+                cur->next = cur->child;
+            }
+            node* next = cur->next;
+            destroy_node(cur);
+            cur = next;
+        }
+        impl_.root_ = nullptr;
+        impl_.size_ = 0;
+    }
+
+    // 按深度优先顺序复制 rhs 的元素，每个元素 push 一次，push 是 O(1) 的
+    template<class T, class Compare, class Alloc>
+    void pairing_heap<T, Compare, Alloc>::append_from(const pairing_heap& rhs, std::false_type) {
+        if(rhs.empty()) return;
+        mabustl::vector<const node*> stack;
+        stack.push_back(rhs.impl_.root_);
+        try {
+            while(!stack.empty()) {
+                const node* p = stack.back();
+                stack.pop_back();
+                push(p->value);
+                for(const node* c = p->child; c != nullptr; c = c->next) stack.push_back(c);
+            }
+        } catch(...) {
+            clear();
+            throw;
+        }
+    }
+
+    // 与上面相同，但移动 rhs 的元素，rhs 的节点留给调用者释放
+    template<class T, class Compare, class Alloc>
+    void pairing_heap<T, Compare, Alloc>::append_from(pairing_heap& rhs, std::true_type) {
+        if(rhs.empty()) return;
+        mabustl::vector<node*> stack;
+        stack.push_back(rhs.impl_.root_);
+        try {
+            while(!stack.empty()) {
+                node* p = stack.back();
+                stack.pop_back();
+                push(mabustl::move(p->value));
+                for(node* c = p->child; c != nullptr; c = c->next) stack.push_back(c);
+            }
+        } catch(...) {
+            clear();
+            throw;
+        }
+    }
+
+    // 重载 mabustl 的 swap
+    template<class T, class Compare, class Alloc>
+    void swap(pairing_heap<T, Compare, Alloc>& lhs, pairing_heap<T, Compare, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * priority_queue: 优先队列，底层默认以 vector 作为容器，用堆算法维护，默认为大根堆
+ */
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "mabu_functional.h"
+#include "mabu_heap_algorithm.h"
+#include "mabu_iterator.h"
+#include "mabu_utility.h"
+#include "mabu_vector.h"
+
+namespace mabustl {
+    template<class T, class Container = mabustl::vector<T>, class Compare = mabustl::less<typename Container::value_type> >
+    class priority_queue {
+    public:
+        typedef Container container_type;
+        typedef Compare value_compare;
+
+        typedef typename Container::value_type value_type;
+        typedef typename Container::size_type size_type;
+        typedef typename Container::reference reference;
+        typedef typename Container::const_reference const_reference;
+
+        static_assert(std::is_same<T, value_type>::value,
+                      "the value_type of Container should be same with T");
+
+    protected:
+        container_type c;
+        value_compare comp;
+
+    public:
+        // 构造、复制、移动函数
+        priority_queue(): c(), comp() {}
+
+        explicit priority_queue(const Compare& compare): c(), comp(compare) {}
+
+        priority_queue(const Compare& compare, const Container& cont): c(cont), comp(compare) {
+            mabustl::make_heap(c.begin(), c.end(), comp);
+        }
+
+        priority_queue(const Compare& compare, Container&& cont): c(mabustl::move(cont)), comp(compare) {
+            mabustl::make_heap(c.begin(), c.end(), comp);
+        }
+
+        template<class InputIter, typename std::enable_if<mabustl::is_input_iterator<InputIter>::value, int>::type = 0>
+        priority_queue(InputIter first, InputIter last, const Compare& compare = Compare())
+            : c(first, last), comp(compare) {
+            mabustl::make_heap(c.begin(), c.end(), comp);
+        }
+
+        priority_queue(std::initializer_list<value_type> ilist, const Compare& compare = Compare())
+            : c(ilist.begin(), ilist.end()), comp(compare) {
+            mabustl::make_heap(c.begin(), c.end(), comp);
+        }
+
+        priority_queue(const priority_queue& rhs) = default;
+        priority_queue(priority_queue&& rhs) = default;
+
+        priority_queue& operator=(const priority_queue& rhs) = default;
+        priority_queue& operator=(priority_queue&& rhs) = default;
+
+        priority_queue& operator=(std::initializer_list<value_type> ilist) {
+            c.assign(ilist.begin(), ilist.end());
+            mabustl::make_heap(c.begin(), c.end(), comp);
+            return *this;
+        }
+
+        ~priority_queue() = default;
+
+        // 访问元素相关操作
+        const_reference top() const { return c.front(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return c.empty(); }
+        size_type size() const noexcept { return c.size(); }
+
+        // 修改容器相关操作
+        void push(const value_type& value) {
+            c.push_back(value);
+            mabustl::push_heap(c.begin(), c.end(), comp);
+        }
+
+        void push(value_type&& value) {
+            c.push_back(mabustl::move(value));
+            mabustl::push_heap(c.begin(), c.end(), comp);
+        }
+
+        template<class... Args>
+        void emplace(Args&&... args) {
+            c.emplace_back(mabustl::forward<Args>(args)...);
+            mabustl::push_heap(c.begin(), c.end(), comp);
+        }
+
+        template<class InputIter>
+        void push_range(InputIter first, InputIter last);
+
+        void push_range(std::initializer_list<value_type> ilist) {
+            push_range(ilist.begin(), ilist.end());
+        }
+
+        void pop() {
+            mabustl::pop_heap(c.begin(), c.end(), comp);
+            c.pop_back();
+        }
+
+        void clear() {
+            c.clear();
+        }
+
+        void swap(priority_queue& rhs) {
+            c.swap(rhs.c);
+            mabustl::swap(comp, rhs.comp);
+        }
+
+    public:
+        friend bool operator==(const priority_queue& lhs, const priority_queue& rhs) {
+            return lhs.c == rhs.c;
+        }
+
+        friend bool operator!=(const priority_queue& lhs, const priority_queue& rhs) {
+            return lhs.c != rhs.c;
+        }
+    };
+
+    /*
+    * *********************************************************************************************************************
+    * push_range
+    * 先把[first, last)全部追加到容器末尾，再恢复堆：
+    * 逐个 push_heap 或整体重建(Floyd)，由 prefer_make_heap 按代价选择，追加的元素较多时只需 O(n) 就能重新成堆
+    * *********************************************************************************************************************
+    */
+    template<class T, class Container, class Compare>
+    template<class InputIter>
+    void priority_queue<T, Container, Compare>::push_range(InputIter first, InputIter last) {
+        const size_type old_size = c.size();
+        c.insert(c.end(), first, last);
+        const size_type new_size = c.size();
+        const size_type count = new_size - old_size;
+        if(count == 0) return;
+
+        if(mabustl::prefer_make_heap(old_size, new_size)) {
+            mabustl::make_heap(c.begin(), c.end(), comp);
+        } else {
+            typename Container::iterator heap_first = c.begin();
+            for(size_type i = old_size + 1; i <= new_size; ++i) {
+                mabustl::push_heap(heap_first, heap_first + i, comp);
+            }
+        }
+    }
+
+    // 重载 mabustl 的 swap
+    template<class T, class Container, class Compare>
+    void swap(priority_queue<T, Container, Compare>& lhs,
+              priority_queue<T, Container, Compare>& rhs) {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * radix_heap: 以无符号整数为 key 的单调小根堆
+ * 要求新 push 的 key 不小于最近一次 pop 出的 key(事件循环中的时间戳天然满足)，
+ * 在这个前提下不需要比较元素之间的大小，只按 key 与 last(最近 pop 出的 key) 最高的不同位分桶：
+ * key == last 放在 0 号桶，否则放在 bit_width(key ^ last) 号桶，共 digits + 1 个桶
+ * pop 时 0 号桶为空，就把编号最小的非空桶整体按新的 last 重新分配到更低的桶中，
+ * 每个元素在整个生命周期中最多下移 digits 次，push / pop 均摊 O(log C)，C 为 key 的取值范围
+ *
+ * T 为 void 时只保存 key，否则保存 pair<Key, T>
+ * 每个桶是一个 vector，重新分配后只 clear 不释放，之后的 push 直接复用已有的空间
+ */
+
+#include <climits>
+#include <limits>
+#include <type_traits>
+
+#include "mabu_allocator.h"
+#include "mabu_stddef.h"
+#include "mabu_utility.h"
+#include "mabu_vector.h"
+
+namespace mabustl {
+    template<class Key, class T>
+    struct radix_heap_traits {
+        typedef pair<Key, T> value_type;
+
+        static Key key(const value_type& value) noexcept {
+            return value.first;
+        }
+    };
+
+    template<class Key>
+    struct radix_heap_traits<Key, void> {
+        typedef Key value_type;
+
+        static Key key(const value_type& value) noexcept {
+            return value;
+        }
+    };
+
+    // x 的有效位数，x 不能为 0
+    inline size_t radix_bit_width(unsigned long long x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(sizeof(unsigned long long) * CHAR_BIT - __builtin_clzll(x));
+#else
+        size_t n = 0;
+        for(; x != 0; x >>= 1) ++n;
+        return n;
+#endif
+    }
+
+    // x 最低的 1 所在的位置，x 不能为 0
+    inline size_t radix_lowest_bit(unsigned long long x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzll(x));
+#else
+        size_t n = 0;
+        for(; (x & 1) == 0; x >>= 1) ++n;
+        return n;
+#endif
+    }
+
+    template<class Key, class T = void,
+             class Alloc = mabustl::allocator<typename radix_heap_traits<Key, T>::value_type> >
+    class radix_heap {
+        static_assert(std::is_integral<Key>::value && std::is_unsigned<Key>::value,
+                      "radix_heap: Key must be an unsigned integer type");
+        static_assert(std::numeric_limits<Key>::digits <= 64, "radix_heap: Key wider than 64 bits is not supported");
+
+    public:
+        typedef Key key_type;
+        typedef typename radix_heap_traits<Key, T>::value_type value_type;
+        typedef Alloc allocator_type;
+        typedef size_t size_type;
+
+        typedef value_type& reference;
+        typedef const value_type& const_reference;
+
+    private:
+        typedef radix_heap_traits<Key, T> traits;
+        typedef mabustl::vector<value_type, Alloc> bucket_type;
+
+        enum : size_t {
+            BITS = std::numeric_limits<Key>::digits,
+            BUCKET_COUNT = BITS + 1
+        };
+
+        bucket_type buckets_[BUCKET_COUNT];
+        // 每个桶中最小元素的位置和 key，只对 1 号及之后的非空桶有意义
+        size_type min_pos_[BUCKET_COUNT];
+        Key min_key_[BUCKET_COUNT];
+        // 第 i - 1 位表示 i 号桶非空，0 号桶直接看 vector 是否为空
+        unsigned long long mask_;
+        Key last_;
+        size_type size_;
+
+    public:
+        // 构造、复制、移动函数
+        radix_heap(): min_pos_(), min_key_(), mask_(0), last_(0), size_(0) {}
+
+        radix_heap(const radix_heap& rhs) = default;
+        radix_heap& operator=(const radix_heap& rhs) = default;
+
+        radix_heap(radix_heap&& rhs) noexcept
+            : mask_(rhs.mask_), last_(rhs.last_), size_(rhs.size_) {
+            for(size_type i = 0; i < BUCKET_COUNT; ++i) {
+                buckets_[i] = mabustl::move(rhs.buckets_[i]);
+                min_pos_[i] = rhs.min_pos_[i];
+                min_key_[i] = rhs.min_key_[i];
+            }
+            rhs.mask_ = 0;
+            rhs.last_ = 0;
+            rhs.size_ = 0;
+        }
+
+        radix_heap& operator=(radix_heap&& rhs) noexcept {
+            if(this != &rhs) {
+                radix_heap tmp(mabustl::move(rhs));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        ~radix_heap() = default;
+
+        // 访问元素相关操作
+        const_reference top() const {
+            MABUSTL_DEBUG(!empty());
+            if(!buckets_[0].empty()) return buckets_[0].back();
+            const size_type i = radix_lowest_bit(mask_) + 1;
+            return buckets_[i][min_pos_[i]];
+        }
+
+        key_type top_key() const {
+            return traits::key(top());
+        }
+
+        // 最近一次 pop 出的 key，之后 push 的 key 不能比它小
+        key_type last_key() const noexcept { return last_; }
+
+        // 容量相关操作
+        bool empty() const noexcept { return size_ == 0; }
+        size_type size() const noexcept { return size_; }
+
+        // 修改容器相关操作
+        void push(const value_type& value) {
+            insert(bucket_index(traits::key(value)), value);
+            ++size_;
+        }
+
+        void push(value_type&& value) {
+            insert(bucket_index(traits::key(value)), mabustl::move(value));
+            ++size_;
+        }
+
+        template<class... Args>
+        void emplace(Args&&... args) {
+            push(value_type(mabustl::forward<Args>(args)...));
+        }
+
+        void pop() {
+            MABUSTL_DEBUG(!empty());
+            if(buckets_[0].empty()) pull();
+            buckets_[0].pop_back();
+            --size_;
+        }
+
+        // 清空所有元素并把 last 重置为 0，桶的空间保留
+        void clear() noexcept {
+            for(size_type i = 0; i < BUCKET_COUNT; ++i) buckets_[i].clear();
+            mask_ = 0;
+            last_ = 0;
+            size_ = 0;
+        }
+
+        void swap(radix_heap& rhs) noexcept {
+            for(size_type i = 0; i < BUCKET_COUNT; ++i) {
+                buckets_[i].swap(rhs.buckets_[i]);
+                mabustl::swap(min_pos_[i], rhs.min_pos_[i]);
+                mabustl::swap(min_key_[i], rhs.min_key_[i]);
+            }
+            mabustl::swap(mask_, rhs.mask_);
+            mabustl::swap(last_, rhs.last_);
+            mabustl::swap(size_, rhs.size_);
+        }
+
+    private:
+        size_type bucket_index(Key key) const noexcept {
+            MABUSTL_DEBUG(key >= last_);
+            return key == last_ ? 0 : radix_bit_width(static_cast<unsigned long long>(key ^ last_));
+        }
+
+        template<class V>
+        void insert(size_type i, V&& value) {
+            const Key key = traits::key(value);
+            bucket_type& bucket = buckets_[i];
+            bucket.push_back(mabustl::forward<V>(value));
+            if(i == 0) return;
+            if(bucket.size() == 1 || key < min_key_[i]) {
+                min_key_[i] = key;
+                min_pos_[i] = bucket.size() - 1;
+            }
+            mask_ |= 1ULL << (i - 1);
+        }
+
+        void pull();
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * pull
+    * 0 号桶为空时调用：取编号最小的非空桶 i，把 last 设为其中最小的 key，再把桶 i 的元素全部重新分桶
+    * 桶 i 中的 key 与新 last 在第 i - 1 位之上都相同，所以它们都会落到编号小于 i 的桶中，最小的那个落到 0 号桶
+    * *****************************************************************************************************************
+    */
+    template<class Key, class T, class Alloc>
+    void radix_heap<Key, T, Alloc>::pull() {
+        MABUSTL_DEBUG(mask_ != 0);
+        const size_type i = radix_lowest_bit(mask_) + 1;
+        bucket_type& bucket = buckets_[i];
+        last_ = min_key_[i];
+        for(value_type& value : bucket) {
+            insert(bucket_index(traits::key(value)), mabustl::move(value));
+        }
+        bucket.clear();
+        mask_ &= ~(1ULL << (i - 1));
+    }
+
+    // 重载 mabustl 的 swap
+    template<class Key, class T, class Alloc>
+    void swap(radix_heap<Key, T, Alloc>& lhs, radix_heap<Key, T, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,436 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * radix_sort: 基数排序，key 可以是整数、IEEE 754 浮点数，或者由它们组成的 mabustl::pair(按字典序)
+ * (1)key 先映射为同宽度的无符号整数并保持顺序：有符号整数翻转符号位；浮点数为正时翻转符号位，为负时翻转所有位。
+ *    浮点数的顺序为 -NaN < -inf < ... < -0 < +0 < ... < +inf < +NaN
+ * (2)LSD：每一位(digit)8 或 11 个比特，元素较少时用 8 位，计数数组更小，清零和求前缀和的开销更低；
+ *    元素较多时用 11 位，32 位的 key 只要 3 趟
+ * (3)第一趟读取时同时统计所有位的计数，某一位上所有元素都相同时跳过这一趟，
+ *    取值范围小或高位全为 0 的 key 只需要很少几趟
+ * (4)元素很多时先按有差异的最高 11 个比特分组(MSD)，每组能放进缓存，再分别做 LSD，
+ *    整个数组只需要读写两遍主存，而不是每一趟都读写一遍；组内的 LSD 只统计和处理可能不同的低位
+ * (5)pair 作为 key 时先按 second 排，再按 first 排，每一步都是稳定的，结果按字典序有序
+ * (6)元素在原区间和临时缓冲区之间来回搬移，缓冲区可以由调用者提供(至少 last - first 个元素，
+ *    由 mabustl::allocator 分配、未构造的内存)，否则在内部分配。搬移按字节复制，所以元素必须可以平凡重定位
+ * (7)元素少于 radix_sort_threshold 个时直接用插入排序
+ * 排序是稳定的。key(value) 给出排序用的 key，默认是元素本身，例如对 pair<Key, T> 的区间用
+ * selectFirst<pair<Key, T> >() 只按 first 排序
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_allocator.h"
+#include "mabu_functional.h"
+#include "mabu_iterator.h"
+#include "mabu_sort_algorithm.h"
+#include "mabu_type_traits.h"
+#include "mabu_utility.h"
+#include "mabu_vector.h"
+
+namespace mabustl {
+    /*
+    * *****************************************************************************************************************
+    * radix_traits
+    * 把算术类型的 key 映射成同宽度的无符号整数，映射前后的大小关系相同
+    * *****************************************************************************************************************
+    */
+    template<size_t Size>
+    struct radix_unsigned;
+
+    template<>
+    struct radix_unsigned<1> { typedef uint8_t type; };
+
+    template<>
+    struct radix_unsigned<2> { typedef uint16_t type; };
+
+    template<>
+    struct radix_unsigned<4> { typedef uint32_t type; };
+
+    template<>
+    struct radix_unsigned<8> { typedef uint64_t type; };
+
+    template<class Key>
+    struct radix_traits {
+        static_assert(std::is_integral<Key>::value ||
+                      (std::is_floating_point<Key>::value && std::numeric_limits<Key>::is_iec559),
+                      "radix_sort requires integral, IEEE 754 floating-point or pair keys");
+
+        typedef typename radix_unsigned<sizeof(Key)>::type unsigned_type;
+
+        enum : size_t { BITS = sizeof(Key) * 8 };
+
+        static unsigned_type encode(Key key) noexcept {
+            return encode(key, std::integral_constant<int, std::is_floating_point<Key>::value ? 2 :
+                                                           std::is_signed<Key>::value ? 1 : 0>());
+        }
+
+    private:
+        static constexpr unsigned_type sign_bit = static_cast<unsigned_type>(unsigned_type(1) << (BITS - 1));
+
+        static unsigned_type encode(Key key, std::integral_constant<int, 0>) noexcept {
+            return static_cast<unsigned_type>(key);
+        }
+
+        static unsigned_type encode(Key key, std::integral_constant<int, 1>) noexcept {
+            return static_cast<unsigned_type>(static_cast<unsigned_type>(key) ^ sign_bit);
+        }
+
+        // 负数翻转所有位，非负数只翻转符号位
+        static unsigned_type encode(Key key, std::integral_constant<int, 2>) noexcept {
+            unsigned_type bits;
+            std::memcpy(&bits, &key, sizeof(Key));
+            const unsigned_type mask = static_cast<unsigned_type>(-static_cast<unsigned_type>(bits >> (BITS - 1)));
+            return static_cast<unsigned_type>(bits ^ (mask | sign_bit));
+        }
+    };
+
+    template<class Key>
+    constexpr typename radix_traits<Key>::unsigned_type radix_traits<Key>::sign_bit;
+
+    template<class Key>
+    struct is_radix_pair : std::false_type {};
+
+    template<class T1, class T2>
+    struct is_radix_pair<mabustl::pair<T1, T2> > : std::true_type {};
+
+    // key(value) 的类型
+    template<class KeyFn, class T>
+    struct radix_key_type {
+        typedef typename std::decay<decltype(std::declval<const KeyFn&>()(std::declval<const T&>()))>::type type;
+    };
+
+    // 取出 pair 类型的 key 中的一项
+    template<class KeyFn, class T>
+    struct radix_first_key {
+        KeyFn key;
+
+        explicit radix_first_key(const KeyFn& k): key(k) {}
+
+        typename radix_key_type<KeyFn, T>::type::first_type operator()(const T& value) const {
+            return key(value).first;
+        }
+    };
+
+    template<class KeyFn, class T>
+    struct radix_second_key {
+        KeyFn key;
+
+        explicit radix_second_key(const KeyFn& k): key(k) {}
+
+        typename radix_key_type<KeyFn, T>::type::second_type operator()(const T& value) const {
+            return key(value).second;
+        }
+    };
+
+    // 与基数排序结果一致的比较，用于元素较少时的插入排序
+    template<class Key>
+    bool radix_key_less(const Key& lhs, const Key& rhs, std::false_type) noexcept {
+        return radix_traits<Key>::encode(lhs) < radix_traits<Key>::encode(rhs);
+    }
+
+    template<class Key>
+    bool radix_key_less(const Key& lhs, const Key& rhs, std::true_type) noexcept {
+        typedef typename Key::first_type first_type;
+        typedef typename Key::second_type second_type;
+        if(mabustl::radix_key_less(lhs.first, rhs.first, is_radix_pair<first_type>())) return true;
+        if(mabustl::radix_key_less(rhs.first, lhs.first, is_radix_pair<first_type>())) return false;
+        return mabustl::radix_key_less(lhs.second, rhs.second, is_radix_pair<second_type>());
+    }
+
+    template<class KeyFn, class T>
+    struct radix_compare {
+        typedef typename radix_key_type<KeyFn, T>::type key_type;
+
+        KeyFn key;
+
+        explicit radix_compare(const KeyFn& k): key(k) {}
+
+        bool operator()(const T& lhs, const T& rhs) const {
+            return mabustl::radix_key_less(key(lhs), key(rhs), is_radix_pair<key_type>());
+        }
+    };
+
+    /*
+    * *****************************************************************************************************************
+    * radix_sort 的实现
+    * in_buffer 表示元素当前在缓冲区中还是在原区间中，每执行一趟翻转一次
+    * *****************************************************************************************************************
+    */
+    // 少于 radix_sort_threshold 个元素时用插入排序，不超过 radix_wide_digit_threshold 时每一位 8 个比特，否则 11 个比特；
+    // 不少于 radix_msd_threshold 时先按最高的一位分组(MSD)，每组小到能放进缓存，再分别做 LSD
+    constexpr size_t radix_sort_threshold = 64;
+    constexpr size_t radix_wide_digit_threshold = size_t(1) << 17;
+    constexpr size_t radix_msd_threshold = size_t(1) << 19;
+
+    // 计数数组的大小：64 位的 key 每一位 11 个比特时分 6 组
+    constexpr size_t radix_counts_size = 6 * 2048;
+
+    // 一次遍历统计低 passes 位上各个取值出现的次数，counts 按位分为 passes 组
+    template<size_t Bits, class Iter, class KeyFn>
+    void radix_histogram(Iter src, size_t n, KeyFn key, size_t passes, size_t* counts) {
+        typedef typename radix_key_type<KeyFn, typename iterator_traits<Iter>::value_type>::type key_type;
+        typedef radix_traits<key_type> traits;
+        typedef typename traits::unsigned_type unsigned_type;
+        enum : size_t { BUCKETS = size_t(1) << Bits };
+        for(size_t i = 0; i != n; ++i) {
+            const unsigned_type k = traits::encode(key(src[i]));
+            for(size_t pass = 0; pass != passes; ++pass) {
+                ++counts[pass * BUCKETS + ((k >> (pass * Bits)) & (BUCKETS - 1))];
+            }
+        }
+    }
+
+    // 按 offsets 把元素分配到 dst 中，offsets 是这一位的前缀和，分配后指向各组的末尾
+    template<size_t Bits, class Iter1, class Iter2, class KeyFn>
+    void radix_scatter(Iter1 src, Iter2 dst, size_t n, KeyFn key, size_t shift, size_t* offsets) {
+        typedef typename iterator_traits<Iter1>::value_type T;
+        typedef typename radix_key_type<KeyFn, T>::type key_type;
+        typedef radix_traits<key_type> traits;
+        enum : size_t { BUCKETS = size_t(1) << Bits };
+        for(size_t i = 0; i != n; ++i) {
+            const size_t digit = static_cast<size_t>((traits::encode(key(src[i])) >> shift) & (BUCKETS - 1));
+            std::memcpy(static_cast<void*>(&dst[offsets[digit]++]), static_cast<const void*>(&src[i]), sizeof(T));
+        }
+    }
+
+    // 把缓冲区中的 n 个元素搬回原区间
+    template<class RandomIter, class T>
+    void radix_copy_back(RandomIter first, const T* buffer, size_t n) {
+        for(size_t i = 0; i != n; ++i) {
+            std::memcpy(static_cast<void*>(&first[i]), static_cast<const void*>(buffer + i), sizeof(T));
+        }
+    }
+
+    template<size_t Bits, class RandomIter, class T, class KeyFn>
+    void radix_count(RandomIter first, const T* buffer, size_t n, KeyFn key, size_t passes, size_t* counts,
+                     bool in_buffer) {
+        enum : size_t { BUCKETS = size_t(1) << Bits };
+        mabustl::fill_n(counts, passes * BUCKETS, size_t(0));
+        if(in_buffer) mabustl::radix_histogram<Bits>(buffer, n, key, passes, counts);
+        else mabustl::radix_histogram<Bits>(first, n, key, passes, counts);
+    }
+
+    // 所有元素在第 pass 位上都相同，这一趟不会改变顺序
+    template<size_t Bits, class RandomIter, class T, class KeyFn>
+    bool radix_trivial_pass(RandomIter first, const T* buffer, size_t n, KeyFn key, const size_t* counts,
+                            size_t pass, bool in_buffer) {
+        typedef typename radix_key_type<KeyFn, T>::type key_type;
+        enum : size_t { BUCKETS = size_t(1) << Bits };
+        const key_type key0 = in_buffer ? key(buffer[0]) : key(first[0]);
+        return counts[pass * BUCKETS + ((radix_traits<key_type>::encode(key0) >> (pass * Bits)) & (BUCKETS - 1))] == n;
+    }
+
+    // 依次执行前 passes 位中不平凡的各趟，counts 已经统计好
+    template<size_t Bits, class RandomIter, class T, class KeyFn>
+    void radix_lsd_passes(RandomIter first, T* buffer, size_t n, KeyFn key, size_t* counts, size_t passes,
+                          bool& in_buffer) {
+        enum : size_t { BUCKETS = size_t(1) << Bits };
+        for(size_t pass = 0; pass != passes; ++pass) {
+            if(mabustl::radix_trivial_pass<Bits>(first, buffer, n, key, counts, pass, in_buffer)) continue;
+            size_t* offsets = counts + pass * BUCKETS;
+            size_t sum = 0;
+            for(size_t digit = 0; digit != BUCKETS; ++digit) {
+                const size_t count = offsets[digit];
+                offsets[digit] = sum;
+                sum += count;
+            }
+            if(in_buffer) mabustl::radix_scatter<Bits>(buffer, first, n, key, pass * Bits, offsets);
+            else mabustl::radix_scatter<Bits>(first, buffer, n, key, pass * Bits, offsets);
+            in_buffer = !in_buffer;
+        }
+    }
+
+    // 只有低 bits 个比特可能不同
+    template<size_t Bits, class RandomIter, class T, class KeyFn>
+    void radix_lsd(RandomIter first, T* buffer, size_t n, KeyFn key, size_t bits, size_t* counts, bool& in_buffer) {
+        const size_t passes = (bits + Bits - 1) / Bits;
+        mabustl::radix_count<Bits>(first, buffer, n, key, passes, counts, in_buffer);
+        mabustl::radix_lsd_passes<Bits>(first, buffer, n, key, counts, passes, in_buffer);
+    }
+
+    // 长度小于 radix_msd_threshold 的区间，只有低 bits 个比特可能不同
+    template<class RandomIter, class T, class KeyFn>
+    void radix_sort_range(RandomIter first, T* buffer, size_t n, KeyFn key, size_t bits, size_t* counts,
+                          bool& in_buffer) {
+        if(n < radix_sort_threshold) {
+            if(in_buffer) {
+                mabustl::radix_copy_back(first, buffer, n);
+                in_buffer = false;
+            }
+            mabustl::insertion_sort(first, first + n, radix_compare<KeyFn, T>(key));
+        } else if(n <= radix_wide_digit_threshold) {
+            mabustl::radix_lsd<8>(first, buffer, n, key, bits, counts, in_buffer);
+        } else {
+            mabustl::radix_lsd<11>(first, buffer, n, key, bits, counts, in_buffer);
+        }
+    }
+
+    template<class RandomIter, class T, class KeyFn>
+    void radix_msd(RandomIter first, T* buffer, size_t n, KeyFn key, size_t* counts, bool& in_buffer);
+
+    // 算术类型的 key
+    template<class RandomIter, class T, class KeyFn>
+    void radix_sort_key(RandomIter first, T* buffer, size_t n, KeyFn key, size_t* counts, bool& in_buffer,
+                        std::false_type) {
+        typedef typename radix_key_type<KeyFn, T>::type key_type;
+        if(n < radix_msd_threshold) {
+            mabustl::radix_sort_range(first, buffer, n, key, radix_traits<key_type>::BITS, counts, in_buffer);
+        } else {
+            mabustl::radix_msd(first, buffer, n, key, counts, in_buffer);
+        }
+    }
+
+    // 所有 key 与第一个 key 按位异或后再按位或，为 1 的比特在 key 之间有差异
+    template<class Iter, class KeyFn>
+    typename radix_traits<typename radix_key_type<KeyFn, typename iterator_traits<Iter>::value_type>::type>::unsigned_type
+    radix_varying_bits(Iter src, size_t n, KeyFn key) {
+        typedef typename radix_key_type<KeyFn, typename iterator_traits<Iter>::value_type>::type key_type;
+        typedef radix_traits<key_type> traits;
+        typedef typename traits::unsigned_type unsigned_type;
+        const unsigned_type key0 = traits::encode(key(src[0]));
+        unsigned_type diff = 0;
+        for(size_t i = 0; i != n; ++i) diff = static_cast<unsigned_type>(diff | (traits::encode(key(src[i])) ^ key0));
+        return diff;
+    }
+
+    // 第 shift 位起 Bits 个比特这一位的计数
+    template<size_t Bits, class Iter, class KeyFn>
+    void radix_digit_histogram(Iter src, size_t n, KeyFn key, size_t shift, size_t* counts) {
+        typedef typename radix_key_type<KeyFn, typename iterator_traits<Iter>::value_type>::type key_type;
+        typedef radix_traits<key_type> traits;
+        enum : size_t { BUCKETS = size_t(1) << Bits };
+        mabustl::fill_n(counts, static_cast<size_t>(BUCKETS), size_t(0));
+        for(size_t i = 0; i != n; ++i) ++counts[(traits::encode(key(src[i])) >> shift) & (BUCKETS - 1)];
+    }
+
+    // 按有差异的最高 11 个比特分到各组，再对每组做 LSD，大数组只需要两次访问主存，结束时元素都在原区间
+    // 这一位不与 LSD 的各位对齐：64 位的 key 对齐时最高一位只有 9 个比特，100M 个元素时每组约 1.5 MB，
+    // 连同缓冲区放不进 L2，不对齐时每组约 400 KB。分组前只统计这一位，同时统计所有位比分组本身还慢
+    // key 分布不均匀(例如浮点数的指数)时某一组可能仍然很大，这一组再按之后的比特分组
+    template<class RandomIter, class T, class KeyFn>
+    void radix_msd(RandomIter first, T* buffer, size_t n, KeyFn key, size_t* counts, bool& in_buffer) {
+        typedef typename radix_key_type<KeyFn, T>::type key_type;
+        typedef typename radix_traits<key_type>::unsigned_type unsigned_type;
+        enum : size_t { BITS = 11, BUCKETS = size_t(1) << BITS };
+        unsigned_type diff = in_buffer ? mabustl::radix_varying_bits(buffer, n, key)
+                                       : mabustl::radix_varying_bits(first, n, key);
+        size_t width = 0;
+        for(; diff != 0; diff = static_cast<unsigned_type>(diff >> 1)) ++width;
+        // 不超过两趟时直接做 LSD
+        if(width <= 2 * BITS) {
+            mabustl::radix_lsd<BITS>(first, buffer, n, key, width, counts, in_buffer);
+            return;
+        }
+
+        const size_t shift = width - BITS;
+        size_t bounds[BUCKETS + 1];
+        if(in_buffer) mabustl::radix_digit_histogram<BITS>(buffer, n, key, shift, counts);
+        else mabustl::radix_digit_histogram<BITS>(first, n, key, shift, counts);
+        size_t sum = 0;
+        for(size_t digit = 0; digit != BUCKETS; ++digit) {
+            const size_t count = counts[digit];
+            counts[digit] = sum;
+            bounds[digit] = sum;
+            sum += count;
+        }
+        bounds[BUCKETS] = n;
+        if(in_buffer) mabustl::radix_scatter<BITS>(buffer, first, n, key, shift, counts);
+        else mabustl::radix_scatter<BITS>(first, buffer, n, key, shift, counts);
+        in_buffer = !in_buffer;
+
+        // 各组内 shift 以上的比特都相同，之后的各趟会跳过它们，counts 可以重复使用
+        for(size_t digit = 0; digit != BUCKETS; ++digit) {
+            const size_t start = bounds[digit];
+            const size_t len = bounds[digit + 1] - start;
+            if(len == 0) continue;
+            bool sub_in_buffer = in_buffer;
+            if(len < radix_msd_threshold) {
+                mabustl::radix_sort_range(first + start, buffer + start, len, key, shift, counts, sub_in_buffer);
+            } else {
+                mabustl::radix_msd(first + start, buffer + start, len, key, counts, sub_in_buffer);
+            }
+            if(sub_in_buffer) mabustl::radix_copy_back(first + start, buffer + start, len);
+        }
+        in_buffer = false;
+    }
+
+    // pair 类型的 key：先按次要的 second 排，再按 first 排
+    template<class RandomIter, class T, class KeyFn>
+    void radix_sort_key(RandomIter first, T* buffer, size_t n, KeyFn key, size_t* counts, bool& in_buffer,
+                        std::true_type) {
+        typedef typename radix_key_type<KeyFn, T>::type key_type;
+        typedef typename key_type::first_type first_type;
+        typedef typename key_type::second_type second_type;
+        mabustl::radix_sort_key(first, buffer, n, radix_second_key<KeyFn, T>(key), counts, in_buffer,
+                                is_radix_pair<second_type>());
+        mabustl::radix_sort_key(first, buffer, n, radix_first_key<KeyFn, T>(key), counts, in_buffer,
+                                is_radix_pair<first_type>());
+    }
+
+    template<class RandomIter, class T, class KeyFn>
+    void radix_sort_aux(RandomIter first, T* buffer, size_t n, KeyFn key, size_t* counts) {
+        typedef typename radix_key_type<KeyFn, T>::type key_type;
+        bool in_buffer = false;
+        mabustl::radix_sort_key(first, buffer, n, key, counts, in_buffer, is_radix_pair<key_type>());
+        if(in_buffer) mabustl::radix_copy_back(first, buffer, n);
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * radix_sort
+    * *****************************************************************************************************************
+    */
+    // buffer 至少能容纳 last - first 个元素，不需要构造
+    template<class RandomIter, class KeyFn>
+    void radix_sort(RandomIter first, RandomIter last, KeyFn key,
+                    typename iterator_traits<RandomIter>::value_type* buffer) {
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        static_assert(is_trivially_relocatable<T>::value, "radix_sort moves elements bytewise");
+        const size_t n = static_cast<size_t>(last - first);
+        if(n < radix_sort_threshold) {
+            mabustl::insertion_sort(first, last, radix_compare<KeyFn, T>(key));
+        } else if(n <= radix_wide_digit_threshold) {
+            // 只会用到 8 个比特一位的计数，放在栈上
+            size_t counts[8 * 256];
+            mabustl::radix_sort_aux(first, buffer, n, key, counts);
+        } else {
+            // 在搬移任何元素之前分配，之后不会再抛出异常
+            mabustl::vector<size_t> counts(radix_counts_size);
+            mabustl::radix_sort_aux(first, buffer, n, key, counts.data());
+        }
+    }
+
+    template<class RandomIter, class KeyFn>
+    void radix_sort(RandomIter first, RandomIter last, KeyFn key) {
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        const size_t n = static_cast<size_t>(last - first);
+        if(n < radix_sort_threshold) {
+            mabustl::radix_sort(first, last, key, static_cast<T*>(nullptr));
+            return;
+        }
+        T* buffer = mabustl::allocator<T>::allocate(n);
+        try {
+            mabustl::radix_sort(first, last, key, buffer);
+        } catch(...) {
+            mabustl::allocator<T>::deallocate(buffer, n);
+            throw;
+        }
+        mabustl::allocator<T>::deallocate(buffer, n);
+    }
+
+    template<class RandomIter>
+    void radix_sort(RandomIter first, RandomIter last) {
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        mabustl::radix_sort(first, last, mabustl::identity<T>());
+    }
+}
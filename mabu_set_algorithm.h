@@ -29,7 +29,7 @@ namespace mabustl {
             if(*first1 < *first2) {
                 *result = *first1;
                 ++first1;
-            } else if(*first1 < *first2) {
+            } else if(*first2 < *first1) {
                 *result = *first2;
                 ++first2;
             } else {
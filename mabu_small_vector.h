@@ -0,0 +1,726 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * small_vector: 带内联存储的动态数组
+ * 元素个数不超过 N 时存放在对象内部的缓冲区中，不进行堆分配；超过 N 时才通过 Alloc 分配空间，之后按 2 倍增长
+ * 元素在内联缓冲区和堆空间之间搬移时：可平凡重定位的类型直接 memcpy，其余类型按 move_if_noexcept 移动或复制
+ * 元素直接用 construct / destroy 构造和析构，所以 Alloc 必须使用默认的 construct(mabustl::allocator 系列和
+ * polymorphic_allocator)
+ * 注意：内联存储时移动 small_vector 需要逐个移动元素，迭代器在移动和交换后失效
+ */
+
+#include <initializer_list>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_allocator.h"
+#include "mabu_allocator_traits.h"
+#include "mabu_construct.h"
+#include "mabu_iterator.h"
+#include "mabu_stddef.h"
+#include "mabu_type_traits.h"
+#include "mabu_uninitialized.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    template<class T, size_t N, class Alloc = mabustl::allocator<T> >
+    class small_vector {
+        static_assert(N > 0, "small_vector: N must be greater than 0");
+        static_assert(std::is_same<T, typename Alloc::value_type>::value, "small_vector: Alloc::value_type must be T");
+        static_assert(allocator_uses_default_construct<Alloc>::value,
+                      "small_vector: Alloc must construct elements with placement new");
+
+    public:
+        typedef T value_type;
+        typedef Alloc allocator_type;
+        typedef allocator_traits<Alloc> alloc_traits;
+        typedef typename alloc_traits::size_type size_type;
+        typedef typename alloc_traits::difference_type difference_type;
+
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+
+        typedef T* iterator;
+        typedef const T* const_iterator;
+        typedef mabustl::reverse_iterator<iterator> reverse_iterator;
+        typedef mabustl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    private:
+        // 继承 allocator，不含状态的 allocator 不占用空间
+        struct small_vector_impl : public Alloc {
+            T* begin_;
+            T* end_;
+            T* cap_;
+
+            small_vector_impl(): Alloc(), begin_(nullptr), end_(nullptr), cap_(nullptr) {}
+
+            explicit small_vector_impl(const Alloc& alloc): Alloc(alloc), begin_(nullptr), end_(nullptr), cap_(nullptr) {}
+        };
+
+        // 搬移元素时能否直接 memcpy
+        typedef std::integral_constant<bool, is_trivially_relocatable<T>::value> relocate_by_memcpy;
+
+        // 搬移元素时使用移动构造还是复制构造
+        typedef std::integral_constant<bool, std::is_nothrow_move_constructible<T>::value ||
+                                             !std::is_copy_constructible<T>::value> relocate_by_move;
+
+        small_vector_impl impl_;
+        typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buffer_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        small_vector(): impl_() {
+            reset_inline();
+        }
+
+        explicit small_vector(const Alloc& alloc): impl_(alloc) {
+            reset_inline();
+        }
+
+        // 构造函数抛出异常时不会调用析构函数，元素构造失败时要自己释放堆空间
+        explicit small_vector(size_type n, const Alloc& alloc = Alloc()): impl_(alloc) {
+            reset_inline();
+            try {
+                resize(n);
+            } catch(...) {
+                clear();
+                release_heap();
+                throw;
+            }
+        }
+
+        small_vector(size_type n, const T& value, const Alloc& alloc = Alloc()): impl_(alloc) {
+            reset_inline();
+            try {
+                insert(impl_.end_, n, value);
+            } catch(...) {
+                clear();
+                release_heap();
+                throw;
+            }
+        }
+
+        template<class Iter, typename std::enable_if<mabustl::is_input_iterator<Iter>::value, int>::type = 0>
+        small_vector(Iter first, Iter last, const Alloc& alloc = Alloc()): impl_(alloc) {
+            reset_inline();
+            range_init(first, last);
+        }
+
+        small_vector(std::initializer_list<T> ilist, const Alloc& alloc = Alloc()): impl_(alloc) {
+            reset_inline();
+            range_init(ilist.begin(), ilist.end());
+        }
+
+        small_vector(const small_vector& rhs)
+            : impl_(alloc_traits::select_on_container_copy_construction(rhs.get_alloc())) {
+            reset_inline();
+            range_init(rhs.begin(), rhs.end());
+        }
+
+        small_vector(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+            : impl_(rhs.get_alloc()) {
+            reset_inline();
+            take(rhs);
+        }
+
+        small_vector& operator=(const small_vector& rhs);
+
+        small_vector& operator=(small_vector&& rhs);
+
+        small_vector& operator=(std::initializer_list<T> ilist) {
+            assign(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        ~small_vector() {
+            clear();
+            release_heap();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept { return impl_.begin_; }
+        const_iterator begin() const noexcept { return impl_.begin_; }
+        iterator end() noexcept { return impl_.end_; }
+        const_iterator end() const noexcept { return impl_.end_; }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return impl_.begin_ == impl_.end_; }
+        size_type size() const noexcept { return static_cast<size_type>(impl_.end_ - impl_.begin_); }
+        size_type capacity() const noexcept { return static_cast<size_type>(impl_.cap_ - impl_.begin_); }
+        size_type max_size() const noexcept { return alloc_traits::max_size(get_alloc()); }
+
+        // 元素是否存放在内联缓冲区中
+        bool is_inline() const noexcept { return impl_.begin_ == inline_data(); }
+
+        static constexpr size_type inline_capacity() noexcept { return N; }
+
+        void reserve(size_type n) {
+            if(n <= capacity()) return;
+            THROW_LENGTH_ERROR_IF(n > max_size(), "small_vector<T>::reserve() n too big");
+            grow_to(n);
+        }
+
+        // 元素个数不超过 N 时搬回内联缓冲区，否则释放多余的堆空间
+        void shrink_to_fit();
+
+        // 访问元素相关操作
+        reference operator[](size_type n) {
+            MABUSTL_DEBUG(n < size());
+            return impl_.begin_[n];
+        }
+
+        const_reference operator[](size_type n) const {
+            MABUSTL_DEBUG(n < size());
+            return impl_.begin_[n];
+        }
+
+        reference at(size_type n) {
+            THROW_OUT_OF_LENGTH_IF(!(n < size()), "small_vector<T>::at() subscript out of range");
+            return impl_.begin_[n];
+        }
+
+        const_reference at(size_type n) const {
+            THROW_OUT_OF_LENGTH_IF(!(n < size()), "small_vector<T>::at() subscript out of range");
+            return impl_.begin_[n];
+        }
+
+        reference front() {
+            MABUSTL_DEBUG(!empty());
+            return *impl_.begin_;
+        }
+
+        const_reference front() const {
+            MABUSTL_DEBUG(!empty());
+            return *impl_.begin_;
+        }
+
+        reference back() {
+            MABUSTL_DEBUG(!empty());
+            return *(impl_.end_ - 1);
+        }
+
+        const_reference back() const {
+            MABUSTL_DEBUG(!empty());
+            return *(impl_.end_ - 1);
+        }
+
+        pointer data() noexcept { return impl_.begin_; }
+        const_pointer data() const noexcept { return impl_.begin_; }
+
+        allocator_type get_allocator() const { return get_alloc(); }
+
+    public:
+        // 修改容器相关操作
+
+        void assign(size_type n, const T& value) {
+            clear();
+            insert(impl_.end_, n, value);
+        }
+
+        template<class Iter, typename std::enable_if<mabustl::is_input_iterator<Iter>::value, int>::type = 0>
+        void assign(Iter first, Iter last) {
+            range_assign(first, last, mabustl::iterator_category(first));
+        }
+
+        void assign(std::initializer_list<T> ilist) {
+            range_assign(ilist.begin(), ilist.end(), mabustl::random_access_iterator_tag());
+        }
+
+        template<class... Args>
+        reference emplace_back(Args&&... args) {
+            if(impl_.end_ == impl_.cap_) return realloc_emplace_back(mabustl::forward<Args>(args)...);
+            mabustl::construct(impl_.end_, mabustl::forward<Args>(args)...);
+            ++impl_.end_;
+            return *(impl_.end_ - 1);
+        }
+
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value) {
+            emplace_back(mabustl::move(value));
+        }
+
+        void pop_back() {
+            MABUSTL_DEBUG(!empty());
+            --impl_.end_;
+            mabustl::destroy(impl_.end_);
+        }
+
+        template<class... Args>
+        iterator emplace(const_iterator pos, Args&&... args);
+
+        iterator insert(const_iterator pos, const T& value) {
+            return emplace(pos, value);
+        }
+
+        iterator insert(const_iterator pos, T&& value) {
+            return emplace(pos, mabustl::move(value));
+        }
+
+        iterator insert(const_iterator pos, size_type n, const T& value);
+
+        template<class Iter, typename std::enable_if<mabustl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert(const_iterator pos, Iter first, Iter last) {
+            return range_insert(pos, first, last, mabustl::iterator_category(first));
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+            return range_insert(pos, ilist.begin(), ilist.end(), mabustl::random_access_iterator_tag());
+        }
+
+        iterator erase(const_iterator pos) {
+            MABUSTL_DEBUG(pos >= begin() && pos < end());
+            T* p = impl_.begin_ + (pos - impl_.begin_);
+            mabustl::move(p + 1, impl_.end_, p);
+            pop_back();
+            return p;
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            MABUSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+            T* p = impl_.begin_ + (first - impl_.begin_);
+            if(first == last) return p;
+            T* new_end = mabustl::move(impl_.begin_ + (last - impl_.begin_), impl_.end_, p);
+            mabustl::destroy(new_end, impl_.end_);
+            impl_.end_ = new_end;
+            return p;
+        }
+
+        void clear() noexcept {
+            mabustl::destroy(impl_.begin_, impl_.end_);
+            impl_.end_ = impl_.begin_;
+        }
+
+        void resize(size_type n);
+
+        void resize(size_type n, const T& value) {
+            if(n < size()) erase(impl_.begin_ + n, impl_.end_);
+            else insert(impl_.end_, n - size(), value);
+        }
+
+        void swap(small_vector& rhs);
+
+    private:
+        Alloc& get_alloc() noexcept { return impl_; }
+        const Alloc& get_alloc() const noexcept { return impl_; }
+
+        T* inline_data() noexcept { return reinterpret_cast<T*>(&buffer_); }
+        const T* inline_data() const noexcept { return reinterpret_cast<const T*>(&buffer_); }
+
+        void reset_inline() noexcept {
+            impl_.begin_ = impl_.end_ = inline_data();
+            impl_.cap_ = inline_data() + N;
+        }
+
+        // 释放堆空间(元素已经析构或搬走)，之后回到空的内联状态
+        void release_heap() noexcept {
+            if(!is_inline()) alloc_traits::deallocate(get_alloc(), impl_.begin_, capacity());
+            reset_inline();
+        }
+
+        // 接管 rhs 的元素：rhs 在堆上时直接接管堆空间，否则逐个移动，rhs 变为空的内联状态
+        void take(small_vector& rhs) {
+            if(rhs.is_inline()) {
+                impl_.end_ = mabustl::uninitialized_move_n(rhs.impl_.begin_, rhs.size(), impl_.begin_);
+                rhs.clear();
+            } else {
+                impl_.begin_ = rhs.impl_.begin_;
+                impl_.end_ = rhs.impl_.end_;
+                impl_.cap_ = rhs.impl_.cap_;
+                rhs.reset_inline();
+            }
+        }
+
+        template<class Iter>
+        void range_init(Iter first, Iter last) {
+            try {
+                insert(impl_.end_, first, last);
+            } catch(...) {
+                clear();
+                release_heap();
+                throw;
+            }
+        }
+
+        template<class Iter>
+        void range_assign(Iter first, Iter last, mabustl::input_iterator_tag) {
+            clear();
+            for(; first != last; ++first) emplace_back(*first);
+        }
+
+        template<class Iter>
+        void range_assign(Iter first, Iter last, mabustl::forward_iterator_tag);
+
+        template<class Iter>
+        iterator range_insert(const_iterator pos, Iter first, Iter last, mabustl::input_iterator_tag) {
+            const size_type index = static_cast<size_type>(pos - impl_.begin_);
+            size_type offset = index;
+            for(; first != last; ++first, ++offset) emplace(impl_.begin_ + offset, *first);
+            return impl_.begin_ + index;
+        }
+
+        template<class Iter>
+        iterator range_insert(const_iterator pos, Iter first, Iter last, mabustl::forward_iterator_tag);
+
+        // 需要再放入 add 个元素时的新容量：至少翻倍
+        size_type next_capacity(size_type add) const {
+            const size_type old = capacity();
+            const size_type limit = max_size();
+            THROW_LENGTH_ERROR_IF(limit - size() < add, "small_vector<T> size too big");
+            if(old > limit - old) return limit;
+            const size_type doubled = old + old;
+            const size_type need = size() + add;
+            return doubled > need ? doubled : need;
+        }
+
+        // 保证至少还能放入 add 个元素
+        void grow_for(size_type add) {
+            if(static_cast<size_type>(impl_.cap_ - impl_.end_) < add) grow_to(next_capacity(add));
+        }
+
+        // 把容量扩大到至少 new_cap：堆上时先尝试原地扩大，否则分配新空间并搬移元素
+        void grow_to(size_type new_cap);
+
+        // 把[first, last)搬到 result 并析构原对象，搬移失败时[first, last)保持不变
+        T* relocate(T* first, T* last, T* result, std::true_type) {
+            return mabustl::uninitialized_relocate(first, last, result);
+        }
+
+        T* relocate(T* first, T* last, T* result, std::false_type) {
+            T* end = transfer_n(first, static_cast<size_type>(last - first), result, relocate_by_move());
+            mabustl::destroy(first, last);
+            return end;
+        }
+
+        T* transfer_n(T* first, size_type n, T* result, std::true_type) {
+            return mabustl::uninitialized_move_n(first, n, result);
+        }
+
+        T* transfer_n(T* first, size_type n, T* result, std::false_type) {
+            return mabustl::uninitialized_copy_n(first, n, result);
+        }
+
+        template<class... Args>
+        reference realloc_emplace_back(Args&&... args);
+
+        // 传播前先用当前 allocator 释放堆空间
+        void copy_alloc(const small_vector& rhs, std::true_type) {
+            if(get_alloc() != rhs.get_alloc()) {
+                clear();
+                release_heap();
+            }
+            get_alloc() = rhs.get_alloc();
+        }
+
+        void copy_alloc(const small_vector&, std::false_type) {}
+
+        void move_alloc(small_vector& rhs, std::true_type) {
+            get_alloc() = mabustl::move(rhs.get_alloc());
+        }
+
+        void move_alloc(small_vector&, std::false_type) {}
+
+        void swap_alloc(small_vector& rhs, std::true_type) {
+            mabustl::swap(get_alloc(), rhs.get_alloc());
+        }
+
+        void swap_alloc(small_vector&, std::false_type) {}
+    };
+
+    /*****************************************************************************************************************/
+
+    template<class T, size_t N, class Alloc>
+    small_vector<T, N, Alloc>& small_vector<T, N, Alloc>::operator=(const small_vector& rhs) {
+        if(this == &rhs) return *this;
+        copy_alloc(rhs, typename alloc_traits::propagate_on_container_copy_assignment());
+        range_assign(rhs.begin(), rhs.end(), mabustl::random_access_iterator_tag());
+        return *this;
+    }
+
+    // rhs 在堆上且 allocator 允许时接管堆空间，否则逐个移动元素
+    template<class T, size_t N, class Alloc>
+    small_vector<T, N, Alloc>& small_vector<T, N, Alloc>::operator=(small_vector&& rhs) {
+        if(this == &rhs) return *this;
+        if(!rhs.is_inline() && (alloc_traits::propagate_on_container_move_assignment::value ||
+                                alloc_traits::is_always_equal::value || get_alloc() == rhs.get_alloc())) {
+            clear();
+            release_heap();
+            move_alloc(rhs, typename alloc_traits::propagate_on_container_move_assignment());
+            take(rhs);
+        } else {
+            clear();
+            reserve(rhs.size());
+            impl_.end_ = mabustl::uninitialized_move_n(rhs.impl_.begin_, rhs.size(), impl_.begin_);
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    template<class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::shrink_to_fit() {
+        if(is_inline() || impl_.end_ == impl_.cap_) return;
+        const size_type n = size();
+        T* old_begin = impl_.begin_;
+        const size_type old_cap = capacity();
+        if(n <= N) {
+            relocate(old_begin, impl_.end_, inline_data(), relocate_by_memcpy());
+            impl_.begin_ = inline_data();
+            impl_.end_ = inline_data() + n;
+            impl_.cap_ = inline_data() + N;
+        } else {
+            T* new_begin = alloc_traits::allocate(get_alloc(), n);
+            try {
+                relocate(old_begin, impl_.end_, new_begin, relocate_by_memcpy());
+            } catch(...) {
+                alloc_traits::deallocate(get_alloc(), new_begin, n);
+                throw;
+            }
+            impl_.begin_ = new_begin;
+            impl_.end_ = impl_.cap_ = new_begin + n;
+        }
+        alloc_traits::deallocate(get_alloc(), old_begin, old_cap);
+    }
+
+    template<class T, size_t N, class Alloc>
+    template<class... Args>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::emplace(const_iterator pos, Args&&... args) {
+        MABUSTL_DEBUG(pos >= begin() && pos <= end());
+        const size_type index = static_cast<size_type>(pos - impl_.begin_);
+        if(pos == impl_.end_) {
+            emplace_back(mabustl::forward<Args>(args)...);
+            return impl_.begin_ + index;
+        }
+
+        // 先构造出新元素(args 可能引用容器内的元素)，再扩容并把[pos, end)后移一位
+        T tmp(mabustl::forward<Args>(args)...);
+        grow_for(1);
+        T* p = impl_.begin_ + index;
+        mabustl::construct(impl_.end_, mabustl::move(*(impl_.end_ - 1)));
+        ++impl_.end_;
+        mabustl::move_backward(p, impl_.end_ - 2, impl_.end_ - 1);
+        *p = mabustl::move(tmp);
+        return p;
+    }
+
+    template<class T, size_t N, class Alloc>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::insert(const_iterator pos, size_type n, const T& value) {
+        MABUSTL_DEBUG(pos >= begin() && pos <= end());
+        const size_type index = static_cast<size_type>(pos - impl_.begin_);
+        if(n == 0) return impl_.begin_ + index;
+
+        // value 可能引用容器内的元素，扩容前先复制一份
+        const T copy(value);
+        grow_for(n);
+        T* p = impl_.begin_ + index;
+        T* old_end = impl_.end_;
+        const size_type elems_after = static_cast<size_type>(old_end - p);
+        if(elems_after > n) {
+            impl_.end_ = mabustl::uninitialized_move_n(old_end - n, n, old_end);
+            mabustl::move_backward(p, old_end - n, old_end);
+            mabustl::fill_n(p, n, copy);
+        } else {
+            impl_.end_ = mabustl::uninitialized_fill_n(old_end, n - elems_after, copy);
+            impl_.end_ = mabustl::uninitialized_move_n(p, elems_after, impl_.end_);
+            mabustl::fill(p, old_end, copy);
+        }
+        return p;
+    }
+
+    template<class T, size_t N, class Alloc>
+    template<class Iter>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::range_insert(const_iterator pos, Iter first, Iter last,
+                                            mabustl::forward_iterator_tag) {
+        MABUSTL_DEBUG(pos >= begin() && pos <= end());
+        const size_type index = static_cast<size_type>(pos - impl_.begin_);
+        const size_type n = static_cast<size_type>(mabustl::distance(first, last));
+        if(n == 0) return impl_.begin_ + index;
+
+        grow_for(n);
+        T* p = impl_.begin_ + index;
+        T* old_end = impl_.end_;
+        const size_type elems_after = static_cast<size_type>(old_end - p);
+        if(elems_after > n) {
+            impl_.end_ = mabustl::uninitialized_move_n(old_end - n, n, old_end);
+            mabustl::move_backward(p, old_end - n, old_end);
+            mabustl::copy(first, last, p);
+        } else {
+            Iter mid = first;
+            mabustl::advance(mid, elems_after);
+            impl_.end_ = mabustl::uninitialized_copy(mid, last, old_end);
+            impl_.end_ = mabustl::uninitialized_move_n(p, elems_after, impl_.end_);
+            mabustl::copy(first, mid, p);
+        }
+        return p;
+    }
+
+    template<class T, size_t N, class Alloc>
+    template<class Iter>
+    void small_vector<T, N, Alloc>::range_assign(Iter first, Iter last, mabustl::forward_iterator_tag) {
+        const size_type n = static_cast<size_type>(mabustl::distance(first, last));
+        if(n > capacity()) {
+            clear();
+            grow_to(n);
+            impl_.end_ = mabustl::uninitialized_copy(first, last, impl_.begin_);
+        } else if(n > size()) {
+            Iter mid = first;
+            mabustl::advance(mid, size());
+            mabustl::copy(first, mid, impl_.begin_);
+            impl_.end_ = mabustl::uninitialized_copy(mid, last, impl_.end_);
+        } else {
+            T* new_end = mabustl::copy(first, last, impl_.begin_);
+            mabustl::destroy(new_end, impl_.end_);
+            impl_.end_ = new_end;
+        }
+    }
+
+    template<class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::resize(size_type n) {
+        if(n < size()) {
+            erase(impl_.begin_ + n, impl_.end_);
+            return;
+        }
+        grow_for(n - size());
+        T* curr = impl_.end_;
+        T* last = impl_.begin_ + n;
+        try {
+            for(; curr != last; ++curr) mabustl::construct(curr);
+        } catch(...) {
+            mabustl::destroy(impl_.end_, curr);
+            throw;
+        }
+        impl_.end_ = last;
+    }
+
+    // 都在堆上时交换指针，否则通过临时对象逐个移动元素
+    template<class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::swap(small_vector& rhs) {
+        if(this == &rhs) return;
+        if(!is_inline() && !rhs.is_inline()) {
+            swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+            mabustl::swap(impl_.begin_, rhs.impl_.begin_);
+            mabustl::swap(impl_.end_, rhs.impl_.end_);
+            mabustl::swap(impl_.cap_, rhs.impl_.cap_);
+            return;
+        }
+        small_vector tmp(mabustl::move(rhs));
+        rhs = mabustl::move(*this);
+        *this = mabustl::move(tmp);
+    }
+
+    template<class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::grow_to(size_type new_cap) {
+        if(!is_inline() && alloc_traits::try_expand(get_alloc(), impl_.begin_, capacity(), new_cap)) {
+            impl_.cap_ = impl_.begin_ + new_cap;
+            return;
+        }
+
+        allocation_result<T*, size_type> r = alloc_traits::allocate_at_least(get_alloc(), new_cap);
+        T* new_end;
+        try {
+            new_end = relocate(impl_.begin_, impl_.end_, r.ptr, relocate_by_memcpy());
+        } catch(...) {
+            alloc_traits::deallocate(get_alloc(), r.ptr, r.count);
+            throw;
+        }
+        release_heap();
+        impl_.begin_ = r.ptr;
+        impl_.end_ = new_end;
+        impl_.cap_ = r.ptr + r.count;
+    }
+
+    // 满了之后的 emplace_back：先在新空间中构造新元素，再搬移旧元素，这样 args 引用旧元素时也是安全的
+    template<class T, size_t N, class Alloc>
+    template<class... Args>
+    typename small_vector<T, N, Alloc>::reference
+    small_vector<T, N, Alloc>::realloc_emplace_back(Args&&... args) {
+        const size_type new_cap = next_capacity(1);
+        if(!is_inline() && alloc_traits::try_expand(get_alloc(), impl_.begin_, capacity(), new_cap)) {
+            impl_.cap_ = impl_.begin_ + new_cap;
+            mabustl::construct(impl_.end_, mabustl::forward<Args>(args)...);
+            ++impl_.end_;
+            return *(impl_.end_ - 1);
+        }
+
+        allocation_result<T*, size_type> r = alloc_traits::allocate_at_least(get_alloc(), new_cap);
+        T* hole = r.ptr + size();
+        try {
+            mabustl::construct(hole, mabustl::forward<Args>(args)...);
+        } catch(...) {
+            alloc_traits::deallocate(get_alloc(), r.ptr, r.count);
+            throw;
+        }
+        try {
+            relocate(impl_.begin_, impl_.end_, r.ptr, relocate_by_memcpy());
+        } catch(...) {
+            mabustl::destroy(hole);
+            alloc_traits::deallocate(get_alloc(), r.ptr, r.count);
+            throw;
+        }
+        release_heap();
+        impl_.begin_ = r.ptr;
+        impl_.end_ = hole + 1;
+        impl_.cap_ = r.ptr + r.count;
+        return *hole;
+    }
+
+    /*****************************************************************************************************************/
+    // 重载比较运算符
+
+    template<class T, size_t N, class Alloc>
+    bool operator==(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return lhs.size() == rhs.size() && mabustl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template<class T, size_t N, class Alloc>
+    bool operator!=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T, size_t N, class Alloc>
+    bool operator<(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return mabustl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template<class T, size_t N, class Alloc>
+    bool operator>(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return rhs < lhs;
+    }
+
+    template<class T, size_t N, class Alloc>
+    bool operator<=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class T, size_t N, class Alloc>
+    bool operator>=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return !(lhs < rhs);
+    }
+
+    // 重载 mabustl 的 swap
+    template<class T, size_t N, class Alloc>
+    void swap(small_vector<T, N, Alloc>& lhs, small_vector<T, N, Alloc>& rhs) {
+        lhs.swap(rhs);
+    }
+}
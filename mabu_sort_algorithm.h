@@ -0,0 +1,457 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * 排序算法：sort insertion_sort is_sorted_until is_sorted
+ * sort 是 pattern-defeating quicksort(pdqsort)，在 introsort 的基础上：
+ * (1)区间小于 24 个元素时用插入排序；不是最左边的区间时左侧一定有不大于区间内所有元素的哨兵，省去边界检查
+ * (2)枢轴取三数中值，区间大于 128 个元素时取九数中值(ninther)
+ * (3)左侧哨兵等于枢轴时，把等于枢轴的元素都划分到左边并跳过，大量重复元素时接近线性
+ * (4)划分极不均衡时打乱几个位置上的元素来破坏可能的恶意模式，次数超过 log2(n) 时改用堆排序，最坏 O(n log n)
+ * (5)划分时没有发生交换，说明区间可能已经有序，用有次数上限的插入排序尝试直接完成，有序和逆序的输入都是 O(n)
+ * (6)算术类型配合 less / greater 时用分块的无分支划分(BlockQuicksort)：先把需要交换的元素的偏移量记录到
+ *    两个 64 字节的数组里，比较结果直接累加到下标上而不产生条件跳转，再成批交换，避免随机数据上的分支预测失败
+ * 每个函数都有一个接受比较函数 comp 的重载版本，sort 不是稳定排序
+ */
+
+#include <cstddef>
+#include <type_traits>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_functional.h"
+#include "mabu_heap_algorithm.h"
+#include "mabu_iterator.h"
+#include "mabu_stddef.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    /*
+    * *****************************************************************************************************************
+    * is_sorted_until / is_sorted
+    * 返回最长的有序前缀的末尾
+    * *****************************************************************************************************************
+    */
+    template<class ForwardIter, class Compare>
+    ForwardIter is_sorted_until(ForwardIter first, ForwardIter last, Compare comp) {
+        if(first == last) return last;
+        ForwardIter next = first;
+        while(++next != last) {
+            if(comp(*next, *first)) return next;
+            first = next;
+        }
+        return last;
+    }
+
+    template<class ForwardIter>
+    ForwardIter is_sorted_until(ForwardIter first, ForwardIter last) {
+        typedef typename iterator_traits<ForwardIter>::value_type T;
+        return mabustl::is_sorted_until(first, last, mabustl::less<T>());
+    }
+
+    template<class ForwardIter, class Compare>
+    bool is_sorted(ForwardIter first, ForwardIter last, Compare comp) {
+        return mabustl::is_sorted_until(first, last, comp) == last;
+    }
+
+    template<class ForwardIter>
+    bool is_sorted(ForwardIter first, ForwardIter last) {
+        return mabustl::is_sorted_until(first, last) == last;
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * insertion_sort
+    * 从后往前找插入位置，元素先移出，沿途的元素逐个后移，最后放回
+    * *****************************************************************************************************************
+    */
+    template<class RandomIter, class Compare>
+    void insertion_sort(RandomIter first, RandomIter last, Compare comp) {
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        if(first == last) return;
+        for(RandomIter cur = first + 1; cur != last; ++cur) {
+            RandomIter sift = cur;
+            RandomIter prev = cur - 1;
+            if(comp(*sift, *prev)) {
+                T value = mabustl::move(*sift);
+                do {
+                    *sift = mabustl::move(*prev);
+                    --sift;
+                } while(sift != first && comp(value, *--prev));
+                *sift = mabustl::move(value);
+            }
+        }
+    }
+
+    template<class RandomIter>
+    void insertion_sort(RandomIter first, RandomIter last) {
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        mabustl::insertion_sort(first, last, mabustl::less<T>());
+    }
+
+    // first - 1 处的元素不大于区间内所有元素，作为哨兵，不需要检查是否到达 first
+    template<class RandomIter, class Compare>
+    void unguarded_insertion_sort(RandomIter first, RandomIter last, Compare comp) {
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        if(first == last) return;
+        for(RandomIter cur = first + 1; cur != last; ++cur) {
+            RandomIter sift = cur;
+            RandomIter prev = cur - 1;
+            if(comp(*sift, *prev)) {
+                T value = mabustl::move(*sift);
+                do {
+                    *sift = mabustl::move(*prev);
+                    --sift;
+                } while(comp(value, *--prev));
+                *sift = mabustl::move(value);
+            }
+        }
+    }
+
+    // 累计移动的元素超过 PARTIAL_INSERTION_LIMIT 个时放弃并返回 false，此时区间不一定有序
+    template<class RandomIter, class Compare>
+    bool partial_insertion_sort(RandomIter first, RandomIter last, Compare comp) {
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        enum : size_t { PARTIAL_INSERTION_LIMIT = 8 };
+        if(first == last) return true;
+        size_t moved = 0;
+        for(RandomIter cur = first + 1; cur != last; ++cur) {
+            RandomIter sift = cur;
+            RandomIter prev = cur - 1;
+            if(comp(*sift, *prev)) {
+                T value = mabustl::move(*sift);
+                do {
+                    *sift = mabustl::move(*prev);
+                    --sift;
+                } while(sift != first && comp(value, *--prev));
+                *sift = mabustl::move(value);
+                moved += static_cast<size_t>(cur - sift);
+            }
+            if(moved > PARTIAL_INSERTION_LIMIT) return false;
+        }
+        return true;
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * 划分
+    * 枢轴事先放在 first 处，划分结束后放到最终位置并返回这个位置
+    * *****************************************************************************************************************
+    */
+    // 把 a b c 三个位置上的元素排好序
+    template<class RandomIter, class Compare>
+    void sort3(RandomIter a, RandomIter b, RandomIter c, Compare comp) {
+        if(comp(*b, *a)) mabustl::iter_swap(a, b);
+        if(comp(*c, *b)) mabustl::iter_swap(b, c);
+        if(comp(*b, *a)) mabustl::iter_swap(a, b);
+    }
+
+    // 小于枢轴的放在左边，不小于的放在右边，second 为真表示没有发生交换
+    template<class RandomIter, class Compare>
+    pair<RandomIter, bool> partition_right(RandomIter first, RandomIter last, Compare comp) {
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        T pivot = mabustl::move(*first);
+        RandomIter left = first;
+        RandomIter right = last;
+
+        // 三数中值保证右边有不小于枢轴的元素，向右扫描不会越界
+        while(comp(*++left, pivot));
+        // 左边没有小于枢轴的元素时，向左扫描需要边界检查，否则 left - 1 就是哨兵
+        if(left - 1 == first) {
+            while(left < right && !comp(*--right, pivot));
+        } else {
+            while(!comp(*--right, pivot));
+        }
+
+        const bool already_partitioned = left >= right;
+        while(left < right) {
+            mabustl::iter_swap(left, right);
+            while(comp(*++left, pivot));
+            while(!comp(*--right, pivot));
+        }
+
+        RandomIter pivot_pos = left - 1;
+        *first = mabustl::move(*pivot_pos);
+        *pivot_pos = mabustl::move(pivot);
+        return pair<RandomIter, bool>(pivot_pos, already_partitioned);
+    }
+
+    // 成批交换：use_swaps 为假时沿着 l0 -> r0 -> l1 -> r1 ... 轮转，每对元素只需要两次移动
+    template<class RandomIter>
+    void swap_offsets(RandomIter left_base, RandomIter right_base, const unsigned char* offsets_l,
+                      const unsigned char* offsets_r, size_t num, bool use_swaps) {
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        if(use_swaps) {
+            // 两侧数量相等时必须逐对交换，否则逆序输入会退化为 O(n^2)
+            for(size_t i = 0; i != num; ++i) {
+                mabustl::iter_swap(left_base + offsets_l[i], right_base - offsets_r[i]);
+            }
+        } else if(num > 0) {
+            RandomIter l = left_base + offsets_l[0];
+            RandomIter r = right_base - offsets_r[0];
+            T tmp = mabustl::move(*l);
+            *l = mabustl::move(*r);
+            for(size_t i = 1; i != num; ++i) {
+                l = left_base + offsets_l[i];
+                *r = mabustl::move(*l);
+                r = right_base - offsets_r[i];
+                *l = mabustl::move(*r);
+            }
+            *r = mabustl::move(tmp);
+        }
+    }
+
+    // 与 partition_right 结果相同，中间部分按块无分支地收集需要交换的元素
+    template<class RandomIter, class Compare>
+    pair<RandomIter, bool> partition_right_branchless(RandomIter first, RandomIter last, Compare comp) {
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        enum : size_t { BLOCK_SIZE = 64 };
+        T pivot = mabustl::move(*first);
+        RandomIter left = first;
+        RandomIter right = last;
+
+        while(comp(*++left, pivot));
+        if(left - 1 == first) {
+            while(left < right && !comp(*--right, pivot));
+        } else {
+            while(!comp(*--right, pivot));
+        }
+
+        const bool already_partitioned = left >= right;
+        if(!already_partitioned) {
+            mabustl::iter_swap(left, right);
+            ++left;
+
+            // 偏移量不超过 BLOCK_SIZE，用一个字节保存，每个数组正好一个缓存行
+            alignas(cache_line_size) unsigned char offsets_l[BLOCK_SIZE];
+            alignas(cache_line_size) unsigned char offsets_r[BLOCK_SIZE];
+            RandomIter left_base = left;
+            RandomIter right_base = right;
+            size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+            while(left < right) {
+                // 只填充已经用完的一侧，两侧都空时平分剩余的元素
+                const size_t num_unknown = static_cast<size_t>(right - left);
+                const size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+                const size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+                // 每个位置都写入偏移量，只有需要交换时计数才加一，下一次写入会覆盖不需要的偏移量
+                if(left_split >= BLOCK_SIZE) {
+                    for(size_t i = 0; i != BLOCK_SIZE; i += 4) {
+                        offsets_l[num_l] = static_cast<unsigned char>(i);
+                        num_l += !comp(left[0], pivot);
+                        offsets_l[num_l] = static_cast<unsigned char>(i + 1);
+                        num_l += !comp(left[1], pivot);
+                        offsets_l[num_l] = static_cast<unsigned char>(i + 2);
+                        num_l += !comp(left[2], pivot);
+                        offsets_l[num_l] = static_cast<unsigned char>(i + 3);
+                        num_l += !comp(left[3], pivot);
+                        left += 4;
+                    }
+                } else {
+                    for(size_t i = 0; i != left_split; ++i) {
+                        offsets_l[num_l] = static_cast<unsigned char>(i);
+                        num_l += !comp(*left, pivot);
+                        ++left;
+                    }
+                }
+
+                // 右侧的偏移量从 1 开始，right_base - offset 指向元素
+                if(right_split >= BLOCK_SIZE) {
+                    for(size_t i = 0; i != BLOCK_SIZE; i += 4) {
+                        offsets_r[num_r] = static_cast<unsigned char>(i + 1);
+                        num_r += comp(right[-1], pivot);
+                        offsets_r[num_r] = static_cast<unsigned char>(i + 2);
+                        num_r += comp(right[-2], pivot);
+                        offsets_r[num_r] = static_cast<unsigned char>(i + 3);
+                        num_r += comp(right[-3], pivot);
+                        offsets_r[num_r] = static_cast<unsigned char>(i + 4);
+                        num_r += comp(right[-4], pivot);
+                        right -= 4;
+                    }
+                } else {
+                    for(size_t i = 0; i != right_split; ++i) {
+                        offsets_r[num_r] = static_cast<unsigned char>(i + 1);
+                        num_r += comp(*--right, pivot);
+                    }
+                }
+
+                const size_t num = mabustl::min(num_l, num_r);
+                mabustl::swap_offsets(left_base, right_base, offsets_l + start_l, offsets_r + start_r,
+                                      num, num_l == num_r);
+                num_l -= num;
+                num_r -= num;
+                start_l += num;
+                start_r += num;
+                if(num_l == 0) {
+                    start_l = 0;
+                    left_base = left;
+                }
+                if(num_r == 0) {
+                    start_r = 0;
+                    right_base = right;
+                }
+            }
+
+            // 剩下的一侧逐个交换到中间
+            if(num_l != 0) {
+                const unsigned char* offsets = offsets_l + start_l;
+                while(num_l--) mabustl::iter_swap(left_base + offsets[num_l], --right);
+                left = right;
+            }
+            if(num_r != 0) {
+                const unsigned char* offsets = offsets_r + start_r;
+                while(num_r--) {
+                    mabustl::iter_swap(right_base - offsets[num_r], left);
+                    ++left;
+                }
+            }
+        }
+
+        RandomIter pivot_pos = left - 1;
+        *first = mabustl::move(*pivot_pos);
+        *pivot_pos = mabustl::move(pivot);
+        return pair<RandomIter, bool>(pivot_pos, already_partitioned);
+    }
+
+    // 左侧哨兵等于枢轴时使用：不大于枢轴的放在左边，返回的位置左边都等于枢轴，不需要再排序
+    template<class RandomIter, class Compare>
+    RandomIter partition_left(RandomIter first, RandomIter last, Compare comp) {
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        T pivot = mabustl::move(*first);
+        RandomIter left = first;
+        RandomIter right = last;
+
+        while(comp(pivot, *--right));
+        if(right + 1 == last) {
+            while(left < right && !comp(pivot, *++left));
+        } else {
+            while(!comp(pivot, *++left));
+        }
+
+        while(left < right) {
+            mabustl::iter_swap(left, right);
+            while(comp(pivot, *--right));
+            while(!comp(pivot, *++left));
+        }
+
+        RandomIter pivot_pos = right;
+        *first = mabustl::move(*pivot_pos);
+        *pivot_pos = mabustl::move(pivot);
+        return pivot_pos;
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * sort
+    * *****************************************************************************************************************
+    */
+    template<class RandomIter, class Compare>
+    pair<RandomIter, bool> sort_partition(RandomIter first, RandomIter last, Compare comp, std::true_type) {
+        return mabustl::partition_right_branchless(first, last, comp);
+    }
+
+    template<class RandomIter, class Compare>
+    pair<RandomIter, bool> sort_partition(RandomIter first, RandomIter last, Compare comp, std::false_type) {
+        return mabustl::partition_right(first, last, comp);
+    }
+
+    // 打乱一侧两端的几个元素，破坏导致划分不均衡的模式
+    template<class RandomIter>
+    void sort_break_patterns(RandomIter first, RandomIter last, size_t len) {
+        enum : size_t { NINTHER_THRESHOLD = 128 };
+        const size_t quarter = len / 4;
+        mabustl::iter_swap(first, first + quarter);
+        mabustl::iter_swap(last - 1, last - quarter);
+        if(len > NINTHER_THRESHOLD) {
+            mabustl::iter_swap(first + 1, first + (quarter + 1));
+            mabustl::iter_swap(first + 2, first + (quarter + 2));
+            mabustl::iter_swap(last - 2, last - (quarter + 1));
+            mabustl::iter_swap(last - 3, last - (quarter + 2));
+        }
+    }
+
+    // bad_allowed 为还允许出现的不均衡划分次数，leftmost 表示 first 左边没有哨兵
+    template<class RandomIter, class Compare, class Branchless>
+    void sort_loop(RandomIter first, RandomIter last, Compare comp, int bad_allowed, bool leftmost,
+                   Branchless branchless) {
+        enum : size_t { INSERTION_SORT_THRESHOLD = 24, NINTHER_THRESHOLD = 128 };
+        while(true) {
+            const size_t len = static_cast<size_t>(last - first);
+            if(len < INSERTION_SORT_THRESHOLD) {
+                if(leftmost) mabustl::insertion_sort(first, last, comp);
+                else mabustl::unguarded_insertion_sort(first, last, comp);
+                return;
+            }
+
+            // 选出的枢轴放在 first 处
+            const size_t half = len / 2;
+            if(len > NINTHER_THRESHOLD) {
+                mabustl::sort3(first, first + half, last - 1, comp);
+                mabustl::sort3(first + 1, first + (half - 1), last - 2, comp);
+                mabustl::sort3(first + 2, first + (half + 1), last - 3, comp);
+                mabustl::sort3(first + (half - 1), first + half, first + (half + 1), comp);
+                mabustl::iter_swap(first, first + half);
+            } else {
+                mabustl::sort3(first + half, first, last - 1, comp);
+            }
+
+            // 哨兵不小于枢轴，说明两者相等，等于枢轴的元素已经在最终位置
+            if(!leftmost && !comp(*(first - 1), *first)) {
+                first = mabustl::partition_left(first, last, comp) + 1;
+                continue;
+            }
+
+            const pair<RandomIter, bool> part = mabustl::sort_partition(first, last, comp, branchless);
+            const RandomIter pivot_pos = part.first;
+            const size_t left_len = static_cast<size_t>(pivot_pos - first);
+            const size_t right_len = static_cast<size_t>(last - (pivot_pos + 1));
+
+            if(left_len < len / 8 || right_len < len / 8) {
+                if(--bad_allowed == 0) {
+                    mabustl::make_heap(first, last, comp);
+                    mabustl::sort_heap(first, last, comp);
+                    return;
+                }
+                if(left_len >= INSERTION_SORT_THRESHOLD) mabustl::sort_break_patterns(first, pivot_pos, left_len);
+                if(right_len >= INSERTION_SORT_THRESHOLD) mabustl::sort_break_patterns(pivot_pos + 1, last, right_len);
+            } else if(part.second && mabustl::partial_insertion_sort(first, pivot_pos, comp) &&
+                      mabustl::partial_insertion_sort(pivot_pos + 1, last, comp)) {
+                return;
+            }
+
+            // 递归处理较短的一侧，循环处理较长的一侧，栈深度不超过 log2(n)
+            if(left_len < right_len) {
+                mabustl::sort_loop(first, pivot_pos, comp, bad_allowed, leftmost, branchless);
+                first = pivot_pos + 1;
+                leftmost = false;
+            } else {
+                mabustl::sort_loop(pivot_pos + 1, last, comp, bad_allowed, false, branchless);
+                last = pivot_pos;
+            }
+        }
+    }
+
+    template<class RandomIter, class Compare>
+    void sort(RandomIter first, RandomIter last, Compare comp) {
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        // 比较不会抛出异常、没有副作用时才能使用无分支划分
+        typedef std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                             (std::is_same<Compare, mabustl::less<T> >::value ||
+                                              std::is_same<Compare, mabustl::greater<T> >::value)>
+        branchless;
+        if(last - first < 2) return;
+        int bad_allowed = 0;
+        for(size_t len = static_cast<size_t>(last - first); len != 0; len >>= 1) ++bad_allowed;
+        mabustl::sort_loop(first, last, comp, bad_allowed, true, branchless());
+    }
+
+    template<class RandomIter>
+    void sort(RandomIter first, RandomIter last) {
+        typedef typename iterator_traits<RandomIter>::value_type T;
+        mabustl::sort(first, last, mabustl::less<T>());
+    }
+}
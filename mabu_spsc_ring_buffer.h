@@ -0,0 +1,250 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * spsc_ring_buffer: 有界的单生产者单消费者无锁环形队列
+ * 只允许一个线程 push、一个线程 pop，两端都不加锁：
+ * (1)head(消费者写) 和 tail(生产者写) 都是单调递增的计数，下标为 计数 & mask，容量向上取整到 2 的幂
+ * (2)生产者构造完元素后用 release 发布 tail，消费者用 acquire 读取 tail 后才访问元素；pop 方向对称
+ * (3)head 和 tail 按 cache line 对齐，各占一个 cache line，并且各自缓存一份对方的计数，
+ *    只有按缓存的值判断为满(空)时才重新读取对方的计数，减少两个核之间 cache line 的来回传递
+ * push_n / pop_n 一次搬运一批元素，最多分成首尾两段连续区间，只发布一次计数
+ * size() 和 empty() 在两个线程同时操作时只是一个近似值
+ */
+
+#include <atomic>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_allocator.h"
+#include "mabu_allocator_traits.h"
+#include "mabu_stddef.h"
+#include "mabu_uninitialized.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    template<class T, class Alloc = mabustl::allocator<T> >
+    class spsc_ring_buffer {
+        static_assert(std::is_same<T, typename Alloc::value_type>::value,
+                      "spsc_ring_buffer: Alloc::value_type must be T");
+        // push_n 直接用 uninitialized_move_n 构造元素，不经过 allocator 的 construct
+        static_assert(allocator_uses_default_construct<Alloc>::value,
+                      "spsc_ring_buffer: Alloc must use the default construct and destroy");
+
+    public:
+        typedef T value_type;
+        typedef Alloc allocator_type;
+        typedef allocator_traits<Alloc> alloc_traits;
+        typedef typename alloc_traits::size_type size_type;
+
+        typedef T& reference;
+        typedef const T& const_reference;
+
+    private:
+        // 继承 allocator，不含状态的 allocator 不占用空间，buffer 和 mask 构造后只读
+        struct ring_impl : public Alloc {
+            T* buffer_;
+            size_type mask_;
+
+            explicit ring_impl(const Alloc& alloc): Alloc(alloc), buffer_(nullptr), mask_(0) {}
+        };
+
+        ring_impl impl_;
+
+        // 消费者一侧：head 以及缓存的 tail
+        alignas(cache_line_size) std::atomic<size_type> head_;
+        size_type tail_cache_;
+
+        // 生产者一侧：tail 以及缓存的 head
+        alignas(cache_line_size) std::atomic<size_type> tail_;
+        size_type head_cache_;
+
+    public:
+        // 构造、析构函数，容量向上取整到 2 的幂
+        explicit spsc_ring_buffer(size_type capacity, const Alloc& alloc = Alloc());
+
+        spsc_ring_buffer(const spsc_ring_buffer&) = delete;
+        spsc_ring_buffer& operator=(const spsc_ring_buffer&) = delete;
+
+        ~spsc_ring_buffer();
+
+        // 容量相关操作
+        size_type capacity() const noexcept { return impl_.mask_ + 1; }
+
+        // 先读 head 再读 tail，tail 不会小于 head；两次读取之间消费者和生产者都可能前进，结果不超过容量
+        size_type size() const noexcept {
+            const size_type head = head_.load(std::memory_order_acquire);
+            const size_type n = tail_.load(std::memory_order_acquire) - head;
+            return n < capacity() ? n : capacity();
+        }
+
+        bool empty() const noexcept { return size() == 0; }
+
+        allocator_type get_allocator() const { return impl_; }
+
+        // 生产者操作，队列满时返回 false，不构造元素
+        template<class... Args>
+        bool emplace(Args&&... args);
+
+        bool push(const T& value) {
+            return emplace(value);
+        }
+
+        bool push(T&& value) {
+            return emplace(mabustl::move(value));
+        }
+
+        // 从 first 开始移动至多 n 个元素到队列中，返回实际放入的个数
+        template<class RandomIter>
+        size_type push_n(RandomIter first, size_type n);
+
+        // 消费者操作，队列为空时 front 返回 nullptr、pop 返回 false
+        T* front() noexcept;
+
+        // 丢弃队首元素，必须先确认 front() 不为空
+        void pop() noexcept;
+
+        bool pop(T& value);
+
+        // 把至多 n 个元素移动赋值到 result 开始的位置，返回实际取出的个数
+        template<class OutputIter>
+        size_type pop_n(OutputIter result, size_type n);
+
+    private:
+        Alloc& get_alloc() noexcept { return impl_; }
+
+        // 生产者还能放入的元素个数，按缓存的 head 不够 need 个时才重新读取
+        size_type free_slots(size_type tail, size_type need) noexcept {
+            size_type room = capacity() - (tail - head_cache_);
+            if(room < need) {
+                head_cache_ = head_.load(std::memory_order_acquire);
+                room = capacity() - (tail - head_cache_);
+            }
+            return room;
+        }
+
+        // 消费者可以取出的元素个数，按缓存的 tail 不够 need 个时才重新读取
+        size_type ready_slots(size_type head, size_type need) noexcept {
+            size_type ready = tail_cache_ - head;
+            if(ready < need) {
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+                ready = tail_cache_ - head;
+            }
+            return ready;
+        }
+    };
+
+    /*****************************************************************************************************************/
+
+    template<class T, class Alloc>
+    spsc_ring_buffer<T, Alloc>::spsc_ring_buffer(size_type capacity, const Alloc& alloc)
+        : impl_(alloc), head_(0), tail_cache_(0), tail_(0), head_cache_(0) {
+        THROW_LENGTH_ERROR_IF(capacity > (alloc_traits::max_size(get_alloc()) >> 1) + 1,
+                              "spsc_ring_buffer<T> capacity too big");
+        size_type cap = 1;
+        while(cap < capacity) cap <<= 1;
+        impl_.buffer_ = alloc_traits::allocate(get_alloc(), cap);
+        impl_.mask_ = cap - 1;
+    }
+
+    template<class T, class Alloc>
+    spsc_ring_buffer<T, Alloc>::~spsc_ring_buffer() {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        for(size_type head = head_.load(std::memory_order_relaxed); head != tail; ++head) {
+            mabustl::destroy(impl_.buffer_ + (head & impl_.mask_));
+        }
+        alloc_traits::deallocate(get_alloc(), impl_.buffer_, capacity());
+    }
+
+    template<class T, class Alloc>
+    template<class... Args>
+    bool spsc_ring_buffer<T, Alloc>::emplace(Args&&... args) {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        if(free_slots(tail, 1) == 0) return false;
+        mabustl::construct(impl_.buffer_ + (tail & impl_.mask_), mabustl::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * push_n
+    * 空位在环上最多分成两段：[tail, 数组末尾) 和 [数组开头, ...)，每段用一次 uninitialized_move_n，
+    * 可平凡移动的类型就是两次 memmove；第二段抛出异常时析构第一段已经构造的元素，tail 保持不变
+    * *****************************************************************************************************************
+    */
+    template<class T, class Alloc>
+    template<class RandomIter>
+    typename spsc_ring_buffer<T, Alloc>::size_type
+    spsc_ring_buffer<T, Alloc>::push_n(RandomIter first, size_type n) {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        const size_type room = free_slots(tail, n);
+        if(n > room) n = room;
+        if(n == 0) return 0;
+
+        const size_type index = tail & impl_.mask_;
+        const size_type first_part = capacity() - index < n ? capacity() - index : n;
+        T* const start = impl_.buffer_ + index;
+        mabustl::uninitialized_move_n(first, first_part, start);
+        if(first_part < n) {
+            try {
+                mabustl::uninitialized_move_n(first + first_part, n - first_part, impl_.buffer_);
+            } catch(...) {
+                mabustl::destroy(start, start + first_part);
+                throw;
+            }
+        }
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    template<class T, class Alloc>
+    T* spsc_ring_buffer<T, Alloc>::front() noexcept {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        if(ready_slots(head, 1) == 0) return nullptr;
+        return impl_.buffer_ + (head & impl_.mask_);
+    }
+
+    template<class T, class Alloc>
+    void spsc_ring_buffer<T, Alloc>::pop() noexcept {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        MABUSTL_DEBUG(head != tail_.load(std::memory_order_acquire));
+        mabustl::destroy(impl_.buffer_ + (head & impl_.mask_));
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    template<class T, class Alloc>
+    bool spsc_ring_buffer<T, Alloc>::pop(T& value) {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        if(ready_slots(head, 1) == 0) return false;
+        T* const p = impl_.buffer_ + (head & impl_.mask_);
+        value = mabustl::move(*p);
+        mabustl::destroy(p);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 与 push_n 对称，元素分两段移动赋值到 result 后再析构，最后一次性发布 head
+    template<class T, class Alloc>
+    template<class OutputIter>
+    typename spsc_ring_buffer<T, Alloc>::size_type
+    spsc_ring_buffer<T, Alloc>::pop_n(OutputIter result, size_type n) {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        const size_type ready = ready_slots(head, n);
+        if(n > ready) n = ready;
+        if(n == 0) return 0;
+
+        const size_type index = head & impl_.mask_;
+        const size_type first_part = capacity() - index < n ? capacity() - index : n;
+        T* const start = impl_.buffer_ + index;
+        result = mabustl::move(start, start + first_part, result);
+        if(first_part < n) mabustl::move(impl_.buffer_, impl_.buffer_ + (n - first_part), result);
+        mabustl::destroy(start, start + first_part);
+        mabustl::destroy(impl_.buffer_, impl_.buffer_ + (n - first_part));
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+}
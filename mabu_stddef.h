@@ -7,9 +7,33 @@
 
 #include <stdexcept>
 #include <cassert>
+#include <cstddef>
 
 
 namespace mabustl {
+    // 缓存行大小，用于按缓存行对齐的分配和避免伪共享
+    constexpr size_t cache_line_size = 64;
+
+    // 预取 addr 所在的缓存行，只是提示，不支持的编译器上什么也不做
+    // GCC 会把只含 __builtin_prefetch 的循环当作没有副作用整个删掉，空的 volatile asm 用来保住它
+    inline void prefetch(const void* addr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(addr);
+        __asm__ __volatile__("");
+#else
+        (void)addr;
+#endif
+    }
+
+    // 自旋等待时调用，x86 上是 pause 指令，降低自旋的功耗并让出流水线给同一核上的另一个超线程
+    inline void cpu_relax() noexcept {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_ia32_pause();
+#elif defined(__GNUC__) || defined(__clang__)
+        __asm__ __volatile__("" ::: "memory");
+#endif
+    }
+
 #define MABUSTL_DEBUG(expr) assert(expr)
 
 #define THROW_LENGTH_ERROR_IF(expr,what) \
@@ -5,6 +5,7 @@
  * author: mabu
  */
 
+#include <type_traits>
 
 namespace mabustl {
     template<class T, T v>
@@ -26,4 +27,29 @@ namespace mabustl {
 
     template<class T1, class T2>
     struct is_pair<mabustl::pair<T1, T2> > : mabustl::m_true_type {};
+
+    /*
+     * is_trivially_relocatable
+     * 把对象的字节复制到新地址，并且不再调用原对象的析构函数，结果等价于移动构造到新地址后析构原对象
+     * 满足这一点的类型可以用一次 memcpy 完成搬移，见 mabu_uninitialized.h 中的 uninitialized_relocate
+     * 默认只对平凡移动构造且平凡析构的类型成立
+     * 不含自引用指针的类型(例如只持有堆内存指针的字符串、智能指针)可以用 MABUSTL_TRIVIALLY_RELOCATABLE 声明
+     */
+    template<class T>
+    struct is_trivially_relocatable : m_bool_constant<std::is_trivially_move_constructible<T>::value &&
+                                                      std::is_trivially_destructible<T>::value> {};
+
+    // 映射容器的元素是 pair<const Key, T>，const 不影响能否按字节搬移
+    template<class T>
+    struct is_trivially_relocatable<const T> : is_trivially_relocatable<T> {};
+
+    template<class T1, class T2>
+    struct is_trivially_relocatable<mabustl::pair<T1, T2> >
+        : m_bool_constant<is_trivially_relocatable<T1>::value && is_trivially_relocatable<T2>::value> {};
+}
+
+// 声明 Type 可平凡重定位，需要在全局命名空间中使用，Type 应写出完整的命名空间
+#define MABUSTL_TRIVIALLY_RELOCATABLE(Type) \
+namespace mabustl { \
+    template <> struct is_trivially_relocatable<Type> : m_true_type {}; \
 }
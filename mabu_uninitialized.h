@@ -5,13 +5,27 @@
  * author: mabu
  */
 
+#include <cstring>
+
 #include "mabu_algorithm_base.h"
+#include "mabu_allocator.h"
 #include "mabu_construct.h"
 #include "mabu_iterator.h"
 #include "mabu_type_traits.h"
 #include "mabu_utility.h"
 
 namespace mabustl {
+    // 在未初始化的空间上，只有构造和赋值都平凡的类型才能用 copy / fill / move(最终是 memmove)代替逐个构造
+    template<class T>
+    struct copy_construct_by_assign
+        : std::integral_constant<bool, std::is_trivially_copy_constructible<T>::value &&
+                                       std::is_trivially_copy_assignable<T>::value> {};
+
+    template<class T>
+    struct move_construct_by_assign
+        : std::integral_constant<bool, std::is_trivially_move_constructible<T>::value &&
+                                       std::is_trivially_move_assignable<T>::value> {};
+
     // uninitialized_copy: 将[first,last)上的内容复制到以result开始的空间，返回复制结束的位置
     template<class InputIter, class ForwardIter>
     ForwardIter unchecked_uninitialized_copy(InputIter first, InputIter last, ForwardIter result, std::true_type) {
@@ -25,13 +39,11 @@ namespace mabustl {
             while(first != last) {
                 mabustl::construct(&*curr, *first);
                 ++first;
-                ++result;
-            }
-        } catch(...) {
-            while(result != curr) {
-                mabustl::destroy(&*curr);
                 ++curr;
             }
+        } catch(...) {
+            mabustl::destroy(result, curr);
+            throw;
         }
         return curr;
     }
@@ -39,7 +51,7 @@ namespace mabustl {
     template<class InputIter, class ForwardIter>
     ForwardIter uninitialized_copy(InputIter first, InputIter last, ForwardIter result) {
         return unchecked_uninitialized_copy(first, last, result,
-                                            std::is_trivially_copy_assignable<
+                                            copy_construct_by_assign<
                                                 typename iterator_traits<ForwardIter>::
                                                 value_type>{});
     }
@@ -54,17 +66,15 @@ namespace mabustl {
     ForwardIter unchecked_uninitialized_copy_n(InputIter first, Size n, ForwardIter result, std::false_type) {
         auto curr = result;
         try {
-            while(n >= 0) {
+            while(n > 0) {
                 mabustl::construct(&*curr, *first);
                 ++first;
                 ++curr;
                 --n;
             }
         } catch(...) {
-            while(result != curr) {
-                mabustl::destroy(&*curr);
-                --curr;
-            }
+            mabustl::destroy(result, curr);
+            throw;
         }
 
         return curr;
@@ -73,8 +83,8 @@ namespace mabustl {
     template<class InputIter, class ForwardIter, class Size>
     ForwardIter uninitialized_copy_n(InputIter first, Size size, ForwardIter result) {
         return unchecked_uninitialized_copy_n(first, size, result,
-                                              std::is_trivially_copy_assignable<
-                                                  typename iterator_traits<InputIter>::
+                                              copy_construct_by_assign<
+                                                  typename iterator_traits<ForwardIter>::
                                                   value_type>{});
     }
 
@@ -93,13 +103,19 @@ namespace mabustl {
                 ++curr;
             }
         } catch(...) {
-            while(first != curr) {
-                mabustl::destroy(&*first);
-                ++first;
-            }
+            mabustl::destroy(first, curr);
+            throw;
         }
     }
 
+    template<class ForwardIter, class T>
+    void uninitialized_fill(ForwardIter first, ForwardIter last, const T& value) {
+        mabustl::unchecked_uninitialized_fill(first, last, value,
+                                              copy_construct_by_assign<
+                                                  typename iterator_traits<ForwardIter>::
+                                                  value_type>{});
+    }
+
     // uninitialized_fill_n: 从 first 位置开始，填充 n 个元素值，返回填充结束的位置
     template<class ForwardIter, class Size, class T>
     ForwardIter
@@ -118,10 +134,8 @@ namespace mabustl {
                 ++curr;
             }
         } catch(...) {
-            while(first != curr) {
-                mabustl::destroy(&*first);
-                ++first;
-            }
+            mabustl::destroy(first, curr);
+            throw;
         }
         return curr;
     }
@@ -129,7 +143,7 @@ namespace mabustl {
     template<class ForwardIter, class Size, class T>
     ForwardIter uninitialized_fill_n(ForwardIter first, Size n, const T& value) {
         return mabustl::unchecked_uninitialized_fill_n(first, n, value,
-                                                       std::is_trivially_copy_assignable<
+                                                       copy_construct_by_assign<
                                                            typename iterator_traits<ForwardIter>::
                                                            value_type>{});
     }
@@ -152,6 +166,7 @@ namespace mabustl {
             }
         } catch(...) {
             mabustl::destroy(result, curr);
+            throw;
         }
         return curr;
     }
@@ -159,8 +174,8 @@ namespace mabustl {
     template<class InputIter, class ForwardIter>
     ForwardIter uninitialized_move(InputIter first, InputIter last, ForwardIter result) {
         return mabustl::unchecked_uninitialized_move(first, last, result,
-                                                     std::is_trivially_move_assignable<
-                                                         typename iterator_traits<InputIter>::
+                                                     move_construct_by_assign<
+                                                         typename iterator_traits<ForwardIter>::
                                                          value_type>{});
     }
 
@@ -195,8 +210,228 @@ namespace mabustl {
     template<class InputIter, class Size, class ForwardIter>
     ForwardIter uninitialized_move_n(InputIter first, Size n, ForwardIter result) {
         return mabustl::unchecked_uninitialized_move_n(first, n, result,
-                                                       std::is_trivially_move_assignable<
-                                                           typename iterator_traits<InputIter>::
+                                                       move_construct_by_assign<
+                                                           typename iterator_traits<ForwardIter>::
                                                            value_type>{});
     }
+
+    /*
+    * *****************************************************************************************************************
+    * uninitialized_relocate
+    * 把[first, last)上的对象搬到以 result 开始的未初始化空间，返回搬移结束的位置，搬移后[first, last)变为未初始化
+    * 可平凡重定位的类型在指针区间上直接 memcpy，两段空间不能重叠
+    * 其余类型：移动构造不抛异常时逐个移动构造并析构原对象；否则按 move_if_noexcept 的规则，
+    * 能复制时先全部复制构造，成功后再析构原对象，抛出异常时[first, last)保持不变(强异常保证)；
+    * 不能复制时只能全部移动构造，抛出异常时[first, last)中的对象仍然有效但值不确定(基本异常保证)
+    * *****************************************************************************************************************
+    */
+    template<class InputIter, class ForwardIter>
+    ForwardIter relocate_cat(InputIter first, InputIter last, ForwardIter result, std::true_type) {
+        for(; first != last; ++first, ++result) {
+            mabustl::construct(&*result, mabustl::move(*first));
+            mabustl::destroy(&*first);
+        }
+        return result;
+    }
+
+    // 移动构造可能抛出异常并且可以复制
+    template<class InputIter, class ForwardIter>
+    ForwardIter relocate_may_throw(InputIter first, InputIter last, ForwardIter result, std::true_type) {
+        ForwardIter end = mabustl::uninitialized_copy(first, last, result);
+        mabustl::destroy(first, last);
+        return end;
+    }
+
+    template<class InputIter, class ForwardIter>
+    ForwardIter relocate_may_throw(InputIter first, InputIter last, ForwardIter result, std::false_type) {
+        ForwardIter end = mabustl::uninitialized_move(first, last, result);
+        mabustl::destroy(first, last);
+        return end;
+    }
+
+    template<class InputIter, class ForwardIter>
+    ForwardIter relocate_cat(InputIter first, InputIter last, ForwardIter result, std::false_type) {
+        return mabustl::relocate_may_throw(first, last, result,
+                                           std::is_copy_constructible<
+                                               typename iterator_traits<InputIter>::value_type>{});
+    }
+
+    template<class InputIter, class ForwardIter>
+    ForwardIter unchecked_uninitialized_relocate(InputIter first, InputIter last, ForwardIter result) {
+        return mabustl::relocate_cat(first, last, result,
+                                     std::is_nothrow_move_constructible<
+                                         typename iterator_traits<InputIter>::value_type>{});
+    }
+
+    // 可平凡重定位类型的特化版本
+    template<class T>
+    typename std::enable_if<is_trivially_relocatable<T>::value, T*>::type
+    unchecked_uninitialized_relocate(T* first, T* last, T* result) {
+        const auto n = static_cast<size_t>(last - first);
+        if(n != 0) std::memcpy(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+        return result + n;
+    }
+
+    template<class InputIter, class ForwardIter>
+    ForwardIter uninitialized_relocate(InputIter first, InputIter last, ForwardIter result) {
+        return mabustl::unchecked_uninitialized_relocate(first, last, result);
+    }
+
+    // uninitialized_relocate_n: 把[first, first + n)上的对象搬到以 result 开始的未初始化空间，返回搬移结束的位置
+    template<class InputIter, class Size, class ForwardIter>
+    ForwardIter uninitialized_relocate_n(InputIter first, Size n, ForwardIter result) {
+        InputIter last = first;
+        mabustl::advance(last, n);
+        return mabustl::unchecked_uninitialized_relocate(first, last, result);
+    }
+
+    /*
+    * *****************************************************************************************************************
+    * 通过 allocator 构造和析构的版本: uninitialized_copy_a uninitialized_move_a uninitialized_fill_n_a destroy_a
+    * 供持有(可能有状态的) allocator 的容器使用，所有构造和析构都经过 allocator_traits
+    * Alloc 的 construct / destroy 就是默认实现时，直接转到上面的版本，保留对平凡类型的快速路径
+    * *****************************************************************************************************************
+    */
+
+    // destroy_a: 析构[first, last)上的对象
+    template<class ForwardIter, class Alloc>
+    void destroy_a_dispatch(ForwardIter first, ForwardIter last, Alloc&, std::true_type) {
+        mabustl::destroy(first, last);
+    }
+
+    template<class ForwardIter, class Alloc>
+    void destroy_a_dispatch(ForwardIter first, ForwardIter last, Alloc& alloc, std::false_type) {
+        for(; first != last; ++first) {
+            allocator_traits<Alloc>::destroy(alloc, &*first);
+        }
+    }
+
+    template<class ForwardIter, class Alloc>
+    void destroy_a(ForwardIter first, ForwardIter last, Alloc& alloc) {
+        mabustl::destroy_a_dispatch(first, last, alloc, allocator_uses_default_construct<Alloc>{});
+    }
+
+    // uninitialized_copy_a
+    template<class InputIter, class ForwardIter, class Alloc>
+    ForwardIter uninitialized_copy_a_dispatch(InputIter first, InputIter last, ForwardIter result,
+                                              Alloc&, std::true_type) {
+        return mabustl::uninitialized_copy(first, last, result);
+    }
+
+    template<class InputIter, class ForwardIter, class Alloc>
+    ForwardIter uninitialized_copy_a_dispatch(InputIter first, InputIter last, ForwardIter result,
+                                              Alloc& alloc, std::false_type) {
+        auto curr = result;
+        try {
+            for(; first != last; ++first, ++curr) {
+                allocator_traits<Alloc>::construct(alloc, &*curr, *first);
+            }
+        } catch(...) {
+            mabustl::destroy_a(result, curr, alloc);
+            throw;
+        }
+        return curr;
+    }
+
+    template<class InputIter, class ForwardIter, class Alloc>
+    ForwardIter uninitialized_copy_a(InputIter first, InputIter last, ForwardIter result, Alloc& alloc) {
+        return mabustl::uninitialized_copy_a_dispatch(first, last, result, alloc,
+                                                      allocator_uses_default_construct<Alloc>{});
+    }
+
+    // uninitialized_move_a
+    template<class InputIter, class ForwardIter, class Alloc>
+    ForwardIter uninitialized_move_a_dispatch(InputIter first, InputIter last, ForwardIter result,
+                                              Alloc&, std::true_type) {
+        return mabustl::uninitialized_move(first, last, result);
+    }
+
+    template<class InputIter, class ForwardIter, class Alloc>
+    ForwardIter uninitialized_move_a_dispatch(InputIter first, InputIter last, ForwardIter result,
+                                              Alloc& alloc, std::false_type) {
+        auto curr = result;
+        try {
+            for(; first != last; ++first, ++curr) {
+                allocator_traits<Alloc>::construct(alloc, &*curr, mabustl::move(*first));
+            }
+        } catch(...) {
+            mabustl::destroy_a(result, curr, alloc);
+            throw;
+        }
+        return curr;
+    }
+
+    template<class InputIter, class ForwardIter, class Alloc>
+    ForwardIter uninitialized_move_a(InputIter first, InputIter last, ForwardIter result, Alloc& alloc) {
+        return mabustl::uninitialized_move_a_dispatch(first, last, result, alloc,
+                                                      allocator_uses_default_construct<Alloc>{});
+    }
+
+    // uninitialized_fill_n_a
+    template<class ForwardIter, class Size, class T, class Alloc>
+    ForwardIter uninitialized_fill_n_a_dispatch(ForwardIter first, Size n, const T& value,
+                                                Alloc&, std::true_type) {
+        return mabustl::uninitialized_fill_n(first, n, value);
+    }
+
+    template<class ForwardIter, class Size, class T, class Alloc>
+    ForwardIter uninitialized_fill_n_a_dispatch(ForwardIter first, Size n, const T& value,
+                                                Alloc& alloc, std::false_type) {
+        auto curr = first;
+        try {
+            for(; n > 0; --n, ++curr) {
+                allocator_traits<Alloc>::construct(alloc, &*curr, value);
+            }
+        } catch(...) {
+            mabustl::destroy_a(first, curr, alloc);
+            throw;
+        }
+        return curr;
+    }
+
+    template<class ForwardIter, class Size, class T, class Alloc>
+    ForwardIter uninitialized_fill_n_a(ForwardIter first, Size n, const T& value, Alloc& alloc) {
+        return mabustl::uninitialized_fill_n_a_dispatch(first, n, value, alloc,
+                                                        allocator_uses_default_construct<Alloc>{});
+    }
+
+    // uninitialized_relocate_a
+    template<class InputIter, class ForwardIter, class Alloc>
+    ForwardIter uninitialized_relocate_a_dispatch(InputIter first, InputIter last, ForwardIter result,
+                                                  Alloc&, std::true_type) {
+        return mabustl::uninitialized_relocate(first, last, result);
+    }
+
+    // 与 uninitialized_relocate 相同，移动构造可能抛出异常并且可以复制时先全部复制，保持强异常保证
+    template<class InputIter, class ForwardIter, class Alloc>
+    ForwardIter relocate_a_may_throw(InputIter first, InputIter last, ForwardIter result, Alloc& alloc,
+                                     std::true_type) {
+        ForwardIter end = mabustl::uninitialized_copy_a(first, last, result, alloc);
+        mabustl::destroy_a(first, last, alloc);
+        return end;
+    }
+
+    template<class InputIter, class ForwardIter, class Alloc>
+    ForwardIter relocate_a_may_throw(InputIter first, InputIter last, ForwardIter result, Alloc& alloc,
+                                     std::false_type) {
+        ForwardIter end = mabustl::uninitialized_move_a(first, last, result, alloc);
+        mabustl::destroy_a(first, last, alloc);
+        return end;
+    }
+
+    template<class InputIter, class ForwardIter, class Alloc>
+    ForwardIter uninitialized_relocate_a_dispatch(InputIter first, InputIter last, ForwardIter result,
+                                                  Alloc& alloc, std::false_type) {
+        typedef typename iterator_traits<InputIter>::value_type value_type;
+        return mabustl::relocate_a_may_throw(first, last, result, alloc,
+                                             std::integral_constant<bool,
+                                                 !std::is_nothrow_move_constructible<value_type>::value &&
+                                                 std::is_copy_constructible<value_type>::value>{});
+    }
+
+    template<class InputIter, class ForwardIter, class Alloc>
+    ForwardIter uninitialized_relocate_a(InputIter first, InputIter last, ForwardIter result, Alloc& alloc) {
+        return mabustl::uninitialized_relocate_a_dispatch(first, last, result, alloc,
+                                                          allocator_uses_default_construct<Alloc>{});
+    }
 }
@@ -167,7 +167,7 @@ namespace mabustl {
 
         // 重载=
         pair& operator=(const pair& rhs) {
-            if(this != rhs) {
+            if(this != &rhs) {
                 this->first = rhs.first;
                 this->second = rhs.second;
             }
@@ -175,8 +175,9 @@ namespace mabustl {
             return *this;
         }
 
-        pair& operator=(const pair&& rhs) {
-            if(this != rhs) {
+        pair& operator=(pair&& rhs) noexcept(std::is_nothrow_move_assignable<T1>::value &&
+                                             std::is_nothrow_move_assignable<T2>::value) {
+            if(this != &rhs) {
                 this->first = mabustl::move(rhs.first);
                 this->second = mabustl::move(rhs.second);
             }
@@ -186,20 +187,16 @@ namespace mabustl {
 
         template<class Other1, class Other2>
         pair& operator=(const pair<Other1, Other2>& rhs) {
-            if(this != rhs) {
-                this->first = rhs.first;
-                this->second = rhs.second;
-            }
+            this->first = rhs.first;
+            this->second = rhs.second;
 
             return *this;
         }
 
         template<class Other1, class Other2>
-        pair& operator=(const pair<Other1, Other2>&& rhs) {
-            if(this != rhs) {
-                this->first = mabustl::forward<Other1>(rhs.first);
-                this->second = mabustl::forward<Other1>(rhs.second);
-            }
+        pair& operator=(pair<Other1, Other2>&& rhs) {
+            this->first = mabustl::forward<Other1>(rhs.first);
+            this->second = mabustl::forward<Other2>(rhs.second);
 
             return *this;
         }
@@ -207,7 +204,7 @@ namespace mabustl {
         ~pair() = default;
 
         void swap(pair& other) {
-            if(this != other) {
+            if(this != &other) {
                 mabustl::swap(this->first, other.first);
                 mabustl::swap(this->second, other.second);
             }
@@ -256,4 +253,23 @@ namespace mabustl {
     pair<T1, T2> make_pair(T1&& first, T2&& second) {
         return pair<T1, T2>(mabustl::forward<T1>(first), mabustl::forward<T2>(second));
     }
+
+    /******************************************************************************************************************/
+    // map_slot
+    // 映射容器的元素类型是 pair<const Key, T>，在节点或数组之间搬移元素时需要从 key 移动构造。
+    // pair<const Key, T> 与 pair<Key, T> 的布局相同，和 abseil 的 map_slot_type 一样通过 union
+    // 把即将析构的原元素当作 pair<Key, T> 访问，对外的元素类型仍然是 pair<const Key, T>
+    template<class Key, class T>
+    union map_slot {
+        pair<const Key, T> value;
+        pair<Key, T> mutable_value;
+
+        map_slot() = delete;
+        ~map_slot() = delete;
+    };
+
+    template<class Key, class T>
+    pair<Key, T>& map_slot_mutable(pair<const Key, T>* value) noexcept {
+        return reinterpret_cast<map_slot<Key, T>*>(value)->mutable_value;
+    }
 }
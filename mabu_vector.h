@@ -0,0 +1,879 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * vector: 连续存储的动态数组
+ * 扩容时容量翻倍，先尝试 allocator 的 try_expand 原地扩大，失败时再通过 allocate_at_least 重新分配并使用多余的容量
+ * 重新分配时搬移元素的方式：
+ * (1)可平凡重定位且 allocator 使用默认 construct 的类型直接 memcpy
+ * (2)移动构造不抛异常或不能复制的类型使用移动构造(move_if_noexcept)
+ * (3)其余类型使用复制构造，这样扩容中抛出异常时原来的元素保持不变(强异常安全)
+ */
+
+#include <initializer_list>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_allocator.h"
+#include "mabu_allocator_traits.h"
+#include "mabu_iterator.h"
+#include "mabu_stddef.h"
+#include "mabu_type_traits.h"
+#include "mabu_uninitialized.h"
+#include "mabu_utility.h"
+
+namespace mabustl {
+    template<class T, class Alloc = mabustl::allocator<T> >
+    class vector {
+        static_assert(std::is_same<T, typename Alloc::value_type>::value, "vector: Alloc::value_type must be T");
+
+    public:
+        typedef T value_type;
+        typedef Alloc allocator_type;
+        typedef allocator_traits<Alloc> alloc_traits;
+        typedef typename alloc_traits::size_type size_type;
+        typedef typename alloc_traits::difference_type difference_type;
+
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+
+        typedef T* iterator;
+        typedef const T* const_iterator;
+        typedef mabustl::reverse_iterator<iterator> reverse_iterator;
+        typedef mabustl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    private:
+        // 继承 allocator，不含状态的 allocator 不占用空间
+        struct vector_impl : public Alloc {
+            T* begin_;
+            T* end_;
+            T* cap_;
+
+            vector_impl(): Alloc(), begin_(nullptr), end_(nullptr), cap_(nullptr) {}
+
+            explicit vector_impl(const Alloc& alloc): Alloc(alloc), begin_(nullptr), end_(nullptr), cap_(nullptr) {}
+
+            explicit vector_impl(Alloc&& alloc)
+                : Alloc(mabustl::move(alloc)), begin_(nullptr), end_(nullptr), cap_(nullptr) {}
+        };
+
+        // 重新分配时能否直接 memcpy
+        typedef std::integral_constant<bool, is_trivially_relocatable<T>::value &&
+                                             allocator_uses_default_construct<Alloc>::value> relocate_by_memcpy;
+
+        // 重新分配时使用移动构造还是复制构造
+        typedef std::integral_constant<bool, std::is_nothrow_move_constructible<T>::value ||
+                                             !std::is_copy_constructible<T>::value> relocate_by_move;
+
+        vector_impl impl_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        vector() noexcept(std::is_nothrow_default_constructible<Alloc>::value): impl_() {}
+
+        explicit vector(const Alloc& alloc) noexcept: impl_(alloc) {}
+
+        // 构造函数抛出异常时不会调用析构函数，元素构造失败时要自己释放已分配的空间
+        explicit vector(size_type n, const Alloc& alloc = Alloc()): impl_(alloc) {
+            try {
+                default_append(n);
+            } catch(...) {
+                destroy_and_deallocate();
+                throw;
+            }
+        }
+
+        vector(size_type n, const T& value, const Alloc& alloc = Alloc()): impl_(alloc) {
+            init_allocate(n);
+            try {
+                impl_.end_ = mabustl::uninitialized_fill_n_a(impl_.begin_, n, value, get_alloc());
+            } catch(...) {
+                destroy_and_deallocate();
+                throw;
+            }
+        }
+
+        template<class Iter, typename std::enable_if<mabustl::is_input_iterator<Iter>::value, int>::type = 0>
+        vector(Iter first, Iter last, const Alloc& alloc = Alloc()): impl_(alloc) {
+            range_init(first, last, mabustl::iterator_category(first));
+        }
+
+        vector(std::initializer_list<T> ilist, const Alloc& alloc = Alloc()): impl_(alloc) {
+            range_init(ilist.begin(), ilist.end(), mabustl::random_access_iterator_tag());
+        }
+
+        vector(const vector& rhs): impl_(alloc_traits::select_on_container_copy_construction(rhs.get_alloc())) {
+            range_init(rhs.begin(), rhs.end(), mabustl::random_access_iterator_tag());
+        }
+
+        vector(const vector& rhs, const Alloc& alloc): impl_(alloc) {
+            range_init(rhs.begin(), rhs.end(), mabustl::random_access_iterator_tag());
+        }
+
+        vector(vector&& rhs) noexcept: impl_(mabustl::move(rhs.get_alloc())) {
+            steal(rhs);
+        }
+
+        // allocator 不相等时不能接管 rhs 的内存，只能逐个移动元素
+        vector(vector&& rhs, const Alloc& alloc): impl_(alloc) {
+            if(get_alloc() == rhs.get_alloc()) {
+                steal(rhs);
+            } else {
+                init_allocate(rhs.size());
+                try {
+                    impl_.end_ = mabustl::uninitialized_move_a(rhs.begin(), rhs.end(), impl_.begin_, get_alloc());
+                } catch(...) {
+                    destroy_and_deallocate();
+                    throw;
+                }
+            }
+        }
+
+        vector& operator=(const vector& rhs);
+
+        vector& operator=(vector&& rhs) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                                 alloc_traits::is_always_equal::value);
+
+        vector& operator=(std::initializer_list<T> ilist) {
+            assign(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        ~vector() {
+            destroy_and_deallocate();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept { return impl_.begin_; }
+        const_iterator begin() const noexcept { return impl_.begin_; }
+        iterator end() noexcept { return impl_.end_; }
+        const_iterator end() const noexcept { return impl_.end_; }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return impl_.begin_ == impl_.end_; }
+        size_type size() const noexcept { return static_cast<size_type>(impl_.end_ - impl_.begin_); }
+        size_type capacity() const noexcept { return static_cast<size_type>(impl_.cap_ - impl_.begin_); }
+        size_type max_size() const noexcept { return alloc_traits::max_size(get_alloc()); }
+
+        void reserve(size_type n);
+
+        void shrink_to_fit();
+
+        // 访问元素相关操作
+        reference operator[](size_type n) {
+            MABUSTL_DEBUG(n < size());
+            return impl_.begin_[n];
+        }
+
+        const_reference operator[](size_type n) const {
+            MABUSTL_DEBUG(n < size());
+            return impl_.begin_[n];
+        }
+
+        reference at(size_type n) {
+            THROW_OUT_OF_LENGTH_IF(!(n < size()), "vector<T>::at() subscript out of range");
+            return impl_.begin_[n];
+        }
+
+        const_reference at(size_type n) const {
+            THROW_OUT_OF_LENGTH_IF(!(n < size()), "vector<T>::at() subscript out of range");
+            return impl_.begin_[n];
+        }
+
+        reference front() {
+            MABUSTL_DEBUG(!empty());
+            return *impl_.begin_;
+        }
+
+        const_reference front() const {
+            MABUSTL_DEBUG(!empty());
+            return *impl_.begin_;
+        }
+
+        reference back() {
+            MABUSTL_DEBUG(!empty());
+            return *(impl_.end_ - 1);
+        }
+
+        const_reference back() const {
+            MABUSTL_DEBUG(!empty());
+            return *(impl_.end_ - 1);
+        }
+
+        pointer data() noexcept { return impl_.begin_; }
+        const_pointer data() const noexcept { return impl_.begin_; }
+
+        allocator_type get_allocator() const { return get_alloc(); }
+
+    public:
+        // 修改容器相关操作
+
+        void assign(size_type n, const T& value);
+
+        template<class Iter, typename std::enable_if<mabustl::is_input_iterator<Iter>::value, int>::type = 0>
+        void assign(Iter first, Iter last) {
+            range_assign(first, last, mabustl::iterator_category(first));
+        }
+
+        void assign(std::initializer_list<T> ilist) {
+            range_assign(ilist.begin(), ilist.end(), mabustl::random_access_iterator_tag());
+        }
+
+        // 直接在尾部构造元素，不产生临时对象
+        template<class... Args>
+        reference emplace_back(Args&&... args);
+
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value) {
+            emplace_back(mabustl::move(value));
+        }
+
+        void pop_back() {
+            MABUSTL_DEBUG(!empty());
+            --impl_.end_;
+            alloc_traits::destroy(get_alloc(), impl_.end_);
+        }
+
+        template<class... Args>
+        iterator emplace(const_iterator pos, Args&&... args);
+
+        iterator insert(const_iterator pos, const T& value) {
+            return emplace(pos, value);
+        }
+
+        iterator insert(const_iterator pos, T&& value) {
+            return emplace(pos, mabustl::move(value));
+        }
+
+        iterator insert(const_iterator pos, size_type n, const T& value);
+
+        template<class Iter, typename std::enable_if<mabustl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert(const_iterator pos, Iter first, Iter last) {
+            return range_insert(pos, first, last, mabustl::iterator_category(first));
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+            return range_insert(pos, ilist.begin(), ilist.end(), mabustl::random_access_iterator_tag());
+        }
+
+        iterator erase(const_iterator pos);
+
+        iterator erase(const_iterator first, const_iterator last);
+
+        void clear() noexcept {
+            mabustl::destroy_a(impl_.begin_, impl_.end_, get_alloc());
+            impl_.end_ = impl_.begin_;
+        }
+
+        void resize(size_type n);
+
+        void resize(size_type n, const T& value);
+
+        void swap(vector& rhs) noexcept;
+
+    private:
+        Alloc& get_alloc() noexcept { return impl_; }
+        const Alloc& get_alloc() const noexcept { return impl_; }
+
+        // 初始化时分配至少 n 个元素的空间
+        void init_allocate(size_type n) {
+            THROW_LENGTH_ERROR_IF(n > max_size(), "vector<T> size too big");
+            if(n == 0) return;
+            allocation_result<T*, size_type> r = alloc_traits::allocate_at_least(get_alloc(), n);
+            impl_.begin_ = impl_.end_ = r.ptr;
+            impl_.cap_ = r.ptr + r.count;
+        }
+
+        template<class Iter>
+        void range_init(Iter first, Iter last, mabustl::input_iterator_tag) {
+            try {
+                for(; first != last; ++first) emplace_back(*first);
+            } catch(...) {
+                destroy_and_deallocate();
+                throw;
+            }
+        }
+
+        template<class Iter>
+        void range_init(Iter first, Iter last, mabustl::forward_iterator_tag) {
+            init_allocate(static_cast<size_type>(mabustl::distance(first, last)));
+            try {
+                impl_.end_ = mabustl::uninitialized_copy_a(first, last, impl_.begin_, get_alloc());
+            } catch(...) {
+                destroy_and_deallocate();
+                throw;
+            }
+        }
+
+        template<class Iter>
+        void range_assign(Iter first, Iter last, mabustl::input_iterator_tag);
+
+        template<class Iter>
+        void range_assign(Iter first, Iter last, mabustl::forward_iterator_tag);
+
+        template<class Iter>
+        iterator range_insert(const_iterator pos, Iter first, Iter last, mabustl::input_iterator_tag);
+
+        template<class Iter>
+        iterator range_insert(const_iterator pos, Iter first, Iter last, mabustl::forward_iterator_tag);
+
+        void steal(vector& rhs) noexcept {
+            impl_.begin_ = rhs.impl_.begin_;
+            impl_.end_ = rhs.impl_.end_;
+            impl_.cap_ = rhs.impl_.cap_;
+            rhs.impl_.begin_ = rhs.impl_.end_ = rhs.impl_.cap_ = nullptr;
+        }
+
+        void destroy_and_deallocate() noexcept {
+            if(impl_.begin_ == nullptr) return;
+            mabustl::destroy_a(impl_.begin_, impl_.end_, get_alloc());
+            alloc_traits::deallocate(get_alloc(), impl_.begin_, capacity());
+            impl_.begin_ = impl_.end_ = impl_.cap_ = nullptr;
+        }
+
+        // 需要再放入 add 个元素时的新容量：至少翻倍
+        size_type next_capacity(size_type add) const {
+            const size_type old = capacity();
+            const size_type limit = max_size();
+            THROW_LENGTH_ERROR_IF(limit - size() < add, "vector<T> size too big");
+            if(old > limit - old) return limit;
+            const size_type doubled = old + old;
+            const size_type need = size() + add;
+            return doubled > need ? doubled : need;
+        }
+
+        // 尝试把容量原地扩大到 new_cap
+        bool expand_in_place(size_type new_cap) {
+            if(impl_.begin_ == nullptr) return false;
+            if(!alloc_traits::try_expand(get_alloc(), impl_.begin_, capacity(), new_cap)) return false;
+            impl_.cap_ = impl_.begin_ + new_cap;
+            return true;
+        }
+
+        // 保证至少还能放入 add 个元素，需要扩容时按 next_capacity 增长
+        void grow_for(size_type add) {
+            if(static_cast<size_type>(impl_.cap_ - impl_.end_) >= add) return;
+            const size_type new_cap = next_capacity(add);
+            if(expand_in_place(new_cap)) return;
+            reallocate(new_cap, impl_.end_, 0);
+        }
+
+        // 分配至少 new_cap 个元素的新空间，把[begin, pos)搬到新空间开头，把[pos, end)搬到其后并空出 gap 个位置
+        // 返回新空间中空出位置的起始地址，空出的位置由调用者负责构造
+        T* reallocate(size_type new_cap, T* pos, size_type gap);
+
+        // 把[first, last)搬到 result，按 move_if_noexcept 选择移动或复制，不析构原对象
+        T* transfer(T* first, T* last, T* result, std::true_type) {
+            return mabustl::uninitialized_move_a(first, last, result, get_alloc());
+        }
+
+        T* transfer(T* first, T* last, T* result, std::false_type) {
+            return mabustl::uninitialized_copy_a(first, last, result, get_alloc());
+        }
+
+        void relocate_around(T* new_begin, T* pos, size_type gap, std::true_type);
+
+        void relocate_around(T* new_begin, T* pos, size_type gap, std::false_type);
+
+        // 在尾部追加 n 个值初始化的元素
+        void default_append(size_type n);
+
+        // 在 pos 处插入 n 个复制自 value 的元素，容量已经足够
+        void fill_insert_in_place(T* pos, size_type n, const T& value);
+
+        // 在 pos 处插入[first, first + n)，容量已经足够
+        template<class Iter>
+        void copy_insert_in_place(T* pos, Iter first, Iter last, size_type n);
+
+        // 传播前先用当前 allocator 释放旧空间
+        void copy_alloc(const vector& rhs, std::true_type) {
+            if(get_alloc() != rhs.get_alloc()) destroy_and_deallocate();
+            get_alloc() = rhs.get_alloc();
+        }
+
+        void copy_alloc(const vector&, std::false_type) {}
+
+        void move_alloc(vector& rhs, std::true_type) {
+            get_alloc() = mabustl::move(rhs.get_alloc());
+        }
+
+        void move_alloc(vector&, std::false_type) {}
+
+        void swap_alloc(vector& rhs, std::true_type) {
+            mabustl::swap(get_alloc(), rhs.get_alloc());
+        }
+
+        void swap_alloc(vector&, std::false_type) {}
+    };
+
+    /*****************************************************************************************************************/
+
+    // 复制赋值：allocator 需要传播且与当前的不相等时，先用当前 allocator 释放旧空间
+    template<class T, class Alloc>
+    vector<T, Alloc>& vector<T, Alloc>::operator=(const vector& rhs) {
+        if(this == &rhs) return *this;
+        copy_alloc(rhs, typename alloc_traits::propagate_on_container_copy_assignment());
+        range_assign(rhs.begin(), rhs.end(), mabustl::random_access_iterator_tag());
+        return *this;
+    }
+
+    // 移动赋值：能接管 rhs 的内存时直接接管，否则逐个移动元素
+    template<class T, class Alloc>
+    vector<T, Alloc>& vector<T, Alloc>::operator=(vector&& rhs)
+    noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+             alloc_traits::is_always_equal::value) {
+        if(this == &rhs) return *this;
+        if(alloc_traits::propagate_on_container_move_assignment::value ||
+           alloc_traits::is_always_equal::value || get_alloc() == rhs.get_alloc()) {
+            destroy_and_deallocate();
+            move_alloc(rhs, typename alloc_traits::propagate_on_container_move_assignment());
+            steal(rhs);
+        } else {
+            clear();
+            reserve(rhs.size());
+            impl_.end_ = mabustl::uninitialized_move_a(rhs.begin(), rhs.end(), impl_.begin_, get_alloc());
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    template<class T, class Alloc>
+    void vector<T, Alloc>::reserve(size_type n) {
+        if(n <= capacity()) return;
+        THROW_LENGTH_ERROR_IF(n > max_size(), "vector<T>::reserve() n too big");
+        if(expand_in_place(n)) return;
+        reallocate(n, impl_.end_, 0);
+    }
+
+    template<class T, class Alloc>
+    void vector<T, Alloc>::shrink_to_fit() {
+        if(impl_.end_ == impl_.cap_) return;
+        if(empty()) {
+            destroy_and_deallocate();
+            return;
+        }
+
+        // 直接用 allocate 而不是 allocate_at_least，避免又拿到多余的容量
+        const size_type n = size();
+        T* new_begin = alloc_traits::allocate(get_alloc(), n);
+        try {
+            relocate_around(new_begin, impl_.end_, 0, relocate_by_memcpy());
+        } catch(...) {
+            alloc_traits::deallocate(get_alloc(), new_begin, n);
+            throw;
+        }
+        alloc_traits::deallocate(get_alloc(), impl_.begin_, capacity());
+        impl_.begin_ = new_begin;
+        impl_.end_ = impl_.cap_ = new_begin + n;
+    }
+
+    template<class T, class Alloc>
+    void vector<T, Alloc>::assign(size_type n, const T& value) {
+        if(n > capacity()) {
+            vector tmp(n, value, get_alloc());
+            swap(tmp);
+        } else if(n > size()) {
+            mabustl::fill(impl_.begin_, impl_.end_, value);
+            impl_.end_ = mabustl::uninitialized_fill_n_a(impl_.end_, n - size(), value, get_alloc());
+        } else {
+            mabustl::fill_n(impl_.begin_, n, value);
+            erase(impl_.begin_ + n, impl_.end_);
+        }
+    }
+
+    template<class T, class Alloc>
+    template<class Iter>
+    void vector<T, Alloc>::range_assign(Iter first, Iter last, mabustl::input_iterator_tag) {
+        T* curr = impl_.begin_;
+        for(; first != last && curr != impl_.end_; ++first, ++curr) *curr = *first;
+        if(first == last) {
+            erase(curr, impl_.end_);
+        } else {
+            for(; first != last; ++first) emplace_back(*first);
+        }
+    }
+
+    template<class T, class Alloc>
+    template<class Iter>
+    void vector<T, Alloc>::range_assign(Iter first, Iter last, mabustl::forward_iterator_tag) {
+        const size_type n = static_cast<size_type>(mabustl::distance(first, last));
+        if(n > capacity()) {
+            // 先构造好新空间再释放旧空间，构造失败时原内容不变
+            allocation_result<T*, size_type> r = alloc_traits::allocate_at_least(get_alloc(), n);
+            T* new_end;
+            try {
+                new_end = mabustl::uninitialized_copy_a(first, last, r.ptr, get_alloc());
+            } catch(...) {
+                alloc_traits::deallocate(get_alloc(), r.ptr, r.count);
+                throw;
+            }
+            destroy_and_deallocate();
+            impl_.begin_ = r.ptr;
+            impl_.end_ = new_end;
+            impl_.cap_ = r.ptr + r.count;
+        } else if(n > size()) {
+            Iter mid = first;
+            mabustl::advance(mid, size());
+            mabustl::copy(first, mid, impl_.begin_);
+            impl_.end_ = mabustl::uninitialized_copy_a(mid, last, impl_.end_, get_alloc());
+        } else {
+            T* new_end = mabustl::copy(first, last, impl_.begin_);
+            mabustl::destroy_a(new_end, impl_.end_, get_alloc());
+            impl_.end_ = new_end;
+        }
+    }
+
+    template<class T, class Alloc>
+    template<class... Args>
+    typename vector<T, Alloc>::reference vector<T, Alloc>::emplace_back(Args&&... args) {
+        if(impl_.end_ != impl_.cap_) {
+            alloc_traits::construct(get_alloc(), impl_.end_, mabustl::forward<Args>(args)...);
+            ++impl_.end_;
+            return *(impl_.end_ - 1);
+        }
+
+        const size_type new_cap = next_capacity(1);
+        if(expand_in_place(new_cap)) {
+            alloc_traits::construct(get_alloc(), impl_.end_, mabustl::forward<Args>(args)...);
+            ++impl_.end_;
+            return *(impl_.end_ - 1);
+        }
+
+        // 先在新空间中构造新元素，再搬移旧元素，这样 args 引用旧元素时也是安全的
+        allocation_result<T*, size_type> r = alloc_traits::allocate_at_least(get_alloc(), new_cap);
+        T* hole = r.ptr + size();
+        try {
+            alloc_traits::construct(get_alloc(), hole, mabustl::forward<Args>(args)...);
+        } catch(...) {
+            alloc_traits::deallocate(get_alloc(), r.ptr, r.count);
+            throw;
+        }
+        try {
+            relocate_around(r.ptr, impl_.end_, 1, relocate_by_memcpy());
+        } catch(...) {
+            alloc_traits::destroy(get_alloc(), hole);
+            alloc_traits::deallocate(get_alloc(), r.ptr, r.count);
+            throw;
+        }
+        if(impl_.begin_ != nullptr) alloc_traits::deallocate(get_alloc(), impl_.begin_, capacity());
+        impl_.begin_ = r.ptr;
+        impl_.end_ = hole + 1;
+        impl_.cap_ = r.ptr + r.count;
+        return *hole;
+    }
+
+    template<class T, class Alloc>
+    template<class... Args>
+    typename vector<T, Alloc>::iterator vector<T, Alloc>::emplace(const_iterator pos, Args&&... args) {
+        MABUSTL_DEBUG(pos >= begin() && pos <= end());
+        const size_type index = static_cast<size_type>(pos - impl_.begin_);
+        if(pos == impl_.end_) {
+            emplace_back(mabustl::forward<Args>(args)...);
+            return impl_.begin_ + index;
+        }
+
+        if(impl_.end_ == impl_.cap_ && !expand_in_place(next_capacity(1))) {
+            allocation_result<T*, size_type> r = alloc_traits::allocate_at_least(get_alloc(), next_capacity(1));
+            T* hole = r.ptr + index;
+            try {
+                alloc_traits::construct(get_alloc(), hole, mabustl::forward<Args>(args)...);
+            } catch(...) {
+                alloc_traits::deallocate(get_alloc(), r.ptr, r.count);
+                throw;
+            }
+            try {
+                relocate_around(r.ptr, impl_.begin_ + index, 1, relocate_by_memcpy());
+            } catch(...) {
+                alloc_traits::destroy(get_alloc(), hole);
+                alloc_traits::deallocate(get_alloc(), r.ptr, r.count);
+                throw;
+            }
+            const size_type n = size();
+            alloc_traits::deallocate(get_alloc(), impl_.begin_, capacity());
+            impl_.begin_ = r.ptr;
+            impl_.end_ = r.ptr + n + 1;
+            impl_.cap_ = r.ptr + r.count;
+            return hole;
+        }
+
+        // 容量足够：先构造出新元素(args 可能引用容器内的元素)，再把[pos, end)后移一位
+        T* p = impl_.begin_ + index;
+        T tmp(mabustl::forward<Args>(args)...);
+        alloc_traits::construct(get_alloc(), impl_.end_, mabustl::move(*(impl_.end_ - 1)));
+        ++impl_.end_;
+        mabustl::move_backward(p, impl_.end_ - 2, impl_.end_ - 1);
+        *p = mabustl::move(tmp);
+        return p;
+    }
+
+    template<class T, class Alloc>
+    typename vector<T, Alloc>::iterator
+    vector<T, Alloc>::insert(const_iterator pos, size_type n, const T& value) {
+        MABUSTL_DEBUG(pos >= begin() && pos <= end());
+        const size_type index = static_cast<size_type>(pos - impl_.begin_);
+        if(n == 0) return impl_.begin_ + index;
+
+        if(static_cast<size_type>(impl_.cap_ - impl_.end_) >= n || expand_in_place(next_capacity(n))) {
+            fill_insert_in_place(impl_.begin_ + index, n, value);
+            return impl_.begin_ + index;
+        }
+
+        const size_type new_cap = next_capacity(n);
+        allocation_result<T*, size_type> r = alloc_traits::allocate_at_least(get_alloc(), new_cap);
+        T* hole = r.ptr + index;
+        try {
+            mabustl::uninitialized_fill_n_a(hole, n, value, get_alloc());
+        } catch(...) {
+            alloc_traits::deallocate(get_alloc(), r.ptr, r.count);
+            throw;
+        }
+        try {
+            relocate_around(r.ptr, impl_.begin_ + index, n, relocate_by_memcpy());
+        } catch(...) {
+            mabustl::destroy_a(hole, hole + n, get_alloc());
+            alloc_traits::deallocate(get_alloc(), r.ptr, r.count);
+            throw;
+        }
+        const size_type old_size = size();
+        if(impl_.begin_ != nullptr) alloc_traits::deallocate(get_alloc(), impl_.begin_, capacity());
+        impl_.begin_ = r.ptr;
+        impl_.end_ = r.ptr + old_size + n;
+        impl_.cap_ = r.ptr + r.count;
+        return hole;
+    }
+
+    template<class T, class Alloc>
+    template<class Iter>
+    typename vector<T, Alloc>::iterator
+    vector<T, Alloc>::range_insert(const_iterator pos, Iter first, Iter last, mabustl::input_iterator_tag) {
+        const size_type index = static_cast<size_type>(pos - impl_.begin_);
+        size_type offset = index;
+        for(; first != last; ++first, ++offset) emplace(impl_.begin_ + offset, *first);
+        return impl_.begin_ + index;
+    }
+
+    template<class T, class Alloc>
+    template<class Iter>
+    typename vector<T, Alloc>::iterator
+    vector<T, Alloc>::range_insert(const_iterator pos, Iter first, Iter last, mabustl::forward_iterator_tag) {
+        MABUSTL_DEBUG(pos >= begin() && pos <= end());
+        const size_type index = static_cast<size_type>(pos - impl_.begin_);
+        const size_type n = static_cast<size_type>(mabustl::distance(first, last));
+        if(n == 0) return impl_.begin_ + index;
+
+        if(static_cast<size_type>(impl_.cap_ - impl_.end_) >= n || expand_in_place(next_capacity(n))) {
+            copy_insert_in_place(impl_.begin_ + index, first, last, n);
+            return impl_.begin_ + index;
+        }
+
+        const size_type new_cap = next_capacity(n);
+        allocation_result<T*, size_type> r = alloc_traits::allocate_at_least(get_alloc(), new_cap);
+        T* hole = r.ptr + index;
+        try {
+            mabustl::uninitialized_copy_a(first, last, hole, get_alloc());
+        } catch(...) {
+            alloc_traits::deallocate(get_alloc(), r.ptr, r.count);
+            throw;
+        }
+        try {
+            relocate_around(r.ptr, impl_.begin_ + index, n, relocate_by_memcpy());
+        } catch(...) {
+            mabustl::destroy_a(hole, hole + n, get_alloc());
+            alloc_traits::deallocate(get_alloc(), r.ptr, r.count);
+            throw;
+        }
+        const size_type old_size = size();
+        if(impl_.begin_ != nullptr) alloc_traits::deallocate(get_alloc(), impl_.begin_, capacity());
+        impl_.begin_ = r.ptr;
+        impl_.end_ = r.ptr + old_size + n;
+        impl_.cap_ = r.ptr + r.count;
+        return hole;
+    }
+
+    template<class T, class Alloc>
+    typename vector<T, Alloc>::iterator vector<T, Alloc>::erase(const_iterator pos) {
+        MABUSTL_DEBUG(pos >= begin() && pos < end());
+        T* p = impl_.begin_ + (pos - impl_.begin_);
+        mabustl::move(p + 1, impl_.end_, p);
+        pop_back();
+        return p;
+    }
+
+    template<class T, class Alloc>
+    typename vector<T, Alloc>::iterator vector<T, Alloc>::erase(const_iterator first, const_iterator last) {
+        MABUSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+        T* p = impl_.begin_ + (first - impl_.begin_);
+        if(first == last) return p;
+        T* new_end = mabustl::move(impl_.begin_ + (last - impl_.begin_), impl_.end_, p);
+        mabustl::destroy_a(new_end, impl_.end_, get_alloc());
+        impl_.end_ = new_end;
+        return p;
+    }
+
+    template<class T, class Alloc>
+    void vector<T, Alloc>::resize(size_type n) {
+        if(n < size()) erase(impl_.begin_ + n, impl_.end_);
+        else default_append(n - size());
+    }
+
+    template<class T, class Alloc>
+    void vector<T, Alloc>::resize(size_type n, const T& value) {
+        if(n < size()) erase(impl_.begin_ + n, impl_.end_);
+        else insert(impl_.end_, n - size(), value);
+    }
+
+    template<class T, class Alloc>
+    void vector<T, Alloc>::swap(vector& rhs) noexcept {
+        if(this == &rhs) return;
+        swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+        mabustl::swap(impl_.begin_, rhs.impl_.begin_);
+        mabustl::swap(impl_.end_, rhs.impl_.end_);
+        mabustl::swap(impl_.cap_, rhs.impl_.cap_);
+    }
+
+    template<class T, class Alloc>
+    T* vector<T, Alloc>::reallocate(size_type new_cap, T* pos, size_type gap) {
+        const size_type index = static_cast<size_type>(pos - impl_.begin_);
+        const size_type old_size = size();
+        allocation_result<T*, size_type> r = alloc_traits::allocate_at_least(get_alloc(), new_cap);
+        try {
+            relocate_around(r.ptr, pos, gap, relocate_by_memcpy());
+        } catch(...) {
+            alloc_traits::deallocate(get_alloc(), r.ptr, r.count);
+            throw;
+        }
+        if(impl_.begin_ != nullptr) alloc_traits::deallocate(get_alloc(), impl_.begin_, capacity());
+        impl_.begin_ = r.ptr;
+        impl_.end_ = r.ptr + old_size;
+        impl_.cap_ = r.ptr + r.count;
+        return r.ptr + index;
+    }
+
+    // 可平凡重定位：两段分别 memcpy，不会抛出异常，旧空间中的对象视为已经搬走
+    template<class T, class Alloc>
+    void vector<T, Alloc>::relocate_around(T* new_begin, T* pos, size_type gap, std::true_type) {
+        T* mid = mabustl::uninitialized_relocate(impl_.begin_, pos, new_begin);
+        mabustl::uninitialized_relocate(pos, impl_.end_, mid + gap);
+    }
+
+    // 其他类型：两段都构造成功后才析构旧对象，失败时销毁已构造的部分，旧空间保持不变
+    template<class T, class Alloc>
+    void vector<T, Alloc>::relocate_around(T* new_begin, T* pos, size_type gap, std::false_type) {
+        T* mid = new_begin;
+        try {
+            mid = transfer(impl_.begin_, pos, new_begin, relocate_by_move());
+            transfer(pos, impl_.end_, mid + gap, relocate_by_move());
+        } catch(...) {
+            mabustl::destroy_a(new_begin, mid, get_alloc());
+            throw;
+        }
+        mabustl::destroy_a(impl_.begin_, impl_.end_, get_alloc());
+    }
+
+    template<class T, class Alloc>
+    void vector<T, Alloc>::default_append(size_type n) {
+        if(n == 0) return;
+        grow_for(n);
+        T* curr = impl_.end_;
+        try {
+            for(; n > 0; --n, ++curr) alloc_traits::construct(get_alloc(), curr);
+        } catch(...) {
+            mabustl::destroy_a(impl_.end_, curr, get_alloc());
+            throw;
+        }
+        impl_.end_ = curr;
+    }
+
+    template<class T, class Alloc>
+    void vector<T, Alloc>::fill_insert_in_place(T* pos, size_type n, const T& value) {
+        // value 可能引用容器内的元素，先复制一份
+        const T copy(value);
+        T* old_end = impl_.end_;
+        const size_type elems_after = static_cast<size_type>(old_end - pos);
+        if(elems_after > n) {
+            impl_.end_ = mabustl::uninitialized_move_a(old_end - n, old_end, old_end, get_alloc());
+            mabustl::move_backward(pos, old_end - n, old_end);
+            mabustl::fill_n(pos, n, copy);
+        } else {
+            impl_.end_ = mabustl::uninitialized_fill_n_a(old_end, n - elems_after, copy, get_alloc());
+            impl_.end_ = mabustl::uninitialized_move_a(pos, old_end, impl_.end_, get_alloc());
+            mabustl::fill(pos, old_end, copy);
+        }
+    }
+
+    template<class T, class Alloc>
+    template<class Iter>
+    void vector<T, Alloc>::copy_insert_in_place(T* pos, Iter first, Iter last, size_type n) {
+        T* old_end = impl_.end_;
+        const size_type elems_after = static_cast<size_type>(old_end - pos);
+        if(elems_after > n) {
+            impl_.end_ = mabustl::uninitialized_move_a(old_end - n, old_end, old_end, get_alloc());
+            mabustl::move_backward(pos, old_end - n, old_end);
+            mabustl::copy(first, last, pos);
+        } else {
+            Iter mid = first;
+            mabustl::advance(mid, elems_after);
+            impl_.end_ = mabustl::uninitialized_copy_a(mid, last, old_end, get_alloc());
+            impl_.end_ = mabustl::uninitialized_move_a(pos, old_end, impl_.end_, get_alloc());
+            mabustl::copy(first, mid, pos);
+        }
+    }
+
+    /*****************************************************************************************************************/
+    // 重载比较运算符
+
+    template<class T, class Alloc>
+    bool operator==(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs) {
+        return lhs.size() == rhs.size() && mabustl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template<class T, class Alloc>
+    bool operator!=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T, class Alloc>
+    bool operator<(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs) {
+        return mabustl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template<class T, class Alloc>
+    bool operator>(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs) {
+        return rhs < lhs;
+    }
+
+    template<class T, class Alloc>
+    bool operator<=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class T, class Alloc>
+    bool operator>=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs) {
+        return !(lhs < rhs);
+    }
+
+    // 重载 mabustl 的 swap
+    template<class T, class Alloc>
+    void swap(vector<T, Alloc>& lhs, vector<T, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * allocator::allocate(n, alignment) / aligned_allocator / 对齐要求超过默认对齐的类型
+ * (1)在 new_alloc、pool_alloc、thread_cache_alloc 上随机大小、随机对齐地分配和回收，检查对齐和块之间没有重叠
+ * (2)alignas(64) 的类型直接用 allocator 分配时按 64 对齐
+ * (3)以 aligned_allocator 作为 std::vector 的 allocator，随机 push_back / pop_back 后与 std::vector 比较，
+ *    每次扩容后数据都按 Align 对齐
+ */
+
+#include <vector>
+
+#include "mabu_allocator.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+using mabustl_test::tagged_block;
+
+namespace {
+    struct alignas(64) padded {
+        int value;
+    };
+
+    template<class Backend>
+    void test_backend() {
+        typedef mabustl::allocator<unsigned char, Backend> alloc_type;
+        std::vector<tagged_block> live;
+        std::vector<size_t> alignments;
+        for(int step = 0; step != 50000; ++step) {
+            if(live.empty() || rand_below(5) < 3) {
+                const size_t n = 1 + rand_below(rand_below(10) == 0 ? 5000 : 300);
+                const size_t alignment = size_t(1) << rand_below(13);  // 1 ~ 4096
+                unsigned char* p = alloc_type::allocate(n, alignment);
+                CHECK(mabustl_test::aligned_to(p, alignment));
+                live.push_back(mabustl_test::make_block(p, n, static_cast<unsigned char>(step)));
+                alignments.push_back(alignment);
+            } else {
+                const size_t i = rand_below(live.size());
+                CHECK(mabustl_test::intact(live[i]));
+                alloc_type::deallocate(live[i].ptr, live[i].n, alignments[i]);
+                live[i] = live.back();
+                live.pop_back();
+                alignments[i] = alignments.back();
+                alignments.pop_back();
+            }
+        }
+        for(size_t i = 0; i != live.size(); ++i) {
+            CHECK(mabustl_test::intact(live[i]));
+            alloc_type::deallocate(live[i].ptr, live[i].n, alignments[i]);
+        }
+    }
+
+    template<class Backend>
+    void test_over_aligned_type() {
+        typedef mabustl::allocator<padded, Backend> alloc_type;
+        std::vector<padded*> blocks;
+        std::vector<size_t> counts;  // 0 表示用 allocate() 分配的单个对象
+        for(int i = 0; i != 1000; ++i) {
+            const size_t n = i % 2 == 0 ? 0 : 1 + rand_below(8);
+            padded* p = n == 0 ? alloc_type::allocate() : alloc_type::allocate(n);
+            CHECK(mabustl_test::aligned_to(p, 64));
+            p->value = i;
+            blocks.push_back(p);
+            counts.push_back(n);
+        }
+        for(size_t i = 0; i != blocks.size(); ++i) {
+            CHECK(blocks[i]->value == static_cast<int>(i));
+            if(counts[i] == 0) alloc_type::deallocate(blocks[i]);
+            else alloc_type::deallocate(blocks[i], counts[i]);
+        }
+    }
+
+    template<size_t Align>
+    void test_std_vector() {
+        std::vector<double> expect;
+        std::vector<double, mabustl::aligned_allocator<double, Align> > actual;
+        for(int step = 0; step != 50000; ++step) {
+            if(expect.empty() || rand_below(3) != 0) {
+                const double value = static_cast<double>(rand_below(1000000));
+                expect.push_back(value);
+                actual.push_back(value);
+            } else {
+                expect.pop_back();
+                actual.pop_back();
+            }
+            if(!actual.empty()) CHECK(mabustl_test::aligned_to(actual.data(), Align));
+        }
+        CHECK(expect == std::vector<double>(actual.begin(), actual.end()));
+
+        // rebind 到对齐要求更高的类型时使用该类型的对齐
+        typedef typename mabustl::aligned_allocator<char, Align>::template rebind<padded>::other rebound;
+        CHECK(rebound::alignment == (Align > 64 ? Align : 64));
+    }
+}
+
+int main() {
+    test_backend<mabustl::new_alloc>();
+    test_backend<mabustl::pool_alloc>();
+    test_backend<mabustl::thread_cache_alloc>();
+    test_over_aligned_type<mabustl::new_alloc>();
+    test_over_aligned_type<mabustl::pool_alloc>();
+    test_std_vector<32>();
+    test_std_vector<mabustl::cache_line_size>();
+    test_std_vector<4096>();
+    return mabustl_test::pass("test_aligned_alloc");
+}
@@ -0,0 +1,217 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * instrumented_allocator / for_each_type_stats / for_each_thread_stats / total_alloc_stats
+ * (1)随机 allocate / allocate_at_least / try_expand / deallocate，同时维护一份参考计数，
+ *    按值类型得到的 live_bytes、peak_bytes、调用次数、累计字节数和直方图与参考计数一致
+ * (2)多个线程交叉分配、在其他线程回收，各线程记录的 live_bytes 之和等于值类型的 live_bytes
+ * (3)以 instrumented_allocator 作为 std::vector 的 allocator，容器析构后 live_bytes 回到 0
+ * (4)mabustl::vector 通过 allocate_at_least / try_expand 得到的容量按实际大小记录，
+ *    live_bytes 始终等于 capacity() 个元素的字节数
+ */
+
+#define MABUSTL_ALLOC_STATS
+
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+#include "mabu_alloc_stats.h"
+#include "mabu_vector.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    // 每个测试使用自己的值类型，统计互不干扰
+    struct random_tag {
+        char data[24];
+    };
+
+    struct thread_tag {
+        char data[8];
+    };
+
+    // 12 字节，pool_alloc 按大小类取整后常常多给出几个元素
+    struct vector_tag {
+        int value;
+        char pad[8];
+    };
+
+    template<class T>
+    mabustl::alloc_stats stats_of() {
+        mabustl::alloc_stats result = mabustl::alloc_stats();
+        mabustl::for_each_type_stats([&result](const mabustl::alloc_stats& s) {
+            if(std::strcmp(s.name, typeid(T).name()) == 0) result = s;
+        });
+        return result;
+    }
+
+    struct live_block {
+        random_tag* ptr;
+        size_t count;  // 回收时传入的个数：allocate_at_least 得到的 count 或 try_expand 之后的 new_n
+    };
+
+    void test_random() {
+        typedef mabustl::instrumented_allocator<random_tag, mabustl::pool_alloc> alloc_type;
+        std::vector<live_block> live;
+        long long live_bytes = 0, peak_bytes = 0;
+        unsigned long long allocate_calls = 0, deallocate_calls = 0, allocated_bytes = 0;
+        unsigned long long histogram[mabustl::ALLOC_STATS_BUCKETS] = {};
+
+        auto record = [&](size_t bytes) {
+            live_bytes += static_cast<long long>(bytes);
+            if(live_bytes > peak_bytes) peak_bytes = live_bytes;
+            ++allocate_calls;
+            allocated_bytes += bytes;
+            size_t bucket = 0;
+            while(bytes >>= 1) ++bucket;
+            ++histogram[bucket];
+        };
+
+        for(int step = 0; step != 50000; ++step) {
+            const size_t op = rand_below(8);
+            if(live.empty() || op < 3) {
+                const size_t n = 1 + rand_below(40);
+                live_block b = {alloc_type::allocate(n), n};
+                record(n * sizeof(random_tag));
+                live.push_back(b);
+            } else if(op < 5) {
+                const size_t n = 1 + rand_below(40);
+                mabustl::allocation_result<random_tag*, size_t> r = alloc_type::allocate_at_least(n);
+                CHECK(r.count >= n);
+                live_block b = {r.ptr, r.count};
+                record(r.count * sizeof(random_tag));
+                live.push_back(b);
+            } else if(op == 5) {
+                live_block& b = live[rand_below(live.size())];
+                const size_t new_n = b.count + rand_below(4);
+                if(alloc_type::try_expand(b.ptr, b.count, new_n)) {
+                    if(new_n > b.count) record((new_n - b.count) * sizeof(random_tag));
+                    b.count = new_n;
+                }
+            } else {
+                const size_t i = rand_below(live.size());
+                alloc_type::deallocate(live[i].ptr, live[i].count);
+                live_bytes -= static_cast<long long>(live[i].count * sizeof(random_tag));
+                ++deallocate_calls;
+                live[i] = live.back();
+                live.pop_back();
+            }
+        }
+        for(size_t i = 0; i != live.size(); ++i) {
+            alloc_type::deallocate(live[i].ptr, live[i].count);
+            live_bytes -= static_cast<long long>(live[i].count * sizeof(random_tag));
+            ++deallocate_calls;
+        }
+
+        const mabustl::alloc_stats s = stats_of<random_tag>();
+        CHECK(s.live_bytes == 0 && live_bytes == 0);
+        CHECK(s.peak_bytes == peak_bytes);
+        CHECK(s.allocate_calls == allocate_calls);
+        CHECK(s.deallocate_calls == deallocate_calls);
+        CHECK(s.allocated_bytes == allocated_bytes);
+        for(size_t i = 0; i != mabustl::ALLOC_STATS_BUCKETS; ++i) CHECK(s.histogram[i] == histogram[i]);
+    }
+
+    void test_threads() {
+        typedef mabustl::instrumented_allocator<thread_tag> alloc_type;
+        std::mutex exchange_mutex;
+        std::vector<thread_tag*> exchange;
+        std::vector<std::thread> threads;
+        for(unsigned t = 0; t != 4; ++t) {
+            threads.push_back(std::thread([&exchange_mutex, &exchange, t] {
+                std::mt19937 rng(t + 1);
+                for(int step = 0; step != 20000; ++step) {
+                    std::lock_guard<std::mutex> lock(exchange_mutex);
+                    if(exchange.empty() || rng() % 2 == 0) {
+                        exchange.push_back(alloc_type::allocate(1));
+                    } else {
+                        alloc_type::deallocate(exchange.back(), 1);
+                        exchange.pop_back();
+                    }
+                }
+            }));
+        }
+        for(size_t t = 0; t != threads.size(); ++t) threads[t].join();
+
+        long long thread_live = 0;
+        mabustl::for_each_thread_stats([&thread_live](const mabustl::alloc_stats& s) { thread_live += s.live_bytes; });
+        const mabustl::alloc_stats s = stats_of<thread_tag>();
+        CHECK(s.live_bytes == static_cast<long long>(exchange.size() * sizeof(thread_tag)));
+        CHECK(s.allocate_calls - s.deallocate_calls == exchange.size());
+
+        // 其他测试在这之前已经全部回收，所有线程的 live_bytes 之和只剩下交换区中的块
+        CHECK(thread_live == s.live_bytes);
+        CHECK(mabustl::total_alloc_stats().live_bytes == s.live_bytes);
+        for(size_t i = 0; i != exchange.size(); ++i) alloc_type::deallocate(exchange[i], 1);
+        CHECK(stats_of<thread_tag>().live_bytes == 0);
+    }
+
+    void test_std_vector() {
+        {
+            std::vector<int> expect;
+            std::vector<int, mabustl::instrumented_allocator<int> > actual;
+            for(int step = 0; step != 100000; ++step) {
+                const int value = static_cast<int>(rand_below(1000));
+                expect.push_back(value);
+                actual.push_back(value);
+                if(rand_below(1000) == 0) {
+                    expect.clear();
+                    actual.clear();
+                    actual.shrink_to_fit();
+                }
+            }
+            CHECK(expect == std::vector<int>(actual.begin(), actual.end()));
+            CHECK(stats_of<int>().live_bytes >= static_cast<long long>(actual.size() * sizeof(int)));
+        }
+        CHECK(stats_of<int>().live_bytes == 0);
+        CHECK(stats_of<int>().allocate_calls == stats_of<int>().deallocate_calls);
+    }
+
+    // 返回 reserve 得到的容量大于请求的次数
+    template<class Alloc>
+    size_t test_mabu_vector() {
+        size_t granted_more = 0;
+        {
+            mabustl::vector<vector_tag, mabustl::instrumented_allocator<vector_tag, Alloc> > v;
+            vector_tag item = vector_tag();
+            for(int step = 0; step != 20000; ++step) {
+                const size_t op = rand_below(100);
+                if(op < 90) {
+                    item.value = step;
+                    v.push_back(item);
+                } else if(op < 94) {
+                    const size_t n = v.capacity() + rand_below(100);
+                    v.reserve(n);
+                    if(v.capacity() > n) ++granted_more;
+                } else if(op < 97) {
+                    v.resize(rand_below(v.size() + 1));
+                } else if(op < 99) {
+                    v.shrink_to_fit();
+                } else {
+                    v.clear();
+                    v.shrink_to_fit();
+                }
+                CHECK(stats_of<vector_tag>().live_bytes == static_cast<long long>(v.capacity() * sizeof(vector_tag)));
+            }
+        }
+        CHECK(stats_of<vector_tag>().live_bytes == 0);
+        return granted_more;
+    }
+}
+
+int main() {
+    CHECK(mabustl::alloc_stats_enabled());
+    test_random();
+    test_std_vector();
+    CHECK(test_mabu_vector<mabustl::pool_alloc>() != 0);
+    test_mabu_vector<mabustl::default_alloc>();
+    test_threads();
+    return mabustl_test::pass("test_alloc_stats");
+}
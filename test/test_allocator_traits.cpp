@@ -0,0 +1,223 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * allocator_traits
+ * (1)只提供最少成员的 allocator、完整的 allocator 和 polymorphic_allocator：
+ *    成员类型、propagate_* / is_always_equal 和 rebind 的结果与 std::allocator_traits 一致
+ * (2)有状态的 allocator 随机 allocate / construct / destroy / deallocate，
+ *    提供了 construct / destroy 的 allocator 由 traits 转交给它，没有提供时使用默认实现，计数与参考值一致
+ * (3)allocate_at_least / try_expand / max_size / select_on_container_copy_construction 的默认实现与转交
+ */
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "mabu_allocator.h"
+#include "mabu_allocator_traits.h"
+#include "mabu_memory.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    // 只有 value_type、allocate、deallocate 和比较
+    template<class T>
+    struct minimal_alloc {
+        typedef T value_type;
+
+        minimal_alloc() {}
+
+        template<class U>
+        minimal_alloc(const minimal_alloc<U>&) {}
+
+        T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T))); }
+        void deallocate(T* ptr, size_t) { ::operator delete(ptr); }
+    };
+
+    template<class T, class U>
+    bool operator==(const minimal_alloc<T>&, const minimal_alloc<U>&) { return true; }
+
+    template<class T, class U>
+    bool operator!=(const minimal_alloc<T>&, const minimal_alloc<U>&) { return false; }
+
+    // 有状态，记录 construct / destroy 的次数，复制时 id 加一
+    struct counters {
+        long long constructs;
+        long long destroys;
+        long long live_objects;
+    };
+
+    template<class T, class Tag = void>
+    struct counting_alloc {
+        typedef T value_type;
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        counters* stats;
+        int id;
+
+        explicit counting_alloc(counters* c, int i = 0): stats(c), id(i) {}
+
+        template<class U>
+        counting_alloc(const counting_alloc<U, Tag>& other): stats(other.stats), id(other.id) {}
+
+        T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T))); }
+        void deallocate(T* ptr, size_t) { ::operator delete(ptr); }
+
+        template<class U, class... Args>
+        void construct(U* ptr, Args&&... args) {
+            ++stats->constructs;
+            ::new(static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+        }
+
+        template<class U>
+        void destroy(U* ptr) {
+            ++stats->destroys;
+            ptr->~U();
+        }
+
+        size_t max_size() const { return 12345; }
+
+        counting_alloc select_on_container_copy_construction() const { return counting_alloc(stats, id + 1); }
+    };
+
+    template<class T, class U, class Tag>
+    bool operator==(const counting_alloc<T, Tag>& lhs, const counting_alloc<U, Tag>& rhs) {
+        return lhs.stats == rhs.stats;
+    }
+
+    template<class Alloc>
+    void same_as_std() {
+        typedef mabustl::allocator_traits<Alloc> mine;
+        typedef std::allocator_traits<Alloc> expect;
+        static_assert(std::is_same<typename mine::value_type, typename expect::value_type>::value, "value_type");
+        static_assert(std::is_same<typename mine::pointer, typename expect::pointer>::value, "pointer");
+        static_assert(std::is_same<typename mine::const_pointer, typename expect::const_pointer>::value,
+                      "const_pointer");
+        static_assert(std::is_same<typename mine::size_type, typename expect::size_type>::value, "size_type");
+        static_assert(std::is_same<typename mine::difference_type, typename expect::difference_type>::value,
+                      "difference_type");
+        static_assert(mine::propagate_on_container_copy_assignment::value ==
+                      expect::propagate_on_container_copy_assignment::value, "propagate_on_container_copy_assignment");
+        static_assert(mine::propagate_on_container_move_assignment::value ==
+                      expect::propagate_on_container_move_assignment::value, "propagate_on_container_move_assignment");
+        static_assert(mine::propagate_on_container_swap::value == expect::propagate_on_container_swap::value,
+                      "propagate_on_container_swap");
+        static_assert(mine::is_always_equal::value == expect::is_always_equal::value, "is_always_equal");
+        static_assert(std::is_same<typename mine::template rebind_alloc<long>,
+                                   typename expect::template rebind_alloc<long> >::value, "rebind_alloc");
+    }
+
+    void test_member_types() {
+        same_as_std<minimal_alloc<int> >();
+        same_as_std<counting_alloc<int> >();
+        same_as_std<mabustl::allocator<int> >();
+        same_as_std<mabustl::pool_allocator<std::string> >();
+        same_as_std<mabustl::polymorphic_allocator<int> >();
+    }
+
+    void test_construct_destroy() {
+        counters c = counters();
+        counting_alloc<std::string> alloc(&c);
+        typedef mabustl::allocator_traits<counting_alloc<std::string> > traits;
+
+        // 每个槽是一块 n 个 string 的空间，记录其中已构造的个数
+        struct slot {
+            std::string* ptr;
+            size_t n;
+            size_t built;
+        };
+        std::vector<slot> slots;
+        long long expect_constructs = 0, expect_destroys = 0;
+        for(int step = 0; step != 20000; ++step) {
+            const size_t op = rand_below(4);
+            if(slots.empty() || op == 0) {
+                const size_t n = 1 + rand_below(8);
+                slot s = {traits::allocate(alloc, n), n, 0};
+                slots.push_back(s);
+            } else if(op == 1) {
+                slot& s = slots[rand_below(slots.size())];
+                if(s.built == s.n) continue;
+                traits::construct(alloc, s.ptr + s.built, 10 + rand_below(30), 'x');
+                CHECK(s.ptr[s.built].size() >= 10);
+                ++s.built;
+                ++expect_constructs;
+            } else if(op == 2) {
+                slot& s = slots[rand_below(slots.size())];
+                if(s.built == 0) continue;
+                traits::destroy(alloc, s.ptr + --s.built);
+                ++expect_destroys;
+            } else {
+                const size_t i = rand_below(slots.size());
+                while(slots[i].built != 0) {
+                    traits::destroy(alloc, slots[i].ptr + --slots[i].built);
+                    ++expect_destroys;
+                }
+                traits::deallocate(alloc, slots[i].ptr, slots[i].n);
+                slots[i] = slots.back();
+                slots.pop_back();
+            }
+        }
+        for(size_t i = 0; i != slots.size(); ++i) {
+            while(slots[i].built != 0) {
+                traits::destroy(alloc, slots[i].ptr + --slots[i].built);
+                ++expect_destroys;
+            }
+            traits::deallocate(alloc, slots[i].ptr, slots[i].n);
+        }
+        CHECK(c.constructs == expect_constructs);
+        CHECK(c.destroys == expect_destroys);
+
+        // 没有 construct / destroy 的 allocator 使用默认实现
+        minimal_alloc<std::string> plain;
+        typedef mabustl::allocator_traits<minimal_alloc<std::string> > plain_traits;
+        std::string* p = plain_traits::allocate(plain, 1);
+        plain_traits::construct(plain, p, "abc");
+        CHECK(*p == "abc");
+        plain_traits::destroy(plain, p);
+        plain_traits::deallocate(plain, p, 1);
+    }
+
+    void test_defaults() {
+        minimal_alloc<int> plain;
+        typedef mabustl::allocator_traits<minimal_alloc<int> > plain_traits;
+        mabustl::allocation_result<int*, size_t> r = plain_traits::allocate_at_least(plain, 7);
+        CHECK(r.count == 7);
+        CHECK(plain_traits::try_expand(plain, r.ptr, 7, 7));
+        CHECK(!plain_traits::try_expand(plain, r.ptr, 7, 8));
+        plain_traits::deallocate(plain, r.ptr, r.count);
+        CHECK(plain_traits::max_size(plain) == static_cast<size_t>(-1) / sizeof(int));
+
+        counters c = counters();
+        counting_alloc<int> counting(&c, 5);
+        typedef mabustl::allocator_traits<counting_alloc<int> > counting_traits;
+        CHECK(counting_traits::max_size(counting) == 12345);
+        CHECK(counting_traits::select_on_container_copy_construction(counting).id == 6);
+        CHECK(mabustl::allocator_traits<minimal_alloc<int> >::select_on_container_copy_construction(plain) == plain);
+
+        // allocator 的 allocate_at_least 由 traits 转交
+        mabustl::pool_allocator<int> pool;
+        typedef mabustl::allocator_traits<mabustl::pool_allocator<int> > pool_traits;
+        mabustl::allocation_result<int*, size_t> pr = pool_traits::allocate_at_least(pool, 3);
+        CHECK(pr.count >= 3);
+        pool_traits::deallocate(pool, pr.ptr, pr.count);
+
+        // polymorphic_allocator 复制容器时换成默认内存资源
+        mabustl::unsynchronized_pool_resource resource;
+        mabustl::polymorphic_allocator<int> poly(&resource);
+        typedef mabustl::allocator_traits<mabustl::polymorphic_allocator<int> > poly_traits;
+        CHECK(poly_traits::select_on_container_copy_construction(poly).resource() == mabustl::get_default_resource());
+    }
+}
+
+int main() {
+    test_member_types();
+    test_construct_destroy();
+    test_defaults();
+    return mabustl_test::pass("test_allocator_traits");
+}
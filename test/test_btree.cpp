@@ -0,0 +1,320 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * btree_set / btree_map
+ * (1)随机的 insert / emplace_hint / erase / find / lower_bound / upper_bound，与 std::set / std::map 逐步比较，
+ *    定期比较正向和反向遍历的全部元素；整数 key 走节点内线性查找，std::less 和 string key 走二分查找
+ * (2)btree_map 的 operator[] / try_emplace / insert_or_assign / at，以及区间 erase
+ * (3)从有序和无序的区间构造，元素数跨过多层节点
+ * (4)用 btree_set 的区间直接调用 set_union / set_intersection / set_difference，与 std 的结果比较
+ * (5)复制、移动、swap 和比较运算符
+ * (6)btree_map 的元素类型是 pair<const Key, T>，节点分裂、合并时仍然移动而不复制 key
+ */
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "mabu_btree_map.h"
+#include "mabu_btree_set.h"
+#include "mabu_set_algorithm.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    template<class Key>
+    Key make_key(size_t i);
+
+    template<>
+    int make_key<int>(size_t i) {
+        return static_cast<int>(i);
+    }
+
+    template<>
+    std::string make_key<std::string>(size_t i) {
+        return "key" + std::to_string(i * 7919 % 100003);
+    }
+
+    template<class Set, class StdSet>
+    bool same_set(const Set& s, const StdSet& expect) {
+        if(s.size() != expect.size() || s.empty() != expect.empty()) return false;
+        typename Set::const_iterator it = s.begin();
+        for(typename StdSet::const_iterator e = expect.begin(); e != expect.end(); ++e, ++it) {
+            if(!(*it == *e)) return false;
+        }
+        if(it != s.end()) return false;
+        typename Set::const_reverse_iterator rit = s.rbegin();
+        for(typename StdSet::const_reverse_iterator e = expect.rbegin(); e != expect.rend(); ++e, ++rit) {
+            if(!(*rit == *e)) return false;
+        }
+        return rit == s.rend();
+    }
+
+    template<class Map, class StdMap>
+    bool same_map(const Map& m, const StdMap& expect) {
+        if(m.size() != expect.size()) return false;
+        typename Map::const_iterator it = m.begin();
+        for(typename StdMap::const_iterator e = expect.begin(); e != expect.end(); ++e, ++it) {
+            if(!(it->first == e->first && it->second == e->second)) return false;
+        }
+        return it == m.end();
+    }
+
+    // 比较两个迭代器指向的位置：都在末尾，或者指向相同的元素
+    template<class Iter, class StdIter>
+    bool same_position(Iter it, Iter end, StdIter e, StdIter std_end) {
+        if((it == end) != (e == std_end)) return false;
+        return it == end || *it == *e;
+    }
+
+    template<class Key, class Compare, class StdCompare>
+    void test_set(size_t key_range, int steps) {
+        typedef mabustl::btree_set<Key, Compare> set_type;
+        typedef std::set<Key, StdCompare> std_set;
+        set_type s;
+        std_set expect;
+        for(int step = 0; step != steps; ++step) {
+            const Key key = make_key<Key>(rand_below(key_range));
+            const size_t op = rand_below(8);
+            if(op < 3) {
+                const bool inserted = s.insert(key).second;
+                CHECK(inserted == expect.insert(key).second);
+            } else if(op == 3) {
+                // 用 lower_bound 作为提示
+                typename set_type::iterator it = s.emplace_hint(s.lower_bound(key), key);
+                CHECK(*it == key);
+                expect.insert(key);
+            } else if(op == 4) {
+                CHECK(s.erase(key) == expect.erase(key));
+            } else if(op == 5) {
+                typename set_type::iterator it = s.find(key);
+                CHECK(same_position(it, s.end(), expect.find(key), expect.end()));
+                if(it != s.end()) {
+                    typename set_type::iterator next = s.erase(it);
+                    typename std_set::iterator std_next = expect.erase(expect.find(key));
+                    CHECK(same_position(next, s.end(), std_next, expect.end()));
+                }
+            } else if(op == 6) {
+                CHECK(same_position(s.lower_bound(key), s.end(), expect.lower_bound(key), expect.end()));
+                CHECK(same_position(s.upper_bound(key), s.end(), expect.upper_bound(key), expect.end()));
+                CHECK(s.count(key) == expect.count(key));
+                CHECK(s.contains(key) == (expect.count(key) != 0));
+            } else {
+                typename set_type::iterator it = s.upper_bound(key);
+                if(it != s.begin()) {
+                    --it;
+                    typename std_set::iterator e = expect.upper_bound(key);
+                    --e;
+                    CHECK(*it == *e);
+                }
+            }
+            CHECK(s.size() == expect.size());
+            if(step % 1000 == 0) CHECK(same_set(s, expect));
+        }
+        CHECK(same_set(s, expect));
+
+        // 区间 erase 之后再清空，两端按比较函数的顺序排列
+        Key low = make_key<Key>(key_range / 4);
+        Key high = make_key<Key>(key_range / 2);
+        if(StdCompare()(high, low)) std::swap(low, high);
+        expect.erase(expect.lower_bound(low), expect.lower_bound(high));
+        s.erase(s.lower_bound(low), s.lower_bound(high));
+        CHECK(same_set(s, expect));
+        s.clear();
+        CHECK(s.empty() && s.begin() == s.end());
+    }
+
+    void test_map(int steps) {
+        typedef mabustl::btree_map<int, std::string> map_type;
+        map_type m;
+        std::map<int, std::string> expect;
+        for(int step = 0; step != steps; ++step) {
+            const int key = static_cast<int>(rand_below(5000));
+            const std::string value = std::to_string(step);
+            const size_t op = rand_below(7);
+            if(op == 0) {
+                m[key] = value;
+                expect[key] = value;
+            } else if(op == 1) {
+                const bool inserted = m.try_emplace(key, value).second;
+                CHECK(inserted == expect.insert(std::make_pair(key, value)).second);
+            } else if(op == 2) {
+                const bool inserted = m.insert_or_assign(key, value).second;
+                CHECK(inserted == (expect.count(key) == 0));
+                expect[key] = value;
+            } else if(op == 3) {
+                const bool inserted = m.insert(mabustl::make_pair(key, value)).second;
+                CHECK(inserted == expect.insert(std::make_pair(key, value)).second);
+            } else if(op == 4) {
+                CHECK(m.erase(key) == expect.erase(key));
+            } else if(op == 5) {
+                const std::map<int, std::string>::iterator e = expect.find(key);
+                if(e == expect.end()) {
+                    bool thrown = false;
+                    try {
+                        m.at(key);
+                    } catch(const std::out_of_range&) {
+                        thrown = true;
+                    }
+                    CHECK(thrown);
+                } else {
+                    CHECK(m.at(key) == e->second);
+                }
+            } else {
+                map_type::iterator it = m.lower_bound(key);
+                std::map<int, std::string>::iterator e = expect.lower_bound(key);
+                CHECK((it == m.end()) == (e == expect.end()));
+                if(e != expect.end()) CHECK(it->first == e->first && it->second == e->second);
+            }
+            CHECK(m.size() == expect.size());
+            if(step % 1000 == 0) CHECK(same_map(m, expect));
+        }
+        CHECK(same_map(m, expect));
+
+        // 复制、移动、swap、比较
+        map_type copy(m);
+        CHECK(copy == m && !(copy < m) && copy <= m);
+        copy[-1] = "smallest";
+        CHECK(copy != m && copy < m && m > copy);
+        map_type moved(std::move(copy));
+        CHECK(moved.size() == m.size() + (expect.count(-1) ? 0 : 1));
+        map_type other;
+        other.swap(moved);
+        CHECK(moved.empty() && other.count(-1) == 1);
+        other = m;
+        CHECK(same_map(other, expect));
+    }
+
+    long long key_copies = 0;
+
+    // 复制时计数，移动不抛异常
+    struct counted_key {
+        int value;
+
+        explicit counted_key(int v): value(v) {}
+        counted_key(const counted_key& other): value(other.value) { ++key_copies; }
+        counted_key(counted_key&& other) noexcept: value(other.value) {}
+        counted_key& operator=(const counted_key& other) {
+            value = other.value;
+            ++key_copies;
+            return *this;
+        }
+
+        friend bool operator<(const counted_key& lhs, const counted_key& rhs) { return lhs.value < rhs.value; }
+    };
+
+    void test_node_moves() {
+        typedef mabustl::btree_map<counted_key, std::string> map_type;
+        static_assert(std::is_same<map_type::value_type, mabustl::pair<const counted_key, std::string> >::value,
+                      "keys are not writable through iterators");
+        map_type m;
+        std::map<int, std::string> expect;
+        key_copies = 0;
+        for(int step = 0; step != 50000; ++step) {
+            const int key = static_cast<int>(rand_below(20000));
+            if(rand_below(3) == 0) {
+                CHECK(m.erase(counted_key(key)) == expect.erase(key));
+            } else if(rand_below(2) == 0) {
+                m.emplace(counted_key(key), std::to_string(step));
+                expect.insert(std::make_pair(key, std::to_string(step)));
+            } else {
+                m.emplace_hint(m.end(), counted_key(key), std::to_string(step));
+                expect.insert(std::make_pair(key, std::to_string(step)));
+            }
+        }
+        CHECK(key_copies == 0);
+        CHECK(m.size() == expect.size());
+        std::map<int, std::string>::const_iterator e = expect.begin();
+        for(map_type::const_iterator it = m.begin(); it != m.end(); ++it, ++e) {
+            CHECK(it->first.value == e->first && it->second == e->second);
+        }
+    }
+
+    void test_bulk_load() {
+        const size_t sizes[] = {0, 1, 2, 100, 10000, 200000};
+        for(size_t s = 0; s != sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            const size_t n = sizes[s];
+            std::vector<int> sorted(n);
+            for(size_t i = 0; i != n; ++i) sorted[i] = static_cast<int>(3 * i);
+            // mabustl 的区间构造只接受 mabustl 的迭代器，用指针传入
+            std::vector<int> shuffled(sorted);
+            std::shuffle(shuffled.begin(), shuffled.end(), mabustl_test::rng());
+            const std::set<int> expect(sorted.begin(), sorted.end());
+
+            mabustl::btree_set<int> from_sorted(sorted.data(), sorted.data() + n);
+            CHECK(same_set(from_sorted, expect));
+            mabustl::btree_set<int> from_shuffled(shuffled.data(), shuffled.data() + n);
+            CHECK(same_set(from_shuffled, expect));
+            CHECK(from_sorted == from_shuffled);
+            for(size_t i = 0; i < n; i += 1 + n / 100) {
+                CHECK(from_sorted.find(static_cast<int>(3 * i)) != from_sorted.end());
+                CHECK(from_sorted.find(static_cast<int>(3 * i + 1)) == from_sorted.end());
+            }
+
+            // 插入已有元素的有序区间，数量不变
+            from_sorted.insert(sorted.data(), sorted.data() + n);
+            CHECK(from_sorted.size() == n);
+        }
+    }
+
+    template<class Algo, class StdAlgo>
+    void check_set_algorithm(const mabustl::btree_set<int>& a, const mabustl::btree_set<int>& b,
+                             const std::set<int>& sa, const std::set<int>& sb, Algo algo, StdAlgo std_algo) {
+        std::vector<int> result;
+        algo(a.begin(), a.end(), b.begin(), b.end(), mabustl::back_inserter(result));
+        std::vector<int> expect;
+        std_algo(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expect));
+        CHECK(result == expect);
+    }
+
+    typedef std::set<int>::const_iterator std_iter;
+    typedef mabustl::btree_set<int>::const_iterator btree_iter;
+    typedef std::back_insert_iterator<std::vector<int> > std_out;
+    typedef mabustl::back_insert_iterator<std::vector<int> > mabu_out;
+
+    void test_set_algorithms() {
+        for(int round = 0; round != 20; ++round) {
+            mabustl::btree_set<int> a;
+            mabustl::btree_set<int> b;
+            std::set<int> sa;
+            std::set<int> sb;
+            const size_t n = rand_below(5000);
+            for(size_t i = 0; i != n; ++i) {
+                const int x = static_cast<int>(rand_below(8000));
+                const int y = static_cast<int>(rand_below(8000));
+                a.insert(x);
+                sa.insert(x);
+                b.insert(y);
+                sb.insert(y);
+            }
+            check_set_algorithm(a, b, sa, sb, mabustl::set_union<btree_iter, btree_iter, mabu_out>,
+                                std::set_union<std_iter, std_iter, std_out>);
+            check_set_algorithm(a, b, sa, sb, mabustl::set_intersection<btree_iter, btree_iter, mabu_out>,
+                                std::set_intersection<std_iter, std_iter, std_out>);
+            check_set_algorithm(a, b, sa, sb, mabustl::set_difference<btree_iter, btree_iter, mabu_out>,
+                                std::set_difference<std_iter, std_iter, std_out>);
+        }
+    }
+}
+
+int main() {
+    test_set<int, mabustl::less<int>, std::less<int> >(20000, 120000);
+    test_set<int, mabustl::greater<int>, std::greater<int> >(300, 30000);
+    test_set<int, std::less<int>, std::less<int> >(20000, 100000);
+    test_set<std::string, mabustl::less<std::string>, std::less<std::string> >(5000, 60000);
+    test_map(100000);
+    test_node_moves();
+    test_bulk_load();
+    test_set_algorithms();
+    return mabustl_test::pass("test_btree");
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * 测试用的公共工具
+ * 每个 test_*.cpp 是一个独立的可执行文件，用固定种子的随机操作驱动 mabustl 的组件，
+ * 并与 std 中对应的实现逐步比较；CHECK 不依赖 NDEBUG，失败时输出位置并以非 0 退出
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#define CHECK(expr)                                                                   \
+    do {                                                                              \
+        if(!(expr)) {                                                                 \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+            std::exit(1);                                                             \
+        }                                                                             \
+    } while(0)
+
+namespace mabustl_test {
+    // 所有测试共用的随机数引擎，种子固定，失败可以复现
+    inline std::mt19937_64& rng() {
+        static std::mt19937_64 engine(20261017);
+        return engine;
+    }
+
+    // [0, n) 内的随机整数
+    inline size_t rand_below(size_t n) {
+        return static_cast<size_t>(rng()() % n);
+    }
+
+    // 分配器测试用：每块内存写满自己的 tag，回收前检查没有被其他块覆盖
+    struct tagged_block {
+        unsigned char* ptr;
+        size_t n;
+        unsigned char tag;
+    };
+
+    inline tagged_block make_block(void* ptr, size_t n, unsigned char tag) {
+        tagged_block b;
+        b.ptr = static_cast<unsigned char*>(ptr);
+        b.n = n;
+        b.tag = tag;
+        std::memset(b.ptr, tag, n);
+        return b;
+    }
+
+    inline bool intact(const tagged_block& b) {
+        for(size_t i = 0; i != b.n; ++i) {
+            if(b.ptr[i] != b.tag) return false;
+        }
+        return true;
+    }
+
+    inline bool aligned_to(const void* ptr, size_t alignment) {
+        return reinterpret_cast<size_t>(ptr) % alignment == 0;
+    }
+
+    inline int pass(const char* name) {
+        std::printf("%s: ok\n", name);
+        return 0;
+    }
+}
@@ -0,0 +1,163 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * d_ary_heap
+ * (1)D 为 2、3、4、8 时 int、std::string 和 16 字节定时器项上的随机操作，与 std::priority_queue 逐步比较
+ *    (push / emplace / pop / replace_top / push_range / 复制 / 移动 / 交换)
+ * (2)默认的 cache_aligned_allocator 下，每组子节点的起始地址按 D * sizeof(T) 和缓存行中较小者对齐
+ * (3)push_range 到空堆只用 O(n) 次比较
+ */
+
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "mabu_d_ary_heap.h"
+#include "mabu_functional.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    struct timer {
+        long long deadline;
+        long long id;
+
+        bool operator<(const timer& rhs) const { return deadline < rhs.deadline; }
+        bool operator>(const timer& rhs) const { return deadline > rhs.deadline; }
+        bool operator==(const timer& rhs) const { return deadline == rhs.deadline; }
+    };
+
+    template<class T>
+    struct value_maker;
+
+    template<>
+    struct value_maker<int> {
+        static int make() { return static_cast<int>(rand_below(10000)); }
+    };
+
+    template<>
+    struct value_maker<long long> {
+        static long long make() { return static_cast<long long>(rand_below(10000)); }
+    };
+
+    template<>
+    struct value_maker<std::string> {
+        static std::string make() { return std::to_string(rand_below(10000)); }
+    };
+
+    template<>
+    struct value_maker<timer> {
+        static timer make() {
+            timer t = {static_cast<long long>(rand_below(10000)), static_cast<long long>(rand_below(10000))};
+            return t;
+        }
+    };
+
+    // 只比较堆顶，相同的优先级可以对应不同的元素，按 comp 都不小于对方即视为相同
+    template<class T, class Compare>
+    bool same_priority(const T& a, const T& b, Compare comp) {
+        return !comp(a, b) && !comp(b, a);
+    }
+
+    template<class T, size_t D, class Compare, class StdCompare>
+    void test_against_std(int steps) {
+        typedef mabustl::d_ary_heap<T, D, Compare> heap;
+        heap actual;
+        std::priority_queue<T, std::vector<T>, StdCompare> expect;
+        Compare comp;
+        for(int step = 0; step != steps; ++step) {
+            const size_t op = rand_below(10);
+            if(op < 4) {
+                const T value = value_maker<T>::make();
+                actual.push(value);
+                expect.push(value);
+            } else if(op == 4) {
+                const T value = value_maker<T>::make();
+                actual.emplace(value);
+                expect.emplace(value);
+            } else if(op == 5 && !expect.empty()) {
+                const T value = value_maker<T>::make();
+                actual.replace_top(value);
+                expect.pop();
+                expect.push(value);
+            } else if(op == 6 && rand_below(8) == 0) {
+                std::vector<T> values(rand_below(rand_below(2) == 0 ? 8 : 300));
+                for(size_t i = 0; i != values.size(); ++i) values[i] = value_maker<T>::make();
+                actual.push_range(values.begin(), values.end());
+                for(size_t i = 0; i != values.size(); ++i) expect.push(values[i]);
+            } else if(op == 7 && rand_below(64) == 0) {
+                heap copy(actual);
+                heap moved(mabustl::move(copy));
+                heap other;
+                other.swap(moved);
+                actual = other;
+            } else if(!expect.empty()) {
+                actual.pop();
+                expect.pop();
+            }
+            CHECK(actual.size() == expect.size());
+            if(!expect.empty()) CHECK(same_priority(actual.top(), expect.top(), comp));
+        }
+        while(!expect.empty()) {
+            CHECK(same_priority(actual.top(), expect.top(), comp));
+            actual.pop();
+            expect.pop();
+        }
+        CHECK(actual.empty());
+    }
+
+    template<class T, size_t D>
+    void test_alignment() {
+        mabustl::d_ary_heap<T, D> heap;
+        for(int i = 0; i != 1000; ++i) heap.push(value_maker<T>::make());
+        const size_t group = D * sizeof(T);
+        const size_t alignment = group < 64 ? group : 64;
+        // 根节点的子节点组紧跟在根节点之后
+        CHECK(mabustl_test::aligned_to(&heap.top() + 1, alignment));
+    }
+
+    long long comparisons = 0;
+
+    struct counting_less {
+        bool operator()(int a, int b) const {
+            ++comparisons;
+            return a < b;
+        }
+    };
+
+    template<size_t D>
+    void test_push_range_linear() {
+        const size_t n = 1 << 16;
+        std::vector<int> values(n);
+        for(size_t i = 0; i != n; ++i) values[i] = static_cast<int>(rand_below(1000000));
+        mabustl::d_ary_heap<int, D, counting_less> heap;
+        comparisons = 0;
+        heap.push_range(values.begin(), values.end());
+        CHECK(comparisons <= static_cast<long long>(2 * D * n));
+        int top = values[0];
+        for(size_t i = 1; i != n; ++i) top = values[i] > top ? values[i] : top;
+        CHECK(heap.top() == top);
+    }
+}
+
+int main() {
+    test_against_std<int, 2, mabustl::less<int>, std::less<int> >(100000);
+    test_against_std<int, 3, mabustl::less<int>, std::less<int> >(100000);
+    test_against_std<int, 4, mabustl::greater<int>, std::greater<int> >(100000);
+    test_against_std<int, 8, mabustl::less<int>, std::less<int> >(100000);
+    test_against_std<std::string, 4, mabustl::less<std::string>, std::less<std::string> >(50000);
+    test_against_std<timer, 4, mabustl::greater<timer>, std::greater<timer> >(100000);
+    test_against_std<timer, 8, mabustl::greater<timer>, std::greater<timer> >(100000);
+    test_alignment<int, 4>();
+    test_alignment<int, 8>();
+    test_alignment<timer, 4>();
+    test_alignment<long long, 8>();
+    test_push_range_linear<4>();
+    test_push_range_linear<8>();
+    return mabustl_test::pass("test_d_ary_heap");
+}
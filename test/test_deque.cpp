@@ -0,0 +1,143 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * deque
+ * (1)int 和 std::string 上两端和中间的随机操作，与 std::vector 逐步比较
+ * (2)copy / copy_backward / move / move_backward / fill 的分段版本：在 deque 与 deque(不同的块内偏移)、
+ *    deque 与指针之间随机选取区间，结果与在 std::vector 上用 std 算法得到的相同
+ *    (int 每块 1024 个元素；300 字节的元素每块 16 个，区间跨越很多块)
+ * (3)两端交替增删很多次，元素不移动：指向未删除元素的指针保持有效
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_deque.h"
+#include "test_sequence.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    struct big {
+        int value;
+        char pad[296];
+
+        big(): value(0) {}
+        explicit big(int v): value(v) {}
+        bool operator==(const big& rhs) const { return value == rhs.value; }
+    };
+
+    template<class T>
+    T make(size_t i) {
+        return T(static_cast<int>(i));
+    }
+
+    template<class Deque>
+    Deque make_deque(size_t n, size_t front_pushes, size_t seed) {
+        // 先从前端插入一部分，使第一个元素落在块中间
+        Deque d;
+        typedef typename Deque::value_type T;
+        for(size_t i = 0; i != front_pushes; ++i) d.push_front(make<T>(seed + n + i));
+        for(size_t i = 0; i != n; ++i) d.push_back(make<T>(seed + i));
+        return d;
+    }
+
+    // mabustl 的迭代器不是 std 的迭代器，逐个复制到 std::vector
+    template<class Deque>
+    std::vector<typename Deque::value_type> to_vector(const Deque& d) {
+        std::vector<typename Deque::value_type> result;
+        for(size_t i = 0; i != d.size(); ++i) result.push_back(d[i]);
+        return result;
+    }
+
+    template<class T>
+    void test_algorithms(size_t max_size) {
+        typedef mabustl::deque<T> deque;
+        for(int round = 0; round != 200; ++round) {
+            deque src = make_deque<deque>(rand_below(max_size), rand_below(max_size / 4 + 1), 0);
+            deque dst = make_deque<deque>(rand_below(max_size), rand_below(max_size / 4 + 1), 100000);
+            std::vector<T> src_expect = to_vector(src);
+            std::vector<T> dst_expect = to_vector(dst);
+            std::vector<T> raw(max_size, make<T>(7));
+            std::vector<T> raw_expect(raw);
+
+            const size_t first = rand_below(src.size() + 1);
+            const size_t n = rand_below(src.size() - first + 1);
+            const size_t op = rand_below(6);
+            if(op == 0 && n <= dst.size()) {
+                const size_t out = rand_below(dst.size() - n + 1);
+                CHECK(mabustl::copy(src.begin() + first, src.begin() + first + n, dst.begin() + out) ==
+                      dst.begin() + out + n);
+                std::copy(src_expect.begin() + first, src_expect.begin() + first + n, dst_expect.begin() + out);
+            } else if(op == 1 && n <= dst.size()) {
+                const size_t out_end = n + rand_below(dst.size() - n + 1);
+                CHECK(mabustl::copy_backward(src.begin() + first, src.begin() + first + n, dst.begin() + out_end) ==
+                      dst.begin() + out_end - n);
+                std::copy_backward(src_expect.begin() + first, src_expect.begin() + first + n,
+                                   dst_expect.begin() + out_end);
+            } else if(op == 2 && n <= dst.size()) {
+                const size_t out = rand_below(dst.size() - n + 1);
+                mabustl::move(src.begin() + first, src.begin() + first + n, dst.begin() + out);
+                std::move(src_expect.begin() + first, src_expect.begin() + first + n, dst_expect.begin() + out);
+            } else if(op == 3) {
+                // 同一个 deque 内向后移动，区间可以重叠
+                const size_t shift = rand_below(src.size() - first - n + 1);
+                mabustl::move_backward(src.begin() + first, src.begin() + first + n, src.begin() + first + n + shift);
+                std::move_backward(src_expect.begin() + first, src_expect.begin() + first + n,
+                                   src_expect.begin() + first + n + shift);
+            } else if(op == 4) {
+                mabustl::fill(src.begin() + first, src.begin() + first + n, make<T>(42));
+                std::fill(src_expect.begin() + first, src_expect.begin() + first + n, make<T>(42));
+            } else if(n <= raw.size()) {
+                // deque 到指针，再从指针回到 deque
+                T* out = raw.data();
+                CHECK(mabustl::copy(src.begin() + first, src.begin() + first + n, out) == out + n);
+                std::copy(src_expect.begin() + first, src_expect.begin() + first + n, raw_expect.begin());
+                if(n <= dst.size()) {
+                    const size_t at = rand_below(dst.size() - n + 1);
+                    mabustl::copy(out, out + n, dst.begin() + at);
+                    std::copy(raw_expect.begin(), raw_expect.begin() + n, dst_expect.begin() + at);
+                }
+            }
+            CHECK(mabustl_test::same_sequence(src, src_expect));
+            CHECK(mabustl_test::same_sequence(dst, dst_expect));
+            CHECK(raw == raw_expect);
+        }
+    }
+
+    void test_stable_addresses() {
+        mabustl::deque<int> d;
+        std::vector<const int*> addresses;
+        std::vector<int> expect;
+        for(int i = 0; i != 5000; ++i) {
+            d.push_back(i);
+            expect.push_back(i);
+        }
+        for(size_t i = 0; i != d.size(); ++i) addresses.push_back(&d[i]);
+        // 从后端删除一部分、前后端各追加很多，原有元素的地址不变
+        for(int i = 0; i != 1000; ++i) d.pop_back();
+        for(int i = 0; i != 20000; ++i) {
+            d.push_front(-i);
+            d.push_back(-i);
+        }
+        const size_t offset = 20000;
+        for(size_t i = 0; i != 4000; ++i) {
+            CHECK(&d[offset + i] == addresses[i]);
+            CHECK(d[offset + i] == expect[i]);
+        }
+    }
+}
+
+int main() {
+    mabustl_test::random_sequence_ops<mabustl::deque<int>, true>(100000);
+    mabustl_test::random_sequence_ops<mabustl::deque<std::string>, true>(100000);
+    test_algorithms<int>(5000);
+    test_algorithms<big>(400);
+    test_stable_addresses();
+    return mabustl_test::pass("test_deque");
+}
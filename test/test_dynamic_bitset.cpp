@@ -0,0 +1,262 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * dynamic_bitset
+ * (1)| & ^ - 以及对应的 *_count，与 std::set_union / set_intersection / set_symmetric_difference / set_difference
+ *    在有序元素区间上的结果比较；两个集合的位数不同，位数跨过多个字，覆盖 popcount 的分块和尾部
+ * (2)count / any / none / all / is_subset_of / intersects，与 std::vector<bool> 和 std::includes 比较
+ * (3)find_first / find_next / for_each_set / to_elements 都按从小到大的顺序给出全部元素
+ * (4)单个位的 set / reset / flip，resize / push_back / ~，最后一个字中超出 size() 的位保持为 0
+ * (5)从有序和无序的元素区间构造，负数元素抛出 out_of_range，
+ *    不小于 max_size() 的元素(包括 SIZE_MAX)抛出 length_error
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "mabu_dynamic_bitset.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    typedef mabustl::dynamic_bitset<> bitset;
+    typedef std::vector<size_t> elements;
+
+    // 位数为 n、每一位以 density / 100 的概率为 1 的随机集合
+    elements random_elements(size_t n, size_t density) {
+        elements result;
+        for(size_t i = 0; i != n; ++i) {
+            if(rand_below(100) < density) result.push_back(i);
+        }
+        return result;
+    }
+
+    bitset from_elements(const elements& e, size_t n) {
+        return bitset(e.data(), e.data() + e.size(), n);
+    }
+
+    elements to_elements(const bitset& b) {
+        elements result;
+        b.to_elements(std::back_inserter(result));
+        return result;
+    }
+
+    // 最后一个字中超出 size() 的位为 0，count 不会数到它们
+    bool tail_clear(const bitset& b) {
+        if(b.size() % bitset::bits_per_block == 0) return true;
+        return (b.data()[b.num_blocks() - 1] >> (b.size() % bitset::bits_per_block)) == 0;
+    }
+
+    void check_same(const bitset& b, const std::vector<bool>& model) {
+        CHECK(b.size() == model.size());
+        CHECK(tail_clear(b));
+        size_t count = 0;
+        for(size_t i = 0; i != model.size(); ++i) {
+            CHECK(b[i] == model[i]);
+            count += model[i];
+        }
+        CHECK(b.count() == count);
+        CHECK(b.any() == (count != 0));
+        CHECK(b.none() == (count == 0));
+        CHECK(b.all() == (count == model.size()));
+    }
+
+    void test_set_operations() {
+        const size_t sizes[] = {0, 1, 63, 64, 65, 1000, 1024, 4097, 20000};
+        const size_t densities[] = {0, 3, 50, 97, 100};
+        const size_t num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+        for(int round = 0; round != 300; ++round) {
+            const size_t na = sizes[rand_below(num_sizes)];
+            const size_t nb = sizes[rand_below(num_sizes)];
+            const elements ea = random_elements(na, densities[rand_below(5)]);
+            const elements eb = random_elements(nb, densities[rand_below(5)]);
+            const bitset a = from_elements(ea, na);
+            const bitset b = from_elements(eb, nb);
+            CHECK(a.size() == na && b.size() == nb);
+            CHECK(to_elements(a) == ea && a.count() == ea.size());
+
+            elements expect;
+            std::set_union(ea.begin(), ea.end(), eb.begin(), eb.end(), std::back_inserter(expect));
+            const bitset u = a | b;
+            CHECK(to_elements(u) == expect && u.size() == std::max(na, nb) && tail_clear(u));
+            CHECK(a.union_count(b) == expect.size());
+
+            expect.clear();
+            std::set_intersection(ea.begin(), ea.end(), eb.begin(), eb.end(), std::back_inserter(expect));
+            const bitset i = a & b;
+            CHECK(to_elements(i) == expect && i.size() == na && tail_clear(i));
+            CHECK(a.intersection_count(b) == expect.size());
+            CHECK(a.intersects(b) == !expect.empty());
+
+            expect.clear();
+            std::set_symmetric_difference(ea.begin(), ea.end(), eb.begin(), eb.end(), std::back_inserter(expect));
+            const bitset x = a ^ b;
+            CHECK(to_elements(x) == expect && x.size() == std::max(na, nb) && tail_clear(x));
+            CHECK(a.symmetric_difference_count(b) == expect.size());
+
+            expect.clear();
+            std::set_difference(ea.begin(), ea.end(), eb.begin(), eb.end(), std::back_inserter(expect));
+            const bitset d = a - b;
+            CHECK(to_elements(d) == expect && d.size() == na && tail_clear(d));
+            CHECK(a.difference_count(b) == expect.size());
+
+            CHECK(a.is_subset_of(b) == std::includes(eb.begin(), eb.end(), ea.begin(), ea.end()));
+            CHECK(a.is_subset_of(a | b) && (a & b).is_subset_of(a));
+
+            // 复合赋值与二元运算一致
+            bitset c = a;
+            c |= b;
+            CHECK(c == u);
+            c = a;
+            c &= b;
+            CHECK(c == i);
+            c = a;
+            c ^= b;
+            CHECK(c == x);
+            c = a;
+            c -= b;
+            CHECK(c == d);
+        }
+    }
+
+    void test_iteration() {
+        for(int round = 0; round != 100; ++round) {
+            const size_t n = 1 + rand_below(5000);
+            const elements e = random_elements(n, rand_below(101));
+            const bitset b = from_elements(e, n);
+
+            elements found;
+            for(size_t pos = b.find_first(); pos != bitset::npos; pos = b.find_next(pos)) found.push_back(pos);
+            CHECK(found == e);
+
+            found.clear();
+            b.for_each_set([&found](size_t pos) { found.push_back(pos); });
+            CHECK(found == e);
+            CHECK(b.find_next(n - 1) == bitset::npos);
+        }
+        CHECK(bitset().find_first() == bitset::npos);
+        CHECK(bitset(100).find_first() == bitset::npos);
+    }
+
+    void test_bit_operations() {
+        bitset b;
+        std::vector<bool> model;
+        for(int step = 0; step != 20000; ++step) {
+            const size_t op = rand_below(8);
+            if(op == 0) {
+                const bool value = rand_below(2) != 0;
+                b.push_back(value);
+                model.push_back(value);
+            } else if(op == 1) {
+                const size_t n = rand_below(700);
+                const bool value = rand_below(2) != 0;
+                b.resize(n, value);
+                model.resize(n, value);
+            } else if(op < 5 && !model.empty()) {
+                const size_t pos = rand_below(model.size());
+                if(op == 2) {
+                    const bool value = rand_below(2) != 0;
+                    b.set(pos, value);
+                    model[pos] = value;
+                } else if(op == 3) {
+                    b.reset(pos);
+                    model[pos] = false;
+                } else {
+                    b.flip(pos);
+                    model[pos] = !model[pos];
+                }
+                CHECK(b.test(pos) == model[pos]);
+            } else if(op == 5) {
+                b.flip();
+                model.flip();
+            } else if(op == 6) {
+                const bitset complement = ~b;
+                std::vector<bool> flipped(model);
+                flipped.flip();
+                check_same(complement, flipped);
+            } else if(rand_below(4) == 0) {
+                if(rand_below(2) == 0) {
+                    b.set();
+                    std::fill(model.begin(), model.end(), true);
+                } else {
+                    b.reset();
+                    std::fill(model.begin(), model.end(), false);
+                }
+            }
+            check_same(b, model);
+        }
+
+        bool thrown = false;
+        try {
+            b.test(b.size());
+        } catch(const std::out_of_range&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+
+    void test_construct() {
+        // 无序、有重复的元素，位数取 max(n, 最大元素 + 1)
+        std::vector<int> values(3000);
+        for(size_t i = 0; i != values.size(); ++i) values[i] = static_cast<int>(rand_below(10000));
+        std::vector<int> sorted(values);
+        std::sort(sorted.begin(), sorted.end());
+        sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+        const bitset from_unsorted(values.data(), values.data() + values.size());
+        const bitset from_sorted(sorted.data(), sorted.data() + sorted.size());
+        CHECK(from_unsorted == from_sorted);
+        CHECK(from_sorted.size() == static_cast<size_t>(sorted.back()) + 1);
+        const elements e = to_elements(from_sorted);
+        CHECK(e.size() == sorted.size() && std::equal(e.begin(), e.end(), sorted.begin()));
+
+        const bitset wide(sorted.data(), sorted.data() + sorted.size(), 20000);
+        CHECK(wide.size() == 20000 && wide.count() == sorted.size());
+
+        bitset grown;
+        grown.insert_elements(sorted.data(), sorted.data() + sorted.size());
+        CHECK(grown == from_sorted && tail_clear(grown));
+
+        bitset moved(std::move(grown));
+        CHECK(moved == from_sorted && grown.empty());
+
+        const int negative[] = {3, -1};
+        bool thrown = false;
+        try {
+            bitset bad(negative, negative + 2);
+        } catch(const std::out_of_range&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+
+        // pos + 1 不能回绕成 0
+        bitset small;
+        const size_t too_big[] = {5, SIZE_MAX, small.max_size(), small.max_size() + 1};
+        for(size_t i = 1; i != 4; ++i) {
+            bitset target(too_big, too_big + 1);
+            thrown = false;
+            try {
+                target.insert_elements(too_big + i, too_big + i + 1);
+            } catch(const std::length_error&) {
+                thrown = true;
+            }
+            CHECK(thrown);
+            CHECK(target.size() == 6 && target.count() == 1 && target.test(5));
+        }
+    }
+}
+
+int main() {
+    test_set_operations();
+    test_iteration();
+    test_bit_operations();
+    test_construct();
+    return mabustl_test::pass("test_dynamic_bitset");
+}
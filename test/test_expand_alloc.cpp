@@ -0,0 +1,127 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * allocate_at_least / try_expand
+ * (1)每个后端随机分配、原地扩大和回收：得到的整段空间都可以写入，扩大后原有内容不变，块之间没有重叠，
+ *    按 allocate_at_least / try_expand 得到的大小回收
+ * (2)allocator<T, Alloc> 按对象个数转交给后端，count 不小于请求的个数
+ * (3)以各后端作为 vector 的 allocator，push_back 为主的随机操作后与 std::vector 比较
+ */
+
+#include <vector>
+
+#include "mabu_allocator.h"
+#include "mabu_vector.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+using mabustl_test::tagged_block;
+
+namespace {
+    template<class Backend>
+    void test_backend(size_t max_bytes) {
+        std::vector<tagged_block> live;
+        for(int step = 0; step != 4000; ++step) {
+            const size_t op = rand_below(3);
+            if(live.empty() || (op == 0 && live.size() < 64)) {
+                const size_t n = 1 + rand_below(max_bytes);
+                size_t usable = 0;
+                void* p = mabustl::backend_allocate_at_least<Backend>(n, usable);
+                CHECK(usable >= n);
+                live.push_back(mabustl_test::make_block(p, usable, static_cast<unsigned char>(step)));
+            } else if(op == 1) {
+                tagged_block& b = live[rand_below(live.size())];
+                const size_t new_n = b.n + rand_below(max_bytes / 4 + 1);
+                if(mabustl::backend_try_expand<Backend>(b.ptr, b.n, new_n)) {
+                    CHECK(mabustl_test::intact(b));
+                    b = mabustl_test::make_block(b.ptr, new_n, static_cast<unsigned char>(b.tag + 1));
+                }
+            } else {
+                const size_t i = rand_below(live.size());
+                CHECK(mabustl_test::intact(live[i]));
+                Backend::deallocate(live[i].ptr, live[i].n);
+                live[i] = live.back();
+                live.pop_back();
+            }
+        }
+        for(size_t i = 0; i != live.size(); ++i) {
+            CHECK(mabustl_test::intact(live[i]));
+            Backend::deallocate(live[i].ptr, live[i].n);
+        }
+
+        // 缩小总是失败，相同大小总是成功
+        size_t usable = 0;
+        void* p = mabustl::backend_allocate_at_least<Backend>(64, usable);
+        CHECK(!mabustl::backend_try_expand<Backend>(p, usable, usable - 1));
+        CHECK(mabustl::backend_try_expand<Backend>(p, usable, usable));
+        Backend::deallocate(p, usable);
+    }
+
+    template<class Backend>
+    void test_allocator() {
+        typedef mabustl::allocator<long long, Backend> alloc;
+        for(int round = 0; round != 200; ++round) {
+            const size_t n = 1 + rand_below(100);
+            mabustl::allocation_result<long long*, size_t> r = alloc::allocate_at_least(n);
+            CHECK(r.count >= n);
+            for(size_t i = 0; i != r.count; ++i) r.ptr[i] = static_cast<long long>(i);
+
+            size_t count = r.count;
+            const size_t new_n = count + rand_below(32);
+            if(alloc::try_expand(r.ptr, count, new_n)) {
+                for(size_t i = count; i != new_n; ++i) r.ptr[i] = static_cast<long long>(i);
+                count = new_n;
+            }
+            for(size_t i = 0; i != count; ++i) CHECK(r.ptr[i] == static_cast<long long>(i));
+            alloc::deallocate(r.ptr, count);
+        }
+    }
+
+    template<class Backend>
+    void test_vector() {
+        std::vector<long long> expect;
+        mabustl::vector<long long, mabustl::allocator<long long, Backend> > actual;
+        for(int step = 0; step != 100000; ++step) {
+            const size_t op = rand_below(16);
+            if(op < 13 || expect.empty()) {
+                expect.push_back(step);
+                actual.push_back(step);
+            } else if(op == 13) {
+                expect.pop_back();
+                actual.pop_back();
+            } else if(op == 14) {
+                const size_t n = rand_below(2 * expect.size() + 1);
+                expect.reserve(n);
+                actual.reserve(n);
+                CHECK(actual.capacity() >= n);
+            } else if(rand_below(64) == 0) {
+                expect.shrink_to_fit();
+                actual.shrink_to_fit();
+            }
+            CHECK(actual.size() == expect.size());
+            CHECK(actual.capacity() >= actual.size());
+        }
+        for(size_t i = 0; i != expect.size(); ++i) CHECK(actual[i] == expect[i]);
+    }
+}
+
+int main() {
+    test_backend<mabustl::new_alloc>(512);
+    test_backend<mabustl::pool_alloc>(512);
+    test_backend<mabustl::thread_cache_alloc>(512);
+    test_backend<mabustl::mmap_alloc>(1 << 18);
+
+    test_allocator<mabustl::new_alloc>();
+    test_allocator<mabustl::pool_alloc>();
+    test_allocator<mabustl::thread_cache_alloc>();
+    test_allocator<mabustl::mmap_alloc>();
+
+    test_vector<mabustl::new_alloc>();
+    test_vector<mabustl::pool_alloc>();
+    test_vector<mabustl::thread_cache_alloc>();
+    test_vector<mabustl::mmap_alloc>();
+    return mabustl_test::pass("test_expand_alloc");
+}
@@ -0,0 +1,232 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * flat_hash_map / flat_hash_set
+ * (1)整数 key(默认的恒等哈希，包括低位全为 0 的 key)、std::string key 和大量冲突的哈希上的随机操作，
+ *    与 std::unordered_map / std::unordered_set 逐步比较
+ * (2)按迭代器删除的同时遍历，每个元素恰好访问一次
+ * (3)reserve / rehash 之后内容不变，reserve(n) 之后插入 n 个元素不再扩容
+ * (4)元素类型是 pair<const Key, T>，rehash 仍然移动而不复制 key 和值
+ */
+
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "mabu_flat_hash_map.h"
+#include "mabu_flat_hash_set.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    // 只有 8 个不同的哈希值，探测序列很长
+    struct colliding_hash {
+        size_t operator()(long long key) const { return static_cast<size_t>(key & 7) * 0x9e3779b97f4a7c15ULL; }
+    };
+
+    struct string_hash {
+        size_t operator()(const std::string& key) const { return std::hash<std::string>()(key); }
+    };
+
+    template<class K>
+    struct key_maker;
+
+    // 一半是小整数，一半低 10 位全为 0
+    template<>
+    struct key_maker<long long> {
+        static long long make(size_t range) {
+            const long long k = static_cast<long long>(rand_below(range));
+            return rand_below(2) == 0 ? k : k << 10;
+        }
+    };
+
+    template<>
+    struct key_maker<std::string> {
+        static std::string make(size_t range) { return "key" + std::to_string(rand_below(range)); }
+    };
+
+    template<class Map, class Expect>
+    bool same_map(const Map& actual, const Expect& expect) {
+        if(actual.size() != expect.size()) return false;
+        size_t visited = 0;
+        for(typename Map::const_iterator it = actual.begin(); it != actual.end(); ++it, ++visited) {
+            typename Expect::const_iterator e = expect.find(it->first);
+            if(e == expect.end() || !(e->second == it->second)) return false;
+        }
+        return visited == expect.size();
+    }
+
+    template<class Set, class Expect>
+    bool same_set(const Set& actual, const Expect& expect) {
+        if(actual.size() != expect.size()) return false;
+        size_t visited = 0;
+        for(typename Set::const_iterator it = actual.begin(); it != actual.end(); ++it, ++visited) {
+            if(expect.count(*it) == 0) return false;
+        }
+        return visited == expect.size();
+    }
+
+    template<class Map>
+    void test_map(size_t range, int steps) {
+        typedef typename Map::key_type K;
+        Map actual;
+        std::unordered_map<K, int> expect;
+        for(int step = 0; step != steps; ++step) {
+            const K key = key_maker<K>::make(range);
+            const int value = static_cast<int>(rand_below(1000));
+            const size_t op = rand_below(12);
+            if(op == 0) {
+                CHECK(actual.insert(mabustl::make_pair(key, value)).second ==
+                      expect.insert(std::make_pair(key, value)).second);
+            } else if(op == 1) {
+                CHECK(actual.emplace(key, value).second == expect.emplace(key, value).second);
+            } else if(op == 2) {
+                CHECK(actual.try_emplace(key, value).second == (expect.count(key) == 0));
+                expect.emplace(key, value);
+            } else if(op == 3) {
+                CHECK(actual.insert_or_assign(key, value).second == (expect.count(key) == 0));
+                expect[key] = value;
+            } else if(op == 4) {
+                actual[key] += value;
+                expect[key] += value;
+            } else if(op == 5 || op == 6) {
+                CHECK(actual.erase(key) == expect.erase(key));
+            } else if(op == 7) {
+                typename Map::iterator it = actual.find(key);
+                CHECK((it == actual.end()) == (expect.count(key) == 0));
+                if(it != actual.end()) {
+                    CHECK(it->second == expect[key]);
+                    it = actual.erase(it);
+                    expect.erase(key);
+                }
+            } else if(op == 8) {
+                CHECK(actual.count(key) == expect.count(key));
+                CHECK(actual.contains(key) == (expect.count(key) != 0));
+                if(expect.count(key) != 0) CHECK(actual.at(key) == expect.at(key));
+            } else if(op == 9 && rand_below(64) == 0) {
+                if(rand_below(2) == 0) {
+                    actual.rehash(rand_below(4 * expect.size() + 1));
+                } else {
+                    actual.reserve(rand_below(4 * expect.size() + 1));
+                }
+                CHECK(same_map(actual, expect));
+            } else if(op == 10 && rand_below(64) == 0) {
+                Map copy(actual);
+                CHECK(copy == actual);
+                Map moved(mabustl::move(copy));
+                CHECK(same_map(moved, expect));
+                Map other;
+                other.swap(moved);
+                actual = other;
+            } else if(op == 11 && rand_below(1024) == 0) {
+                actual.clear();
+                expect.clear();
+            }
+            CHECK(actual.size() == expect.size());
+            if(step % 1024 == 0) CHECK(same_map(actual, expect));
+        }
+        CHECK(same_map(actual, expect));
+
+        // 按迭代器删除一半，其余的恰好访问一次
+        const size_t before = expect.size();
+        size_t visited = 0;
+        for(typename Map::iterator it = actual.begin(); it != actual.end(); ++visited) {
+            if(rand_below(2) == 0) {
+                expect.erase(it->first);
+                it = actual.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        CHECK(visited == before);
+        CHECK(same_map(actual, expect));
+    }
+
+    template<class Set>
+    void test_set(size_t range, int steps) {
+        typedef typename Set::key_type K;
+        Set actual;
+        std::unordered_set<K> expect;
+        for(int step = 0; step != steps; ++step) {
+            const K key = key_maker<K>::make(range);
+            const size_t op = rand_below(4);
+            if(op == 0) {
+                CHECK(actual.insert(key).second == expect.insert(key).second);
+            } else if(op == 1) {
+                CHECK(actual.emplace(key).second == expect.emplace(key).second);
+            } else if(op == 2) {
+                CHECK(actual.erase(key) == expect.erase(key));
+            } else {
+                CHECK(actual.count(key) == expect.count(key));
+            }
+            CHECK(actual.size() == expect.size());
+        }
+        CHECK(same_set(actual, expect));
+    }
+
+    void test_reserve() {
+        for(int round = 0; round != 50; ++round) {
+            const size_t n = 1 + rand_below(5000);
+            mabustl::flat_hash_map<long long, int> m;
+            m.reserve(n);
+            const size_t buckets = m.bucket_count();
+            CHECK(m.capacity() >= n);
+            for(size_t i = 0; i != n; ++i) m.emplace(static_cast<long long>(i) << 4, static_cast<int>(i));
+            CHECK(m.bucket_count() == buckets);
+            for(size_t i = 0; i != n; ++i) CHECK(m.at(static_cast<long long>(i) << 4) == static_cast<int>(i));
+        }
+    }
+
+    long long key_copies = 0;
+
+    // 复制时计数，移动不抛异常
+    struct counted_key {
+        long long value;
+
+        explicit counted_key(long long v): value(v) {}
+        counted_key(const counted_key& other): value(other.value) { ++key_copies; }
+        counted_key(counted_key&& other) noexcept: value(other.value) {}
+        counted_key& operator=(const counted_key& other) {
+            value = other.value;
+            ++key_copies;
+            return *this;
+        }
+
+        friend bool operator==(const counted_key& lhs, const counted_key& rhs) { return lhs.value == rhs.value; }
+    };
+
+    struct counted_key_hash {
+        size_t operator()(const counted_key& key) const { return static_cast<size_t>(key.value); }
+    };
+
+    void test_rehash_moves() {
+        typedef mabustl::flat_hash_map<counted_key, std::string, counted_key_hash> map_type;
+        static_assert(std::is_same<map_type::value_type, mabustl::pair<const counted_key, std::string> >::value,
+                      "keys are not writable through iterators");
+        static_assert(mabustl::is_trivially_relocatable<mabustl::flat_hash_map<int, int>::value_type>::value,
+                      "const does not disable the memcpy rehash");
+        map_type m;
+        key_copies = 0;
+        for(long long i = 0; i != 10000; ++i) m.emplace(counted_key(i), std::to_string(i));
+        CHECK(key_copies == 0);
+        for(long long i = 0; i != 10000; ++i) CHECK(m.at(counted_key(i)) == std::to_string(i));
+    }
+}
+
+int main() {
+    test_map<mabustl::flat_hash_map<long long, int> >(2000, 200000);
+    test_map<mabustl::flat_hash_map<long long, int> >(200000, 200000);
+    test_map<mabustl::flat_hash_map<long long, int, colliding_hash> >(300, 50000);
+    test_map<mabustl::flat_hash_map<std::string, int, string_hash> >(2000, 100000);
+    test_set<mabustl::flat_hash_set<long long> >(2000, 200000);
+    test_set<mabustl::flat_hash_set<std::string, string_hash> >(2000, 100000);
+    test_reserve();
+    test_rehash_moves();
+    return mabustl_test::pass("test_flat_hash_map");
+}
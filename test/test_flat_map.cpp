@@ -0,0 +1,339 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * flat_set / flat_map
+ * (1)随机的 insert / 批量 insert / erase / find / lower_bound / upper_bound，与 std::set / std::map 逐步比较；
+ *    批量 insert 之后通过 const 引用调用 find / contains / count / size / lower_bound，能看到这一批的全部元素
+ * (2)已有的 key 和同一批中重复的 key 都保留先放入的元素，与 std::map::insert 相同
+ * (3)一批 k 个元素合并进 n 个元素的比较次数和移动次数都在 O(n + k log k) 以内，逐个插入要 O(nk) 次移动
+ * (4)从无序区间构造、insert_or_assign / at / operator[]、复制、移动、swap 和比较运算符
+ * (5)批量 insert 之后通过 const 引用遍历、比较两个容器以及做 set_union / set_intersection，结果与 std::set 一致
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "mabu_flat_map.h"
+#include "mabu_flat_set.h"
+#include "mabu_set_algorithm.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    template<class Set, class StdSet>
+    bool same_set(Set& s, const StdSet& expect) {
+        if(s.size() != expect.size()) return false;
+        typename StdSet::const_iterator e = expect.begin();
+        for(typename Set::iterator it = s.begin(); it != s.end(); ++it, ++e) {
+            if(!(*it == *e)) return false;
+        }
+        return e == expect.end();
+    }
+
+    template<class Map, class StdMap>
+    bool same_map(Map& m, const StdMap& expect) {
+        if(m.size() != expect.size()) return false;
+        typename StdMap::const_iterator e = expect.begin();
+        for(typename Map::iterator it = m.begin(); it != m.end(); ++it, ++e) {
+            if(!(it->first == e->first && it->second == e->second)) return false;
+        }
+        return e == expect.end();
+    }
+
+    template<class Compare, class StdCompare>
+    void test_set(int key_range, int steps) {
+        typedef mabustl::flat_set<int, Compare> set_type;
+        set_type s;
+        std::set<int, StdCompare> expect;
+        for(int step = 0; step != steps; ++step) {
+            const int key = static_cast<int>(rand_below(key_range));
+            const size_t op = rand_below(8);
+            if(op == 0) {
+                const bool inserted = s.insert(key).second;
+                CHECK(inserted == expect.insert(key).second);
+            } else if(op < 3) {
+                // mabustl 的区间 insert 只接受 mabustl 的迭代器，用指针传入
+                int batch[4];
+                const size_t k = 1 + rand_below(4);
+                for(size_t i = 0; i != k; ++i) batch[i] = static_cast<int>(rand_below(key_range));
+                s.insert(batch, batch + k);
+                expect.insert(batch, batch + k);
+                // insert 返回时这一批已经全部合并，const 的查找能看到每一个元素
+                const set_type& cs = s;
+                for(size_t i = 0; i != k; ++i) {
+                    CHECK(cs.contains(batch[i]) && cs.count(batch[i]) == 1 && cs.find(batch[i]) != cs.end());
+                }
+                CHECK(cs.size() == expect.size());
+            } else if(op == 3) {
+                CHECK(s.erase(key) == expect.erase(key));
+            } else if(op == 4) {
+                const set_type& cs = s;
+                CHECK(cs.contains(key) == (expect.count(key) != 0));
+                typename set_type::iterator it = s.find(key);
+                CHECK((it == s.end()) == (expect.find(key) == expect.end()));
+            } else if(op == 5) {
+                typename set_type::iterator lo = s.lower_bound(key);
+                typename std::set<int, StdCompare>::iterator e = expect.lower_bound(key);
+                CHECK((lo == s.end()) == (e == expect.end()));
+                if(e != expect.end()) CHECK(*lo == *e);
+                typename set_type::iterator hi = s.upper_bound(key);
+                e = expect.upper_bound(key);
+                CHECK((hi == s.end()) == (e == expect.end()));
+                if(e != expect.end()) CHECK(*hi == *e);
+            } else if(op == 6) {
+                // 位于正确位置的 hint 不需要查找
+                typename set_type::iterator hint = s.lower_bound(key);
+                typename set_type::iterator it = s.insert(hint, key);
+                CHECK(*it == key);
+                expect.insert(key);
+            } else {
+                const set_type& cs = s;
+                typename set_type::const_iterator lo = cs.lower_bound(key);
+                typename std::set<int, StdCompare>::iterator e = expect.lower_bound(key);
+                CHECK((lo == cs.end()) == (e == expect.end()));
+                if(e != expect.end()) CHECK(*lo == *e);
+            }
+            CHECK(s.empty() == expect.empty());
+            if(step % 500 == 0) CHECK(same_set(s, expect));
+        }
+        CHECK(same_set(s, expect));
+    }
+
+    void test_map(int steps) {
+        typedef mabustl::flat_map<int, std::string> map_type;
+        map_type m;
+        std::map<int, std::string> expect;
+        for(int step = 0; step != steps; ++step) {
+            const int key = static_cast<int>(rand_below(3000));
+            const std::string value = std::to_string(step);
+            const size_t op = rand_below(7);
+            if(op < 2) {
+                // 已有的 key 和同一批中更早出现的 key 都不会被覆盖
+                map_type::value_type batch[3];
+                const size_t k = 1 + rand_below(3);
+                for(size_t i = 0; i != k; ++i) {
+                    const int batch_key = i == 0 ? key : static_cast<int>(rand_below(3000));
+                    batch[i] = mabustl::make_pair(batch_key, value + "." + std::to_string(i));
+                    expect.insert(std::make_pair(batch[i].first, batch[i].second));
+                }
+                m.insert(batch, batch + k);
+            } else if(op == 2) {
+                m[key] = value;
+                expect[key] = value;
+            } else if(op == 3) {
+                const bool inserted = m.insert_or_assign(key, value).second;
+                CHECK(inserted == (expect.count(key) == 0));
+                expect[key] = value;
+            } else if(op == 4) {
+                const bool inserted = m.try_emplace(key, value).second;
+                CHECK(inserted == expect.insert(std::make_pair(key, value)).second);
+            } else if(op == 5) {
+                CHECK(m.erase(key) == expect.erase(key));
+            } else {
+                const std::map<int, std::string>::iterator e = expect.find(key);
+                if(e == expect.end()) {
+                    bool thrown = false;
+                    try {
+                        m.at(key);
+                    } catch(const std::out_of_range&) {
+                        thrown = true;
+                    }
+                    CHECK(thrown);
+                } else {
+                    CHECK(m.at(key) == e->second);
+                }
+            }
+            if(step % 500 == 0) CHECK(same_map(m, expect));
+        }
+        CHECK(same_map(m, expect));
+
+        map_type copy(m);
+        CHECK(copy == m && copy <= m && !(copy < m));
+        copy[-1] = "smallest";
+        CHECK(copy != m && copy < m && m > copy);
+        map_type moved(std::move(copy));
+        map_type other;
+        other.swap(moved);
+        CHECK(moved.empty() && other.count(-1) == 1);
+        other = m;
+        CHECK(same_map(other, expect));
+    }
+
+    void test_range_construct() {
+        std::vector<int> keys(20000);
+        for(size_t i = 0; i != keys.size(); ++i) keys[i] = static_cast<int>(rand_below(10000));
+        const std::set<int> expect(keys.begin(), keys.end());
+        // mabustl 的区间构造只接受 mabustl 的迭代器，用指针传入
+        mabustl::flat_set<int> s(keys.data(), keys.data() + keys.size());
+        CHECK(same_set(s, expect));
+        mabustl::flat_set<int, mabustl::greater<int> > r(keys.data(), keys.data() + keys.size());
+        CHECK(r.size() == expect.size());
+        std::set<int>::const_reverse_iterator e = expect.rbegin();
+        for(mabustl::flat_set<int, mabustl::greater<int> >::iterator it = r.begin(); it != r.end(); ++it, ++e) {
+            CHECK(*it == *e);
+        }
+    }
+
+    // 随机地一部分逐个插入、一部分作为一批插入
+    template<class Set, class StdSet>
+    void fill_random(Set& s, StdSet& expect, int key_range) {
+        int batch[8];
+        size_t k = 0;
+        const size_t n = rand_below(8);
+        for(size_t i = 0; i != n; ++i) {
+            const int key = static_cast<int>(rand_below(key_range));
+            if(rand_below(2) == 0) s.insert(key);
+            else batch[k++] = key;
+            expect.insert(key);
+        }
+        s.insert(batch, batch + k);
+    }
+
+    void test_batch_visible() {
+        typedef mabustl::flat_set<int> set_type;
+        set_type a;
+        a.insert(1);
+        a.insert(5);
+        const int batch[] = {3};
+        a.insert(batch, batch + 1);
+        const set_type& ca = a;
+        CHECK(ca.size() == 3 && ca.contains(3) && *ca.find(3) == 3);
+        CHECK(*ca.lower_bound(2) == 3 && *ca.upper_bound(3) == 5);
+        CHECK(std::distance(ca.begin(), ca.end()) == 3);
+
+        set_type b;
+        b.insert(1);
+        b.insert(2);
+        b.insert(4);
+        const set_type& cb = b;
+        CHECK(ca != cb && cb < ca && ca > cb);
+
+        // const 的有序区间算法直接用 begin / end，结果包括批量插入的元素
+        std::vector<int> out(8);
+        CHECK(mabustl::set_union(ca.begin(), ca.end(), cb.begin(), cb.end(), out.data()) - out.data() == 5);
+        CHECK(out[0] == 1 && out[1] == 2 && out[2] == 3 && out[3] == 4 && out[4] == 5);
+        CHECK(mabustl::set_intersection(ca.begin(), ca.end(), cb.begin(), cb.end(), out.data()) - out.data() == 1);
+        CHECK(out[0] == 1);
+
+        for(int round = 0; round != 20000; ++round) {
+            set_type s, t;
+            std::set<int> es, et;
+            const int key_range = 1 + static_cast<int>(rand_below(6));
+            fill_random(s, es, key_range);
+            fill_random(t, et, key_range);
+            const set_type& cs = s;
+            const set_type& ct = t;
+            CHECK((cs == ct) == (es == et));
+            CHECK((cs != ct) == (es != et));
+            CHECK((cs < ct) == (es < et));
+            CHECK((cs <= ct) == (es <= et));
+            CHECK((cs > ct) == (es > et));
+            CHECK((cs >= ct) == (es >= et));
+            std::vector<int> expect_union, expect_inter;
+            std::set_union(es.begin(), es.end(), et.begin(), et.end(), std::back_inserter(expect_union));
+            std::set_intersection(es.begin(), es.end(), et.begin(), et.end(), std::back_inserter(expect_inter));
+            const size_t union_size = mabustl::set_union(cs.begin(), cs.end(), ct.begin(), ct.end(),
+                                                         out.data()) - out.data();
+            CHECK(std::vector<int>(out.begin(), out.begin() + union_size) == expect_union);
+            const size_t inter_size = mabustl::set_intersection(cs.begin(), cs.end(), ct.begin(), ct.end(),
+                                                                out.data()) - out.data();
+            CHECK(std::vector<int>(out.begin(), out.begin() + inter_size) == expect_inter);
+            CHECK(same_set(s, es) && same_set(t, et));
+        }
+
+        // key 已存在时保留原来的元素，同一批中重复的 key 保留靠前的元素
+        typedef mabustl::flat_map<int, int> map_type;
+        map_type m, n;
+        m.insert(mabustl::make_pair(1, 10));
+        const map_type::value_type pairs[] = {mabustl::make_pair(1, 11), mabustl::make_pair(2, 20),
+                                              mabustl::make_pair(2, 21)};
+        m.insert(pairs, pairs + 3);
+        n.insert(mabustl::make_pair(1, 10));
+        n.insert(mabustl::make_pair(2, 20));
+        const map_type& cm = m;
+        const map_type& cn = n;
+        CHECK(cm.size() == 2 && cm.at(1) == 10 && cm.at(2) == 20);
+        CHECK(cm == cn && !(cm < cn) && !(cn < cm));
+        n[2] = 19;
+        CHECK(cm != cn && cn < cm);
+    }
+
+    // 统计比较和移动的次数
+    size_t compares = 0;
+    size_t moves = 0;
+
+    struct counted_key {
+        int value;
+
+        counted_key(int v): value(v) {}
+        counted_key(const counted_key& rhs): value(rhs.value) { ++moves; }
+        counted_key& operator=(const counted_key& rhs) {
+            value = rhs.value;
+            ++moves;
+            return *this;
+        }
+    };
+
+    struct counting_less {
+        bool operator()(const counted_key& lhs, const counted_key& rhs) const {
+            ++compares;
+            return lhs.value < rhs.value;
+        }
+    };
+
+    void test_batch_cost() {
+        const size_t n = 100000;
+        const size_t k = 1000;
+        typedef mabustl::flat_set<counted_key, counting_less> set_type;
+        set_type s;
+        s.reserve(n + k);
+        std::vector<counted_key> initial;
+        for(size_t i = 0; i != n; ++i) initial.push_back(counted_key(static_cast<int>(2 * i)));
+        s.insert(initial.data(), initial.data() + n);
+        CHECK(s.size() == n);
+
+        std::vector<int> batch(k);
+        std::vector<counted_key> values;
+        for(size_t i = 0; i != k; ++i) {
+            batch[i] = static_cast<int>(2 * rand_below(n) + 1);
+            values.push_back(counted_key(batch[i]));
+        }
+        compares = 0;
+        moves = 0;
+        s.insert(values.data(), values.data() + k);
+        const double bound = static_cast<double>(n + k) + k * std::log2(static_cast<double>(k));
+        CHECK(compares <= 2 * bound);
+        CHECK(moves <= 3 * bound);
+        CHECK(moves < n * k / 100);
+
+        std::sort(batch.begin(), batch.end());
+        batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+        CHECK(s.size() == n + batch.size());
+        int last = -1;
+        for(set_type::iterator it = s.begin(); it != s.end(); ++it) {
+            CHECK(it->value > last);
+            last = it->value;
+        }
+    }
+}
+
+int main() {
+    test_set<mabustl::less<int>, std::less<int> >(5000, 20000);
+    test_set<mabustl::greater<int>, std::greater<int> >(200, 20000);
+    test_map(20000);
+    test_range_construct();
+    test_batch_visible();
+    test_batch_cost();
+    return mabustl_test::pass("test_flat_map");
+}
@@ -0,0 +1,159 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * hash_bytes / hash_mix / hash_combine
+ * (1)hash_bytes 只取决于内容、长度和 seed，与起始地址的对齐无关
+ * (2)雪崩：随机输入翻转任意一位，平均约一半的输出位翻转(hash_bytes 的各种长度、hash_mix、mixed_hash)
+ * (3)随机的不同输入没有哈希冲突
+ * (4)pair / std::pair / std::tuple 的哈希与 hash_values 一致并且与顺序有关；+0.0 和 -0.0 的哈希相同
+ * (5)作为 std::unordered_map 的 Hash 参数，与使用 std::hash 的 std::unordered_map 逐步比较
+ */
+
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "mabu_functional.h"
+#include "mabu_utility.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    int popcount(uint64_t x) {
+        return __builtin_popcountll(x);
+    }
+
+    std::vector<unsigned char> random_bytes(size_t len) {
+        std::vector<unsigned char> bytes(len + 1);
+        for(size_t i = 0; i != len; ++i) bytes[i] = static_cast<unsigned char>(rand_below(256));
+        return bytes;
+    }
+
+    void test_alignment() {
+        for(size_t len = 0; len != 300; ++len) {
+            const std::vector<unsigned char> bytes = random_bytes(len);
+            const uint64_t seed = mabustl_test::rng()();
+            const uint64_t expect = mabustl::hash_bytes64(bytes.data(), len, seed);
+            unsigned char buffer[320];
+            for(size_t offset = 1; offset != 16; ++offset) {
+                std::memcpy(buffer + offset, bytes.data(), len);
+                CHECK(mabustl::hash_bytes64(buffer + offset, len, seed) == expect);
+            }
+            if(len != 0) CHECK(mabustl::hash_bytes64(bytes.data(), len, seed + 1) != expect);
+        }
+    }
+
+    // 每个输入位翻转时平均翻转的输出位数应接近 32
+    void test_avalanche() {
+        const size_t lengths[] = {1, 3, 4, 7, 8, 9, 16, 17, 33, 48, 49, 100, 200};
+        for(size_t l = 0; l != sizeof(lengths) / sizeof(lengths[0]); ++l) {
+            const size_t len = lengths[l];
+            std::vector<long long> flips(len * 8);
+            const int samples = 200;
+            for(int s = 0; s != samples; ++s) {
+                std::vector<unsigned char> bytes = random_bytes(len);
+                const uint64_t base = mabustl::hash_bytes64(bytes.data(), len);
+                for(size_t bit = 0; bit != len * 8; ++bit) {
+                    bytes[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+                    flips[bit] += popcount(base ^ mabustl::hash_bytes64(bytes.data(), len));
+                    bytes[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+                }
+            }
+            for(size_t bit = 0; bit != len * 8; ++bit) {
+                const double mean = static_cast<double>(flips[bit]) / samples;
+                CHECK(mean > 29.0 && mean < 35.0);
+            }
+        }
+
+        std::vector<long long> flips(64);
+        const int samples = 2000;
+        for(int s = 0; s != samples; ++s) {
+            const uint64_t x = mabustl_test::rng()();
+            const uint64_t base = mabustl::hash_mix(x);
+            CHECK(mabustl::mixed_hash<uint64_t>()(x) == base);
+            for(size_t bit = 0; bit != 64; ++bit) flips[bit] += popcount(base ^ mabustl::hash_mix(x ^ (1ULL << bit)));
+        }
+        for(size_t bit = 0; bit != 64; ++bit) {
+            const double mean = static_cast<double>(flips[bit]) / samples;
+            CHECK(mean > 31.0 && mean < 33.0);
+        }
+    }
+
+    void test_collisions() {
+        std::unordered_set<std::string> inputs;
+        std::unordered_set<uint64_t> hashes;
+        while(inputs.size() != 100000) {
+            std::string s(rand_below(24), ' ');
+            for(size_t i = 0; i != s.size(); ++i) s[i] = static_cast<char>('a' + rand_below(4));
+            if(!inputs.insert(s).second) continue;
+            CHECK(hashes.insert(mabustl::hash_bytes64(s.data(), s.size())).second);
+        }
+
+        // 步长为 2 的幂的整数
+        hashes.clear();
+        for(uint64_t i = 0; i != 100000; ++i) CHECK(hashes.insert(mabustl::hash_mix(i << 20)).second);
+    }
+
+    void test_combine() {
+        typedef mabustl::hash<mabustl::pair<int, long long> > pair_hash;
+        typedef mabustl::hash<std::pair<int, long long> > std_pair_hash;
+        typedef mabustl::hash<std::tuple<int, long long, double> > tuple_hash;
+        for(int round = 0; round != 1000; ++round) {
+            const int a = static_cast<int>(rand_below(1000));
+            const long long b = static_cast<long long>(rand_below(1000)) + 1000;
+            const double c = static_cast<double>(rand_below(1000)) / 7;
+            CHECK(pair_hash()(mabustl::make_pair(a, b)) == mabustl::hash_values(a, b));
+            CHECK(std_pair_hash()(std::make_pair(a, b)) == mabustl::hash_values(a, b));
+            CHECK(tuple_hash()(std::make_tuple(a, b, c)) == mabustl::hash_values(a, b, c));
+            CHECK(mabustl::hash_values(a, b) != mabustl::hash_values(b, a));
+
+            size_t seed = 0;
+            mabustl::hash_combine(seed, b);
+            mabustl::hash_combine(seed, a);
+            CHECK(seed == mabustl::hash_values(a, b));
+        }
+        CHECK(mabustl::hash<double>()(0.0) == mabustl::hash<double>()(-0.0));
+        CHECK(mabustl::hash<float>()(0.0f) == mabustl::hash<float>()(-0.0f));
+        CHECK(mabustl::hash<long double>()(0.0L) == mabustl::hash<long double>()(-0.0L));
+        CHECK(mabustl::hash<long double>()(1.5L) == mabustl::hash<long double>()(3.0L / 2));
+    }
+
+    struct int_pair_hash {
+        size_t operator()(const std::pair<int, int>& p) const {
+            return std::hash<long long>()((static_cast<long long>(p.first) << 32) ^ p.second);
+        }
+    };
+
+    void test_with_unordered_map() {
+        std::unordered_map<std::pair<int, int>, int, mabustl::hash<std::pair<int, int> > > actual;
+        std::unordered_map<std::pair<int, int>, int, int_pair_hash> expect;
+        for(int step = 0; step != 200000; ++step) {
+            const std::pair<int, int> key(static_cast<int>(rand_below(300)), static_cast<int>(rand_below(300)));
+            if(rand_below(3) == 0) {
+                CHECK(actual.erase(key) == expect.erase(key));
+            } else {
+                actual[key] += step;
+                expect[key] += step;
+            }
+            CHECK(actual.size() == expect.size());
+        }
+        for(auto it = expect.begin(); it != expect.end(); ++it) CHECK(actual.at(it->first) == it->second);
+    }
+}
+
+int main() {
+    test_alignment();
+    test_avalanche();
+    test_collisions();
+    test_combine();
+    test_with_unordered_map();
+    return mabustl_test::pass("test_hash");
+}
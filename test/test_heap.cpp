@@ -0,0 +1,168 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * push_heap / pop_heap / make_heap / sort_heap / is_heap_until / priority_queue
+ * (1)随机数组上与 std 的对应算法比较：is_heap_until 的结果相同，make_heap 后 std::is_heap 成立，
+ *    逐个 pop_heap 得到的序列与排序结果相同，sort_heap 与 std::sort 相同(默认比较和 greater)
+ * (2)只能移动的元素(std::unique_ptr)可以建堆、入堆、出堆和排序
+ * (3)priority_queue 的随机操作与 std::priority_queue 比较；push_range 到空队列只用 O(n) 次比较，
+ *    prefer_make_heap 在追加的元素多时选择整体重建
+ */
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "mabu_functional.h"
+#include "mabu_heap_algorithm.h"
+#include "mabu_queue.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    std::vector<int> random_ints(size_t n, size_t range) {
+        std::vector<int> v(n);
+        for(size_t i = 0; i != n; ++i) v[i] = static_cast<int>(rand_below(range));
+        return v;
+    }
+
+    template<class Compare, class StdCompare>
+    void test_algorithms(Compare comp, StdCompare std_comp) {
+        for(int round = 0; round != 2000; ++round) {
+            std::vector<int> v = random_ints(rand_below(200), rand_below(2) == 0 ? 10 : 100000);
+            int* first = v.data();
+            int* last = v.data() + v.size();
+
+            // 随机数组以及在堆上做少量改动的数组
+            std::vector<int> almost(v);
+            std::make_heap(almost.begin(), almost.end(), std_comp);
+            if(!almost.empty()) almost[rand_below(almost.size())] = static_cast<int>(rand_below(100000));
+            CHECK(mabustl::is_heap_until(first, last, comp) - first ==
+                  std::is_heap_until(v.begin(), v.end(), std_comp) - v.begin());
+            CHECK(mabustl::is_heap_until(almost.data(), almost.data() + almost.size(), comp) - almost.data() ==
+                  std::is_heap_until(almost.begin(), almost.end(), std_comp) - almost.begin());
+
+            std::vector<int> sorted(v);
+            std::sort(sorted.begin(), sorted.end(), std_comp);
+
+            mabustl::make_heap(first, last, comp);
+            CHECK(std::is_heap(v.begin(), v.end(), std_comp));
+            CHECK(mabustl::is_heap(first, last, comp));
+
+            // 逐个出堆，得到从大到小的序列
+            for(int* end = last; end != first; --end) {
+                mabustl::pop_heap(first, end, comp);
+                CHECK(std::is_heap(first, end - 1, std_comp));
+            }
+            CHECK(std::equal(v.begin(), v.end(), sorted.begin()));
+
+            // 逐个入堆后排序
+            std::vector<int> w = random_ints(rand_below(200), 1000);
+            for(size_t i = 1; i <= w.size(); ++i) {
+                mabustl::push_heap(w.data(), w.data() + i, comp);
+                CHECK(std::is_heap(w.begin(), w.begin() + i, std_comp));
+            }
+            std::vector<int> w_sorted(w);
+            std::sort(w_sorted.begin(), w_sorted.end(), std_comp);
+            mabustl::sort_heap(w.data(), w.data() + w.size(), comp);
+            CHECK(w == w_sorted);
+        }
+    }
+
+    struct ptr_less {
+        bool operator()(const std::unique_ptr<std::string>& a, const std::unique_ptr<std::string>& b) const {
+            return *a < *b;
+        }
+    };
+
+    void test_move_only() {
+        for(int round = 0; round != 200; ++round) {
+            const size_t n = rand_below(100);
+            std::vector<std::unique_ptr<std::string> > v;
+            std::vector<std::string> expect;
+            for(size_t i = 0; i != n; ++i) {
+                expect.push_back(std::to_string(rand_below(1000)));
+                v.push_back(std::unique_ptr<std::string>(new std::string(expect.back())));
+            }
+            std::sort(expect.begin(), expect.end());
+
+            std::unique_ptr<std::string>* first = v.data();
+            mabustl::make_heap(first, first + n, ptr_less());
+            if(n != 0) {
+                mabustl::pop_heap(first, first + n, ptr_less());
+                mabustl::push_heap(first, first + n, ptr_less());
+            }
+            mabustl::sort_heap(first, first + n, ptr_less());
+            for(size_t i = 0; i != n; ++i) CHECK(v[i] && *v[i] == expect[i]);
+        }
+    }
+
+    long long comparisons = 0;
+
+    struct counting_less {
+        bool operator()(int a, int b) const {
+            ++comparisons;
+            return a < b;
+        }
+    };
+
+    template<class Compare, class StdCompare>
+    void test_priority_queue() {
+        mabustl::priority_queue<int, mabustl::vector<int>, Compare> actual;
+        std::priority_queue<int, std::vector<int>, StdCompare> expect;
+        for(int step = 0; step != 100000; ++step) {
+            const size_t op = rand_below(8);
+            if(op < 3) {
+                const int value = static_cast<int>(rand_below(10000));
+                actual.push(value);
+                expect.push(value);
+            } else if(op == 3) {
+                const int value = static_cast<int>(rand_below(10000));
+                actual.emplace(value);
+                expect.emplace(value);
+            } else if(op == 4 && rand_below(8) == 0) {
+                const std::vector<int> values = random_ints(rand_below(rand_below(2) == 0 ? 8 : 500), 10000);
+                actual.push_range(values.data(), values.data() + values.size());
+                for(size_t i = 0; i != values.size(); ++i) expect.push(values[i]);
+            } else if(!expect.empty()) {
+                actual.pop();
+                expect.pop();
+            }
+            CHECK(actual.size() == expect.size());
+            if(!expect.empty()) CHECK(actual.top() == expect.top());
+        }
+    }
+
+    void test_push_range_linear() {
+        const size_t n = 1 << 16;
+        const std::vector<int> values = random_ints(n, 1000000);
+        mabustl::priority_queue<int, mabustl::vector<int>, counting_less> q;
+        comparisons = 0;
+        q.push_range(values.data(), values.data() + n);
+        CHECK(comparisons <= static_cast<long long>(2 * n));
+        CHECK(q.top() == *std::max_element(values.begin(), values.end()));
+
+        // 空堆追加时整体重建，大堆追加少量元素时逐个上溯；叉数越大上溯越便宜
+        CHECK(mabustl::prefer_make_heap<size_t>(0, n));
+        CHECK(!mabustl::prefer_make_heap<size_t>(n, n + 1));
+        CHECK(mabustl::prefer_make_heap<size_t>(n, 2 * n));
+        CHECK(mabustl::prefer_make_heap<size_t>(n / 2, n, 2) && !mabustl::prefer_make_heap<size_t>(n / 2, n, 64));
+    }
+}
+
+int main() {
+    test_algorithms(mabustl::less<int>(), std::less<int>());
+    test_algorithms(mabustl::greater<int>(), std::greater<int>());
+    test_move_only();
+    test_priority_queue<mabustl::less<int>, std::less<int> >();
+    test_priority_queue<mabustl::greater<int>, std::greater<int> >();
+    test_push_range_linear();
+    return mabustl_test::pass("test_heap");
+}
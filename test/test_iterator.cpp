@@ -0,0 +1,144 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * mabu_iterator.h / mabu_algorithm_base.h 中被容器依赖的基础部分
+ * (1)iterator 和 iterator_traits(包括 T* 与 const T* 的特化)的成员类型，difference_type 的拼写
+ * (2)reverse_iterator 的比较和相减，与 std::reverse_iterator 逐一比较
+ * (3)lexicographical_compare(通用版本、带比较函数的版本和 unsigned char 的 memcmp 版本)与 std 比较
+ * (4)copy / copy_backward / move_backward 在指针区间上(包括重叠)与 std 比较；move_iterator 移动而不复制
+ */
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "mabu_algorithm_base.h"
+#include "mabu_functional.h"
+#include "mabu_iterator.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    typedef mabustl::iterator<mabustl::forward_iterator_tag, int, long> custom_iterator;
+    static_assert(std::is_same<custom_iterator::difference_type, long>::value, "iterator::difference_type");
+    static_assert(std::is_same<mabustl::iterator_traits<int*>::difference_type, ptrdiff_t>::value, "T*");
+    static_assert(std::is_same<mabustl::iterator_traits<int*>::reference, int&>::value, "T*");
+    static_assert(std::is_same<mabustl::iterator_traits<int*>::iterator_category,
+                               mabustl::random_access_iterator_tag>::value, "T*");
+    static_assert(std::is_same<mabustl::iterator_traits<const int*>::value_type, int>::value, "const T*");
+    static_assert(std::is_same<mabustl::iterator_traits<const int*>::pointer, const int*>::value, "const T*");
+    static_assert(std::is_same<mabustl::iterator_traits<const int*>::reference, const int&>::value, "const T*");
+    static_assert(std::is_same<mabustl::iterator_traits<mabustl::reverse_iterator<int*> >::difference_type,
+                               ptrdiff_t>::value, "reverse_iterator");
+    static_assert(mabustl::is_random_access_iterator<const char*>::value, "const T*");
+
+    void test_reverse_iterator() {
+        int data[64];
+        for(int round = 0; round != 10000; ++round) {
+            int* a = data + rand_below(65);
+            int* b = data + rand_below(65);
+            const mabustl::reverse_iterator<int*> ma(a), mb(b);
+            const std::reverse_iterator<int*> sa(a), sb(b);
+            CHECK((ma == mb) == (sa == sb));
+            CHECK((ma != mb) == (sa != sb));
+            CHECK((ma < mb) == (sa < sb));
+            CHECK((ma > mb) == (sa > sb));
+            CHECK((ma <= mb) == (sa <= sb));
+            CHECK((ma >= mb) == (sa >= sb));
+            CHECK(ma - mb == sa - sb);
+        }
+    }
+
+    template<class T>
+    std::vector<T> random_sequence(size_t alphabet) {
+        std::vector<T> v(rand_below(6));
+        for(size_t i = 0; i != v.size(); ++i) v[i] = static_cast<T>(rand_below(alphabet));
+        return v;
+    }
+
+    void test_lexicographical_compare() {
+        for(int round = 0; round != 20000; ++round) {
+            const std::vector<int> a = random_sequence<int>(3), b = random_sequence<int>(3);
+            const int* a0 = a.data();
+            const int* b0 = b.data();
+            CHECK(mabustl::lexicographical_compare(a0, a0 + a.size(), b0, b0 + b.size()) ==
+                  std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end()));
+            CHECK(mabustl::lexicographical_compare(a0, a0 + a.size(), b0, b0 + b.size(), mabustl::greater<int>()) ==
+                  std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), std::greater<int>()));
+
+            // unsigned char 走 memcmp，包括高位为 1 的字节
+            const std::vector<unsigned char> c = random_sequence<unsigned char>(256);
+            const std::vector<unsigned char> d = rand_below(2) == 0 ? c : random_sequence<unsigned char>(256);
+            const unsigned char* c0 = c.data();
+            const unsigned char* d0 = d.data();
+            CHECK(mabustl::lexicographical_compare(c0, c0 + c.size(), d0, d0 + d.size()) ==
+                  std::lexicographical_compare(c.begin(), c.end(), d.begin(), d.end()));
+        }
+    }
+
+    template<class T>
+    T make(size_t i) {
+        return static_cast<T>(i);
+    }
+
+    template<>
+    std::string make<std::string>(size_t i) {
+        return std::string(i % 40, static_cast<char>('a' + i % 26));
+    }
+
+    template<class T>
+    void test_copy_backward() {
+        for(int round = 0; round != 5000; ++round) {
+            std::vector<T> actual(64), expect(64);
+            for(size_t i = 0; i != actual.size(); ++i) actual[i] = expect[i] = make<T>(i);
+            const size_t first = rand_below(64);
+            const size_t last = first + rand_below(64 - first + 1);
+            const size_t n = last - first;
+            T* p = actual.data();
+            if(rand_below(2) == 0) {
+                // 向后移动，区间可能重叠
+                const size_t result = last + rand_below(64 - last + 1);
+                CHECK(mabustl::copy_backward(p + first, p + last, p + result) == p + result - n);
+                std::copy_backward(expect.begin() + first, expect.begin() + last, expect.begin() + result);
+            } else {
+                const size_t result = rand_below(first + 1);
+                CHECK(mabustl::copy(p + first, p + last, p + result) == p + result + n);
+                std::copy(expect.begin() + first, expect.begin() + last, expect.begin() + result);
+            }
+            CHECK(actual == expect);
+        }
+    }
+
+    void test_move_iterator() {
+        std::vector<std::string> src(10, std::string(40, 'x'));
+        std::vector<std::string> dst(10);
+        std::string* first = src.data();
+        mabustl::copy(mabustl::move_iterator<std::string*>(first), mabustl::move_iterator<std::string*>(first + 10),
+                      dst.data());
+        for(size_t i = 0; i != 10; ++i) {
+            CHECK(dst[i] == std::string(40, 'x'));
+            CHECK(src[i].empty());
+        }
+
+        std::vector<std::string> tail(src.size());
+        for(size_t i = 0; i != tail.size(); ++i) tail[i] = std::to_string(i);
+        mabustl::move_backward(tail.data(), tail.data() + 5, tail.data() + 10);
+        for(size_t i = 5; i != 10; ++i) CHECK(tail[i] == std::to_string(i - 5));
+    }
+}
+
+int main() {
+    test_reverse_iterator();
+    test_lexicographical_compare();
+    test_copy_backward<int>();
+    test_copy_backward<std::string>();
+    test_move_iterator();
+    return mabustl_test::pass("test_iterator");
+}
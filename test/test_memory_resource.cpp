@@ -0,0 +1,157 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * monotonic_buffer_resource / unsynchronized_pool_resource / polymorphic_allocator
+ * (1)随机大小、随机对齐地分配和回收，检查对齐和块之间没有重叠
+ * (2)上游是计数的内存资源，release 或析构之后向上游申请的内存全部归还
+ * (3)以 polymorphic_allocator 作为 std::list 的 allocator，随机操作后与 std::list 比较
+ */
+
+#include <list>
+#include <vector>
+
+#include "mabu_memory.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+using mabustl_test::tagged_block;
+
+namespace {
+    // 转交给 new_delete_resource，并记录尚未归还的字节数
+    class counting_resource : public mabustl::memory_resource {
+    public:
+        counting_resource(): live_bytes(0), allocations(0) {}
+
+        long long live_bytes;
+        long long allocations;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            live_bytes += static_cast<long long>(bytes);
+            ++allocations;
+            return mabustl::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+            live_bytes -= static_cast<long long>(bytes);
+            mabustl::new_delete_resource()->deallocate(ptr, bytes, alignment);
+        }
+
+        bool do_is_equal(const mabustl::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    size_t random_alignment() {
+        return size_t(1) << rand_below(8);  // 1 ~ 128
+    }
+
+    size_t random_bytes() {
+        return rand_below(10) == 0 ? 4096 + rand_below(20000) : 1 + rand_below(600);
+    }
+
+    void test_monotonic() {
+        counting_resource upstream;
+        unsigned char buffer[512];
+        {
+            mabustl::monotonic_buffer_resource mono(buffer, sizeof(buffer), &upstream);
+            for(int round = 0; round != 4; ++round) {
+                std::vector<tagged_block> live;
+                for(int i = 0; i != 2000; ++i) {
+                    const size_t n = random_bytes();
+                    const size_t alignment = random_alignment();
+                    void* p = mono.allocate(n, alignment);
+                    CHECK(mabustl_test::aligned_to(p, alignment));
+                    live.push_back(mabustl_test::make_block(p, n, static_cast<unsigned char>(i)));
+                    if(rand_below(4) == 0) mono.deallocate(p, n, alignment);  // 不会真正回收
+                }
+                for(size_t i = 0; i != live.size(); ++i) CHECK(mabustl_test::intact(live[i]));
+                mono.release();
+                CHECK(upstream.live_bytes == 0);
+            }
+
+            // release 之后先使用初始 buffer
+            const long long before = upstream.allocations;
+            void* p = mono.allocate(16, 8);
+            CHECK(p >= static_cast<void*>(buffer) && p < static_cast<void*>(buffer + sizeof(buffer)));
+            CHECK(upstream.allocations == before);
+            mono.allocate(10000, 8);
+        }
+        CHECK(upstream.live_bytes == 0);
+    }
+
+    void test_pool() {
+        counting_resource upstream;
+        {
+            mabustl::unsynchronized_pool_resource pool(&upstream);
+            std::vector<tagged_block> live;
+            std::vector<size_t> alignments;
+            for(int step = 0; step != 100000; ++step) {
+                if(live.empty() || rand_below(5) < 3) {
+                    const size_t n = random_bytes();
+                    const size_t alignment = random_alignment();
+                    void* p = pool.allocate(n, alignment);
+                    CHECK(mabustl_test::aligned_to(p, alignment));
+                    live.push_back(mabustl_test::make_block(p, n, static_cast<unsigned char>(step)));
+                    alignments.push_back(alignment);
+                } else {
+                    const size_t i = rand_below(live.size());
+                    CHECK(mabustl_test::intact(live[i]));
+                    pool.deallocate(live[i].ptr, live[i].n, alignments[i]);
+                    live[i] = live.back();
+                    live.pop_back();
+                    alignments[i] = alignments.back();
+                    alignments.pop_back();
+                }
+            }
+            for(size_t i = 0; i != live.size(); ++i) CHECK(mabustl_test::intact(live[i]));
+
+            // 没有 deallocate 的块也由 release 归还
+            pool.release();
+            CHECK(upstream.live_bytes == 0);
+            pool.allocate(100);
+            pool.allocate(100000);
+        }
+        CHECK(upstream.live_bytes == 0);
+    }
+
+    void test_std_list() {
+        mabustl::unsynchronized_pool_resource pool;
+        std::list<int> expect;
+        std::list<int, mabustl::polymorphic_allocator<int> > actual(
+            (mabustl::polymorphic_allocator<int>(&pool)));
+        for(int step = 0; step != 100000; ++step) {
+            const int value = static_cast<int>(rand_below(1000));
+            switch(rand_below(4)) {
+            case 0:
+                expect.push_back(value);
+                actual.push_back(value);
+                break;
+            case 1:
+                expect.push_front(value);
+                actual.push_front(value);
+                break;
+            default:
+                if(!expect.empty()) {
+                    CHECK(expect.front() == actual.front());
+                    expect.pop_front();
+                    actual.pop_front();
+                }
+                break;
+            }
+        }
+        CHECK(expect.size() == actual.size());
+        CHECK(std::equal(expect.begin(), expect.end(), actual.begin()));
+        CHECK(actual.get_allocator().resource() == &pool);
+    }
+}
+
+int main() {
+    test_monotonic();
+    test_pool();
+    test_std_list();
+    return mabustl_test::pass("test_memory_resource");
+}
@@ -0,0 +1,98 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * mmap_alloc / huge_page_alloc / 带预取缺页的 basic_mmap_alloc
+ * (1)随机大小(阈值两侧都有)地分配和回收，检查块之间没有重叠，huge_page_alloc 的映射按大页对齐
+ * (2)allocate_at_least 得到的整段空间都可以写入；try_expand 成功后新增的部分可以写入，按新大小回收
+ * (3)以 huge_page_allocator 作为 std::vector 的 allocator，随机操作后与 std::vector 比较
+ */
+
+#include <vector>
+
+#include "mabu_allocator.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+using mabustl_test::tagged_block;
+
+namespace {
+    typedef mabustl::basic_mmap_alloc<false, true, 4096> prefault_alloc;
+
+    template<class Backend>
+    void test_blocks(size_t threshold, size_t map_alignment) {
+        std::vector<tagged_block> live;
+        for(int step = 0; step != 100; ++step) {
+            if(live.size() < 8 && (live.empty() || rand_below(2) == 0)) {
+                // 一半略小于阈值，一半不小于阈值
+                const size_t n = rand_below(2) == 0 ? threshold - 1 - rand_below(threshold / 2)
+                                                    : threshold + rand_below(threshold);
+                void* p = Backend::allocate(n);
+                if(n >= threshold) CHECK(mabustl_test::aligned_to(p, map_alignment));
+                live.push_back(mabustl_test::make_block(p, n, static_cast<unsigned char>(step)));
+            } else {
+                const size_t i = rand_below(live.size());
+                CHECK(mabustl_test::intact(live[i]));
+                Backend::deallocate(live[i].ptr, live[i].n);
+                live[i] = live.back();
+                live.pop_back();
+            }
+        }
+        for(size_t i = 0; i != live.size(); ++i) {
+            CHECK(mabustl_test::intact(live[i]));
+            Backend::deallocate(live[i].ptr, live[i].n);
+        }
+    }
+
+    template<class Backend>
+    void test_at_least_and_expand(size_t threshold) {
+        for(int round = 0; round != 20; ++round) {
+            const size_t n = threshold + rand_below(threshold);
+            size_t usable = 0;
+            void* p = Backend::allocate_at_least(n, usable);
+            CHECK(usable >= n);
+            tagged_block b = mabustl_test::make_block(p, usable, static_cast<unsigned char>(round));
+
+            const size_t new_n = usable + rand_below(2 * threshold);
+            if(Backend::try_expand(p, usable, new_n)) {
+                CHECK(mabustl_test::intact(b));
+                b = mabustl_test::make_block(p, new_n, static_cast<unsigned char>(round + 1));
+            }
+            CHECK(mabustl_test::intact(b));
+            Backend::deallocate(b.ptr, b.n);
+        }
+        // 缩小总是失败，相同大小总是成功
+        void* p = Backend::allocate(threshold);
+        CHECK(!Backend::try_expand(p, threshold, threshold - 1));
+        CHECK(Backend::try_expand(p, threshold, threshold));
+        Backend::deallocate(p, threshold);
+    }
+
+    void test_std_vector() {
+        std::vector<long long> expect;
+        std::vector<long long, mabustl::huge_page_allocator<long long> > actual;
+        for(int step = 0; step != 1000000; ++step) {
+            if(expect.empty() || rand_below(4) != 0) {
+                expect.push_back(step);
+                actual.push_back(step);
+            } else {
+                expect.pop_back();
+                actual.pop_back();
+            }
+        }
+        CHECK(expect == std::vector<long long>(actual.begin(), actual.end()));
+    }
+}
+
+int main() {
+    test_blocks<mabustl::mmap_alloc>(mabustl::MMAP_THRESHOLD, 4096);
+    test_blocks<mabustl::huge_page_alloc>(mabustl::HUGE_PAGE_SIZE, mabustl::HUGE_PAGE_SIZE);
+    test_blocks<prefault_alloc>(4096, 4096);
+    test_at_least_and_expand<mabustl::mmap_alloc>(mabustl::MMAP_THRESHOLD);
+    test_at_least_and_expand<mabustl::huge_page_alloc>(mabustl::HUGE_PAGE_SIZE);
+    test_at_least_and_expand<prefault_alloc>(4096);
+    test_std_vector();
+    return mabustl_test::pass("test_mmap_alloc");
+}
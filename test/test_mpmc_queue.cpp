@@ -0,0 +1,159 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * mpmc_queue
+ * (1)单线程上 try_push / try_emplace / try_pop 的随机操作，与 std::deque 逐步比较，满(空)时返回 false
+ * (2)多个生产者和多个消费者，阻塞版本与 try 版本混用：每个元素恰好被取出一次，
+ *    同一个消费者看到的同一个生产者的元素保持入队的顺序
+ * (3)析构时销毁剩余的元素
+ */
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mabu_mpmc_queue.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    std::string make_value(size_t i) {
+        return std::to_string(i) + std::string(24 + i % 16, static_cast<char>('a' + i % 26));
+    }
+
+    void test_single_thread(size_t capacity) {
+        mabustl::mpmc_queue<std::string> q(capacity);
+        CHECK(q.capacity() >= capacity && q.capacity() >= 2);
+        std::deque<std::string> expect;
+        size_t next = 0;
+        for(int step = 0; step != 50000; ++step) {
+            const size_t op = rand_below(3);
+            if(op == 0) {
+                const bool ok = q.try_push(make_value(next));
+                CHECK(ok == (expect.size() < q.capacity()));
+                if(ok) expect.push_back(make_value(next));
+                ++next;
+            } else if(op == 1) {
+                // 按 (n, c) 构造，构造可能抛异常，走先构造再抢槽的路径
+                const size_t n = 1 + next % 40;
+                const bool ok = q.try_emplace(n, 'x');
+                CHECK(ok == (expect.size() < q.capacity()));
+                if(ok) expect.push_back(std::string(n, 'x'));
+                ++next;
+            } else {
+                std::string value;
+                const bool ok = q.try_pop(value);
+                CHECK(ok == !expect.empty());
+                if(ok) {
+                    CHECK(value == expect.front());
+                    expect.pop_front();
+                }
+            }
+            CHECK(q.size() == expect.size());
+            CHECK(q.empty() == expect.empty());
+        }
+    }
+
+    // 元素的高 32 位是生产者编号，低 32 位是该生产者的序号
+    typedef unsigned long long item;
+
+    void test_threads(size_t capacity, size_t producers, size_t consumers, size_t per_producer) {
+        mabustl::mpmc_queue<item> q(capacity);
+        const size_t total = producers * per_producer;
+        std::atomic<size_t> taken(0);
+        std::vector<std::vector<item> > received(consumers);
+
+        std::vector<std::thread> threads;
+        for(size_t p = 0; p != producers; ++p) {
+            threads.emplace_back([&q, p, per_producer] {
+                for(size_t i = 0; i != per_producer; ++i) {
+                    const item value = (static_cast<item>(p) << 32) | i;
+                    // 偶数编号的生产者用阻塞版本，奇数编号的用 try 版本并在失败时让出
+                    if(p % 2 == 0) {
+                        q.push(value);
+                    } else {
+                        while(!q.try_push(value)) std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for(size_t c = 0; c != consumers; ++c) {
+            threads.emplace_back([&q, &taken, &received, c, total] {
+                // 先占一个名额再取，保证所有消费者取出的元素总数恰好是 total，阻塞的 pop 不会永远等下去
+                while(taken.fetch_add(1) < total) {
+                    item value;
+                    if(c % 2 == 0) {
+                        q.pop(value);
+                    } else {
+                        while(!q.try_pop(value)) std::this_thread::yield();
+                    }
+                    received[c].push_back(value);
+                }
+            });
+        }
+        for(size_t i = 0; i != threads.size(); ++i) threads[i].join();
+        CHECK(q.empty());
+
+        std::vector<item> all;
+        for(size_t c = 0; c != consumers; ++c) {
+            std::vector<item> last(producers, ~item(0));
+            for(size_t i = 0; i != received[c].size(); ++i) {
+                const item value = received[c][i];
+                const size_t p = static_cast<size_t>(value >> 32);
+                CHECK(p < producers);
+                CHECK(last[p] == ~item(0) || last[p] < value);
+                last[p] = value;
+            }
+            all.insert(all.end(), received[c].begin(), received[c].end());
+        }
+        CHECK(all.size() == total);
+        std::sort(all.begin(), all.end());
+        for(size_t p = 0; p != producers; ++p) {
+            for(size_t i = 0; i != per_producer; ++i) {
+                CHECK(all[p * per_producer + i] == ((static_cast<item>(p) << 32) | i));
+            }
+        }
+    }
+
+    int live = 0;
+
+    struct counted {
+        counted() { ++live; }
+        counted(const counted&) { ++live; }
+        counted(counted&&) noexcept { ++live; }
+        counted& operator=(const counted&) = default;
+        ~counted() { --live; }
+    };
+
+    void test_destroy_remaining() {
+        {
+            mabustl::mpmc_queue<counted> q(16);
+            for(int i = 0; i != 40; ++i) {
+                q.try_emplace();
+                counted value;
+                if(i % 3 == 0) q.try_pop(value);
+            }
+            CHECK(live == static_cast<int>(q.size()));
+        }
+        CHECK(live == 0);
+    }
+}
+
+int main() {
+    test_single_thread(1);
+    test_single_thread(7);
+    test_single_thread(64);
+
+    test_threads(2, 2, 2, 20000);
+    test_threads(64, 4, 3, 20000);
+    test_threads(1024, 3, 5, 20000);
+
+    test_destroy_remaining();
+    return mabustl_test::pass("test_mpmc_queue");
+}
@@ -0,0 +1,236 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * pairing_heap
+ * (1)随机的 push / pop / decrease_key / increase_key / update / erase(handle) / merge，
+ *    与 std::set 维护的参考集合逐步比较堆顶，handle 在元素被删除之前始终指向原来的元素
+ * (2)在随机图上用 decrease_key 实现的 Dijkstra 与用 std::priority_queue(惰性删除)实现的结果相同
+ * (3)复制、移动和交换
+ */
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "mabu_functional.h"
+#include "mabu_pairing_heap.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    // id 保证元素互不相同，堆顶是确定的
+    struct item {
+        int key;
+        int id;
+
+        bool operator<(const item& rhs) const { return key != rhs.key ? key < rhs.key : id < rhs.id; }
+    };
+
+    typedef mabustl::pairing_heap<item> heap;
+    typedef heap::handle handle;
+
+    struct model {
+        std::set<std::pair<int, int> > items;  // (key, id)
+        std::vector<handle> handles;           // 按 id 索引，已删除的为空
+        std::vector<int> keys;                 // 按 id 索引
+        std::vector<int> owner;                // 按 id 索引，所在堆的编号
+
+        int add(int key, int heap_id) {
+            const int id = static_cast<int>(handles.size());
+            handles.push_back(handle());
+            keys.push_back(key);
+            owner.push_back(heap_id);
+            return id;
+        }
+    };
+
+    void check_top(const heap& h, const model& m, int heap_id) {
+        std::set<std::pair<int, int> >::const_reverse_iterator it = m.items.rbegin();
+        while(it != m.items.rend() && m.owner[it->second] != heap_id) ++it;
+        CHECK(h.empty() == (it == m.items.rend()));
+        if(h.empty()) return;
+        CHECK(h.top().key == it->first && h.top().id == it->second);
+        CHECK(h.top_handle() == m.handles[it->second]);
+    }
+
+    int pick_live(const model& m, int heap_id) {
+        for(int tries = 0; tries != 64; ++tries) {
+            const int id = static_cast<int>(rand_below(m.handles.size()));
+            if(m.handles[id] && m.owner[id] == heap_id) return id;
+        }
+        return -1;
+    }
+
+    void test_against_model() {
+        model m;
+        heap h, other;
+        for(int step = 0; step != 40000; ++step) {
+            const size_t op = rand_below(10);
+            if(op < 3 || h.empty()) {
+                // 一部分放进 other，稍后并入 h
+                const int heap_id = rand_below(4) == 0 ? 1 : 0;
+                const int key = static_cast<int>(rand_below(100000));
+                const int id = m.add(key, heap_id);
+                const item value = {key, id};
+                m.handles[id] = heap_id == 0 ? h.push(value) : other.push(value);
+                m.items.insert(std::make_pair(key, id));
+                CHECK(m.handles[id]->id == id);
+            } else if(op == 3) {
+                const int id = h.top().id;
+                h.pop();
+                m.items.erase(std::make_pair(m.keys[id], id));
+                m.handles[id] = handle();
+            } else if(op <= 7) {
+                const int id = pick_live(m, 0);
+                if(id < 0) continue;
+                const int old_key = m.keys[id];
+                int key = static_cast<int>(rand_below(100000));
+                if(op == 4) {
+                    key = old_key + static_cast<int>(rand_below(1000));
+                    const item value = {key, id};
+                    h.decrease_key(m.handles[id], value);
+                } else if(op == 5) {
+                    key = old_key - static_cast<int>(rand_below(1000));
+                    const item value = {key, id};
+                    h.increase_key(m.handles[id], value);
+                } else if(op == 6) {
+                    const item value = {key, id};
+                    h.update(m.handles[id], value);
+                } else {
+                    h.erase(m.handles[id]);
+                    m.items.erase(std::make_pair(old_key, id));
+                    m.handles[id] = handle();
+                    CHECK(h.size() == m.items.size() - other.size());
+                    continue;
+                }
+                m.items.erase(std::make_pair(old_key, id));
+                m.items.insert(std::make_pair(key, id));
+                m.keys[id] = key;
+                CHECK(m.handles[id]->key == key);
+            } else if(op == 8 && rand_below(16) == 0) {
+                h.merge(other);
+                CHECK(other.empty());
+                for(size_t id = 0; id != m.owner.size(); ++id) m.owner[id] = 0;
+            } else {
+                const int id = pick_live(m, 0);
+                if(id >= 0) CHECK(m.handles[id]->key == m.keys[id] && m.handles[id]->id == id);
+            }
+            CHECK(h.size() + other.size() == m.items.size());
+            check_top(h, m, 0);
+            check_top(other, m, 1);
+        }
+    }
+
+    void test_copy_move_swap() {
+        for(int round = 0; round != 100; ++round) {
+            std::vector<int> expect;
+            mabustl::pairing_heap<int> a;
+            for(size_t i = rand_below(200); i != 0; --i) {
+                expect.push_back(static_cast<int>(rand_below(1000)));
+                a.push(expect.back());
+            }
+            std::sort(expect.rbegin(), expect.rend());
+
+            mabustl::pairing_heap<int> b(a);
+            mabustl::pairing_heap<int> c(mabustl::move(a));
+            mabustl::pairing_heap<int> d;
+            d.push(1);
+            d.swap(c);
+            CHECK(c.size() == 1 && c.top() == 1);
+            c = b;
+            for(size_t i = 0; i != expect.size(); ++i) {
+                CHECK(b.top() == expect[i] && c.top() == expect[i] && d.top() == expect[i]);
+                b.pop();
+                c.pop();
+                d.pop();
+            }
+            CHECK(b.empty() && c.empty() && d.empty());
+        }
+    }
+
+    struct edge {
+        int to;
+        long long weight;
+    };
+
+    struct vertex_dist {
+        long long dist;
+        int vertex;
+
+        bool operator>(const vertex_dist& rhs) const { return dist > rhs.dist; }
+    };
+
+    void test_dijkstra() {
+        for(int round = 0; round != 20; ++round) {
+            const int n = 1 + static_cast<int>(rand_below(2000));
+            std::vector<std::vector<edge> > graph(n);
+            for(int e = static_cast<int>(rand_below(8 * n)); e != 0; --e) {
+                const edge ed = {static_cast<int>(rand_below(n)), static_cast<long long>(rand_below(1000))};
+                graph[rand_below(n)].push_back(ed);
+            }
+            const long long inf = -1;
+
+            // std::priority_queue，同一个顶点可以多次入队，出队时跳过过期的项
+            std::vector<long long> expect(n, inf);
+            std::priority_queue<std::pair<long long, int>, std::vector<std::pair<long long, int> >,
+                                std::greater<std::pair<long long, int> > > pq;
+            expect[0] = 0;
+            pq.push(std::make_pair(0LL, 0));
+            while(!pq.empty()) {
+                const std::pair<long long, int> top = pq.top();
+                pq.pop();
+                if(top.first != expect[top.second]) continue;
+                for(size_t i = 0; i != graph[top.second].size(); ++i) {
+                    const edge& ed = graph[top.second][i];
+                    const long long d = top.first + ed.weight;
+                    if(expect[ed.to] == inf || d < expect[ed.to]) {
+                        expect[ed.to] = d;
+                        pq.push(std::make_pair(d, ed.to));
+                    }
+                }
+            }
+
+            // pairing_heap，每个顶点只入堆一次，距离变小时 decrease_key
+            typedef mabustl::pairing_heap<vertex_dist, mabustl::greater<vertex_dist> > dheap;
+            std::vector<long long> actual(n, inf);
+            std::vector<dheap::handle> handles(n);
+            std::vector<bool> done(n, false);
+            dheap h;
+            const vertex_dist start = {0, 0};
+            actual[0] = 0;
+            handles[0] = h.push(start);
+            while(!h.empty()) {
+                const vertex_dist top = h.top();
+                h.pop();
+                done[top.vertex] = true;
+                for(size_t i = 0; i != graph[top.vertex].size(); ++i) {
+                    const edge& ed = graph[top.vertex][i];
+                    if(done[ed.to]) continue;
+                    const vertex_dist next = {top.dist + ed.weight, ed.to};
+                    if(actual[ed.to] == inf) {
+                        actual[ed.to] = next.dist;
+                        handles[ed.to] = h.push(next);
+                    } else if(next.dist < actual[ed.to]) {
+                        actual[ed.to] = next.dist;
+                        h.decrease_key(handles[ed.to], next);
+                    }
+                }
+            }
+            CHECK(actual == expect);
+        }
+    }
+}
+
+int main() {
+    test_against_model();
+    test_copy_move_swap();
+    test_dijkstra();
+    return mabustl_test::pass("test_pairing_heap");
+}
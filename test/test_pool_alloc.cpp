@@ -0,0 +1,70 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * pool_alloc / pool_allocator
+ * (1)随机大小(包括超过 MAX_BYTES 的)随机顺序地分配和回收，每块写满自己的编号，回收前检查没有被其他块覆盖
+ * (2)以 pool_allocator 作为 std::map 的 allocator，随机操作后与使用 std::allocator 的 std::map 比较
+ */
+
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "mabu_allocator.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+using mabustl_test::tagged_block;
+
+namespace {
+    void test_raw_blocks() {
+        std::vector<tagged_block> live;
+        for(int step = 0; step != 200000; ++step) {
+            if(live.empty() || rand_below(3) != 0) {
+                // 大部分请求落在内存池负责的范围内，少量超过 MAX_BYTES
+                const size_t n = rand_below(8) == 0 ? mabustl::pool_alloc::MAX_BYTES + rand_below(2000)
+                                                    : 1 + rand_below(mabustl::pool_alloc::MAX_BYTES);
+                void* p = mabustl::pool_alloc::allocate(n);
+                CHECK(p != nullptr);
+                CHECK(mabustl_test::aligned_to(p, mabustl::pool_alloc::ALIGN));
+                live.push_back(mabustl_test::make_block(p, n, static_cast<unsigned char>(step)));
+            } else {
+                const size_t i = rand_below(live.size());
+                CHECK(mabustl_test::intact(live[i]));
+                mabustl::pool_alloc::deallocate(live[i].ptr, live[i].n);
+                live[i] = live.back();
+                live.pop_back();
+            }
+        }
+        for(size_t i = 0; i != live.size(); ++i) {
+            CHECK(mabustl_test::intact(live[i]));
+            mabustl::pool_alloc::deallocate(live[i].ptr, live[i].n);
+        }
+    }
+
+    void test_std_map() {
+        typedef std::pair<const int, long long> value_type;
+        std::map<int, long long> expect;
+        std::map<int, long long, std::less<int>, mabustl::pool_allocator<value_type> > actual;
+        for(int step = 0; step != 100000; ++step) {
+            const int key = static_cast<int>(rand_below(5000));
+            if(rand_below(3) != 0) {
+                expect[key] += step;
+                actual[key] += step;
+            } else {
+                CHECK(expect.erase(key) == actual.erase(key));
+            }
+        }
+        CHECK(expect.size() == actual.size());
+        CHECK(std::equal(expect.begin(), expect.end(), actual.begin()));
+    }
+}
+
+int main() {
+    test_raw_blocks();
+    test_std_map();
+    return mabustl_test::pass("test_pool_alloc");
+}
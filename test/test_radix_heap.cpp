@@ -0,0 +1,159 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * radix_heap
+ * (1)8、16、32、64 位 key 上单调的随机 push / pop，与 std::priority_queue(小根堆)逐步比较堆顶的 key，
+ *    包括接近 key 最大值的情况；带值时值始终与它的 key 对应
+ * (2)clear 之后重复同样的操作，桶的空间被复用，不再分配
+ * (3)复制、移动和交换
+ */
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+#include "mabu_allocator.h"
+#include "mabu_radix_heap.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    long long allocations = 0;
+
+    // 记录分配次数的 allocator
+    template<class T>
+    class counting_allocator : public mabustl::allocator<T> {
+    public:
+        typedef mabustl::allocator<T> base_type;
+        typedef typename base_type::size_type size_type;
+
+        template<class U>
+        struct rebind {
+            typedef counting_allocator<U> other;
+        };
+
+        counting_allocator() noexcept {}
+
+        template<class U>
+        counting_allocator(const counting_allocator<U>&) noexcept {}
+
+        static T* allocate(size_type n) {
+            ++allocations;
+            return base_type::allocate(n);
+        }
+
+        static mabustl::allocation_result<T*, size_type> allocate_at_least(size_type n) {
+            ++allocations;
+            return base_type::allocate_at_least(n);
+        }
+    };
+
+    template<class Key>
+    unsigned payload_of(Key key) {
+        return static_cast<unsigned>(key * 2654435761u);
+    }
+
+    // 从 base 开始，每次 push 的 key 在 [last, last + spread] 内，并且不超过 Key 的最大值
+    template<class Key>
+    void test_against_std(Key base, Key spread, int steps) {
+        mabustl::radix_heap<Key, unsigned> actual;
+        std::priority_queue<Key, std::vector<Key>, std::greater<Key> > expect;
+        const Key max_key = std::numeric_limits<Key>::max();
+        Key last = base;
+        for(int step = 0; step != steps; ++step) {
+            if(expect.empty() || rand_below(2) == 0) {
+                const Key room = max_key - last < spread ? static_cast<Key>(max_key - last) : spread;
+                const Key key = static_cast<Key>(last + static_cast<Key>(rand_below(static_cast<size_t>(room) + 1)));
+                actual.push(mabustl::make_pair(key, payload_of(key)));
+                expect.push(key);
+            } else {
+                CHECK(actual.top_key() == expect.top());
+                CHECK(actual.top().second == payload_of(expect.top()));
+                last = expect.top();
+                actual.pop();
+                expect.pop();
+                CHECK(actual.last_key() == last);
+            }
+            CHECK(actual.size() == expect.size());
+            if(!expect.empty()) CHECK(actual.top_key() == expect.top());
+        }
+        while(!expect.empty()) {
+            CHECK(actual.top_key() == expect.top());
+            actual.pop();
+            expect.pop();
+        }
+        CHECK(actual.empty());
+    }
+
+    void run_workload(mabustl::radix_heap<unsigned, void, counting_allocator<unsigned> >& heap,
+                      const std::vector<unsigned>& delays) {
+        unsigned now = 0;
+        for(size_t i = 0; i != delays.size(); ++i) {
+            if(i % 3 == 2) {
+                now = heap.top();
+                heap.pop();
+            } else {
+                heap.push(now + delays[i]);
+            }
+        }
+        while(!heap.empty()) heap.pop();
+    }
+
+    void test_reuse() {
+        std::vector<unsigned> delays(100000);
+        for(size_t i = 0; i != delays.size(); ++i) delays[i] = static_cast<unsigned>(rand_below(1 << 20));
+        mabustl::radix_heap<unsigned, void, counting_allocator<unsigned> > heap;
+        run_workload(heap, delays);
+        CHECK(allocations > 0);
+        heap.clear();
+        const long long first_round = allocations;
+        run_workload(heap, delays);
+        CHECK(allocations == first_round);
+    }
+
+    void test_copy_move_swap() {
+        for(int round = 0; round != 100; ++round) {
+            std::vector<unsigned long long> expect;
+            mabustl::radix_heap<unsigned long long> a;
+            for(size_t i = rand_below(300); i != 0; --i) {
+                expect.push_back(rand_below(1 << 30));
+                a.push(expect.back());
+            }
+            std::sort(expect.begin(), expect.end());
+
+            mabustl::radix_heap<unsigned long long> b(a);
+            mabustl::radix_heap<unsigned long long> c(mabustl::move(a));
+            mabustl::radix_heap<unsigned long long> d;
+            d.push(7);
+            d.swap(c);
+            CHECK(c.size() == 1 && c.top() == 7);
+            c = b;
+            for(size_t i = 0; i != expect.size(); ++i) {
+                CHECK(b.top() == expect[i] && c.top() == expect[i] && d.top() == expect[i]);
+                b.pop();
+                c.pop();
+                d.pop();
+            }
+            CHECK(b.empty() && c.empty() && d.empty());
+        }
+    }
+}
+
+int main() {
+    test_against_std<unsigned char>(0, 40, 20000);
+    test_against_std<unsigned short>(0, 1000, 100000);
+    test_against_std<unsigned>(0, 1u << 20, 200000);
+    test_against_std<unsigned>(4000000000u, 1u << 20, 200000);
+    test_against_std<unsigned long long>(0, 1ULL << 40, 200000);
+    test_against_std<unsigned long long>(std::numeric_limits<unsigned long long>::max() - (1ULL << 30), 1ULL << 20,
+                                         200000);
+    test_reuse();
+    test_copy_move_swap();
+    return mabustl_test::pass("test_radix_heap");
+}
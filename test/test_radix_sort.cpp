@@ -0,0 +1,225 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * radix_sort
+ * (1)8 到 64 位的有符号、无符号整数以及 float / double，随机、取值范围很小(跳过大部分趟)、全部相等、有序、逆序的输入，
+ *    结果与 std::sort 相同；长度跨过插入排序、8 位 / 11 位一位以及 MSD 分组的阈值，包括偏斜到一个分组的浮点数
+ * (2)浮点数的顺序：-inf < 负数 < -0 < +0 < 正数 < +inf，负的 NaN 在最前，正的 NaN 在最后
+ * (3)pair 作为 key 时按字典序，嵌套的 pair 也可以；用 selectFirst 只按 first 排序时是稳定的，与 std::stable_sort 相同
+ * (4)调用者用 mabustl::allocator 提供缓冲区
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "mabu_allocator.h"
+#include "mabu_functional.h"
+#include "mabu_radix_sort.h"
+#include "mabu_utility.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    enum pattern {
+        RANDOM,
+        NARROW,
+        ALL_EQUAL,
+        SORTED,
+        REVERSED,
+        PATTERN_COUNT
+    };
+
+    // 随机的位模式转换为 T，浮点数取有限值
+    template<class T>
+    T random_value(std::false_type) {
+        return static_cast<T>(mabustl_test::rng()());
+    }
+
+    template<class T>
+    T random_value(std::true_type) {
+        const int exponent = static_cast<int>(rand_below(80)) - 40;
+        const double magnitude = std::ldexp(static_cast<double>(rand_below(1 << 20)), exponent);
+        return static_cast<T>(rand_below(2) ? magnitude : -magnitude);
+    }
+
+    template<class T>
+    std::vector<T> make_input(pattern p, size_t n) {
+        std::vector<T> v(n);
+        for(size_t i = 0; i != n; ++i) {
+            switch(p) {
+                case RANDOM: v[i] = random_value<T>(std::is_floating_point<T>()); break;
+                case NARROW: v[i] = static_cast<T>(rand_below(100)); break;
+                case ALL_EQUAL: v[i] = static_cast<T>(42); break;
+                case SORTED: v[i] = static_cast<T>(i); break;
+                default: v[i] = static_cast<T>(n - i); break;
+            }
+        }
+        if(p == SORTED || p == REVERSED) std::sort(v.begin(), v.end());
+        if(p == REVERSED) std::reverse(v.begin(), v.end());
+        return v;
+    }
+
+    // -0 排在 +0 前面，其余与 < 相同
+    template<class T>
+    bool total_less(T a, T b) {
+        return a < b || (a == b && std::signbit(static_cast<double>(a)) && !std::signbit(static_cast<double>(b)));
+    }
+
+    template<class T>
+    bool same_bits(const std::vector<T>& a, const std::vector<T>& b) {
+        return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+    }
+
+    template<class T>
+    void check_sort(std::vector<T> v) {
+        std::vector<T> expect(v);
+        std::sort(expect.begin(), expect.end(), total_less<T>);
+        mabustl::radix_sort(v.data(), v.data() + v.size());
+        CHECK(same_bits(v, expect));
+    }
+
+    template<class T>
+    void test_type(size_t max_size) {
+        const size_t sizes[] = {0, 1, 2, 63, 64, 65, 1000, size_t(1) << 17, (size_t(1) << 17) + 1,
+                                (size_t(1) << 19) + 3};
+        for(size_t s = 0; s != sizeof(sizes) / sizeof(sizes[0]) && sizes[s] <= max_size; ++s) {
+            // 大的输入只用随机和取值范围小的两种
+            const int patterns = sizes[s] > 1000 ? NARROW + 1 : PATTERN_COUNT;
+            for(int p = 0; p != patterns; ++p) check_sort(make_input<T>(static_cast<pattern>(p), sizes[s]));
+        }
+    }
+
+    template<class T>
+    void test_floating_specials() {
+        typedef std::numeric_limits<T> limits;
+        const T specials[] = {T(0), -T(0), limits::infinity(), -limits::infinity(), limits::denorm_min(),
+                              -limits::denorm_min(), limits::min(), -limits::min(), limits::max(), -limits::max(),
+                              T(1), T(-1)};
+        std::vector<T> v;
+        for(int i = 0; i != 5000; ++i) v.push_back(specials[rand_below(sizeof(specials) / sizeof(specials[0]))]);
+        for(int i = 0; i != 5000; ++i) v.push_back(random_value<T>(std::true_type()));
+        check_sort(v);
+
+        // NaN 按符号位分到两端，中间仍然有序
+        const T nan = limits::quiet_NaN();
+        const size_t nans = 100;
+        for(size_t i = 0; i != nans; ++i) v.push_back(std::copysign(nan, i % 2 ? T(-1) : T(1)));
+        std::shuffle(v.begin(), v.end(), mabustl_test::rng());
+        mabustl::radix_sort(v.data(), v.data() + v.size());
+        for(size_t i = 0; i != nans / 2; ++i) {
+            CHECK(std::isnan(v[i]) && std::signbit(v[i]));
+            CHECK(std::isnan(v[v.size() - 1 - i]) && !std::signbit(v[v.size() - 1 - i]));
+        }
+        CHECK(std::is_sorted(v.begin() + nans / 2, v.end() - nans / 2, total_less<T>));
+    }
+
+    // 大部分元素落在同一个 MSD 分组中，分组本身仍然需要再分组
+    void test_skewed() {
+        std::vector<double> v((size_t(1) << 20) + 5);
+        for(size_t i = 0; i != v.size(); ++i) {
+            v[i] = i % 64 == 0 ? static_cast<double>(rand_below(1000000)) - 500000.0
+                               : 1.0 + static_cast<double>(rand_below(1 << 30)) / (1 << 30);
+        }
+        check_sort(v);
+    }
+
+    template<class Pair>
+    bool pair_less(const Pair& a, const Pair& b) {
+        return a.first < b.first || (!(b.first < a.first) && a.second < b.second);
+    }
+
+    void test_pairs() {
+        // pair<int, double> 按字典序
+        typedef mabustl::pair<int, double> key_pair;
+        std::vector<key_pair> v;
+        for(int i = 0; i != 200000; ++i) {
+            const int first = static_cast<int>(rand_below(1000)) - 500;
+            v.push_back(key_pair(first, static_cast<double>(rand_below(1000)) / 8));
+        }
+        std::vector<key_pair> expect(v);
+        std::sort(expect.begin(), expect.end(), pair_less<key_pair>);
+        mabustl::radix_sort(v.data(), v.data() + v.size());
+        for(size_t i = 0; i != v.size(); ++i) {
+            CHECK(v[i].first == expect[i].first && v[i].second == expect[i].second);
+        }
+
+        // 嵌套的 pair
+        typedef mabustl::pair<mabustl::pair<short, unsigned char>, long long> nested;
+        std::vector<nested> w;
+        for(int i = 0; i != 50000; ++i) {
+            w.push_back(nested(mabustl::make_pair(static_cast<short>(rand_below(7)) - 3,
+                                                  static_cast<unsigned char>(rand_below(256))),
+                               static_cast<long long>(mabustl_test::rng()())));
+        }
+        std::vector<nested> nested_expect(w);
+        std::sort(nested_expect.begin(), nested_expect.end(), [](const nested& a, const nested& b) {
+            return pair_less(a.first, b.first) || (!pair_less(b.first, a.first) && a.second < b.second);
+        });
+        mabustl::radix_sort(w.data(), w.data() + w.size());
+        for(size_t i = 0; i != w.size(); ++i) {
+            CHECK(w[i].first.first == nested_expect[i].first.first);
+            CHECK(w[i].first.second == nested_expect[i].first.second);
+            CHECK(w[i].second == nested_expect[i].second);
+        }
+    }
+
+    void test_stable_by_first() {
+        typedef mabustl::pair<uint32_t, uint32_t> record;
+        const size_t sizes[] = {50, 5000, 300000};
+        for(size_t s = 0; s != 3; ++s) {
+            std::vector<record> v(sizes[s]);
+            for(size_t i = 0; i != v.size(); ++i) {
+                v[i] = record(static_cast<uint32_t>(rand_below(64)), static_cast<uint32_t>(i));
+            }
+            std::vector<record> expect(v);
+            std::stable_sort(expect.begin(), expect.end(),
+                             [](const record& a, const record& b) { return a.first < b.first; });
+            mabustl::radix_sort(v.data(), v.data() + v.size(), mabustl::selectFirst<record>());
+            for(size_t i = 0; i != v.size(); ++i) {
+                CHECK(v[i].first == expect[i].first && v[i].second == expect[i].second);
+            }
+        }
+    }
+
+    void test_caller_buffer() {
+        const size_t n = 300000;
+        std::vector<int64_t> v = make_input<int64_t>(RANDOM, n);
+        std::vector<int64_t> expect(v);
+        std::sort(expect.begin(), expect.end());
+        int64_t* buffer = mabustl::allocator<int64_t>::allocate(n);
+        mabustl::radix_sort(v.data(), v.data() + n, mabustl::identity<int64_t>(), buffer);
+        mabustl::allocator<int64_t>::deallocate(buffer, n);
+        CHECK(v == expect);
+    }
+}
+
+int main() {
+    // 8 位 / 11 位一位的阈值对所有类型都测试，MSD 分组只对其中几种测试，double 的 MSD 分组见 test_skewed
+    const size_t lsd = (size_t(1) << 17) + 1;
+    const size_t all = static_cast<size_t>(-1);
+    test_type<uint8_t>(lsd);
+    test_type<int8_t>(lsd);
+    test_type<uint16_t>(lsd);
+    test_type<int16_t>(lsd);
+    test_type<uint32_t>(all);
+    test_type<int32_t>(lsd);
+    test_type<uint64_t>(lsd);
+    test_type<int64_t>(all);
+    test_type<float>(lsd);
+    test_type<double>(lsd);
+    test_floating_specials<float>();
+    test_floating_specials<double>();
+    test_skewed();
+    test_pairs();
+    test_stable_by_first();
+    test_caller_buffer();
+    return mabustl_test::pass("test_radix_sort");
+}
@@ -0,0 +1,274 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * is_trivially_relocatable / uninitialized_relocate / uninitialized_relocate_n
+ * (1)trait 的默认值、pair 的组合和 MABUSTL_TRIVIALLY_RELOCATABLE 声明
+ * (2)随机长度的区间搬移后与 std 复制得到的参考序列比较：
+ *    声明了可平凡重定位的类型不调用移动构造和析构，其余类型每个元素恰好一次构造和一次析构
+ * (3)复制构造抛出异常时源区间保持不变(强异常保证)；只能移动的类型移动构造抛出异常时不泄漏(基本异常保证)
+ * (4)uninitialized_relocate_a 经过带 construct 的 allocator 时同样保持强异常保证
+ */
+
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "mabu_type_traits.h"
+#include "mabu_uninitialized.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    long long moves = 0;
+    long long copies = 0;
+    long long destroys = 0;
+    long long throw_countdown = -1;  // 为 0 时下一次复制 / 移动抛出异常，为负时不抛出
+
+    void maybe_throw() {
+        if(throw_countdown < 0) return;
+        if(throw_countdown-- == 0) throw std::bad_alloc();
+    }
+
+    // 只持有一个堆指针的字符串，声明为可平凡重定位
+    struct heap_string {
+        char* data;
+
+        explicit heap_string(const std::string& s): data(new char[s.size() + 1]) {
+            s.copy(data, s.size());
+            data[s.size()] = '\0';
+        }
+        heap_string(heap_string&& other) noexcept: data(other.data) {
+            other.data = nullptr;
+            ++moves;
+        }
+        heap_string(const heap_string&) = delete;
+        ~heap_string() {
+            delete[] data;
+            ++destroys;
+        }
+
+        std::string str() const { return data; }
+    };
+
+    // 移动构造不抛异常，但没有声明可平凡重定位
+    struct nothrow_string {
+        std::string value;
+
+        explicit nothrow_string(const std::string& s): value(s) {}
+        nothrow_string(nothrow_string&& other) noexcept: value(std::move(other.value)) { ++moves; }
+        nothrow_string(const nothrow_string& other): value(other.value) { ++copies; }
+        ~nothrow_string() { ++destroys; }
+
+        std::string str() const { return value; }
+    };
+
+    // 移动构造可能抛出异常，可以复制
+    struct copyable_string {
+        std::string value;
+
+        explicit copyable_string(const std::string& s): value(s) {}
+        copyable_string(copyable_string&& other): value(std::move(other.value)) { ++moves; }
+        copyable_string(const copyable_string& other): value(other.value) {
+            maybe_throw();
+            ++copies;
+        }
+        ~copyable_string() { ++destroys; }
+
+        std::string str() const { return value; }
+    };
+
+    // 移动构造可能抛出异常，不能复制
+    struct move_only_string {
+        std::string value;
+
+        explicit move_only_string(const std::string& s): value(s) {}
+        move_only_string(move_only_string&& other): value(std::move(other.value)) {
+            maybe_throw();
+            ++moves;
+        }
+        move_only_string(const move_only_string&) = delete;
+        ~move_only_string() { ++destroys; }
+
+        std::string str() const { return value; }
+    };
+
+    long long alloc_constructs = 0;
+
+    // 自定义 construct 的 allocator，uninitialized_*_a 不能走默认构造的快速路径
+    template<class T>
+    struct construct_counting_allocator {
+        typedef T value_type;
+
+        construct_counting_allocator() {}
+
+        template<class U>
+        construct_counting_allocator(const construct_counting_allocator<U>&) {}
+
+        T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T))); }
+        void deallocate(T* ptr, size_t) { ::operator delete(ptr); }
+
+        template<class U, class... Args>
+        void construct(U* ptr, Args&&... args) {
+            ::new(static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+            ++alloc_constructs;
+        }
+    };
+}
+
+MABUSTL_TRIVIALLY_RELOCATABLE(heap_string)
+
+namespace {
+    static_assert(mabustl::is_trivially_relocatable<int>::value, "int");
+    static_assert(mabustl::is_trivially_relocatable<double*>::value, "pointer");
+    static_assert(mabustl::is_trivially_relocatable<heap_string>::value, "declared");
+    static_assert(!mabustl::is_trivially_relocatable<nothrow_string>::value, "not declared");
+    static_assert(mabustl::is_trivially_relocatable<mabustl::pair<int, heap_string> >::value, "pair");
+    static_assert(!mabustl::is_trivially_relocatable<mabustl::pair<int, nothrow_string> >::value, "pair");
+
+    std::string random_string() {
+        // 长短都有，短的落在 std::string 的 SSO 内
+        return std::string(rand_below(40), static_cast<char>('a' + rand_below(26)));
+    }
+
+    template<class T>
+    T* make_range(const std::vector<std::string>& values) {
+        T* p = static_cast<T*>(::operator new(values.size() * sizeof(T) + 1));
+        for(size_t i = 0; i != values.size(); ++i) ::new(static_cast<void*>(p + i)) T(values[i]);
+        return p;
+    }
+
+    template<class T>
+    void free_range(T* p, size_t n) {
+        for(size_t i = 0; i != n; ++i) p[i].~T();
+        ::operator delete(p);
+    }
+
+    template<class T>
+    void test_relocate(bool trivial) {
+        for(int round = 0; round != 500; ++round) {
+            std::vector<std::string> expect(rand_below(64));
+            for(size_t i = 0; i != expect.size(); ++i) expect[i] = random_string();
+            const size_t n = expect.size();
+
+            T* src = make_range<T>(expect);
+            T* dst = static_cast<T*>(::operator new(n * sizeof(T) + 1));
+            moves = copies = destroys = 0;
+            T* end = rand_below(2) == 0 ? mabustl::uninitialized_relocate(src, src + n, dst)
+                                        : mabustl::uninitialized_relocate_n(src, n, dst);
+            CHECK(end == dst + n);
+            CHECK(moves + copies == (trivial ? 0 : static_cast<long long>(n)));
+            CHECK(destroys == (trivial ? 0 : static_cast<long long>(n)));
+            // src 中的对象已经结束生命期，只回收内存
+            ::operator delete(src);
+            for(size_t i = 0; i != n; ++i) CHECK(dst[i].str() == expect[i]);
+            free_range(dst, n);
+        }
+    }
+
+    void test_strong_guarantee() {
+        for(int round = 0; round != 200; ++round) {
+            std::vector<std::string> expect(1 + rand_below(32));
+            for(size_t i = 0; i != expect.size(); ++i) expect[i] = random_string();
+            const size_t n = expect.size();
+
+            copyable_string* src = make_range<copyable_string>(expect);
+            copyable_string* dst = static_cast<copyable_string*>(::operator new(n * sizeof(copyable_string)));
+            moves = copies = destroys = 0;
+            throw_countdown = static_cast<long long>(rand_below(n));
+            bool thrown = false;
+            try {
+                mabustl::uninitialized_relocate(src, src + n, dst);
+            } catch(const std::bad_alloc&) {
+                thrown = true;
+            }
+            throw_countdown = -1;
+            CHECK(thrown);
+            CHECK(moves == 0);
+            CHECK(destroys == copies);  // 已经复制出的对象都被析构
+            for(size_t i = 0; i != n; ++i) CHECK(src[i].str() == expect[i]);
+            ::operator delete(dst);
+            free_range(src, n);
+        }
+    }
+
+    void test_strong_guarantee_a() {
+        static_assert(!mabustl::allocator_uses_default_construct<
+                          construct_counting_allocator<copyable_string> >::value, "custom construct");
+        construct_counting_allocator<copyable_string> alloc;
+        for(int round = 0; round != 200; ++round) {
+            std::vector<std::string> expect(1 + rand_below(32));
+            for(size_t i = 0; i != expect.size(); ++i) expect[i] = random_string();
+            const size_t n = expect.size();
+
+            copyable_string* src = make_range<copyable_string>(expect);
+            copyable_string* dst = alloc.allocate(n);
+            moves = copies = destroys = alloc_constructs = 0;
+            // 为 n 时不抛出，检查正常搬移的结果
+            const size_t countdown = rand_below(n + 1);
+            throw_countdown = static_cast<long long>(countdown);
+            bool thrown = false;
+            try {
+                mabustl::uninitialized_relocate_a(src, src + n, dst, alloc);
+            } catch(const std::bad_alloc&) {
+                thrown = true;
+            }
+            throw_countdown = -1;
+            CHECK(thrown == (countdown != n));
+            CHECK(moves == 0);
+            CHECK(alloc_constructs == copies);
+            if(thrown) {
+                CHECK(destroys == copies);  // 已经复制出的对象都被析构
+                for(size_t i = 0; i != n; ++i) CHECK(src[i].str() == expect[i]);
+                alloc.deallocate(dst, n);
+                free_range(src, n);
+            } else {
+                CHECK(copies == static_cast<long long>(n));
+                CHECK(destroys == static_cast<long long>(n));
+                ::operator delete(src);
+                for(size_t i = 0; i != n; ++i) CHECK(dst[i].str() == expect[i]);
+                free_range(dst, n);
+            }
+        }
+    }
+
+    void test_basic_guarantee() {
+        for(int round = 0; round != 200; ++round) {
+            std::vector<std::string> expect(1 + rand_below(32));
+            for(size_t i = 0; i != expect.size(); ++i) expect[i] = random_string();
+            const size_t n = expect.size();
+
+            move_only_string* src = make_range<move_only_string>(expect);
+            move_only_string* dst = static_cast<move_only_string*>(::operator new(n * sizeof(move_only_string)));
+            moves = copies = destroys = 0;
+            throw_countdown = static_cast<long long>(rand_below(n));
+            bool thrown = false;
+            try {
+                mabustl::uninitialized_relocate(src, src + n, dst);
+            } catch(const std::bad_alloc&) {
+                thrown = true;
+            }
+            throw_countdown = -1;
+            CHECK(thrown);
+            CHECK(destroys == moves);  // 已经移动出的对象都被析构，源区间仍然全部存活
+            ::operator delete(dst);
+            free_range(src, n);
+        }
+    }
+}
+
+int main() {
+    test_relocate<heap_string>(true);
+    test_relocate<nothrow_string>(false);
+    test_relocate<copyable_string>(false);
+    test_relocate<move_only_string>(false);
+    test_strong_guarantee();
+    test_strong_guarantee_a();
+    test_basic_guarantee();
+    return mabustl_test::pass("test_relocate");
+}
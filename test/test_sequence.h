@@ -0,0 +1,173 @@
+#pragma once
+
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * vector / small_vector / deque 共用的随机操作
+ * 对同一串随机操作，mabustl 的序列容器与 std::vector 逐步比较，
+ * 覆盖首尾增删、中间插入删除(包括插入容器自身的元素)、resize、assign、复制、移动和交换
+ */
+
+#include <string>
+#include <vector>
+
+#include "mabu_utility.h"
+#include "test_common.h"
+
+namespace mabustl_test {
+    template<class T>
+    struct value_maker;
+
+    template<>
+    struct value_maker<int> {
+        static int make(size_t i) { return static_cast<int>(i); }
+    };
+
+    // 长短都有，短的落在 std::string 的 SSO 内
+    template<>
+    struct value_maker<std::string> {
+        static std::string make(size_t i) { return std::string(i % 37, static_cast<char>('a' + i % 26)); }
+    };
+
+    template<class Seq, class T>
+    bool same_sequence(const Seq& actual, const std::vector<T>& expect) {
+        if(actual.size() != expect.size()) return false;
+        size_t i = 0;
+        for(typename Seq::const_iterator it = actual.begin(); it != actual.end(); ++it, ++i) {
+            if(!(*it == expect[i])) return false;
+        }
+        return true;
+    }
+
+    // HasFront 为 true 时也测试 push_front / pop_front / emplace_front
+    template<class Seq, bool HasFront>
+    struct end_ops;
+
+    template<class Seq>
+    struct end_ops<Seq, false> {
+        typedef typename Seq::value_type T;
+
+        static void run(Seq& actual, std::vector<T>& expect, size_t op, size_t i) {
+            if(op == 0 || expect.empty()) {
+                const T value = value_maker<T>::make(i);
+                actual.push_back(value);
+                expect.push_back(value);
+            } else if(op == 1) {
+                actual.emplace_back(value_maker<T>::make(i));
+                expect.emplace_back(value_maker<T>::make(i));
+            } else {
+                actual.pop_back();
+                expect.pop_back();
+            }
+        }
+    };
+
+    template<class Seq>
+    struct end_ops<Seq, true> {
+        typedef typename Seq::value_type T;
+
+        static void run(Seq& actual, std::vector<T>& expect, size_t op, size_t i) {
+            if(expect.empty() || rand_below(2) == 0) {
+                end_ops<Seq, false>::run(actual, expect, op, i);
+            } else if(op == 0) {
+                const T value = value_maker<T>::make(i);
+                actual.push_front(value);
+                expect.insert(expect.begin(), value);
+            } else if(op == 1) {
+                actual.emplace_front(value_maker<T>::make(i));
+                expect.insert(expect.begin(), value_maker<T>::make(i));
+            } else {
+                actual.pop_front();
+                expect.erase(expect.begin());
+            }
+        }
+    };
+
+    template<class Seq, bool HasFront>
+    void random_sequence_ops(int steps) {
+        typedef typename Seq::value_type T;
+        Seq actual;
+        std::vector<T> expect;
+        for(int step = 0; step != steps; ++step) {
+            const size_t i = rand_below(1000);
+            const size_t op = rand_below(20);
+            if(op < 9) {
+                end_ops<Seq, HasFront>::run(actual, expect, op % 3, i);
+            } else if(op == 9) {
+                const size_t pos = rand_below(expect.size() + 1);
+                actual.insert(actual.begin() + pos, value_maker<T>::make(i));
+                expect.insert(expect.begin() + pos, value_maker<T>::make(i));
+            } else if(op == 10 && !expect.empty()) {
+                // 插入容器自身的元素
+                const size_t pos = rand_below(expect.size() + 1);
+                const size_t from = rand_below(expect.size());
+                actual.insert(actual.begin() + pos, actual[from]);
+                expect.insert(expect.begin() + pos, T(expect[from]));
+            } else if(op == 11) {
+                const size_t pos = rand_below(expect.size() + 1);
+                const size_t n = rand_below(8);
+                actual.insert(actual.begin() + pos, n, value_maker<T>::make(i));
+                expect.insert(expect.begin() + pos, n, value_maker<T>::make(i));
+            } else if(op == 12) {
+                const size_t pos = rand_below(expect.size() + 1);
+                std::vector<T> src(rand_below(8));
+                for(size_t k = 0; k != src.size(); ++k) src[k] = value_maker<T>::make(i + k);
+                const T* first = src.empty() ? nullptr : &src[0];
+                actual.insert(actual.begin() + pos, first, first + src.size());
+                expect.insert(expect.begin() + pos, src.begin(), src.end());
+            } else if(op == 13 && !expect.empty()) {
+                const size_t pos = rand_below(expect.size());
+                actual.erase(actual.begin() + pos);
+                expect.erase(expect.begin() + pos);
+            } else if(op == 14 && !expect.empty()) {
+                const size_t first = rand_below(expect.size());
+                const size_t last = first + rand_below(expect.size() - first + 1);
+                actual.erase(actual.begin() + first, actual.begin() + last);
+                expect.erase(expect.begin() + first, expect.begin() + last);
+            } else if(op == 15) {
+                const size_t n = rand_below(2 * expect.size() + 4);
+                if(rand_below(2) == 0) {
+                    actual.resize(n);
+                    expect.resize(n);
+                } else {
+                    actual.resize(n, value_maker<T>::make(i));
+                    expect.resize(n, value_maker<T>::make(i));
+                }
+            } else if(op == 16 && rand_below(8) == 0) {
+                const size_t n = rand_below(16);
+                actual.assign(n, value_maker<T>::make(i));
+                expect.assign(n, value_maker<T>::make(i));
+            } else if(op == 17) {
+                Seq copy(actual);
+                CHECK(same_sequence(copy, expect));
+                Seq moved(mabustl::move(copy));
+                CHECK(same_sequence(moved, expect));
+                copy = moved;
+                actual = mabustl::move(copy);
+            } else if(op == 18) {
+                Seq other;
+                std::vector<T> other_expect;
+                for(size_t k = rand_below(24); k != 0; --k) {
+                    other.push_back(value_maker<T>::make(i + k));
+                    other_expect.push_back(value_maker<T>::make(i + k));
+                }
+                actual.swap(other);
+                expect.swap(other_expect);
+                CHECK(same_sequence(other, other_expect));
+            } else if(op == 19 && rand_below(32) == 0) {
+                actual.clear();
+                expect.clear();
+            }
+            CHECK(same_sequence(actual, expect));
+            if(!expect.empty()) {
+                CHECK(actual.front() == expect.front());
+                CHECK(actual.back() == expect.back());
+                const size_t k = rand_below(expect.size());
+                CHECK(actual[k] == expect[k]);
+            }
+        }
+    }
+}
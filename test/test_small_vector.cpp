@@ -0,0 +1,179 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * small_vector
+ * (1)N 为 1、4、16 时 int 和 std::string 上的随机操作，与 std::vector 逐步比较(内联和堆存储之间来回切换)
+ * (2)元素个数不超过 N 时不分配，超过后才分配；回到 N 以内并 shrink_to_fit 后回到内联存储，分配与回收次数相等
+ * (3)内联存储和堆存储的 small_vector 之间互相移动和交换
+ * (4)small_vector(n) / small_vector(n, value) 中元素的构造抛出异常时，已分配的堆空间被回收
+ */
+
+#include <new>
+#include <string>
+#include <vector>
+
+#include "mabu_allocator.h"
+#include "mabu_small_vector.h"
+#include "test_sequence.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    long long allocations = 0;
+    long long deallocations = 0;
+
+    // 记录分配和回收次数的 allocator
+    template<class T>
+    class counting_allocator : public mabustl::allocator<T> {
+    public:
+        typedef mabustl::allocator<T> base_type;
+        typedef typename base_type::size_type size_type;
+
+        template<class U>
+        struct rebind {
+            typedef counting_allocator<U> other;
+        };
+
+        counting_allocator() noexcept {}
+
+        template<class U>
+        counting_allocator(const counting_allocator<U>&) noexcept {}
+
+        static T* allocate(size_type n) {
+            ++allocations;
+            return base_type::allocate(n);
+        }
+
+        static mabustl::allocation_result<T*, size_type> allocate_at_least(size_type n) {
+            ++allocations;
+            return base_type::allocate_at_least(n);
+        }
+
+        static void deallocate(T* ptr, size_type n) {
+            if(ptr == nullptr) return;
+            ++deallocations;
+            base_type::deallocate(ptr, n);
+        }
+    };
+
+    template<size_t N>
+    void test_allocations() {
+        typedef mabustl::small_vector<std::string, N, counting_allocator<std::string> > sv;
+        allocations = deallocations = 0;
+        {
+            sv v;
+            for(size_t i = 0; i != N; ++i) v.push_back(mabustl_test::value_maker<std::string>::make(i));
+            CHECK(v.is_inline());
+            CHECK(allocations == 0);
+
+            v.push_back("spill");
+            CHECK(!v.is_inline());
+            CHECK(allocations == 1);
+
+            v.resize(N);
+            v.shrink_to_fit();
+            CHECK(v.is_inline());
+            CHECK(deallocations == 1);
+            for(size_t i = 0; i != N; ++i) CHECK(v[i] == mabustl_test::value_maker<std::string>::make(i));
+
+            // 反复在 N 附近增删，不超过 N 时不再分配
+            for(int step = 0; step != 1000; ++step) {
+                if(v.size() < N && rand_below(2) == 0) {
+                    v.emplace_back("x");
+                } else if(!v.empty()) {
+                    v.pop_back();
+                }
+            }
+            CHECK(allocations == 1);
+        }
+        CHECK(allocations == deallocations);
+    }
+
+    long long throw_countdown = -1;  // 为 0 时下一次构造抛出异常，为负时不抛出
+
+    struct throwing_ctor {
+        int value;
+
+        static void may_throw() {
+            if(throw_countdown >= 0 && throw_countdown-- == 0) throw std::bad_alloc();
+        }
+
+        throwing_ctor(): value(0) { may_throw(); }
+        explicit throwing_ctor(int v): value(v) {}
+        throwing_ctor(const throwing_ctor& other): value(other.value) { may_throw(); }
+        throwing_ctor& operator=(const throwing_ctor& other) {
+            value = other.value;
+            return *this;
+        }
+    };
+
+    template<size_t N>
+    void test_constructor_throw() {
+        typedef mabustl::small_vector<throwing_ctor, N, counting_allocator<throwing_ctor> > sv;
+        allocations = deallocations = 0;
+        for(int round = 0; round != 200; ++round) {
+            // 超过 N 时元素放在堆上
+            const size_t n = 1 + rand_below(3 * N);
+            throw_countdown = static_cast<long long>(rand_below(n));
+            bool thrown = false;
+            try {
+                if(rand_below(2) == 0) {
+                    sv v(n);
+                } else {
+                    const throwing_ctor value(7);
+                    sv v(n, value);
+                }
+            } catch(const std::bad_alloc&) {
+                thrown = true;
+            }
+            throw_countdown = -1;
+            CHECK(thrown);
+            CHECK(allocations == deallocations);
+        }
+    }
+
+    template<size_t N>
+    void test_move_and_swap() {
+        typedef mabustl::small_vector<std::string, N> sv;
+        for(int round = 0; round != 200; ++round) {
+            std::vector<std::string> ea(rand_below(2 * N + 1)), eb(rand_below(2 * N + 1));
+            sv a, b;
+            for(size_t i = 0; i != ea.size(); ++i) {
+                ea[i] = mabustl_test::value_maker<std::string>::make(i);
+                a.push_back(ea[i]);
+            }
+            for(size_t i = 0; i != eb.size(); ++i) {
+                eb[i] = mabustl_test::value_maker<std::string>::make(i + 7);
+                b.push_back(eb[i]);
+            }
+
+            a.swap(b);
+            CHECK(mabustl_test::same_sequence(a, eb));
+            CHECK(mabustl_test::same_sequence(b, ea));
+
+            sv c(mabustl::move(a));
+            CHECK(mabustl_test::same_sequence(c, eb));
+            CHECK(c.is_inline() == (eb.size() <= N));
+            b = mabustl::move(c);
+            CHECK(mabustl_test::same_sequence(b, eb));
+        }
+    }
+}
+
+int main() {
+    mabustl_test::random_sequence_ops<mabustl::small_vector<int, 1>, false>(30000);
+    mabustl_test::random_sequence_ops<mabustl::small_vector<int, 16>, false>(30000);
+    mabustl_test::random_sequence_ops<mabustl::small_vector<std::string, 4>, false>(30000);
+    mabustl_test::random_sequence_ops<mabustl::small_vector<std::string, 16>, false>(30000);
+    test_allocations<1>();
+    test_allocations<4>();
+    test_allocations<16>();
+    test_constructor_throw<1>();
+    test_constructor_throw<4>();
+    test_move_and_swap<4>();
+    test_move_and_swap<16>();
+    return mabustl_test::pass("test_small_vector");
+}
@@ -0,0 +1,236 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * sort / insertion_sort / is_sorted / is_sorted_until
+ * (1)随机、有序、逆序、少量不同值、全部相等、锯齿、山峰等输入，长度跨过插入排序和九数中值的阈值，
+ *    排序结果与 std::sort 相同；int / double / unsigned char 配合 less、greater 走无分支划分，
+ *    string、自定义比较函数和只能移动的元素走普通划分
+ * (2)比较次数不超过 c * n * log2(n)，包括 McIlroy 的 antiqsort 对手针对本实现现场构造的最坏输入
+ * (3)insertion_sort、is_sorted、is_sorted_until 与 std 比较
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mabu_functional.h"
+#include "mabu_sort_algorithm.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    enum pattern {
+        RANDOM,
+        SORTED,
+        REVERSED,
+        FEW_UNIQUE,
+        ALL_EQUAL,
+        SAWTOOTH,
+        ORGAN_PIPE,
+        SORTED_TAIL_NOISE,
+        PATTERN_COUNT
+    };
+
+    std::vector<long long> make_input(pattern p, size_t n) {
+        std::vector<long long> v(n);
+        for(size_t i = 0; i != n; ++i) {
+            switch(p) {
+                case RANDOM: v[i] = static_cast<long long>(mabustl_test::rng()()); break;
+                case SORTED: v[i] = static_cast<long long>(i); break;
+                case REVERSED: v[i] = static_cast<long long>(n - i); break;
+                case FEW_UNIQUE: v[i] = static_cast<long long>(rand_below(4)); break;
+                case ALL_EQUAL: v[i] = 7; break;
+                case SAWTOOTH: v[i] = static_cast<long long>(i % 97); break;
+                case ORGAN_PIPE: v[i] = static_cast<long long>(i < n / 2 ? i : n - i); break;
+                default: v[i] = static_cast<long long>(i + (i + 10 > n ? rand_below(n + 1) : 0)); break;
+            }
+        }
+        return v;
+    }
+
+    // 把 long long 的输入转换为各种元素类型
+    template<class T>
+    T convert(long long x);
+
+    template<>
+    int convert<int>(long long x) {
+        return static_cast<int>(x);
+    }
+
+    template<>
+    double convert<double>(long long x) {
+        return static_cast<double>(x % 100000) / 7.0;
+    }
+
+    template<>
+    unsigned char convert<unsigned char>(long long x) {
+        return static_cast<unsigned char>(x);
+    }
+
+    template<>
+    std::string convert<std::string>(long long x) {
+        return std::to_string(x % 100000);
+    }
+
+    template<class T, class Compare, class StdCompare>
+    void check_sort(const std::vector<long long>& input, Compare comp, StdCompare std_comp) {
+        std::vector<T> v(input.size());
+        for(size_t i = 0; i != input.size(); ++i) v[i] = convert<T>(input[i]);
+        std::vector<T> expect(v);
+        std::sort(expect.begin(), expect.end(), std_comp);
+        mabustl::sort(v.data(), v.data() + v.size(), comp);
+        CHECK(v == expect);
+        CHECK(mabustl::is_sorted(v.data(), v.data() + v.size(), comp));
+    }
+
+    // 先按低 3 位十进制数、再按值比较
+    bool by_low_digits(int a, int b) {
+        return a % 1000 < b % 1000 || (a % 1000 == b % 1000 && a < b);
+    }
+
+    void test_patterns() {
+        const size_t sizes[] = {0, 1, 2, 3, 23, 24, 25, 127, 128, 129, 1000, 4096, 50000};
+        for(size_t s = 0; s != sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            for(int p = 0; p != PATTERN_COUNT; ++p) {
+                const std::vector<long long> input = make_input(static_cast<pattern>(p), sizes[s]);
+                check_sort<int>(input, mabustl::less<int>(), std::less<int>());
+                check_sort<int>(input, mabustl::greater<int>(), std::greater<int>());
+                check_sort<double>(input, mabustl::less<double>(), std::less<double>());
+                check_sort<unsigned char>(input, mabustl::less<unsigned char>(), std::less<unsigned char>());
+                check_sort<std::string>(input, mabustl::less<std::string>(), std::less<std::string>());
+                // 自定义比较函数不走无分支划分
+                check_sort<int>(input, by_low_digits, by_low_digits);
+            }
+        }
+
+        // 默认比较函数
+        std::vector<int> v(10000);
+        for(size_t i = 0; i != v.size(); ++i) v[i] = static_cast<int>(rand_below(1000));
+        std::vector<int> expect(v);
+        std::sort(expect.begin(), expect.end());
+        mabustl::sort(v.data(), v.data() + v.size());
+        CHECK(v == expect);
+    }
+
+    void test_move_only() {
+        typedef std::unique_ptr<int> ptr;
+        std::vector<ptr> v;
+        std::vector<int> expect;
+        for(int i = 0; i != 5000; ++i) {
+            const int x = static_cast<int>(rand_below(300));
+            v.push_back(ptr(new int(x)));
+            expect.push_back(x);
+        }
+        std::sort(expect.begin(), expect.end());
+        mabustl::sort(v.data(), v.data() + v.size(), [](const ptr& a, const ptr& b) { return *a < *b; });
+        for(size_t i = 0; i != v.size(); ++i) CHECK(*v[i] == expect[i]);
+    }
+
+    size_t compares = 0;
+
+    struct counting_less {
+        bool operator()(int a, int b) const {
+            ++compares;
+            return a < b;
+        }
+    };
+
+    /*
+     * McIlroy, "A Killer Adversary for Quicksort"：排序下标，所有元素一开始都是未定值(gas)，
+     * 两个未定值比较时把其中一个(上一次比较中出现过的候选，通常是枢轴)定为当前最小的值，
+     * 排序结束后每个位置的取值就是让这次排序比较次数最多的输入
+     */
+    class antiqsort {
+    public:
+        explicit antiqsort(size_t n): value_(n, static_cast<int>(n)), gas_(static_cast<int>(n)), solid_(0),
+                                      candidate_(0) {}
+
+        bool operator()(int x, int y) {
+            if(value_[x] == gas_ && value_[y] == gas_) freeze(x == candidate_ ? x : y);
+            if(value_[x] == gas_) candidate_ = x;
+            else if(value_[y] == gas_) candidate_ = y;
+            return value_[x] < value_[y];
+        }
+
+        std::vector<int> input() const { return value_; }
+
+    private:
+        void freeze(int x) { value_[x] = solid_++; }
+
+        std::vector<int> value_;
+        int gas_;
+        int solid_;
+        int candidate_;
+    };
+
+    // 比较函数对象按值传递，用指针共享对手的状态
+    struct antiqsort_ref {
+        antiqsort* adversary;
+
+        bool operator()(int x, int y) const { return (*adversary)(x, y); }
+    };
+
+    void check_compares(std::vector<int> v, double factor) {
+        const size_t n = v.size();
+        compares = 0;
+        mabustl::sort(v.data(), v.data() + n, counting_less());
+        CHECK(std::is_sorted(v.begin(), v.end()));
+        CHECK(static_cast<double>(compares) <= factor * n * std::log2(static_cast<double>(n)));
+    }
+
+    void test_compare_count() {
+        const size_t n = 100000;
+        for(int p = 0; p != PATTERN_COUNT; ++p) {
+            const std::vector<long long> input = make_input(static_cast<pattern>(p), n);
+            std::vector<int> v(n);
+            for(size_t i = 0; i != n; ++i) v[i] = static_cast<int>(input[i]);
+            check_compares(v, 2.0);
+        }
+
+        // 对手构造的输入：不退化为 O(n^2)
+        const size_t sizes[] = {1000, 20000};
+        for(size_t s = 0; s != 2; ++s) {
+            antiqsort adversary(sizes[s]);
+            std::vector<int> index(sizes[s]);
+            for(size_t i = 0; i != index.size(); ++i) index[i] = static_cast<int>(i);
+            antiqsort_ref ref = {&adversary};
+            mabustl::sort(index.data(), index.data() + index.size(), ref);
+            check_compares(adversary.input(), 4.0);
+        }
+    }
+
+    void test_helpers() {
+        for(int round = 0; round != 200; ++round) {
+            const size_t n = rand_below(200);
+            std::vector<int> v(n);
+            for(size_t i = 0; i != n; ++i) v[i] = static_cast<int>(rand_below(50));
+            // 把随机长度的前缀排好序
+            std::sort(v.begin(), v.begin() + rand_below(n + 1));
+            CHECK(mabustl::is_sorted_until(v.data(), v.data() + n) - v.data() ==
+                  std::is_sorted_until(v.begin(), v.end()) - v.begin());
+            CHECK(mabustl::is_sorted(v.data(), v.data() + n) == std::is_sorted(v.begin(), v.end()));
+            CHECK(mabustl::is_sorted_until(v.data(), v.data() + n, mabustl::greater<int>()) - v.data() ==
+                  std::is_sorted_until(v.begin(), v.end(), std::greater<int>()) - v.begin());
+
+            std::vector<int> expect(v);
+            std::sort(expect.begin(), expect.end());
+            mabustl::insertion_sort(v.data(), v.data() + n);
+            CHECK(v == expect);
+        }
+    }
+}
+
+int main() {
+    test_patterns();
+    test_move_only();
+    test_compare_count();
+    test_helpers();
+    return mabustl_test::pass("test_sort");
+}
@@ -0,0 +1,158 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * spsc_ring_buffer
+ * (1)单线程上 push / emplace / push_n / front / pop / pop_n 的随机操作，与 std::deque 逐步比较，
+ *    满时 push 失败，push_n / pop_n 跨过数组末尾
+ * (2)一个生产者线程和一个消费者线程，随机大小的批量与单个操作混合，消费者按顺序收到全部元素
+ * (3)析构时销毁剩余的元素
+ */
+
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mabu_spsc_ring_buffer.h"
+#include "test_common.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    std::string make_value(size_t i) {
+        // 长字符串，半途读取到的元素会表现为内容不一致
+        return std::to_string(i) + std::string(24 + i % 16, static_cast<char>('a' + i % 26));
+    }
+
+    void test_single_thread(size_t capacity) {
+        mabustl::spsc_ring_buffer<std::string> q(capacity);
+        CHECK(q.capacity() >= capacity && q.capacity() < 2 * capacity + 1);
+        std::deque<std::string> expect;
+        size_t next = 0;
+        for(int step = 0; step != 50000; ++step) {
+            const size_t op = rand_below(6);
+            if(op == 0) {
+                const bool ok = q.push(make_value(next));
+                CHECK(ok == (expect.size() < q.capacity()));
+                if(ok) expect.push_back(make_value(next));
+                ++next;
+            } else if(op == 1) {
+                const bool ok = q.emplace(make_value(next));
+                CHECK(ok == (expect.size() < q.capacity()));
+                if(ok) expect.push_back(make_value(next));
+                ++next;
+            } else if(op == 2) {
+                std::vector<std::string> batch(rand_below(q.capacity() + 2));
+                for(size_t i = 0; i != batch.size(); ++i) batch[i] = make_value(next + i);
+                const size_t pushed = q.push_n(batch.data(), batch.size());
+                CHECK(pushed == std::min(batch.size(), q.capacity() - expect.size()));
+                for(size_t i = 0; i != pushed; ++i) expect.push_back(make_value(next + i));
+                next += batch.size();
+            } else if(op == 3) {
+                std::string* front = q.front();
+                CHECK((front == nullptr) == expect.empty());
+                if(front != nullptr) {
+                    CHECK(*front == expect.front());
+                    q.pop();
+                    expect.pop_front();
+                }
+            } else if(op == 4) {
+                std::string value;
+                const bool ok = q.pop(value);
+                CHECK(ok == !expect.empty());
+                if(ok) {
+                    CHECK(value == expect.front());
+                    expect.pop_front();
+                }
+            } else {
+                std::vector<std::string> out(rand_below(q.capacity() + 2));
+                const size_t popped = q.pop_n(out.data(), out.size());
+                CHECK(popped == std::min(out.size(), expect.size()));
+                for(size_t i = 0; i != popped; ++i) {
+                    CHECK(out[i] == expect.front());
+                    expect.pop_front();
+                }
+            }
+            CHECK(q.size() == expect.size());
+            CHECK(q.empty() == expect.empty());
+        }
+    }
+
+    void test_two_threads(size_t capacity, size_t total) {
+        mabustl::spsc_ring_buffer<std::string> q(capacity);
+        std::thread producer([&q, total] {
+            std::mt19937_64 rng(1);
+            size_t next = 0;
+            std::vector<std::string> batch;
+            while(next != total) {
+                size_t pushed = 0;
+                if(rng() % 2 == 0) {
+                    pushed = q.push(make_value(next)) ? 1 : 0;
+                } else {
+                    batch.resize(std::min<size_t>(1 + rng() % 64, total - next));
+                    for(size_t i = 0; i != batch.size(); ++i) batch[i] = make_value(next + i);
+                    pushed = q.push_n(batch.data(), batch.size());
+                }
+                next += pushed;
+                // 只有一个核时空转会占满整个时间片，没有进展就让出
+                if(pushed == 0) std::this_thread::yield();
+            }
+        });
+
+        std::mt19937_64 rng(2);
+        size_t expected = 0;
+        std::vector<std::string> out(64);
+        while(expected != total) {
+            size_t popped = 0;
+            if(rng() % 2 == 0) {
+                std::string value;
+                if(q.pop(value)) {
+                    CHECK(value == make_value(expected));
+                    popped = 1;
+                    ++expected;
+                }
+            } else {
+                popped = q.pop_n(out.data(), 1 + rng() % 64);
+                for(size_t i = 0; i != popped; ++i, ++expected) CHECK(out[i] == make_value(expected));
+            }
+            if(popped == 0) std::this_thread::yield();
+        }
+        producer.join();
+        CHECK(q.empty());
+    }
+
+    int live = 0;
+
+    struct counted {
+        counted() { ++live; }
+        counted(const counted&) { ++live; }
+        counted(counted&&) noexcept { ++live; }
+        counted& operator=(const counted&) = default;
+        ~counted() { --live; }
+    };
+
+    void test_destroy_remaining() {
+        {
+            mabustl::spsc_ring_buffer<counted> q(16);
+            for(int i = 0; i != 40; ++i) {
+                q.emplace();
+                if(i % 3 == 0) q.pop();
+            }
+            CHECK(live == static_cast<int>(q.size()));
+        }
+        CHECK(live == 0);
+    }
+}
+
+int main() {
+    test_single_thread(1);
+    test_single_thread(7);
+    test_single_thread(64);
+    test_two_threads(4, 100000);
+    test_two_threads(1024, 200000);
+    test_destroy_remaining();
+    return mabustl_test::pass("test_spsc_ring_buffer");
+}
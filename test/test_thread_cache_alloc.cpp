@@ -0,0 +1,105 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * thread_cache_alloc / thread_cache_allocator
+ * (1)多个线程随机分配，一部分块经由共享的交换区交给其他线程回收(跨线程回收)，回收前检查块没有被覆盖；
+ *    线程在还持有缓存时退出，缓存归还给 pool_alloc 之后其他线程继续使用
+ * (2)以 thread_cache_allocator 作为 std::map 的 allocator，随机操作后与 std::map 比较
+ */
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "mabu_allocator.h"
+#include "test_common.h"
+
+using mabustl_test::tagged_block;
+
+namespace {
+    enum { THREADS = 4, STEPS = 50000 };
+
+    std::mutex exchange_mutex;
+    std::vector<tagged_block> exchange;  // 由一个线程分配、等待其他线程回收的块
+
+    void worker(unsigned seed) {
+        std::mt19937 rng(seed);
+        std::vector<tagged_block> live;
+        for(int step = 0; step != STEPS; ++step) {
+            const unsigned op = rng() % 8;
+            if(op < 4 || live.empty()) {
+                const size_t n = rng() % 10 == 0 ? 300 + rng() % 1000 : 1 + rng() % mabustl::pool_alloc::MAX_BYTES;
+                void* p = mabustl::thread_cache_alloc::allocate(n);
+                CHECK(mabustl_test::aligned_to(p, mabustl::pool_alloc::ALIGN));
+                live.push_back(mabustl_test::make_block(p, n, static_cast<unsigned char>(seed + step)));
+            } else if(op < 6) {
+                const size_t i = rng() % live.size();
+                CHECK(mabustl_test::intact(live[i]));
+                mabustl::thread_cache_alloc::deallocate(live[i].ptr, live[i].n);
+                live[i] = live.back();
+                live.pop_back();
+            } else if(op == 6) {
+                std::lock_guard<std::mutex> lock(exchange_mutex);
+                exchange.push_back(live.back());
+                live.pop_back();
+            } else {
+                tagged_block b;
+                {
+                    std::lock_guard<std::mutex> lock(exchange_mutex);
+                    if(exchange.empty()) continue;
+                    b = exchange.back();
+                    exchange.pop_back();
+                }
+                CHECK(mabustl_test::intact(b));
+                mabustl::thread_cache_alloc::deallocate(b.ptr, b.n);
+            }
+        }
+        for(size_t i = 0; i != live.size(); ++i) {
+            CHECK(mabustl_test::intact(live[i]));
+            mabustl::thread_cache_alloc::deallocate(live[i].ptr, live[i].n);
+        }
+    }
+
+    void test_cross_thread() {
+        // 两轮线程，第二轮会用到第一轮线程退出时还给 pool_alloc 的块
+        for(unsigned round = 0; round != 2; ++round) {
+            std::vector<std::thread> threads;
+            for(unsigned t = 0; t != THREADS; ++t) threads.push_back(std::thread(worker, round * THREADS + t + 1));
+            for(size_t t = 0; t != threads.size(); ++t) threads[t].join();
+        }
+        for(size_t i = 0; i != exchange.size(); ++i) {
+            CHECK(mabustl_test::intact(exchange[i]));
+            mabustl::thread_cache_alloc::deallocate(exchange[i].ptr, exchange[i].n);
+        }
+        exchange.clear();
+    }
+
+    void test_std_map() {
+        typedef std::pair<const int, int> value_type;
+        std::map<int, int> expect;
+        std::map<int, int, std::less<int>, mabustl::thread_cache_allocator<value_type> > actual;
+        for(int step = 0; step != 100000; ++step) {
+            const int key = static_cast<int>(mabustl_test::rand_below(3000));
+            if(mabustl_test::rand_below(2) == 0) {
+                expect[key] = step;
+                actual[key] = step;
+            } else {
+                CHECK(expect.erase(key) == actual.erase(key));
+            }
+        }
+        CHECK(expect.size() == actual.size());
+        CHECK(std::equal(expect.begin(), expect.end(), actual.begin()));
+    }
+}
+
+int main() {
+    test_cross_thread();
+    test_std_map();
+    return mabustl_test::pass("test_thread_cache_alloc");
+}
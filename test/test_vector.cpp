@@ -0,0 +1,203 @@
+/*
+ * time: 2026-10-17
+ * author: mabu
+ */
+
+/*
+ * vector
+ * (1)int(平凡类型，走 memmove 搬移)和 std::string 上的随机操作，与 std::vector 逐步比较
+ * (2)复制构造抛出异常时，push_back / insert 引起的扩容不改变原有内容(强异常保证)；
+ *    构造函数中元素的构造抛出异常时，已分配的空间全部回收
+ * (3)emplace_back 直接构造，不产生临时对象；reserve 之后 push_back 不再扩容
+ * (4)复制赋值平凡但复制构造不平凡的类型，vector(n, value) / 区间构造 / insert 都调用复制构造
+ */
+
+#include <new>
+#include <string>
+#include <vector>
+
+#include "mabu_vector.h"
+#include "test_sequence.h"
+
+using mabustl_test::rand_below;
+
+namespace {
+    long long copies = 0;
+    long long moves = 0;
+    long long throw_countdown = -1;  // 为 0 时下一次复制抛出异常，为负时不抛出
+
+    // 移动构造可能抛出异常，扩容时 vector 只能复制
+    struct throwing_copy {
+        int value;
+
+        explicit throwing_copy(int v): value(v) {}
+        throwing_copy(const throwing_copy& other): value(other.value) {
+            if(throw_countdown >= 0 && throw_countdown-- == 0) throw std::bad_alloc();
+            ++copies;
+        }
+        throwing_copy(throwing_copy&& other): value(other.value) { ++moves; }
+        throwing_copy& operator=(const throwing_copy& other) {
+            value = other.value;
+            return *this;
+        }
+    };
+
+    void test_strong_guarantee() {
+        for(int round = 0; round != 200; ++round) {
+            mabustl::vector<throwing_copy> v;
+            const int n = 1 + static_cast<int>(rand_below(100));
+            for(int i = 0; i != n; ++i) v.emplace_back(i);
+            v.shrink_to_fit();
+            const size_t cap = v.capacity();
+
+            throw_countdown = static_cast<long long>(rand_below(v.size()));
+            bool thrown = false;
+            try {
+                if(rand_below(2) == 0) {
+                    v.push_back(throwing_copy(-1));
+                } else {
+                    v.insert(v.end(), throwing_copy(-1));
+                }
+            } catch(const std::bad_alloc&) {
+                thrown = true;
+            }
+            throw_countdown = -1;
+            if(!thrown) continue;  // 倒数的次数落在了新元素本身上
+            CHECK(v.capacity() == cap);
+            CHECK(static_cast<int>(v.size()) == n);
+            for(int i = 0; i != n; ++i) CHECK(v[i].value == i);
+        }
+    }
+
+    // 默认构造、复制和移动都可能抛出异常
+    struct throwing_ctor {
+        int value;
+
+        static void may_throw() {
+            if(throw_countdown >= 0 && throw_countdown-- == 0) throw std::bad_alloc();
+        }
+
+        throwing_ctor(): value(0) { may_throw(); }
+        explicit throwing_ctor(int v): value(v) {}
+        throwing_ctor(const throwing_ctor& other): value(other.value) { may_throw(); }
+        throwing_ctor(throwing_ctor&& other): value(other.value) { may_throw(); }
+        throwing_ctor& operator=(const throwing_ctor& other) {
+            value = other.value;
+            return *this;
+        }
+    };
+
+    long long live_blocks = 0;
+
+    // 有状态，记录未回收的内存块数；id 不同的 allocator 不相等
+    template<class T>
+    struct live_alloc {
+        typedef T value_type;
+
+        int id;
+
+        explicit live_alloc(int i = 0): id(i) {}
+
+        template<class U>
+        live_alloc(const live_alloc<U>& other): id(other.id) {}
+
+        T* allocate(size_t n) {
+            ++live_blocks;
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* ptr, size_t) {
+            --live_blocks;
+            ::operator delete(ptr);
+        }
+    };
+
+    template<class T, class U>
+    bool operator==(const live_alloc<T>& lhs, const live_alloc<U>& rhs) { return lhs.id == rhs.id; }
+
+    template<class T, class U>
+    bool operator!=(const live_alloc<T>& lhs, const live_alloc<U>& rhs) { return lhs.id != rhs.id; }
+
+    void test_constructor_throw() {
+        typedef mabustl::vector<throwing_ctor, live_alloc<throwing_ctor> > vector_type;
+        for(int round = 0; round != 600; ++round) {
+            const size_t n = 1 + rand_below(100);
+            vector_type src(live_alloc<throwing_ctor>(1));
+            for(size_t i = 0; i != n; ++i) src.emplace_back(static_cast<int>(i));
+            const long long before = live_blocks;
+
+            throw_countdown = static_cast<long long>(rand_below(n));
+            bool thrown = false;
+            try {
+                const size_t op = round % 3;
+                if(op == 0) {
+                    vector_type v(n, live_alloc<throwing_ctor>(2));
+                } else if(op == 1) {
+                    vector_type v(n, throwing_ctor(7), live_alloc<throwing_ctor>(2));
+                } else {
+                    // allocator 不相等，只能逐个移动元素
+                    vector_type v(std::move(src), live_alloc<throwing_ctor>(2));
+                }
+            } catch(const std::bad_alloc&) {
+                thrown = true;
+            }
+            throw_countdown = -1;
+            CHECK(thrown);
+            CHECK(live_blocks == before);
+        }
+        CHECK(live_blocks == 0);
+    }
+
+    long long ctor_copies = 0;
+
+    // 复制赋值是平凡的，复制构造不是：未初始化的空间上不能用赋值代替构造
+    struct counted_ctor {
+        int value;
+
+        explicit counted_ctor(int v): value(v) {}
+        counted_ctor(const counted_ctor& other): value(other.value) { ++ctor_copies; }
+        counted_ctor& operator=(const counted_ctor&) = default;
+    };
+
+    void test_nontrivial_copy_constructor() {
+        ctor_copies = 0;
+        const counted_ctor value(5);
+        mabustl::vector<counted_ctor> filled(100, value);
+        CHECK(ctor_copies == 100);
+
+        ctor_copies = 0;
+        mabustl::vector<counted_ctor> copied(filled.begin(), filled.end());
+        CHECK(ctor_copies == 100);
+
+        // 在末尾之后的未初始化空间上插入
+        copied.reserve(300);
+        ctor_copies = 0;
+        copied.insert(copied.end(), 50, value);
+        CHECK(ctor_copies >= 50);
+        copied.insert(copied.end(), filled.begin(), filled.end());
+        CHECK(ctor_copies >= 150);
+        CHECK(copied.size() == 250);
+        for(size_t i = 0; i != copied.size(); ++i) CHECK(copied[i].value == 5);
+    }
+
+    void test_emplace_and_reserve() {
+        mabustl::vector<throwing_copy> v;
+        v.reserve(1000);
+        const throwing_copy* data = v.data();
+        copies = moves = 0;
+        for(int i = 0; i != 1000; ++i) v.emplace_back(i);
+        CHECK(copies == 0 && moves == 0);
+        CHECK(v.data() == data);
+        CHECK(v.capacity() >= 1000);
+    }
+}
+
+int main() {
+    mabustl_test::random_sequence_ops<mabustl::vector<int>, false>(100000);
+    mabustl_test::random_sequence_ops<mabustl::vector<std::string>, false>(100000);
+    test_strong_guarantee();
+    test_constructor_throw();
+    test_emplace_and_reserve();
+    test_nontrivial_copy_constructor();
+    return mabustl_test::pass("test_vector");
+}